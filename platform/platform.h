@@ -54,6 +54,16 @@ error_code platform_get_system_time_ms(u64* out_time);
 // System Functions
 
 error_code platform_get_available_memory_size(umax* out_size);
+error_code platform_get_processor_count(u32* out_count);
+error_code platform_get_process_id(u32* out_id);
+
+// Thread Functions
+
+typedef error_code (*platform_thread_function)(void* data);
+typedef void* platform_thread;
+
+error_code platform_thread_create(platform_thread* out_thread, platform_thread_function function, void* data);
+error_code platform_thread_join(platform_thread thread, error_code* out_result); // waits for the thread to finish and releases it
 
 // Memory Functions
 
@@ -76,5 +86,8 @@ error_code platform_file_exists(str path, bool* out_exists);
 error_code platform_create_file(str path, str content);
 error_code platform_get_file_content_length(str path, u32* out_length);
 error_code platform_read_file_length(str path, u32 length, str* in_out_content, u32* out_length);
+error_code platform_write_file(str path, const byte* data, u32 length); // creates the file or overwrites its content
+error_code platform_replace_file(str source_path, str destination_path); // moves the file, replacing the destination in a single step
+error_code platform_delete_file(str path);
 
 #endif
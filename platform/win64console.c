@@ -407,6 +407,72 @@ error_code platform_get_available_memory_size(umax* out_size) {
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
+error_code platform_get_processor_count(u32* out_count) {
+    SYSTEM_INFO system_info;
+    RUN_ERROR_CODE_FUNCTION(platform_memory_clear, &system_info, sizeof(SYSTEM_INFO));
+    GetSystemInfo(&system_info);
+
+    *out_count = system_info.dwNumberOfProcessors > 0 ? (u32) system_info.dwNumberOfProcessors : 1;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code platform_get_process_id(u32* out_id) {
+    *out_id = (u32) GetCurrentProcessId();
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// Thread Functions
+
+typedef struct {
+    platform_thread_function function;
+    void* data;
+} win64_thread_start;
+
+static DWORD WINAPI win64_thread_entry(LPVOID parameter) {
+    win64_thread_start start = *((win64_thread_start*) parameter);
+    HeapFree(win64_globals.heap_handle, 0, parameter);
+
+    return (DWORD) start.function(start.data);
+}
+
+error_code platform_thread_create(platform_thread* out_thread, platform_thread_function function, void* data) {
+    win64_thread_start* start = NULL;
+    RUN_ERROR_CODE_FUNCTION(platform_memory_allocate, (void**) &start, sizeof(win64_thread_start));
+    start->function = function;
+    start->data = data;
+
+    HANDLE thread = CreateThread(NULL, 0, win64_thread_entry, start, 0, NULL);
+    if (thread == NULL) {
+        RUN_ERROR_CODE_FUNCTION(platform_memory_deallocate, start);
+        return ERROR_CODE_FAILED_TO_CREATE_THREAD;
+    }
+
+    *out_thread = (platform_thread) thread;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code platform_thread_join(platform_thread thread, error_code* out_result) {
+    if (WaitForSingleObject((HANDLE) thread, INFINITE) != WAIT_OBJECT_0) {
+        return ERROR_CODE_FAILED_TO_JOIN_THREAD;
+    }
+
+    DWORD exit_code = 0;
+    if (GetExitCodeThread((HANDLE) thread, &exit_code) == 0) {
+        return ERROR_CODE_FAILED_TO_JOIN_THREAD;
+    }
+
+    if (CloseHandle((HANDLE) thread) == 0) {
+        return ERROR_CODE_WIN64_FAILED_CLOSE_HANDLE;
+    }
+
+    *out_result = (error_code) exit_code;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
 // Memory Functions
 
 error_code platform_memory_heap_initialize() {
@@ -638,5 +704,41 @@ error_code platform_read_file_length(str path, u32 length, str* in_out_content,
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
+error_code platform_write_file(str path, const byte* data, u32 length) {
+    HANDLE file_handle = CreateFileA((LPCSTR) path, GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return ERROR_CODE_FAILED_TO_CREATE_FILE;
+    }
+
+    DWORD bytes_written = 0;
+    BOOL result_write_file = WriteFile(file_handle, (LPCVOID) data, (DWORD) length, &bytes_written, NULL);
+
+    if (CloseHandle(file_handle) == 0) {
+        return ERROR_CODE_WIN64_FAILED_CLOSE_HANDLE;
+    }
+
+    if (result_write_file == FALSE || (DWORD) length != bytes_written) {
+        return ERROR_CODE_FAILED_TO_WRITE_FILE;
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code platform_replace_file(str source_path, str destination_path) {
+    if (MoveFileExA((LPCSTR) source_path, (LPCSTR) destination_path, MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) == 0) {
+        return ERROR_CODE_FAILED_TO_MOVE_FILE;
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code platform_delete_file(str path) {
+    if (DeleteFileA((LPCSTR) path) == 0) {
+        return ERROR_CODE_FAILED_TO_DELETE_FILE;
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
 #endif
 #endif
@@ -9,3 +9,7 @@
 string_hash hash_bytes(byte* bytes, u32 length) {
     return (string_hash) rapidhash((void*) bytes, length);
 }
+
+string_hash hash_bytes_seeded(byte* bytes, u32 length, u64 seed) {
+    return (string_hash) rapidhash_withSeed((void*) bytes, length, seed);
+}
@@ -12,5 +12,6 @@ typedef u64 string_hash;
 // Functions
 
 string_hash hash_bytes(byte* bytes, u32 length);
+string_hash hash_bytes_seeded(byte* bytes, u32 length, u64 seed); // chains hashes, e.g. when hashing data that is not stored contiguously
 
 #endif
@@ -29,6 +29,10 @@
 #define PROGRAM_FEATURE_NO_COLOR_REGISTRY (0)   /* if this is set to 1 the color registry table is not generated, saving up program space */
 
 #define PROGRAM_FEATURE_WAVE_COMPILER_DEBUG_MODE (1) /* debugs compilation steps taken, useful while working on the compiler */
+#define PROGRAM_FEATURE_WAVE_TOKENIZER_BENCHMARK (0) /* tokenizes the source file repeatedly before compiling it and prints the tokenizer throughput in MB/s */
+#define PROGRAM_FEATURE_WAVE_STREAMING_COMPILER (1) /* the parser pulls tokens from the tokenizer on demand instead of tokenizing the whole source up front, which bounds the memory used by tokens; not used when function bodies are compiled in parallel (PROGRAM_FEATURE_WAVE_PARALLEL_COMPILER without PROGRAM_FEATURE_DEBUG_MODE) or when compiling with a compile cache, both need the whole token stream */
+#define PROGRAM_FEATURE_WAVE_PARALLEL_COMPILER (0) /* compiles function bodies on multiple threads once all declarations are parsed, which requires the whole token stream and therefore takes precedence over PROGRAM_FEATURE_WAVE_STREAMING_COMPILER; ignored in debug mode, where the source is streamed instead */
+#define PROGRAM_FEATURE_WAVE_PROFILER (0) /* the vm counts function calls, conditional jumps and switch cases for profile guided compilation once a profile is attached to it (see @wave_profile_attach), which costs a check per counted instruction otherwise */
 
 // Safety Features
 
@@ -38,6 +42,7 @@
 // Program Features
 
 #define PROGRAM_FEATURE_32BIT_MODE (0) /* disables certain 64bit features, like copying data in word sizes of 64bit instead of 32bit */
+#define PROGRAM_FEATURE_SIMD (1) /* compiles sse2, avx2 and avx-512 kernels for the array math builtins (x86-64 with gcc or clang only), the kernel set is picked at runtime */
 
 #define PROGRAM_FEATURE_NO_OPCODE_NAMES (0) /* if this is set to 0 a table containing the name of every opcode is generated which may use up more program space */
 
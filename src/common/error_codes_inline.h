@@ -28,6 +28,9 @@ ERROR_CODE_ENTRY(FAILED_TO_COMMANDLINE_PRINT,
 
 ERROR_CODE_ENTRY(FAILED_TO_GET_TIME,                                                            ERROR_FLAG_SEVERE)
 
+ERROR_CODE_ENTRY(FAILED_TO_CREATE_THREAD,                                                       ERROR_FLAG_SEVERE)
+ERROR_CODE_ENTRY(FAILED_TO_JOIN_THREAD,                                                         ERROR_FLAG_SEVERE)
+
 ERROR_CODE_ENTRY(FAILED_TO_RETRIEVE_MEMORY_SIZE,                                                ERROR_FLAG_WARNING)
 
 ERROR_CODE_ENTRY(FAILED_TO_ALLOCATE,                                                            ERROR_FLAG_SEVERE)
@@ -40,6 +43,8 @@ ERROR_CODE_ENTRY(FAILED_TO_CREATE_FOLDER,
 ERROR_CODE_ENTRY(FAILED_TO_CREATE_FILE,                                                         ERROR_FLAG_SEVERE)
 ERROR_CODE_ENTRY(FAILED_TO_WRITE_FILE,                                                          ERROR_FLAG_SEVERE)
 ERROR_CODE_ENTRY(FAILED_TO_READ_FILE,                                                           ERROR_FLAG_SEVERE)
+ERROR_CODE_ENTRY(FAILED_TO_MOVE_FILE,                                                           ERROR_FLAG_SEVERE)
+ERROR_CODE_ENTRY(FAILED_TO_DELETE_FILE,                                                         ERROR_FLAG_SEVERE)
 
 ////////////////////////////////////////////////////////////////
 // Platform Specific Error Codes                              //
@@ -120,6 +125,10 @@ ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_CALL_STACK_UNDERFLOW,
 ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION,                                       ERROR_FLAG_WARNING)
 ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_INDEX_OUT_OF_BOUNDS,                                          ERROR_FLAG_WARNING)
 ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_GLOBALS_INDEX_OUT_OF_BOUNDS,                                  ERROR_FLAG_WARNING)
+ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_ARRAY_TOO_LONG,                                               ERROR_FLAG_WARNING)
+ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_ARRAY_TYPE_MISMATCH,                                          ERROR_FLAG_WARNING)
+ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_ARRAY_VIEW_NOT_RESIZABLE,                                     ERROR_FLAG_WARNING)
+ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_ARRAY_SLICED_NOT_RESIZABLE,                                   ERROR_FLAG_WARNING)
 
 ERROR_CODE_ENTRY(LANGUAGE_RUNTIME_INVALID_NATIVE_FUNCTION_CALL,                                 ERROR_FLAG_WARNING)
 
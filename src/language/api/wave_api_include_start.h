@@ -1,6 +1,7 @@
 #define WAVE_VM_SAFE_MODE (0)
 #define WAVE_VM_STACK_INLINE_DEFINE (1)
 #define WAVE_VM_STACK_INLINE_THROW_ERRORS (0)
+#define WAVE_VM_STACK_INLINE_GROW (0)
 #include "language/runtime/wave_vm_stack_inline.h"
 
 #define WAVE_VM_NATIVE_FUNCTION(package, function_name, parameter_size, statement)                                                              \
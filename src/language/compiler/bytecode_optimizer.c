@@ -0,0 +1,746 @@
+#include "bytecode_optimizer.h"
+
+#include "common/data/string/string.h"
+
+#include "common/memory/memory.h"
+
+#include "language/wave_opcodes.h"
+
+// Defines
+
+#define BYTECODE_OPTIMIZER_RESERVE(pointer, capacity, amount, initial_capacity)                         \
+    do {                                                                                                \
+        if ((amount) > (capacity)) {                                                                    \
+            u32 new_capacity = (capacity) == 0 ? (initial_capacity) : (capacity) * 2;                   \
+            while ((amount) > new_capacity) {                                                           \
+                new_capacity *= 2;                                                                      \
+            }                                                                                           \
+                                                                                                        \
+            RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(pointer), sizeof(*(pointer)) * new_capacity); \
+            (capacity) = new_capacity;                                                                  \
+        }                                                                                               \
+    } while (0)
+
+#define BYTECODE_OPTIMIZER_READ(type, bytecode, offset) (*((type*) ((bytecode) + (offset))))
+
+#define BYTECODE_OPTIMIZER_IS_FAMILY(opcode, first) ((opcode) >= (first) && (opcode) <= (first) + 3) // the 8, 16, 32 and 64bit variants of an instruction follow each other
+#define BYTECODE_OPTIMIZER_IS_CONDITIONAL_JUMP(opcode) ((opcode) >= OPCODE_CJUMP_8_IF_0 && (opcode) <= OPCODE_CJUMP_64_IF_1)
+
+// Functions
+
+// decoding
+
+static bool bytecode_optimizer_get_size(const byte* bytecode, u32 remaining, u32* out_size, u32* out_target_count) { // false if the instruction cannot be decoded
+    if (remaining == 0) {
+        return false;
+    }
+
+    u32 size = 1;
+    u32 target_count = 0;
+
+    wave_opcode opcode = bytecode[0];
+    switch (opcode) {
+        case OPCODE_NOP:
+        case OPCODE_END:
+        case OPCODE_CALL_DYN:
+        case OPCODE_CALL_DYN_ERR:
+        case OPCODE_ERR_THROW:
+        case OPCODE_ERR_CATCH:
+        case OPCODE_ERR_READ:
+        case OPCODE_ERR_CHECK:
+        case OPCODE_POP_8:
+        case OPCODE_POP_16:
+        case OPCODE_POP_32:
+        case OPCODE_POP_64:
+        case OPCODE_POP_128:
+        case OPCODE_POP_FREE:
+        case OPCODE_SWAP_8:
+        case OPCODE_SWAP_16:
+        case OPCODE_SWAP_32:
+        case OPCODE_SWAP_64:
+        case OPCODE_STR_CONCAT:
+        case OPCODE_STR_DUP:
+        case OPCODE_STR_EQU:
+        case OPCODE_STR_GET:
+        case OPCODE_STR_SET:
+        case OPCODE_STR_LEN:
+        case OPCODE_ARR_GET:
+        case OPCODE_ARR_SET:
+        case OPCODE_ARR_LEN: {
+            break;
+        }
+
+        case OPCODE_CJUMP:  { size += sizeof(i32); target_count = 1; break; }
+        case OPCODE_RETURN: { size += sizeof(u8); break; }
+        case OPCODE_CALL:  { size += sizeof(u32); break; } // linked after parsing, the offset does not depend on where the call is placed
+
+        case OPCODE_CJUMP_8_IF_0:
+        case OPCODE_CJUMP_8_IF_1:
+        case OPCODE_CJUMP_16_IF_0:
+        case OPCODE_CJUMP_16_IF_1:
+        case OPCODE_CJUMP_32_IF_0:
+        case OPCODE_CJUMP_32_IF_1:
+        case OPCODE_CJUMP_64_IF_0:
+        case OPCODE_CJUMP_64_IF_1: {
+            size += sizeof(i16);
+            target_count = 1;
+            break;
+        }
+
+        case OPCODE_TABLESWITCH:
+        case OPCODE_LOOKUPSWITCH: {
+            if (remaining < sizeof(byte) + sizeof(u16)) {
+                return false;
+            }
+
+            u16 field = BYTECODE_OPTIMIZER_READ(u16, bytecode, sizeof(byte));
+            u32 entry_size = opcode == OPCODE_TABLESWITCH ? sizeof(u16) : (1u << (field >> (U16_BIT_COUNT - 2))) + sizeof(u16);
+
+            target_count = field & 0b0011111111111111;
+            size += sizeof(u16) + entry_size * target_count;
+            break;
+        }
+
+        case OPCODE_CALL_NATIVE:
+        case OPCODE_CALL_NATIVE_ERR:
+        case OPCODE_POP_N:
+
+        case OPCODE_LOAD_8:
+        case OPCODE_LOAD_16:
+        case OPCODE_LOAD_32:
+        case OPCODE_LOAD_64:
+        case OPCODE_STORE_8:
+        case OPCODE_STORE_16:
+        case OPCODE_STORE_32:
+        case OPCODE_STORE_64:
+
+        case OPCODE_GET_GLOB_8:
+        case OPCODE_GET_GLOB_16:
+        case OPCODE_GET_GLOB_32:
+        case OPCODE_GET_GLOB_64:
+        case OPCODE_SET_GLOB_8:
+        case OPCODE_SET_GLOB_16:
+        case OPCODE_SET_GLOB_32:
+        case OPCODE_SET_GLOB_64:
+
+        case OPCODE_STRUCT_GET_8:
+        case OPCODE_STRUCT_GET_16:
+        case OPCODE_STRUCT_GET_32:
+        case OPCODE_STRUCT_GET_64:
+        case OPCODE_STRUCT_SET_8:
+        case OPCODE_STRUCT_SET_16:
+        case OPCODE_STRUCT_SET_32:
+        case OPCODE_STRUCT_SET_64: {
+            size += sizeof(u16);
+            break;
+        }
+
+        case OPCODE_PUSH_8:  { size += sizeof(u8);  break; }
+        case OPCODE_PUSH_16: { size += sizeof(u16); break; }
+        case OPCODE_PUSH_32: { size += sizeof(u32); break; }
+        case OPCODE_PUSH_64: { size += sizeof(u64); break; }
+
+        case OPCODE_TYPE_CONV_STATIC:
+        case OPCODE_TYPE_CONV_REINTERPRET: {
+            size += sizeof(u8);
+            break;
+        }
+
+        case OPCODE_STR_NEW: {
+            if (remaining < sizeof(byte) + sizeof(u32)) {
+                return false;
+            }
+
+            size += sizeof(u32) + BYTECODE_OPTIMIZER_READ(u32, bytecode, sizeof(byte));
+            break;
+        }
+
+        case OPCODE_EXT: {
+            if (remaining < sizeof(byte) * 2) {
+                return false;
+            }
+
+            size += sizeof(byte);
+            switch ((wave_opcode_extended) bytecode[1]) {
+                case OPCODE_EXT_ARR_COPY:
+                case OPCODE_EXT_ARR_SLICE: {
+                    break;
+                }
+
+                case OPCODE_EXT_U16_TO_U8:
+                case OPCODE_EXT_U32_TO_U8:
+                case OPCODE_EXT_U32_TO_U16:
+                case OPCODE_EXT_U64_TO_U8:
+                case OPCODE_EXT_U64_TO_U16:
+                case OPCODE_EXT_U64_TO_U32:
+                case OPCODE_EXT_U8_TO_U16:
+                case OPCODE_EXT_U8_TO_U32:
+                case OPCODE_EXT_U8_TO_U64:
+                case OPCODE_EXT_U16_TO_U32:
+                case OPCODE_EXT_U16_TO_U64:
+                case OPCODE_EXT_U32_TO_U64:
+                case OPCODE_EXT_I8_TO_I16:
+                case OPCODE_EXT_I8_TO_I32:
+                case OPCODE_EXT_I8_TO_I64:
+                case OPCODE_EXT_I16_TO_I32:
+                case OPCODE_EXT_I16_TO_I64:
+                case OPCODE_EXT_I32_TO_I64:
+                case OPCODE_EXT_I32_TO_F32:
+                case OPCODE_EXT_I32_TO_F64:
+                case OPCODE_EXT_U32_TO_F64:
+                case OPCODE_EXT_I64_TO_F64:
+                case OPCODE_EXT_F32_TO_I32:
+                case OPCODE_EXT_F64_TO_I32:
+                case OPCODE_EXT_F64_TO_I64:
+                case OPCODE_EXT_F32_TO_F64:
+                case OPCODE_EXT_F64_TO_F32: {
+                    break;
+                }
+
+                case OPCODE_EXT_ARR_FILL:
+                case OPCODE_EXT_ARR_FIND:
+                case OPCODE_EXT_ARR_PUSH: {
+                    size += sizeof(u8);
+                    break;
+                }
+
+                case OPCODE_EXT_STORE_KEEP_8:
+                case OPCODE_EXT_STORE_KEEP_16:
+                case OPCODE_EXT_STORE_KEEP_32:
+                case OPCODE_EXT_STORE_KEEP_64: {
+                    size += sizeof(u16);
+                    break;
+                }
+
+                case OPCODE_EXT_STR_NEW_LOCAL: {
+                    if (remaining < sizeof(byte) * 2 + sizeof(u16) + sizeof(u32)) {
+                        return false;
+                    }
+
+                    size += sizeof(u16) + sizeof(u32) + BYTECODE_OPTIMIZER_READ(u32, bytecode, sizeof(byte) * 2 + sizeof(u16));
+                    break;
+                }
+
+                case OPCODE_EXT_TAIL_CALL: { // linked after parsing like @OPCODE_CALL
+                    size += sizeof(u32);
+                    break;
+                }
+
+                default: {
+                    return false;
+                }
+            }
+
+            break;
+        }
+
+        default: { // the operations without parameters, the others (e.g. dynamic jumps) cannot be decoded
+            if (opcode < OPCODE_SHIFT_L_8 || opcode > OPCODE_F64_GE) {
+                return false;
+            }
+
+            break;
+        }
+    }
+
+    if (size > remaining) {
+        return false;
+    }
+
+    *out_size = size;
+    *out_target_count = target_count;
+    return true;
+}
+
+static u32 bytecode_optimizer_get_target_position(const byte* bytecode, const wave_bytecode_instruction* instruction, u32 index) { // the position in the bytecode where the branch offset @index of @instruction is stored
+    switch (bytecode[instruction->offset]) {
+        case OPCODE_TABLESWITCH: {
+            return instruction->offset + sizeof(byte) + sizeof(u16) + sizeof(u16) * index;
+        }
+
+        case OPCODE_LOOKUPSWITCH: {
+            u32 value_size = 1u << (BYTECODE_OPTIMIZER_READ(u16, bytecode, instruction->offset + sizeof(byte)) >> (U16_BIT_COUNT - 2));
+            return instruction->offset + sizeof(byte) + sizeof(u16) + (value_size + sizeof(u16)) * index + value_size;
+        }
+
+        default: {
+            return instruction->offset + sizeof(byte);
+        }
+    }
+}
+
+static u32 bytecode_optimizer_find(const wave_bytecode_optimizer* optimizer, u32 offset) { // the instruction containing @offset, @instruction_count if it lies behind the last one
+    if (optimizer->instruction_count == 0 || offset >= optimizer->bytecode_size) {
+        return optimizer->instruction_count;
+    }
+
+    u32 low = 0;
+    u32 high = optimizer->instruction_count - 1;
+    while (low < high) {
+        u32 middle = low + (high - low + 1) / 2;
+        if (optimizer->instructions[middle].offset <= offset) {
+            low = middle;
+        } else {
+            high = middle - 1;
+        }
+    }
+
+    return low;
+}
+
+static error_code bytecode_optimizer_decode(wave_bytecode_optimizer* optimizer, const byte* bytecode, u32 size, bool* out_decoded) {
+    const wave_memory_reallocation_function reallocate_memory = optimizer->reallocate_memory;
+
+    optimizer->instruction_count = 0;
+    optimizer->target_count = 0;
+    *out_decoded = false;
+
+    for (u32 offset = 0; offset < size;) {
+        u32 instruction_size = 0;
+        u32 target_count = 0;
+        if (!bytecode_optimizer_get_size(bytecode + offset, size - offset, &instruction_size, &target_count)) {
+            optimizer->instruction_count = 0;
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+
+        BYTECODE_OPTIMIZER_RESERVE(optimizer->instructions, optimizer->instruction_capacity, optimizer->instruction_count + 1, 64);
+        BYTECODE_OPTIMIZER_RESERVE(optimizer->targets, optimizer->target_capacity, optimizer->target_count + target_count, 16);
+
+        wave_bytecode_instruction* instruction = &optimizer->instructions[optimizer->instruction_count++];
+        *instruction = (wave_bytecode_instruction) {
+            .offset = offset,
+            .new_offset = offset,
+            .size = instruction_size,
+            .removed = false,
+            .first_target = optimizer->target_count,
+            .target_count = (u16) target_count
+        };
+
+        // the targets are kept as positions until every instruction is known
+
+        for (u32 i = 0; i < target_count; i++) {
+            u32 position = bytecode_optimizer_get_target_position(bytecode, instruction, i);
+
+            i64 target = 0;
+            if (bytecode[offset] == OPCODE_CJUMP) {
+                target = (i64) offset + instruction_size + BYTECODE_OPTIMIZER_READ(i32, bytecode, position);
+            } else if (BYTECODE_OPTIMIZER_IS_CONDITIONAL_JUMP(bytecode[offset])) {
+                target = (i64) offset + instruction_size + BYTECODE_OPTIMIZER_READ(i16, bytecode, position);
+            } else {
+                target = (i64) offset + instruction_size + BYTECODE_OPTIMIZER_READ(u16, bytecode, position);
+            }
+
+            if (target < 0 || target > size) { // jumps that leave the bytecode cannot be relocated
+                optimizer->instruction_count = 0;
+                return ERROR_CODE_EXECUTION_SUCCESSFUL;
+            }
+
+            optimizer->targets[optimizer->target_count++] = (u32) target;
+        }
+
+        offset += instruction_size;
+    }
+
+    // the branch-target map, every branch has to land on an instruction
+
+    BYTECODE_OPTIMIZER_RESERVE(optimizer->label_counts, optimizer->label_capacity, optimizer->instruction_count + 1, 64);
+    memory_set_32(optimizer->label_counts, 0, optimizer->instruction_count + 1);
+
+    for (u32 i = 0; i < optimizer->target_count; i++) {
+        u32 target = bytecode_optimizer_find(optimizer, optimizer->targets[i]);
+        if (target != optimizer->instruction_count && optimizer->instructions[target].offset != optimizer->targets[i]) {
+            optimizer->instruction_count = 0;
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+
+        optimizer->targets[i] = target;
+        optimizer->label_counts[target]++;
+    }
+
+    *out_decoded = true;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// rewriting
+
+static u32 bytecode_optimizer_next(const wave_bytecode_optimizer* optimizer, u32 index) { // the next kept instruction behind @index, @instruction_count at the end
+    index++;
+    while (index < optimizer->instruction_count && optimizer->instructions[index].removed) {
+        index++;
+    }
+
+    return index;
+}
+
+static u32 bytecode_optimizer_get_offset(const wave_bytecode_optimizer* optimizer, u32 index) {
+    return index < optimizer->instruction_count ? optimizer->instructions[index].offset : optimizer->bytecode_size;
+}
+
+static void bytecode_optimizer_clear_targets(wave_bytecode_optimizer* optimizer, u32 index) {
+    wave_bytecode_instruction* instruction = &optimizer->instructions[index];
+    for (u32 i = 0; i < instruction->target_count; i++) {
+        optimizer->label_counts[optimizer->targets[instruction->first_target + i]]--;
+    }
+
+    instruction->target_count = 0;
+}
+
+static void bytecode_optimizer_remove(wave_bytecode_optimizer* optimizer, u32 index) { // the branches landing on the instruction land on the next kept one instead
+    bytecode_optimizer_clear_targets(optimizer, index);
+
+    optimizer->instructions[index].removed = true;
+    optimizer->instructions_removed++;
+
+    if (optimizer->label_counts[index] == 0) {
+        return;
+    }
+
+    u32 next = bytecode_optimizer_next(optimizer, index);
+    for (u32 i = 0; i < optimizer->instruction_count; i++) {
+        const wave_bytecode_instruction* instruction = &optimizer->instructions[i];
+        for (u32 j = 0; j < instruction->target_count; j++) {
+            if (optimizer->targets[instruction->first_target + j] == index) {
+                optimizer->targets[instruction->first_target + j] = next;
+            }
+        }
+    }
+
+    optimizer->label_counts[next] += optimizer->label_counts[index];
+    optimizer->label_counts[index] = 0;
+}
+
+static bool bytecode_optimizer_thread_jumps(wave_bytecode_optimizer* optimizer, const byte* bytecode, u32 index) { // lets the branches of @index jump to where the jumps they land on go
+    const wave_bytecode_instruction* instruction = &optimizer->instructions[index];
+    const wave_opcode opcode = bytecode[instruction->offset];
+
+    u32 end = instruction->offset + instruction->size;
+
+    bool changed = false;
+    for (u32 i = 0; i < instruction->target_count; i++) {
+        u32* target = &optimizer->targets[instruction->first_target + i];
+
+        for (u32 hops = 0; hops < optimizer->instruction_count && *target < optimizer->instruction_count; hops++) {
+            const wave_bytecode_instruction* jump = &optimizer->instructions[*target];
+            if (bytecode[jump->offset] != OPCODE_CJUMP || jump->target_count == 0) {
+                break;
+            }
+
+            u32 next_target = optimizer->targets[jump->first_target];
+            if (next_target == *target) {
+                break;
+            }
+
+            // instructions are only removed, so the distance to the target only shrinks and fits once it fits now
+
+            i64 distance = (i64) bytecode_optimizer_get_offset(optimizer, next_target) - (i64) end;
+            if (BYTECODE_OPTIMIZER_IS_CONDITIONAL_JUMP(opcode) && (distance < I16_MIN || distance > I16_MAX)) {
+                break;
+            } else if ((opcode == OPCODE_TABLESWITCH || opcode == OPCODE_LOOKUPSWITCH) && (distance < 0 || distance > U16_MAX)) {
+                break;
+            }
+
+            optimizer->label_counts[*target]--;
+            optimizer->label_counts[next_target]++;
+            *target = next_target;
+
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+static bool bytecode_optimizer_rewrite(wave_bytecode_optimizer* optimizer, byte* bytecode, u32 index) { // rewrites the sequence starting at @index, returns whether it changed
+    wave_bytecode_instruction* instruction = &optimizer->instructions[index];
+    const wave_opcode opcode = bytecode[instruction->offset];
+
+    bool changed = instruction->target_count > 0 && bytecode_optimizer_thread_jumps(optimizer, bytecode, index);
+
+    // the sequences do not extend across labels, the second instruction must only be reachable through the first one
+
+    u32 next = bytecode_optimizer_next(optimizer, index);
+    if (opcode == OPCODE_NOP) {
+        bytecode_optimizer_remove(optimizer, index);
+        return true;
+    } else if (next == optimizer->instruction_count) {
+        return changed;
+    }
+
+    wave_bytecode_instruction* next_instruction = &optimizer->instructions[next];
+    const wave_opcode next_opcode = bytecode[next_instruction->offset];
+    const bool next_label = optimizer->label_counts[next] > 0;
+
+    if (BYTECODE_OPTIMIZER_IS_FAMILY(opcode, OPCODE_PUSH_8) && !next_label) {
+        const u32 width = opcode - OPCODE_PUSH_8;
+
+        u64 value = 0;
+        switch (opcode) {
+            case OPCODE_PUSH_8:  { value = BYTECODE_OPTIMIZER_READ(u8,  bytecode, instruction->offset + sizeof(byte)); break; }
+            case OPCODE_PUSH_16: { value = BYTECODE_OPTIMIZER_READ(u16, bytecode, instruction->offset + sizeof(byte)); break; }
+            case OPCODE_PUSH_32: { value = BYTECODE_OPTIMIZER_READ(u32, bytecode, instruction->offset + sizeof(byte)); break; }
+            case OPCODE_PUSH_64: { value = BYTECODE_OPTIMIZER_READ(u64, bytecode, instruction->offset + sizeof(byte)); break; }
+
+            default: {
+                break;
+            }
+        }
+
+        // PUSH_x; POP_x -> nothing
+
+        if (next_opcode == OPCODE_POP_8 + width) {
+            bytecode_optimizer_remove(optimizer, index);
+            bytecode_optimizer_remove(optimizer, next);
+            return true;
+        }
+
+        // PUSH_x 1; x_ADD -> x_INC
+
+        if (value == 1) {
+            wave_opcode replacement = OPCODE_NOP;
+            if (next_opcode == OPCODE_U8_ADD + width) {
+                replacement = OPCODE_U8_INC + width;
+            } else if (next_opcode == OPCODE_I8_ADD + width) {
+                replacement = OPCODE_I8_INC + width;
+            } else if (next_opcode == OPCODE_U8_SUB + width) {
+                replacement = OPCODE_U8_DEC + width;
+            } else if (next_opcode == OPCODE_I8_SUB + width) {
+                replacement = OPCODE_I8_DEC + width;
+            }
+
+            if (replacement != OPCODE_NOP) {
+                bytecode[next_instruction->offset] = replacement;
+                bytecode_optimizer_remove(optimizer, index);
+                return true;
+            }
+        }
+    }
+
+    // STORE_x n; LOAD_x n -> STORE_KEEP_x n, written over both instructions, as the extended form is one byte longer than the store
+
+    if (BYTECODE_OPTIMIZER_IS_FAMILY(opcode, OPCODE_STORE_8) && !next_label && next_opcode == OPCODE_LOAD_8 + (opcode - OPCODE_STORE_8)) {
+        u16 variable_offset = BYTECODE_OPTIMIZER_READ(u16, bytecode, instruction->offset + sizeof(byte));
+        if (variable_offset == BYTECODE_OPTIMIZER_READ(u16, bytecode, next_instruction->offset + sizeof(byte))) {
+            bytecode[instruction->offset + 0] = OPCODE_EXT;
+            bytecode[instruction->offset + 1] = OPCODE_EXT_STORE_KEEP_8 + (opcode - OPCODE_STORE_8);
+            BYTECODE_OPTIMIZER_READ(u16, bytecode, instruction->offset + sizeof(byte) * 2) = variable_offset;
+
+            instruction->size = sizeof(byte) * 2 + sizeof(u16);
+            bytecode_optimizer_remove(optimizer, next);
+            return true;
+        }
+    }
+
+    // NOT_x; CJUMP_x_IF_0 -> CJUMP_x_IF_1, the condition left on the stack is popped right behind the jump
+
+    if (BYTECODE_OPTIMIZER_IS_FAMILY(opcode, OPCODE_NOT_8) && !next_label && BYTECODE_OPTIMIZER_IS_CONDITIONAL_JUMP(next_opcode) && (u32) (next_opcode - OPCODE_CJUMP_8_IF_0) / 2 == (u32) (opcode - OPCODE_NOT_8)) {
+        u32 pop = bytecode_optimizer_next(optimizer, next);
+        if (pop < optimizer->instruction_count && bytecode[optimizer->instructions[pop].offset] == OPCODE_POP_8 + (opcode - OPCODE_NOT_8)) {
+            bytecode[next_instruction->offset] = OPCODE_CJUMP_8_IF_0 + ((next_opcode - OPCODE_CJUMP_8_IF_0) ^ 1);
+            bytecode_optimizer_remove(optimizer, index);
+            return true;
+        }
+    }
+
+    if (opcode == OPCODE_CJUMP && instruction->target_count > 0) {
+        u32 target = optimizer->targets[instruction->first_target];
+
+        // jumps to the next instruction
+
+        if (target == next) {
+            bytecode_optimizer_remove(optimizer, index);
+            return true;
+        }
+
+        // jumps to a return are the return
+
+        if (target < optimizer->instruction_count && (bytecode[optimizer->instructions[target].offset] == OPCODE_RETURN || bytecode[optimizer->instructions[target].offset] == OPCODE_END)) {
+            const wave_bytecode_instruction* return_instruction = &optimizer->instructions[target];
+
+            bytecode_optimizer_clear_targets(optimizer, index);
+            for (u32 i = 0; i < return_instruction->size; i++) { // the return is never larger than the jump
+                bytecode[instruction->offset + i] = bytecode[return_instruction->offset + i];
+            }
+
+            instruction->size = return_instruction->size;
+            return true;
+        }
+    }
+
+    // the instructions behind an unconditional jump are unreachable up to the next label
+
+    if (opcode == OPCODE_CJUMP || opcode == OPCODE_RETURN || opcode == OPCODE_END || (opcode == OPCODE_EXT && bytecode[instruction->offset + 1] == OPCODE_EXT_TAIL_CALL)) {
+        while (next < optimizer->instruction_count && optimizer->label_counts[next] == 0) {
+            bytecode_optimizer_remove(optimizer, next);
+            next = bytecode_optimizer_next(optimizer, next);
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+error_code wave_bytecode_optimizer_new(wave_bytecode_optimizer* optimizer, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
+    *optimizer = (wave_bytecode_optimizer) {
+        .allocate_memory = allocate_memory,
+        .reallocate_memory = reallocate_memory,
+        .deallocate_memory = deallocate_memory,
+
+        .instructions = NULL,
+        .instruction_capacity = 0,
+        .instruction_count = 0,
+
+        .targets = NULL,
+        .target_capacity = 0,
+        .target_count = 0,
+
+        .label_counts = NULL,
+        .label_capacity = 0,
+
+        .bytecode_size = 0,
+        .instructions_removed = 0,
+        .bytes_saved = 0
+    };
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_bytecode_optimizer_destroy(wave_bytecode_optimizer* optimizer) {
+    const wave_memory_deallocation_function deallocate_memory = optimizer->deallocate_memory;
+
+    #define BYTECODE_OPTIMIZER_DEALLOCATE(pointer) do { if ((pointer) != NULL) { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) (pointer)); (pointer) = NULL; } } while (0)
+
+    BYTECODE_OPTIMIZER_DEALLOCATE(optimizer->instructions);
+    BYTECODE_OPTIMIZER_DEALLOCATE(optimizer->targets);
+    BYTECODE_OPTIMIZER_DEALLOCATE(optimizer->label_counts);
+
+    #undef BYTECODE_OPTIMIZER_DEALLOCATE
+
+    optimizer->instruction_capacity = 0;
+    optimizer->instruction_count = 0;
+    optimizer->target_capacity = 0;
+    optimizer->target_count = 0;
+    optimizer->label_capacity = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_bytecode_optimizer_optimize(wave_bytecode_optimizer* optimizer, byte* bytecode, u32* size) {
+    optimizer->bytecode_size = *size;
+    optimizer->instructions_removed = 0;
+    optimizer->bytes_saved = 0;
+
+    bool decoded = false;
+    RUN_ERROR_CODE_FUNCTION(bytecode_optimizer_decode, optimizer, bytecode, *size, &decoded);
+    if (!decoded) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    // rewrite until no sequence changes, a rewritten sequence may form a new one with the instruction in front of it
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (u32 i = 0; i < optimizer->instruction_count; i++) {
+            if (!optimizer->instructions[i].removed) {
+                changed = bytecode_optimizer_rewrite(optimizer, bytecode, i) || changed;
+            }
+        }
+    }
+
+    // move the kept instructions together, which only ever moves them towards the start
+
+    u32 new_size = 0;
+    for (u32 i = 0; i < optimizer->instruction_count; i++) {
+        wave_bytecode_instruction* instruction = &optimizer->instructions[i];
+
+        instruction->new_offset = new_size;
+        if (instruction->removed) {
+            continue;
+        }
+
+        if (instruction->new_offset != instruction->offset) {
+            memory_copy(bytecode + instruction->offset, bytecode + instruction->new_offset, instruction->size);
+        }
+
+        new_size += instruction->size;
+    }
+
+    // encode the branch offsets again
+
+    for (u32 i = 0; i < optimizer->instruction_count; i++) {
+        const wave_bytecode_instruction* instruction = &optimizer->instructions[i];
+        if (instruction->removed || instruction->target_count == 0) {
+            continue;
+        }
+
+        const wave_bytecode_instruction moved_instruction = (wave_bytecode_instruction) { .offset = instruction->new_offset };
+        const wave_opcode opcode = bytecode[instruction->new_offset];
+
+        i64 end = instruction->new_offset + instruction->size;
+        for (u32 j = 0; j < instruction->target_count; j++) {
+            u32 target = optimizer->targets[instruction->first_target + j];
+            i64 offset = (i64) (target < optimizer->instruction_count ? optimizer->instructions[target].new_offset : new_size) - end;
+
+            u32 position = bytecode_optimizer_get_target_position(bytecode, &moved_instruction, j);
+            if (opcode == OPCODE_CJUMP) {
+                BYTECODE_OPTIMIZER_READ(i32, bytecode, position) = (i32) offset;
+            } else if (BYTECODE_OPTIMIZER_IS_CONDITIONAL_JUMP(opcode)) {
+                BYTECODE_OPTIMIZER_READ(i16, bytecode, position) = (i16) offset;
+            } else {
+                BYTECODE_OPTIMIZER_READ(u16, bytecode, position) = (u16) offset;
+            }
+        }
+    }
+
+    optimizer->bytes_saved = *size - new_size;
+    *size = new_size;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+u32 wave_bytecode_optimizer_relocate(const wave_bytecode_optimizer* optimizer, u32 offset) {
+    u32 index = bytecode_optimizer_find(optimizer, offset);
+    if (index == optimizer->instruction_count) {
+        return offset - optimizer->bytes_saved;
+    }
+
+    const wave_bytecode_instruction* instruction = &optimizer->instructions[index];
+    return instruction->removed ? U32_MAX : instruction->new_offset + (offset - instruction->offset);
+}
+
+error_code wave_bytecode_optimizer_dump(const wave_bytecode_optimizer* optimizer, cstr name, u32 name_length, wave_compiler_message_function print_function) {
+    const wave_memory_allocation_function allocate_memory = optimizer->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = optimizer->deallocate_memory;
+
+    #define BYTECODE_OPTIMIZER_FORMAT "bytecode of %*s after peephole: %u32 of %u32 bytes saved, %u32 instructions removed\n"
+
+    cstr entrypoint_name = "entrypoint";
+    str_format_data variables[] = {
+        (str_format_data) 0,
+        name != NULL ? name_length : (u32) (STRING_LENGTH("entrypoint") - 1),
+        (str_format_data) (name != NULL ? name : entrypoint_name),
+        optimizer->bytes_saved,
+        optimizer->bytecode_size,
+        optimizer->instructions_removed
+    };
+
+    u32 length = 0;
+    str_format("%n" BYTECODE_OPTIMIZER_FORMAT, variables, NULL, &length);
+
+    str message = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &message, sizeof(char) * (length + 1));
+    str_format("%n" BYTECODE_OPTIMIZER_FORMAT, variables, message, &length);
+
+    #undef BYTECODE_OPTIMIZER_FORMAT
+
+    error_code print_result = print_function(COMPILER_MESSAGE_TYPE_INFO, message, length);
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) message);
+
+    return print_result;
+}
+
+#undef BYTECODE_OPTIMIZER_RESERVE
+#undef BYTECODE_OPTIMIZER_READ
+
+#undef BYTECODE_OPTIMIZER_IS_FAMILY
+#undef BYTECODE_OPTIMIZER_IS_CONDITIONAL_JUMP
@@ -0,0 +1,70 @@
+#ifndef WAVE_LANGUAGE_BYTECODE_OPTIMIZER
+#define WAVE_LANGUAGE_BYTECODE_OPTIMIZER
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "language/wave_common.h"
+
+#include "language/compiler/compiler.h"
+
+/* Peephole Optimizer
+*
+* Rewrites short instruction sequences of emitted bytecode in place, e.g. a push that is popped right away,
+* a store followed by a load of the same variable, a negated condition of a conditional jump, or jumps to jumps.
+* The bytecode is decoded into instructions first, every branch offset is resolved to the instruction it lands on,
+* which is a label that no rewritten sequence may extend across. Instructions are only ever removed or shortened,
+* so once the remaining ones are moved together, the branch offsets are encoded again and still fit.
+*
+* Bytecode that cannot be decoded (e.g. dynamic jumps) is left as it is.
+* */
+
+// Typedefs
+
+typedef struct {
+    u32 offset; // the position in the bytecode passed to @wave_bytecode_optimizer_optimize
+    u32 new_offset; // the position once the removed instructions are left out, the one of the next kept instruction if removed
+
+    u32 size; // rewritten instructions are only ever shortened
+    bool removed;
+
+    u32 first_target; // the index into @wave_bytecode_optimizer.targets
+    u16 target_count; // the amount of branch offsets of the instruction
+} wave_bytecode_instruction;
+
+typedef struct {
+    wave_memory_allocation_function allocate_memory;
+    wave_memory_reallocation_function reallocate_memory;
+    wave_memory_deallocation_function deallocate_memory;
+
+    wave_bytecode_instruction* instructions;
+    u32 instruction_capacity;
+    u32 instruction_count;
+
+    u32* targets; // the instruction every branch offset lands on, @instruction_count for the end of the bytecode
+    u32 target_capacity;
+    u32 target_count;
+
+    u32* label_counts; // the amount of branch offsets landing on every instruction, one more for the end of the bytecode
+    u32 label_capacity;
+
+    // statistics of the last optimized bytecode
+
+    u32 bytecode_size; // the size before it was optimized
+    u32 instructions_removed;
+    u32 bytes_saved;
+} wave_bytecode_optimizer;
+
+// Functions
+
+error_code wave_bytecode_optimizer_new(wave_bytecode_optimizer* optimizer, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
+error_code wave_bytecode_optimizer_destroy(wave_bytecode_optimizer* optimizer);
+
+error_code wave_bytecode_optimizer_optimize(wave_bytecode_optimizer* optimizer, byte* bytecode, u32* size); // optimizes the instructions of a function body in place and updates @size, branch offsets must not leave @bytecode
+u32 wave_bytecode_optimizer_relocate(const wave_bytecode_optimizer* optimizer, u32 offset); // the position of @offset in the optimized bytecode, U32_MAX if the instruction containing it was removed
+
+error_code wave_bytecode_optimizer_dump(const wave_bytecode_optimizer* optimizer, cstr name, u32 name_length, wave_compiler_message_function print_function); // prints the statistics of the last optimized bytecode, @name is NULL for the entrypoint
+
+#endif
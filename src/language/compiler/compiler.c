@@ -1,90 +1,200 @@
 #include "compiler.h"
 
+#include <stdatomic.h>
+
+#include "platform.h"
+
 #include "common/constants.h"
+#include "common/defines.h"
 #include "common/error_codes.h"
 #include "common/debug.h"
 
+#include "common/data/string/hash.h"
 #include "common/data/string/string.h"
 
+#include "common/memory/memory.h"
+
+#include "language/compiler/data/wave_arena.h"
 #include "language/compiler/data/wave_compiler_common.h"
 #include "language/compiler/parser.h"
 #include "language/compiler/tokenizer.h"
 
 #include "language/runtime/wave_vm.h"
 
+// Defines
+
+#define COMPILER_IMAGE_MAGIC (0x43425657) /* "WVBC" */
+#define COMPILER_IMAGE_VERSION (7) /* increment whenever the bytecode produced for the same source changes */
+
+#define COMPILER_IMAGE_FILE_EXTENSION ".wbc"
+#define COMPILER_IMAGE_TEMPORARY_FILE_EXTENSION ".tmp"
+
 // Typedefs
 
 typedef struct {
-    compiler_message_type type;
-    u32 message_length;
-    str message;
-} compiler_error;
+    u32 magic;
+    u32 version;
 
-// compilation interface
+    u64 key; // the hash of the source, the compiler version and the native functions (see @compiler_image_get_key)
+    u64 function_hash;
+    u32 source_length;
 
-struct {
-    wave_vm* vm;
+    u32 bytecode_size; // followed by the bytecode
+} compiler_image_header; // the header of a bytecode image stored by @wave_compile_bytecode_cached
 
-    // error handling
+// compilation interface
 
-    u32 error_count;
-    u32 error_capacity;
-    compiler_error* errors;
-} compiler;
+static _Thread_local compiler_error_list* compiler_errors; // the error list of the calling thread (see @compiler_set_error_list)
+static wave_compiler_message_function compiler_ir_dump_function; // shared by all threads, see @wave_compiler_set_ir_dump_function
+static wave_profile* compiler_profile; // only read by the threads compiling function bodies, see @wave_compiler_set_profile
 
 // Functions
 
+compiler_error_list* compiler_set_error_list(compiler_error_list* list) {
+    compiler_error_list* previous_list = compiler_errors;
+    compiler_errors = list;
+
+    return previous_list;
+}
+
 void compiler_raise_error(compiler_message_type type, str message, u32 message_length) {
-    if (compiler.error_count + 1 >= compiler.error_capacity) {
-        compiler.error_capacity += 8;
-        if (compiler.vm->reallocate_memory((void**) &(compiler.errors), sizeof(compiler_error) * compiler.error_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+    compiler_error_list* list = compiler_errors;
+
+    if (list->error_count + 1 >= list->error_capacity) {
+        list->error_capacity = list->error_capacity == 0 ? 8 : list->error_capacity * 2;
+
+        error_code result = list->errors == NULL
+            ? list->vm->allocate_memory((void**) &(list->errors), sizeof(compiler_error) * list->error_capacity)
+            : list->vm->reallocate_memory((void**) &(list->errors), sizeof(compiler_error) * list->error_capacity);
+
+        if (result != ERROR_CODE_EXECUTION_SUCCESSFUL) {
             return; // don't try to throw another error, it probably won't work
         }
     }
 
-    compiler.errors[compiler.error_count] = (compiler_error) { .type = type, .message_length = message_length, .message = message };
-    compiler.error_count++;
+    list->errors[list->error_count] = (compiler_error) { .type = type, .message_length = message_length, .message = message };
+    list->error_count++;
 }
 
 bool compiler_has_error(void) {
-    return compiler.error_count > 0;
+    return compiler_errors->error_count > 0;
+}
+
+error_code compiler_move_errors(compiler_error_list* source) {
+    const wave_memory_deallocation_function deallocate_memory = source->vm->deallocate_memory;
+
+    for (u32 i = 0; i < source->error_count; i++) {
+        compiler_raise_error(source->errors[i].type, source->errors[i].message, source->errors[i].message_length);
+    }
+
+    if (source->errors != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) source->errors);
+    }
+
+    source->errors = NULL;
+    source->error_count = 0;
+    source->error_capacity = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+void wave_compiler_set_ir_dump_function(wave_compiler_message_function dump_function) {
+    compiler_ir_dump_function = dump_function;
+}
+
+wave_compiler_message_function wave_compiler_get_ir_dump_function(void) {
+    return compiler_ir_dump_function;
+}
+
+void wave_compiler_set_profile(wave_profile* profile) {
+    compiler_profile = profile;
+}
+
+wave_profile* wave_compiler_get_profile(void) {
+    return compiler_profile;
 }
 
 error_code wave_compile_bytecode(wave_vm* vm, str source, wave_compiler_message_function message_function) {
+    return wave_compile_bytecode_incremental(vm, source, NULL, message_function);
+}
+
+error_code wave_compile_bytecode_incremental(wave_vm* vm, str source, wave_compile_cache* cache, wave_compiler_message_function message_function) {
     const wave_memory_allocation_function allocate_memory = vm->allocate_memory;
     const wave_memory_deallocation_function deallocate_memory = vm->deallocate_memory;
 
     error_code result = ERROR_CODE_EXECUTION_SUCCESSFUL;
 
-    #define PRINT_STRING(type, string) do { if (message_function != NULL) { RUN_ERROR_CODE_FUNCTION_TRACELESS(message_function, type, string "\n", STRING_LENGTH(string) + 1); } } while (0)
+    // once the arena and the error list are set, failures jump to the cleanup, which restores them and frees the arena
+
+    #define RUN_COMPILER_FUNCTION(function_name, ...)                                       \
+        do {                                                                                \
+            error_code function_result = function_name(__VA_ARGS__);                        \
+            if (function_result != ERROR_CODE_EXECUTION_SUCCESSFUL) {                       \
+                result = function_result;                                                   \
+                goto wave_compile_bytecode_cleanup;                                         \
+            }                                                                               \
+        } while (0)
+
+    #define RUN_COMPILER_CLEANUP_FUNCTION(function_name, ...)                               \
+        do {                                                                                \
+            error_code function_result = function_name(__VA_ARGS__);                        \
+            if (function_result != ERROR_CODE_EXECUTION_SUCCESSFUL && result == ERROR_CODE_EXECUTION_SUCCESSFUL) { \
+                result = function_result; /* keep cleaning up, the first error is returned */ \
+            }                                                                               \
+        } while (0)
 
-    // initialize compiler
+    #define PRINT_STRING(type, string) do { if (message_function != NULL) { RUN_COMPILER_FUNCTION(message_function, type, string "\n", STRING_LENGTH(string) + 1); } } while (0)
 
-    compiler.errors = NULL;
-    compiler.error_capacity = 8;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &compiler.errors, sizeof(compiler_error) * compiler.error_capacity);
-    compiler.error_count = 0;
+    // initialize compiler, its temporaries are allocated from an arena that is freed at once after the compilation
 
-    // tokenize source
+    wave_arena arena;
+    RUN_ERROR_CODE_FUNCTION(wave_arena_new, &arena, COMPILER_ARENA_CHUNK_SIZE, allocate_memory, deallocate_memory);
+    wave_arena* previous_arena = wave_arena_set_current(&arena);
 
-    parse_token* token_stack_start = NULL;
-    parse_token* token_stack_end = NULL;
-    byte* data_stack_start = NULL;
-    byte* data_stack_end = NULL;
-    if (wave_compiler_tokenize(vm, source, &token_stack_start, &token_stack_end, &data_stack_start, &data_stack_end) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+    wave_vm compiler_vm = *vm;
+    compiler_vm.allocate_memory = wave_arena_current_allocate;
+    compiler_vm.allocate_zero_memory = wave_arena_current_allocate_zero;
+    compiler_vm.reallocate_memory = wave_arena_current_reallocate;
+    compiler_vm.deallocate_memory = wave_arena_current_deallocate;
+
+    compiler_vm.bytecode_start = NULL; // set by the parser
+    compiler_vm.bytecode_end = NULL;
+
+    bool tokenizer_started = false; // the tokenizer is only destroyed once it has been started
+
+    compiler_error_list errors = (compiler_error_list) { .vm = &compiler_vm, .errors = NULL, .error_count = 0, .error_capacity = 8 };
+    compiler_error_list* previous_errors = compiler_set_error_list(&errors);
+    RUN_COMPILER_FUNCTION(wave_arena_current_allocate, (void**) &errors.errors, sizeof(compiler_error) * errors.error_capacity);
+
+    // tokenize source, the compile cache and the parallel compilation of function bodies require the whole token stream
+
+    wave_token_stream tokens;
+    tokenizer_started = true;
+
+    #if PROGRAM_FEATURE_WAVE_STREAMING_COMPILER != 0 && COMPILER_PARALLEL_BODIES == 0
+    error_code tokenize_result = cache == NULL ? wave_compiler_tokenizer_begin_stream(&compiler_vm, source, &tokens) : wave_compiler_tokenize(&compiler_vm, source, &tokens);
+    #else
+    error_code tokenize_result = wave_compiler_tokenize(&compiler_vm, source, &tokens);
+    #endif
+
+    if (tokenize_result != ERROR_CODE_EXECUTION_SUCCESSFUL) {
         PRINT_STRING(COMPILER_MESSAGE_TYPE_ERROR, "failed to tokenize source, attempting to deallocate temporary memory...");
-        RUN_ERROR_CODE_FUNCTION(wave_compiler_tokenizer_destroy);
+        RUN_COMPILER_FUNCTION(wave_compiler_tokenizer_destroy);
         PRINT_STRING(COMPILER_MESSAGE_TYPE_ERROR, "temporary memory deallocated");
 
         result = ERROR_CODE_EXECUTION_FAILED;
         goto wave_compile_bytecode_print_errors;
     }
 
-    // parse and compile tokens
+    // parse and compile tokens, the sites of an earlier compilation do not match the new bytecode
+
+    if (compiler_profile != NULL) {
+        wave_profile_clear_sites(compiler_profile);
+    }
 
-    if (wave_compiler_parser_compile(vm, token_stack_start, token_stack_end, data_stack_start, data_stack_end) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+    if (wave_compiler_parser_compile(&compiler_vm, &tokens, cache) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
         PRINT_STRING(COMPILER_MESSAGE_TYPE_ERROR, "failed to parse and compile source, attempting to deallocate temporary memory...");
-        RUN_ERROR_CODE_FUNCTION(wave_compiler_parser_destroy);
+        RUN_COMPILER_FUNCTION(wave_compiler_parser_destroy);
         PRINT_STRING(COMPILER_MESSAGE_TYPE_ERROR, "temporary memory deallocated");
 
         result = ERROR_CODE_EXECUTION_FAILED;
@@ -96,30 +206,238 @@ error_code wave_compile_bytecode(wave_vm* vm, str source, wave_compiler_message_
     wave_compile_bytecode_print_errors: {}
 
     if (message_function != NULL && compiler_has_error()) {
-        for (u32 i = 0; i < compiler.error_count; i++) {
-            if (compiler.errors[i].message != NULL) {
-                RUN_ERROR_CODE_FUNCTION_TRACELESS(message_function, compiler.errors[i].type, compiler.errors[i].message, compiler.errors[i].message_length);
+        for (u32 i = 0; i < errors.error_count; i++) {
+            if (errors.errors[i].message != NULL) {
+                RUN_COMPILER_FUNCTION(message_function, errors.errors[i].type, errors.errors[i].message, errors.errors[i].message_length);
             }
         }
     }
 
+    // output result, the bytecode of a failed compilation is kept as well for disassembling it
+
+    if (compiler_vm.bytecode_start != NULL && compiler_vm.bytecode_end != NULL) {
+        u32 bytecode_size = compiler_vm.bytecode_end - compiler_vm.bytecode_start;
+
+        vm->bytecode_start = NULL;
+        RUN_COMPILER_FUNCTION(allocate_memory, (void**) &(vm->bytecode_start), sizeof(byte) * bytecode_size);
+        memory_copy(compiler_vm.bytecode_start, vm->bytecode_start, bytecode_size);
+
+        vm->bytecode_end = vm->bytecode_start + bytecode_size;
+    }
+
+    vm->bytecode_current = vm->bytecode_start;
+
+    // deallocate temporary memory, destroying the tokenizer only clears its state as the arena frees the memory
+
+    wave_compile_bytecode_cleanup: {}
+
+    if (tokenizer_started) {
+        RUN_COMPILER_CLEANUP_FUNCTION(wave_compiler_tokenizer_destroy);
+    }
+
+    for (u32 i = 0; i < errors.error_count; i++) {
+        if (errors.errors[i].message != NULL) { // allocated by @COMPILER_RAISE
+            RUN_COMPILER_CLEANUP_FUNCTION(platform_memory_deallocate, (void*) errors.errors[i].message);
+        }
+    }
+
+    compiler_set_error_list(previous_errors);
+
+    wave_arena_set_current(previous_arena);
+    RUN_COMPILER_CLEANUP_FUNCTION(wave_arena_destroy, &arena);
+
+    #undef RUN_COMPILER_FUNCTION
+    #undef RUN_COMPILER_CLEANUP_FUNCTION
     #undef PRINT_STRING
 
-    // deallocate temporary memory
+    return result;
+}
+
+// cached compilation
+
+static atomic_uint compiler_image_temporary_count; // numbers the temporary files of this process, so that threads storing the same image do not share one
 
-    RUN_ERROR_CODE_FUNCTION(wave_compiler_tokenizer_destroy);
+static u64 compiler_image_get_key(wave_vm* vm, str source, u32 source_length) {
+    u64 version[] = { PROGRAM_VERSION_PART_0, PROGRAM_VERSION_PART_1, PROGRAM_VERSION_PART_2, COMPILER_IMAGE_VERSION, vm->function_hash };
+
+    return hash_bytes_seeded((byte*) source, source_length, hash_bytes((byte*) version, sizeof(version)));
+}
+
+static error_code compiler_image_get_path(wave_vm* vm, str cache_directory, u64 key, bool temporary, str* out_path) { // "<cache_directory>/<key>.wbc" or "<cache_directory>/<key>.<process_id>.<count>.tmp"
+    const wave_memory_allocation_function allocate_memory = vm->allocate_memory;
 
-    for (u32 i = 0; i < compiler.error_count; i++) {
-        if (compiler.errors[i].message != NULL) {
-            RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) compiler.errors[i].message);
+    u32 process_id = 0;
+    u32 temporary_count = 0;
+    if (temporary) { // temporary files are unique to the process and the call writing them
+        RUN_ERROR_CODE_FUNCTION(platform_get_process_id, &process_id);
+        temporary_count = atomic_fetch_add_explicit(&compiler_image_temporary_count, 1, memory_order_relaxed);
+    }
+
+    cstr extension = temporary ? COMPILER_IMAGE_TEMPORARY_FILE_EXTENSION : COMPILER_IMAGE_FILE_EXTENSION;
+
+    u32 directory_length = str_length(cache_directory);
+    u32 extension_length = str_length((str) extension);
+
+    str path = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &path, sizeof(char) * (directory_length + 1 + 16 + (1 + 8) * 2 + extension_length + 1));
+
+    str current = path;
+
+    memory_copy((void*) cache_directory, current, directory_length);
+    current += directory_length;
+    *current++ = '/';
+
+    for (i32 i = 15; i >= 0; i--) {
+        *current++ = "0123456789abcdef"[(key >> (i * 4)) & 0xF];
+    }
+
+    if (temporary) {
+        *current++ = '.';
+        for (i32 i = 7; i >= 0; i--) {
+            *current++ = "0123456789abcdef"[(process_id >> (i * 4)) & 0xF];
+        }
+
+        *current++ = '.';
+        for (i32 i = 7; i >= 0; i--) {
+            *current++ = "0123456789abcdef"[(temporary_count >> (i * 4)) & 0xF];
         }
     }
 
-    RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) compiler.errors);
+    memory_copy((void*) extension, current, extension_length);
+    current += extension_length;
+    *current = '\0';
 
-    // output result
+    *out_path = path;
 
-    vm->bytecode_current = vm->bytecode_start;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code compiler_image_load(wave_vm* vm, str path, const compiler_image_header* expected_header, bool* out_loaded) {
+    const wave_memory_allocation_function allocate_memory = vm->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = vm->deallocate_memory;
+
+    *out_loaded = false;
+
+    bool file_exists = false;
+    RUN_ERROR_CODE_FUNCTION(platform_file_exists, path, &file_exists);
+    if (!file_exists) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    u32 file_length = 0;
+    if (platform_get_file_content_length(path, &file_length) != ERROR_CODE_EXECUTION_SUCCESSFUL || file_length < sizeof(compiler_image_header)) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL; // treated as a miss, the image is replaced once the source is compiled
+    }
+
+    byte* image = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &image, sizeof(byte) * (file_length + 1)); // reading appends a null terminator
+
+    u32 read_length = 0;
+    bool image_valid = platform_read_file_length(path, file_length, (str*) &image, &read_length) == ERROR_CODE_EXECUTION_SUCCESSFUL && read_length == file_length;
+
+    // another version, source or set of native functions that hashed to the same key is a miss as well
+
+    compiler_image_header header = image_valid ? *((compiler_image_header*) image) : (compiler_image_header) { .magic = 0 };
+    image_valid = image_valid &&
+        header.magic == expected_header->magic && header.version == expected_header->version &&
+        header.key == expected_header->key && header.function_hash == expected_header->function_hash && header.source_length == expected_header->source_length &&
+        header.bytecode_size > 0 && header.bytecode_size == file_length - sizeof(compiler_image_header);
+
+    if (image_valid) {
+        vm->bytecode_start = NULL;
+        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(vm->bytecode_start), sizeof(byte) * header.bytecode_size);
+        memory_copy(image + sizeof(compiler_image_header), vm->bytecode_start, header.bytecode_size);
+
+        vm->bytecode_end = vm->bytecode_start + header.bytecode_size;
+        vm->bytecode_current = vm->bytecode_start;
+
+        *out_loaded = true;
+    }
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, image);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code compiler_image_store(wave_vm* vm, str cache_directory, str path, const compiler_image_header* header) {
+    const wave_memory_allocation_function allocate_memory = vm->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = vm->deallocate_memory;
+
+    u32 image_size = sizeof(compiler_image_header) + header->bytecode_size;
+
+    byte* image = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &image, sizeof(byte) * image_size);
+    *((compiler_image_header*) image) = *header;
+    memory_copy(vm->bytecode_start, image + sizeof(compiler_image_header), header->bytecode_size);
+
+    // write a temporary file first and move it in place, so other processes never read a partially written image
+
+    str temporary_path = NULL;
+    RUN_ERROR_CODE_FUNCTION(compiler_image_get_path, vm, cache_directory, header->key, true, &temporary_path);
+
+    error_code result = platform_write_file(temporary_path, image, image_size);
+    if (result == ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        result = platform_replace_file(temporary_path, path);
+    }
+
+    if (result != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        bool temporary_file_exists = false;
+        if (platform_file_exists(temporary_path, &temporary_file_exists) == ERROR_CODE_EXECUTION_SUCCESSFUL && temporary_file_exists) {
+            RUN_ERROR_CODE_FUNCTION_IGNORE(platform_delete_file, temporary_path);
+        }
+    }
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, temporary_path);
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, image);
 
     return result;
 }
+
+error_code wave_compile_bytecode_cached(wave_vm* vm, str source, str cache_directory, wave_compiler_message_function message_function) {
+    const wave_memory_deallocation_function deallocate_memory = vm->deallocate_memory;
+
+    if (compiler_profile != NULL) { // the image depends on the profile and has to add its sites to it
+        return wave_compile_bytecode(vm, source, message_function);
+    }
+
+    u32 source_length = str_length(source);
+
+    compiler_image_header header = (compiler_image_header) {
+        .magic = COMPILER_IMAGE_MAGIC,
+        .version = COMPILER_IMAGE_VERSION,
+
+        .key = compiler_image_get_key(vm, source, source_length),
+        .function_hash = vm->function_hash,
+        .source_length = source_length,
+
+        .bytecode_size = 0
+    };
+
+    str path = NULL;
+    RUN_ERROR_CODE_FUNCTION(compiler_image_get_path, vm, cache_directory, header.key, false, &path);
+
+    // load the image of an earlier compilation
+
+    bool loaded = false;
+    error_code result = compiler_image_load(vm, path, &header, &loaded);
+    if (result == ERROR_CODE_EXECUTION_SUCCESSFUL && !loaded) {
+        result = wave_compile_bytecode(vm, source, message_function);
+
+        // the cache is an optimization, failing to store the image does not fail the compilation
+
+        if (result == ERROR_CODE_EXECUTION_SUCCESSFUL && platform_create_folder(cache_directory) == ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            header.bytecode_size = vm->bytecode_end - vm->bytecode_start;
+            RUN_ERROR_CODE_FUNCTION_IGNORE(compiler_image_store, vm, cache_directory, path, &header);
+        }
+    }
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, path);
+
+    return result;
+}
+
+#undef COMPILER_IMAGE_MAGIC
+#undef COMPILER_IMAGE_VERSION
+
+#undef COMPILER_IMAGE_FILE_EXTENSION
+#undef COMPILER_IMAGE_TEMPORARY_FILE_EXTENSION
@@ -8,6 +8,9 @@
 #include "common/debug.h"
 #include "common/defines.h"
 
+#include "language/compiler/data/wave_compile_cache.h"
+#include "language/compiler/data/wave_profile.h"
+
 #include "language/runtime/wave_vm.h"
 
 // Defines
@@ -48,11 +51,35 @@ typedef byte compiler_message_type; // COMPILER_MESSAGE_TPE
 
 typedef error_code (*wave_compiler_message_function)(compiler_message_type type, str string, u32 length);
 
+typedef struct {
+    compiler_message_type type;
+    u32 message_length;
+    str message;
+} compiler_error;
+
+typedef struct {
+    wave_vm* vm;
+
+    u32 error_count;
+    u32 error_capacity;
+    compiler_error* errors; // NULL until the first error is raised, if @error_capacity is 0
+} compiler_error_list;
+
 // Functions
 
+compiler_error_list* compiler_set_error_list(compiler_error_list* list); // every thread raises errors into its own list, returns the list that was set before
 void compiler_raise_error(compiler_message_type type, str message, u32 message_length);
-bool compiler_has_error(void);
+bool compiler_has_error(void); // whether an error was raised into the list of the calling thread
+error_code compiler_move_errors(compiler_error_list* source); // appends the errors of @source to the list of the calling thread and empties @source
+
+void wave_compiler_set_ir_dump_function(wave_compiler_message_function dump_function); // prints the ir of every function after each optimization pass, NULL to stop (function bodies are then compiled on one thread)
+wave_compiler_message_function wave_compiler_get_ir_dump_function(void);
+
+void wave_compiler_set_profile(wave_profile* profile); // guides the compilation by the records of @profile and adds the sites of the emitted bytecode to it, so it can be attached to the vm running it, NULL to stop (the compile caches are not used meanwhile)
+wave_profile* wave_compiler_get_profile(void);
 
-error_code wave_compile_bytecode(wave_vm* vm, str source, wave_compiler_message_function message_function);
+error_code wave_compile_bytecode(wave_vm* vm, str source, wave_compiler_message_function message_function); // function bodies may be compiled on multiple threads, so the memory functions of @vm must be thread safe
+error_code wave_compile_bytecode_cached(wave_vm* vm, str source, str cache_directory, wave_compiler_message_function message_function); // loads the bytecode from @cache_directory if the same source was compiled for the same native functions before, stores it there otherwise
+error_code wave_compile_bytecode_incremental(wave_vm* vm, str source, wave_compile_cache* cache, wave_compiler_message_function message_function); // reuses the bytecode of the functions that did not change since the last compilation with @cache
 
 #endif
@@ -0,0 +1,206 @@
+#include "wave_arena.h"
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "common/memory/memory.h"
+
+// Defines
+
+#define ARENA_ALIGNMENT (sizeof(umax)) /* every allocation starts with its size and is aligned to it */
+#define ARENA_ALIGN(size) (((size) + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1))
+
+#define ARENA_BLOCK_SIZE(size) (ARENA_ALIGN(sizeof(umax) + (size))) /* the size of an allocation including its header */
+#define ARENA_CHUNK_DATA(chunk) ((byte*) (chunk) + ARENA_ALIGN(sizeof(wave_arena_chunk)))
+
+// Typedefs
+
+static _Thread_local wave_arena* current_arena; // the arena of the calling thread (see @wave_arena_set_current)
+
+// Functions
+
+error_code wave_arena_new(wave_arena* arena, umax chunk_size, wave_memory_allocation_function allocate_memory, wave_memory_deallocation_function deallocate_memory) {
+    arena->allocate_memory = allocate_memory;
+    arena->deallocate_memory = deallocate_memory;
+
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_arena_destroy(wave_arena* arena) {
+    const wave_memory_deallocation_function deallocate_memory = arena->deallocate_memory;
+
+    wave_arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        wave_arena_chunk* next = chunk->next;
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, chunk);
+        chunk = next;
+    }
+
+    arena->chunks = NULL;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code arena_new_chunk(wave_arena* arena, umax capacity, wave_arena_chunk** out_chunk) {
+    const wave_memory_allocation_function allocate_memory = arena->allocate_memory;
+
+    wave_arena_chunk* chunk = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &chunk, ARENA_ALIGN(sizeof(wave_arena_chunk)) + capacity);
+
+    chunk->next = NULL;
+    chunk->capacity = capacity;
+    chunk->used = 0;
+
+    *out_chunk = chunk;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static bool arena_is_last_block(const wave_arena_chunk* chunk, const byte* block) {
+    return chunk != NULL && block + ARENA_BLOCK_SIZE(*((const umax*) block)) == ARENA_CHUNK_DATA(chunk) + chunk->used;
+}
+
+error_code wave_arena_allocate(wave_arena* arena, void** out_pointer, umax size) {
+    umax block_size = ARENA_BLOCK_SIZE(size);
+    wave_arena_chunk* chunk = arena->chunks;
+
+    if (chunk == NULL || chunk->used + block_size > chunk->capacity) {
+        if (block_size > arena->chunk_size / 2) { // large allocations get a chunk of their own, so the remainder of the current chunk is not wasted
+            RUN_ERROR_CODE_FUNCTION(arena_new_chunk, arena, block_size, &chunk);
+
+            if (arena->chunks != NULL) {
+                chunk->next = arena->chunks->next;
+                arena->chunks->next = chunk;
+            } else {
+                arena->chunks = chunk;
+            }
+        } else {
+            RUN_ERROR_CODE_FUNCTION(arena_new_chunk, arena, arena->chunk_size, &chunk);
+
+            chunk->next = arena->chunks;
+            arena->chunks = chunk;
+        }
+    }
+
+    byte* block = ARENA_CHUNK_DATA(chunk) + chunk->used;
+    *((umax*) block) = size;
+    chunk->used += block_size;
+
+    *out_pointer = block + sizeof(umax);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_arena_reallocate(wave_arena* arena, void** in_out_pointer, umax size) {
+    if (*in_out_pointer == NULL) {
+        return wave_arena_allocate(arena, in_out_pointer, size);
+    }
+
+    byte* block = (byte*) *in_out_pointer - sizeof(umax);
+    umax old_size = *((umax*) block);
+
+    // the last allocation of the current chunk grows in place
+
+    wave_arena_chunk* chunk = arena->chunks;
+    if (arena_is_last_block(chunk, block)) {
+        umax used = chunk->used - ARENA_BLOCK_SIZE(old_size) + ARENA_BLOCK_SIZE(size);
+
+        if (used <= chunk->capacity) {
+            *((umax*) block) = size;
+            chunk->used = used;
+
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+    }
+
+    if (size <= old_size) {
+        *((umax*) block) = size;
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    void* pointer = NULL;
+    RUN_ERROR_CODE_FUNCTION(wave_arena_allocate, arena, &pointer, size);
+    memory_copy(*in_out_pointer, pointer, (u32) old_size);
+
+    *in_out_pointer = pointer;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+void wave_arena_deallocate(wave_arena* arena, void* pointer) {
+    if (pointer == NULL) {
+        return;
+    }
+
+    byte* block = (byte*) pointer - sizeof(umax);
+
+    wave_arena_chunk* chunk = arena->chunks;
+    if (arena_is_last_block(chunk, block)) {
+        chunk->used -= ARENA_BLOCK_SIZE(*((umax*) block));
+    }
+}
+
+void wave_arena_adopt(wave_arena* arena, wave_arena* other) {
+    if (other->chunks == NULL) {
+        return;
+    }
+
+    // the chunks of @other are inserted behind the current chunk of @arena, which keeps allocating from it
+
+    wave_arena_chunk* last = other->chunks;
+    while (last->next != NULL) {
+        last = last->next;
+    }
+
+    if (arena->chunks != NULL) {
+        last->next = arena->chunks->next;
+        arena->chunks->next = other->chunks;
+    } else {
+        arena->chunks = other->chunks;
+    }
+
+    other->chunks = NULL;
+}
+
+// thread bound memory functions
+
+wave_arena* wave_arena_set_current(wave_arena* arena) {
+    wave_arena* previous_arena = current_arena;
+    current_arena = arena;
+
+    return previous_arena;
+}
+
+wave_arena* wave_arena_get_current(void) {
+    return current_arena;
+}
+
+error_code wave_arena_current_allocate(void** out_pointer, umax size) {
+    return wave_arena_allocate(current_arena, out_pointer, size);
+}
+
+error_code wave_arena_current_allocate_zero(void** out_pointer, umax size) {
+    RUN_ERROR_CODE_FUNCTION(wave_arena_allocate, current_arena, out_pointer, size);
+    memory_clear(*out_pointer, (u32) size);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_arena_current_reallocate(void** in_out_pointer, umax size) {
+    return wave_arena_reallocate(current_arena, in_out_pointer, size);
+}
+
+error_code wave_arena_current_deallocate(void* pointer) {
+    wave_arena_deallocate(current_arena, pointer);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+#undef ARENA_ALIGNMENT
+#undef ARENA_ALIGN
+
+#undef ARENA_BLOCK_SIZE
+#undef ARENA_CHUNK_DATA
@@ -0,0 +1,63 @@
+#ifndef WAVE_LANGUAGE_WAVE_ARENA
+#define WAVE_LANGUAGE_WAVE_ARENA
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "language/wave_common.h"
+
+/* Arena
+*
+* Bump allocates from large chunks, all of which are freed at once by @wave_arena_destroy.
+* Every allocation is preceded by its size, so that the last allocation of the current chunk
+* can be grown or released in place. Other allocations are only released with the arena.
+*
+* The compiler allocates its temporaries from an arena by handing the tokenizer and the parser
+* a vm whose memory functions are @wave_arena_current_allocate and its siblings. They allocate
+* from the arena set for the calling thread (see @wave_arena_set_current), an arena must
+* therefore not be used by multiple threads at once. Threads use arenas of their own and
+* hand them to the arena of the compilation once they are done (see @wave_arena_adopt).
+* */
+
+// Typedefs
+
+typedef struct wave_arena_chunk wave_arena_chunk;
+struct wave_arena_chunk {
+    wave_arena_chunk* next;
+
+    umax capacity;
+    umax used;
+}; // followed by @capacity bytes of data
+
+typedef struct {
+    wave_memory_allocation_function allocate_memory;
+    wave_memory_deallocation_function deallocate_memory;
+
+    wave_arena_chunk* chunks; // the chunk allocations are made from, followed by the full ones
+    umax chunk_size;
+} wave_arena;
+
+// Functions
+
+error_code wave_arena_new(wave_arena* arena, umax chunk_size, wave_memory_allocation_function allocate_memory, wave_memory_deallocation_function deallocate_memory); // chunks are only allocated once they are needed
+error_code wave_arena_destroy(wave_arena* arena); // frees every allocation of the arena
+
+error_code wave_arena_allocate(wave_arena* arena, void** out_pointer, umax size);
+error_code wave_arena_reallocate(wave_arena* arena, void** in_out_pointer, umax size);
+void wave_arena_deallocate(wave_arena* arena, void* pointer); // only releases the last allocation of the current chunk
+
+void wave_arena_adopt(wave_arena* arena, wave_arena* other); // moves the chunks of @other to @arena, which frees them once it is destroyed
+
+// thread bound memory functions (see @wave_memory_allocation_function)
+
+wave_arena* wave_arena_set_current(wave_arena* arena); // sets the arena of the calling thread, returns the one that was set before
+wave_arena* wave_arena_get_current(void);
+
+error_code wave_arena_current_allocate(void** out_pointer, umax size);
+error_code wave_arena_current_allocate_zero(void** out_pointer, umax size);
+error_code wave_arena_current_reallocate(void** in_out_pointer, umax size);
+error_code wave_arena_current_deallocate(void* pointer);
+
+#endif
@@ -3,28 +3,25 @@
 #include "common/constants.h"
 #include "common/error_codes.h"
 
+#include "common/memory/memory.h"
+
 // Functions
 
-error_code wave_ast_new(wave_ast* ast, umax initial_size, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
+error_code wave_ast_new(wave_ast* ast, u32 initial_capacity, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
     ast->allocate_memory = allocate_memory;
     ast->reallocate_memory = reallocate_memory;
     ast->deallocate_memory = deallocate_memory;
 
     ast->nodes = NULL;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(ast->nodes), sizeof(wave_ast_node) * initial_size);
-    ast->node_capacity = initial_size;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(ast->nodes), sizeof(wave_ast_node) * initial_capacity);
+    ast->node_capacity = initial_capacity;
     ast->node_count = 0;
 
-    ast->start_node = WAVE_AST_NODE_END;
-
-    return ERROR_CODE_EXECUTION_SUCCESSFUL;
-}
-
-error_code wave_ast_resize(wave_ast* ast, umax grow_size) {
-    const wave_memory_reallocation_function reallocate_memory = ast->reallocate_memory;
+    ast->data = NULL;
+    ast->data_capacity = 0;
+    ast->data_size = 0;
 
-    ast->node_capacity += grow_size;
-    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(ast->nodes), sizeof(wave_ast_node) * ast->node_capacity);
+    ast->root_node = WAVE_AST_NONE;
 
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
@@ -34,23 +31,62 @@ error_code wave_ast_destroy(wave_ast* ast) {
 
     if (ast->nodes != NULL) {
         RUN_ERROR_CODE_FUNCTION(deallocate_memory, ast->nodes);
+        ast->nodes = NULL;
     }
 
     ast->node_capacity = 0;
     ast->node_count = 0;
 
-    ast->start_node = WAVE_AST_NODE_END;
+    if (ast->data != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, ast->data);
+        ast->data = NULL;
+    }
+
+    ast->data_capacity = 0;
+    ast->data_size = 0;
+
+    ast->root_node = WAVE_AST_NONE;
 
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
-error_code wave_ast_insert(wave_ast* ast, wave_ast_node node) {
+void wave_ast_clear(wave_ast* ast) {
+    ast->node_count = 0;
+    ast->data_size = 0;
+    ast->root_node = WAVE_AST_NONE;
+}
+
+error_code wave_ast_insert(wave_ast* ast, wave_ast_node node, wave_ast_index* out_index) {
+    const wave_memory_reallocation_function reallocate_memory = ast->reallocate_memory;
+
     if (ast->node_count >= ast->node_capacity) {
-        RUN_ERROR_CODE_FUNCTION(wave_ast_resize, ast, 512);
+        ast->node_capacity = ast->node_capacity == 0 ? 64 : ast->node_capacity * 2;
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(ast->nodes), sizeof(wave_ast_node) * ast->node_capacity);
     }
 
     ast->nodes[ast->node_count] = node;
+    *out_index = ast->node_count;
     ast->node_count++;
 
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
+
+error_code wave_ast_insert_data(wave_ast* ast, const void* data, u32 size, u32* out_offset) {
+    const wave_memory_reallocation_function reallocate_memory = ast->reallocate_memory;
+
+    if (ast->data_size + size > ast->data_capacity) {
+        u32 data_capacity = ast->data_capacity == 0 ? 256 : ast->data_capacity * 2;
+        while (ast->data_size + size > data_capacity) {
+            data_capacity *= 2;
+        }
+
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(ast->data), sizeof(byte) * data_capacity);
+        ast->data_capacity = data_capacity;
+    }
+
+    memory_copy((void*) data, ast->data + ast->data_size, size);
+    *out_offset = ast->data_size;
+    ast->data_size += size;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
@@ -8,6 +8,8 @@
 
 #include "language/wave_common.h"
 
+#include "language/compiler/data/wave_compiler_common.h"
+
 // Typedefs
 
 typedef enum {
@@ -36,6 +38,12 @@ typedef enum {
 
     NODE_TYPE_EXPRESSION, // an expression statement
 
+    NODE_TYPE_CONSTANT, // a number or literal, already converted to the type of the expression
+    NODE_TYPE_STRING, // a string literal, allocated when it is evaluated
+    NODE_TYPE_VARIABLE, // reads a local or global variable
+    NODE_TYPE_ASSIGNMENT, // stores the value of its child node in a local or global variable
+    NODE_TYPE_TYPE_CONVERSION, // converts the value of its child node
+
     NODE_TYPE_OPERATION_START, // marks the start of the operation-node-types
 
     NODE_TYPE_UNARY_OPERATION_PLUS,
@@ -78,20 +86,44 @@ typedef enum {
 typedef byte node_type; // @NODE_TYPES
 COMPILE_ASSERT(NODE_TYPE_MAX <= 256, too_many_ast_node_types_defined);
 
-typedef struct wave_ast_node {
+typedef u32 wave_ast_index; // the index of a node in @wave_ast.nodes, nodes refer to each other by index, so growing the node array does not invalidate them
+
+typedef struct {
     node_type type;
+    wave_type value_type; // the type the node evaluates to
+
+    u32 source_offset; // the offset of the token the node was parsed from, used for error messages
+    wave_ast_index next_node; // the next node of the list the node is part of (e.g. the arguments of a function call), @WAVE_AST_NONE if it is the last one
 
     union { // type specific node data
         struct { // @NODE_TYPE_LIST, @NODE_TYPE_STATEMENT_BLOCK
-            struct wave_ast_node* next_node;
-            umax node_count;
+            wave_ast_index first_node;
+            u32 node_count;
         } list_data;
 
         struct { // @NODE_TYPE_UNARY_OPERATION, @NODE_TYPE_BINARY_OPERATION; the operation type is stored in @type to save space
-            struct wave_ast_node* left_node;
-            struct wave_ast_node* right_node;
+            wave_ast_index left_node; // the operand of unary operations
+            wave_ast_index right_node;
         } expression_data;
 
+        struct { // @NODE_TYPE_CONSTANT
+            union_number value; // stored in the width of @value_type, upper bytes are zero
+        } constant_data;
+
+        struct { // @NODE_TYPE_STRING
+            u32 data_index; // the offset of the string in @wave_ast.data (length followed by the characters), token data does not outlive the token window
+        } string_data;
+
+        struct { // @NODE_TYPE_VARIABLE, @NODE_TYPE_ASSIGNMENT
+            wave_symbol symbol;
+            wave_ast_index value_node; // the assigned value, @WAVE_AST_NONE for variable reads
+        } variable_data;
+
+        struct { // @NODE_TYPE_TYPE_CONVERSION
+            wave_ast_index value_node;
+            wave_type from_type; // converted to @value_type
+        } type_conversion_data;
+
         struct { // @NODE_TYPE_FUNCTION_DEFINITION
             wave_type return_type : 4;
 
@@ -105,17 +137,18 @@ typedef struct wave_ast_node {
         } function_definition_data;
 
         struct { // @NODE_TYPE_STATEMENT_FUNCTION_CALL
-            bool native_function  : 1;
-            bool has_parameters   : 1;
-            wave_type return_type : 4;
+            bool native_function    : 1;
+            bool reference_function : 1; // called through a variable of type @WAVE_TYPE_FUNC
+            bool error_function     : 1;
 
-            umax parameter_count;
-        } function_call_data;
+            u16 native_function_index;
+
+            wave_symbol symbol;
+            u32 token_index; // the token of the function name, function calls are linked through patch holes created for it
 
-        struct { // used for setting data to 0
-            umax zero1;
-            umax zero2;
-        };
+            wave_ast_index first_argument; // linked through @next_node, in the order they are pushed
+            u32 argument_count;
+        } function_call_data;
     };
 } wave_ast_node;
 COMPILE_ASSERT(WAVE_TYPE_VOID <= 15, too_many_variable_types_defined); // either update the bit field or remove a few types
@@ -126,22 +159,29 @@ typedef struct {
     wave_memory_deallocation_function deallocate_memory;
 
     wave_ast_node* nodes; // the linear memory that stores the nodes
-    umax node_capacity;
-    umax node_count;
+    u32 node_capacity;
+    u32 node_count;
+
+    byte* data; // the data referenced by nodes (e.g. @NODE_TYPE_STRING)
+    u32 data_capacity;
+    u32 data_size;
 
-    wave_ast_node start_node; // typically a @NODE_TYPE_LIST storing multiple functions
+    wave_ast_index root_node; // the node code is generated for, @WAVE_AST_NONE if the tree is empty
 } wave_ast;
 
 // Defines
 
-#define WAVE_AST_NODE_END ((wave_ast_node) { .type = NODE_TYPE_END, .zero1 = 0, .zero2 = 0 })
+#define WAVE_AST_NONE (U32_MAX) /* marks the absence of a node */
+#define WAVE_AST_NODE(ast, index) (&((ast)->nodes[index]))
 
 // Functions
 
-error_code wave_ast_new(wave_ast* ast, umax initial_size, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
-error_code wave_ast_resize(wave_ast* ast, umax grow_size);
+error_code wave_ast_new(wave_ast* ast, u32 initial_capacity, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
 error_code wave_ast_destroy(wave_ast* ast);
 
-error_code wave_ast_insert(wave_ast* ast, wave_ast_node node);
+void wave_ast_clear(wave_ast* ast); // removes all nodes and data, the memory is kept for the next tree
+
+error_code wave_ast_insert(wave_ast* ast, wave_ast_node node, wave_ast_index* out_index);
+error_code wave_ast_insert_data(wave_ast* ast, const void* data, u32 size, u32* out_offset);
 
 #endif
@@ -0,0 +1,158 @@
+#include "wave_compile_cache.h"
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "common/memory/memory.h"
+
+// Defines
+
+#define COMPILE_CACHE_INITIAL_CAPACITY (32)
+
+// Functions
+
+static error_code compile_cache_free_entry(wave_compile_cache* cache, wave_compile_cache_entry* entry) {
+    const wave_memory_deallocation_function deallocate_memory = cache->deallocate_memory;
+
+    if (entry->bytecode != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, entry->bytecode);
+        entry->bytecode = NULL;
+    }
+
+    if (entry->relocations != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, entry->relocations);
+        entry->relocations = NULL;
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_compile_cache_new(wave_compile_cache* cache, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
+    cache->allocate_memory = allocate_memory;
+    cache->reallocate_memory = reallocate_memory;
+    cache->deallocate_memory = deallocate_memory;
+
+    cache->entries = NULL;
+    cache->entry_capacity = COMPILE_CACHE_INITIAL_CAPACITY;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(cache->entries), sizeof(wave_compile_cache_entry) * cache->entry_capacity);
+    cache->entry_count = 0;
+
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_new, &(cache->table), COMPILE_CACHE_INITIAL_CAPACITY * 2, allocate_memory, reallocate_memory, deallocate_memory);
+
+    cache->generation = 0;
+
+    cache->hit_count = 0;
+    cache->miss_count = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_compile_cache_destroy(wave_compile_cache* cache) {
+    const wave_memory_deallocation_function deallocate_memory = cache->deallocate_memory;
+
+    if (cache->entries != NULL) {
+        for (u32 i = 0; i < cache->entry_count; i++) {
+            RUN_ERROR_CODE_FUNCTION(compile_cache_free_entry, cache, &(cache->entries[i]));
+        }
+
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, cache->entries);
+        cache->entries = NULL;
+    }
+
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_destroy, &(cache->table));
+
+    cache->entry_count = 0;
+    cache->entry_capacity = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+void wave_compile_cache_begin(wave_compile_cache* cache) {
+    cache->generation++;
+
+    cache->hit_count = 0;
+    cache->miss_count = 0;
+}
+
+error_code wave_compile_cache_sweep(wave_compile_cache* cache) {
+    // compact the used entries to the front and rebuild the table, as the indices of the entries change
+
+    u32 entry_count = 0;
+    for (u32 i = 0; i < cache->entry_count; i++) {
+        if (cache->entries[i].generation != cache->generation) {
+            RUN_ERROR_CODE_FUNCTION(compile_cache_free_entry, cache, &(cache->entries[i]));
+            continue;
+        }
+
+        cache->entries[entry_count] = cache->entries[i];
+        entry_count++;
+    }
+
+    cache->entry_count = entry_count;
+
+    wave_symbol_table_clear(&(cache->table));
+    for (u32 i = 0; i < cache->entry_count; i++) {
+        RUN_ERROR_CODE_FUNCTION(wave_symbol_table_set, &(cache->table), cache->entries[i].key, i);
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+wave_compile_cache_entry* wave_compile_cache_find(wave_compile_cache* cache, u64 key) {
+    u32 index = wave_symbol_table_find(&(cache->table), key);
+    if (index == WAVE_SYMBOL_TABLE_NONE) {
+        cache->miss_count++;
+        return NULL;
+    }
+
+    cache->hit_count++;
+
+    wave_compile_cache_entry* entry = &(cache->entries[index]);
+    entry->generation = cache->generation;
+
+    return entry;
+}
+
+error_code wave_compile_cache_store(wave_compile_cache* cache, u64 key, const byte* bytecode, u32 bytecode_size, u32 branch_offset, u16 locals_size, const wave_compile_cache_relocation* relocations, u32 relocation_count) {
+    const wave_memory_allocation_function allocate_memory = cache->allocate_memory;
+    const wave_memory_reallocation_function reallocate_memory = cache->reallocate_memory;
+
+    if (wave_symbol_table_find(&(cache->table), key) != WAVE_SYMBOL_TABLE_NONE) { // an identical declaration was already stored
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    if (cache->entry_count >= cache->entry_capacity) {
+        cache->entry_capacity *= 2;
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(cache->entries), sizeof(wave_compile_cache_entry) * cache->entry_capacity);
+    }
+
+    wave_compile_cache_entry entry = (wave_compile_cache_entry) {
+        .key = key,
+        .generation = cache->generation,
+
+        .bytecode = NULL,
+        .bytecode_size = bytecode_size,
+        .branch_offset = branch_offset,
+        .locals_size = locals_size,
+
+        .relocations = NULL,
+        .relocation_count = relocation_count
+    };
+
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(entry.bytecode), sizeof(byte) * bytecode_size);
+    memory_copy((void*) bytecode, entry.bytecode, bytecode_size);
+
+    if (relocation_count > 0) {
+        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(entry.relocations), sizeof(wave_compile_cache_relocation) * relocation_count);
+        memory_copy((void*) relocations, entry.relocations, sizeof(wave_compile_cache_relocation) * relocation_count);
+    }
+
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_set, &(cache->table), key, cache->entry_count);
+
+    cache->entries[cache->entry_count] = entry;
+    cache->entry_count++;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+#undef COMPILE_CACHE_INITIAL_CAPACITY
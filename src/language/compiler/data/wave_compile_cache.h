@@ -0,0 +1,74 @@
+#ifndef WAVE_LANGUAGE_WAVE_COMPILE_CACHE
+#define WAVE_LANGUAGE_WAVE_COMPILE_CACHE
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "language/wave_common.h"
+
+#include "language/compiler/data/wave_symbol_table.h"
+
+/* Compile Cache
+*
+* Keeps the compiled bytecode of function declarations across compilations, so that recompiling
+* a script after an edit only parses the functions whose declaration changed.
+*
+* Entries are keyed by a hash over the tokens of the whole declaration and over the signatures of
+* every global, function and native function the declaration names (see @parser_hash_declaration).
+* A function whose callee changed its signature therefore misses the cache and is recompiled as well.
+*
+* The bytecode of an entry does not depend on where it is placed, as calls to other functions are
+* stored as relocations and linked through patch holes once the entry is reused.
+* Entries that are not used by a compilation are evicted at its end (see @wave_compile_cache_sweep).
+* */
+
+// Typedefs
+
+typedef struct {
+    u32 bytecode_index; // the offset of the 32bit branch offset operand into the bytecode of the entry
+    u32 token_offset; // the offset of the callee identifier token from the first token of the declaration
+} wave_compile_cache_relocation;
+
+typedef struct {
+    u64 key;
+    u32 generation; // the last compilation that used the entry
+
+    byte* bytecode; // the function from its @DEBUG_INSTRUCTION_TYPE_FUNCTION_START to its @DEBUG_INSTRUCTION_TYPE_FUNCTION_END instruction
+    u32 bytecode_size;
+    u32 branch_offset; // the offset of the branch target of the function into @bytecode
+    u16 locals_size;
+
+    wave_compile_cache_relocation* relocations;
+    u32 relocation_count;
+} wave_compile_cache_entry;
+
+typedef struct {
+    wave_memory_allocation_function allocate_memory;
+    wave_memory_reallocation_function reallocate_memory;
+    wave_memory_deallocation_function deallocate_memory;
+
+    wave_compile_cache_entry* entries;
+    u32 entry_count;
+    u32 entry_capacity;
+
+    wave_symbol_table table; // maps the key of every entry to its index in @entries
+    u32 generation; // incremented for every compilation that uses the cache
+
+    u32 hit_count; // statistics of the last compilation
+    u32 miss_count;
+} wave_compile_cache;
+
+// Functions
+
+error_code wave_compile_cache_new(wave_compile_cache* cache, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
+error_code wave_compile_cache_destroy(wave_compile_cache* cache);
+
+void wave_compile_cache_begin(wave_compile_cache* cache); // starts a new generation, called before every compilation
+error_code wave_compile_cache_sweep(wave_compile_cache* cache); // evicts every entry that was not used since @wave_compile_cache_begin
+
+wave_compile_cache_entry* wave_compile_cache_find(wave_compile_cache* cache, u64 key); // returns NULL if there is no entry for @key, marks the entry as used otherwise
+error_code wave_compile_cache_store(wave_compile_cache* cache, u64 key, const byte* bytecode, u32 bytecode_size, u32 branch_offset, u16 locals_size, const wave_compile_cache_relocation* relocations, u32 relocation_count); // copies the data into a new entry
+
+#endif
@@ -4,6 +4,7 @@
 // Includes
 
 #include "common/constants.h"
+#include "common/defines.h"
 
 #include "language/wave_common.h"
 
@@ -44,30 +45,51 @@ typedef enum {
 COMPILE_ASSERT(WAVE_TOKEN_MAX <= 256, too_many_tokens_defined);
 typedef byte wave_token; // WAVE_TOKENS
 
+typedef u32 wave_symbol; // dense id of a distinct identifier, assigned in order of first appearance (see @wave_token_stream.identifiers)
+
+typedef struct {
+    string_hash hash; // identifier string hash
+    str source_pointer; // pointer to the first appearance of the identifier in the source code
+} wave_identifier;
+
 typedef struct {
     wave_token token; // the token
-    u32 data_index; // the tokens index to the data stack // TODO: add binary tree or tree-like structure for storing identifiers
+    u32 data_index; // the tokens index to the data stack, or the @wave_symbol of identifier tokens
+    u32 source_offset; // the offset of the first character of the token into the source, line and row are only resolved when needed (see @wave_compiler_tokenizer_get_line)
+} parse_token; // a single token read from a @wave_token_stream
 
-    u32 line; // the line in which the token has started
-    u32 row; // the row in @line that points to the first character of the token
-} parse_token;
+typedef struct {
+    wave_token* tokens; // the kind of every token
+    u32* data_indices; // the index of every token into the data stack (the @wave_symbol for identifiers), 0 if the token has no data
+    u32* source_offsets; // the offset of the first character of every token into the source
+    u32 count; // the amount of tokens, the last token is @WAVE_TOKEN_FILE_END once @complete is set
+    u32 window_mask; // the token at index i is stored at (i & @window_mask), @U32_MAX unless the stream is pulled on demand (see @wave_compiler_tokenizer_pull)
+    bool complete; // whether the whole source has been tokenized
+
+    byte* data_stack_start; // the values of number and string tokens
+    byte* data_stack_end;
+
+    wave_identifier* identifiers; // every distinct identifier once, indexed by its @wave_symbol
+    u32 identifier_count;
+} wave_token_stream; // tokens are stored as separate arrays, so scanning the token kinds only touches one byte per token; a pulled stream only holds a window of @TOKEN_WINDOW_SIZE tokens
 
 typedef struct {
     f32 f32; // 32bit precision
     f64 f64; // 64bit precision
 } wave_float; // for quick access and errors when type converting from one to the other
 
-typedef struct {
-    string_hash hash; // identifier string hash
-    str source_pointer; // pointer to the source code
-} wave_identifier;
-
 // Defines
 
-#define TOKEN_STACK_GROW_SIZE (1024)
-#define DATA_STACK_GROW_SIZE (1024)
+#define TOKEN_STACK_INITIAL_CAPACITY (1024) /* the token and data stacks grow geometrically from these capacities */
+#define DATA_STACK_INITIAL_CAPACITY (1024)
+#define IDENTIFIER_STACK_INITIAL_CAPACITY (256)
+
+#define TOKEN_WINDOW_SIZE (256) /* the amount of tokens a pulled token stream holds at once, must be a power of two */
+#define TOKEN_WINDOW_LOOKBACK (8) /* the amount of tokens before the requested one that stay in the window when it is refilled */
+
+#define WAVE_SYMBOL_NONE (U32_MAX) /* marks the absence of a symbol, e.g. for unnamed parameters */
 
-#define BYTECODE_STACK_GROW_SIZE (1024)
+#define BYTECODE_STACK_INITIAL_CAPACITY (1024) /* the bytecode grows geometrically from this capacity */
 
 #define LOCALS_STACK_GROW_SIZE (16)
 #define GLOBALS_STACK_GROW_SIZE (16)
@@ -75,4 +97,34 @@ typedef struct {
 #define FUNCTION_STACK_GROW_SIZE (16)
 #define EXTERN_FUNCTION_STACK_GROW_SIZE (16)
 
+#define PATCH_HOLE_STACK_GROW_SIZE (32)
+
+#define CALL_OPERAND_STACK_GROW_SIZE (16)
+#define IR_JUMP_STACK_GROW_SIZE (16)
+#define SWITCH_CASE_STACK_GROW_SIZE (16)
+#define CALL_SITE_STACK_GROW_SIZE (16)
+#define PROFILE_SITE_STACK_GROW_SIZE (16)
+
+#define INLINE_MAX_BODY_TOKEN_COUNT (64) /* bodies of up to this many tokens without calls are compiled before the others, so their callers can inline them */
+#define INLINE_MAX_COST (16) /* the maximum amount of instructions an optimized body may have to be inlined without the inline modifier */
+#define INLINE_MAX_GROWTH (256) /* the maximum amount of instructions inlined into a single function body */
+#define INLINE_MAX_HOT_BODY_TOKEN_COUNT (256) /* replaces @INLINE_MAX_BODY_TOKEN_COUNT for functions the profile marks as hot (see @wave_profile_is_hot) */
+#define INLINE_MAX_HOT_COST (64) /* replaces @INLINE_MAX_COST for functions the profile marks as hot */
+
+#define SWITCH_MIN_TABLE_CASE_COUNT (4) /* switches with fewer cases are lowered to a chain of comparisons */
+#define SWITCH_MAX_TABLE_DENSITY (2) /* the maximum amount of jump table entries per case, sparser switches are searched instead */
+#define SWITCH_MIN_LOOKUP_CASE_COUNT (8) /* sparse switches with fewer cases are lowered to a chain of comparisons */
+#define SWITCH_MAX_TABLE_LENGTH (0b0011111111111111) /* the 14 bit length of @OPCODE_TABLESWITCH and @OPCODE_LOOKUPSWITCH */
+#define SWITCH_HOT_CASE_RATIO (2) /* a case taken by more than 1 / @SWITCH_HOT_CASE_RATIO of the executions of a sparse switch is compared in front of its search */
+
+#define COMPILER_MAX_THREAD_COUNT (16) /* the maximum amount of threads compiling function bodies at once */
+
+#if PROGRAM_FEATURE_WAVE_PARALLEL_COMPILER != 0 && PROGRAM_FEATURE_DEBUG_MODE == 0 // the debug output is not thread safe
+    #define COMPILER_PARALLEL_BODIES (1) /* function bodies are compiled on multiple threads, the whole source is tokenized up front */
+#else
+    #define COMPILER_PARALLEL_BODIES (0)
+#endif
+
+#define COMPILER_ARENA_CHUNK_SIZE (64 * 1024) /* the size of the chunks compiler temporaries are allocated from */
+
 #endif
@@ -0,0 +1,1311 @@
+#include "wave_ir.h"
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "common/data/string/string.h"
+
+#include "common/memory/memory.h"
+
+#include "language/wave_opcodes.h"
+
+// Defines
+
+#define IR_RESERVE(pointer, capacity, count, amount, initial_capacity)                                  \
+    do {                                                                                                \
+        if ((count) + (amount) > (capacity)) {                                                          \
+            u32 new_capacity = (capacity) == 0 ? (initial_capacity) : (capacity) * 2;                   \
+            while ((count) + (amount) > new_capacity) {                                                 \
+                new_capacity *= 2;                                                                      \
+            }                                                                                           \
+                                                                                                        \
+            RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(pointer), sizeof(*(pointer)) * new_capacity); \
+            (capacity) = new_capacity;                                                                  \
+        }                                                                                               \
+    } while (0)
+
+// Typedefs
+
+typedef struct {
+    str buffer;
+    u32 length;
+    u32 capacity;
+} ir_dump_line; // the line @wave_ir_dump is printing
+
+static cstr ir_opcode_names[IR_OPCODE_MAX] = {
+    [IR_OPCODE_NONE]          = "none",
+
+    [IR_OPCODE_CONSTANT]      = "const",
+    [IR_OPCODE_STRING]        = "str.new",
+    [IR_OPCODE_STRING_LOCAL]  = "str.new.local",
+    [IR_OPCODE_PHI]           = "phi",
+    [IR_OPCODE_CONVERSION]    = "convert",
+    [IR_OPCODE_OPERATION]     = "operation",
+
+    [IR_OPCODE_LOAD_LOCAL]    = "load.local",
+    [IR_OPCODE_STORE_LOCAL]   = "store.local",
+    [IR_OPCODE_LOAD_GLOBAL]   = "load.global",
+    [IR_OPCODE_STORE_GLOBAL]  = "store.global",
+
+    [IR_OPCODE_CALL]          = "call",
+    [IR_OPCODE_POP]           = "pop",
+
+    [IR_OPCODE_JUMP]          = "jump",
+    [IR_OPCODE_BRANCH]        = "branch",
+    [IR_OPCODE_SWITCH]        = "switch",
+    [IR_OPCODE_RETURN]        = "return",
+    [IR_OPCODE_EXIT]          = "exit"
+};
+
+static cstr ir_operation_names[NODE_TYPE_MAX] = {
+    [NODE_TYPE_UNARY_OPERATION_PLUS]    = "plus",
+    [NODE_TYPE_UNARY_OPERATION_MINUS]   = "neg",
+    [NODE_TYPE_UNARY_OPERATION_ABS]     = "abs",
+    [NODE_TYPE_UNARY_OPERATION_BIT_NOT] = "bnot",
+    [NODE_TYPE_UNARY_OPERATION_NOT]     = "not",
+
+    [NODE_TYPE_BINARY_OPERATION_ADD] = "add",
+    [NODE_TYPE_BINARY_OPERATION_SUB] = "sub",
+    [NODE_TYPE_BINARY_OPERATION_MUL] = "mul",
+    [NODE_TYPE_BINARY_OPERATION_DIV] = "div",
+    [NODE_TYPE_BINARY_OPERATION_MOD] = "mod",
+    [NODE_TYPE_BINARY_OPERATION_POW] = "pow",
+
+    [NODE_TYPE_BINARY_OPERATION_EQUAL]   = "equ",
+    [NODE_TYPE_BINARY_OPERATION_UNEQUAL] = "neq",
+    [NODE_TYPE_BINARY_OPERATION_AND]     = "and",
+    [NODE_TYPE_BINARY_OPERATION_OR]      = "or",
+
+    [NODE_TYPE_BINARY_OPERATION_LESS_THAN]          = "lt",
+    [NODE_TYPE_BINARY_OPERATION_LESS_THAN_EQUAL]    = "le",
+    [NODE_TYPE_BINARY_OPERATION_GREATER_THAN]       = "gt",
+    [NODE_TYPE_BINARY_OPERATION_GREATER_THAN_EQUAL] = "ge",
+
+    [NODE_TYPE_BINARY_OPERATION_BIT_AND]         = "band",
+    [NODE_TYPE_BINARY_OPERATION_BIT_OR]          = "bor",
+    [NODE_TYPE_BINARY_OPERATION_BIT_XOR]         = "xor",
+    [NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT]  = "shl",
+    [NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_RIGHT] = "shr"
+};
+
+// Functions
+
+error_code wave_ir_new(wave_ir* ir, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
+    *ir = (wave_ir) {
+        .allocate_memory = allocate_memory,
+        .reallocate_memory = reallocate_memory,
+        .deallocate_memory = deallocate_memory,
+
+        .instructions = NULL,
+        .operands = NULL,
+        .blocks = NULL,
+        .data = NULL,
+
+        .variables = NULL,
+        .definitions = NULL,
+        .incomplete_phis = NULL,
+
+        .order = NULL,
+        .use_counts = NULL
+    };
+
+    RUN_ERROR_CODE_FUNCTION(wave_ir_clear, ir);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_destroy(wave_ir* ir) {
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    #define IR_DEALLOCATE(pointer) do { if ((pointer) != NULL) { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) (pointer)); (pointer) = NULL; } } while (0)
+
+    for (u32 i = 0; i < ir->block_capacity; i++) {
+        IR_DEALLOCATE(ir->blocks[i].predecessors);
+    }
+
+    IR_DEALLOCATE(ir->instructions);
+    IR_DEALLOCATE(ir->operands);
+    IR_DEALLOCATE(ir->blocks);
+    IR_DEALLOCATE(ir->data);
+
+    IR_DEALLOCATE(ir->variables);
+    IR_DEALLOCATE(ir->definitions);
+    IR_DEALLOCATE(ir->incomplete_phis);
+
+    IR_DEALLOCATE(ir->order);
+    IR_DEALLOCATE(ir->use_counts);
+
+    #undef IR_DEALLOCATE
+
+    ir->instruction_capacity = 0;
+    ir->operand_capacity = 0;
+    ir->block_capacity = 0;
+    ir->data_capacity = 0;
+    ir->variable_capacity = 0;
+    ir->definition_capacity = 0;
+    ir->incomplete_phi_capacity = 0;
+    ir->use_count_capacity = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_clear(wave_ir* ir) {
+    ir->instruction_count = 0;
+    ir->operand_count = 0;
+    ir->block_count = 0;
+    ir->data_size = 0;
+
+    ir->variable_count = 0;
+    ir->definition_count = 0;
+    ir->incomplete_phi_count = 0;
+
+    ir->valid_analyses = IR_ANALYSIS_NONE;
+    ir->order_count = 0;
+
+    ir->name = NULL;
+    ir->name_length = 0;
+
+    // the entry block has no predecessors
+
+    RUN_ERROR_CODE_FUNCTION(wave_ir_add_block, ir, &ir->current_block);
+    RUN_ERROR_CODE_FUNCTION(wave_ir_seal_block, ir, ir->current_block);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_copy(wave_ir* ir, const wave_ir* source) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    RUN_ERROR_CODE_FUNCTION(wave_ir_clear, ir);
+    ir->block_count = 0;
+
+    IR_RESERVE(ir->instructions, ir->instruction_capacity, 0, source->instruction_count, 64);
+    IR_RESERVE(ir->operands, ir->operand_capacity, 0, source->operand_count, 128);
+    IR_RESERVE(ir->data, ir->data_capacity, 0, source->data_size, 256);
+    IR_RESERVE(ir->variables, ir->variable_capacity, 0, source->variable_count, 16);
+
+    memory_copy((void*) source->instructions, ir->instructions, sizeof(wave_ir_instruction) * source->instruction_count);
+    memory_copy((void*) source->operands, ir->operands, sizeof(wave_ir_index) * source->operand_count);
+    memory_copy((void*) source->data, ir->data, source->data_size);
+    memory_copy((void*) source->variables, ir->variables, sizeof(wave_ir_variable) * source->variable_count);
+
+    ir->instruction_count = source->instruction_count;
+    ir->operand_count = source->operand_count;
+    ir->data_size = source->data_size;
+    ir->variable_count = source->variable_count;
+
+    // the blocks keep their own predecessor lists
+
+    for (wave_ir_block_index i = 0; i < source->block_count; i++) {
+        wave_ir_block_index block = WAVE_IR_NONE;
+        RUN_ERROR_CODE_FUNCTION(wave_ir_add_block, ir, &block);
+
+        const wave_ir_block* source_block = WAVE_IR_BLOCK(source, i);
+        wave_ir_block* copied_block = WAVE_IR_BLOCK(ir, block);
+
+        IR_RESERVE(copied_block->predecessors, copied_block->predecessor_capacity, 0, source_block->predecessor_count, 4);
+        if (source_block->predecessor_count != 0) {
+            memory_copy((void*) source_block->predecessors, copied_block->predecessors, sizeof(wave_ir_block_index) * source_block->predecessor_count);
+        }
+
+        copied_block->first_instruction = source_block->first_instruction;
+        copied_block->last_instruction = source_block->last_instruction;
+        copied_block->predecessor_count = source_block->predecessor_count;
+        copied_block->removed = source_block->removed;
+        copied_block->sealed = true;
+    }
+
+    ir->current_block = source->current_block;
+
+    ir->name = source->name;
+    ir->name_length = source->name_length;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// building
+
+error_code wave_ir_add_block(wave_ir* ir, wave_ir_block_index* out_block) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    if (ir->block_count >= ir->block_capacity) { // the predecessor lists of blocks that were cleared are reused
+        u32 block_capacity = ir->block_capacity == 0 ? 8 : ir->block_capacity * 2;
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(ir->blocks), sizeof(wave_ir_block) * block_capacity);
+
+        for (u32 i = ir->block_capacity; i < block_capacity; i++) {
+            ir->blocks[i].predecessors = NULL;
+            ir->blocks[i].predecessor_capacity = 0;
+        }
+
+        ir->block_capacity = block_capacity;
+    }
+
+    wave_ir_block* block = WAVE_IR_BLOCK(ir, ir->block_count);
+
+    block->first_instruction = WAVE_IR_NONE;
+    block->last_instruction = WAVE_IR_NONE;
+    block->predecessor_count = 0;
+
+    block->removed = false;
+    block->sealed = false;
+
+    block->last_definition = U32_MAX;
+    block->last_incomplete_phi = U32_MAX;
+
+    block->order_index = U32_MAX;
+    block->immediate_dominator = WAVE_IR_NONE;
+
+    *out_block = ir->block_count;
+    ir->block_count++;
+
+    ir->valid_analyses = IR_ANALYSIS_NONE;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_add_edge(wave_ir* ir, wave_ir_block_index from, wave_ir_block_index to) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    wave_ir_block* block = WAVE_IR_BLOCK(ir, to);
+    IR_RESERVE(block->predecessors, block->predecessor_capacity, block->predecessor_count, 1, 4);
+
+    block->predecessors[block->predecessor_count] = from;
+    block->predecessor_count++;
+
+    ir->valid_analyses = IR_ANALYSIS_NONE;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static void ir_link(wave_ir* ir, wave_ir_index index, wave_ir_block_index block_index, wave_ir_index next) { // inserts the instruction in front of @next, at the end of the block if @next is @WAVE_IR_NONE
+    wave_ir_block* block = WAVE_IR_BLOCK(ir, block_index);
+    wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+
+    instruction->block = block_index;
+    instruction->next = next;
+    instruction->previous = next == WAVE_IR_NONE ? block->last_instruction : WAVE_IR_INSTRUCTION(ir, next)->previous;
+
+    if (instruction->previous != WAVE_IR_NONE) {
+        WAVE_IR_INSTRUCTION(ir, instruction->previous)->next = index;
+    } else {
+        block->first_instruction = index;
+    }
+
+    if (next != WAVE_IR_NONE) {
+        WAVE_IR_INSTRUCTION(ir, next)->previous = index;
+    } else {
+        block->last_instruction = index;
+    }
+}
+
+static error_code ir_insert(wave_ir* ir, wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count, wave_ir_block_index block, wave_ir_index next, wave_ir_index* out_index) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    IR_RESERVE(ir->instructions, ir->instruction_capacity, ir->instruction_count, 1, 64);
+    IR_RESERVE(ir->operands, ir->operand_capacity, ir->operand_count, operand_count, 128);
+
+    instruction.operand_index = ir->operand_count;
+    instruction.operand_count = operand_count;
+
+    if (operand_count != 0) {
+        memory_copy((void*) operands, ir->operands + ir->operand_count, sizeof(wave_ir_index) * operand_count);
+        ir->operand_count += operand_count;
+    }
+
+    wave_ir_index index = ir->instruction_count;
+    ir->instructions[index] = instruction;
+    ir->instruction_count++;
+
+    ir_link(ir, index, block, next);
+
+    ir->valid_analyses &= ~IR_ANALYSIS_USES;
+
+    *out_index = index;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code ir_append_operand(wave_ir* ir, wave_ir_index index, wave_ir_index operand) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    IR_RESERVE(ir->operands, ir->operand_capacity, ir->operand_count, WAVE_IR_INSTRUCTION(ir, index)->operand_count + 1, 128);
+
+    wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+    if (instruction->operand_index + instruction->operand_count != ir->operand_count) { // the operands are moved behind the ones of the other instructions
+        memory_copy(ir->operands + instruction->operand_index, ir->operands + ir->operand_count, sizeof(wave_ir_index) * instruction->operand_count);
+
+        instruction->operand_index = ir->operand_count;
+        ir->operand_count += instruction->operand_count;
+    }
+
+    ir->operands[ir->operand_count] = operand;
+    ir->operand_count++;
+    instruction->operand_count++;
+
+    ir->valid_analyses &= ~IR_ANALYSIS_USES;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_append(wave_ir* ir, wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count, wave_ir_index* out_index) {
+    return ir_insert(ir, instruction, operands, operand_count, ir->current_block, WAVE_IR_NONE, out_index);
+}
+
+error_code wave_ir_insert(wave_ir* ir, wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count, wave_ir_block_index block, wave_ir_index next, wave_ir_index* out_index) {
+    return ir_insert(ir, instruction, operands, operand_count, block, next, out_index);
+}
+
+error_code wave_ir_insert_data(wave_ir* ir, const void* data, u32 size, u32* out_offset) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    IR_RESERVE(ir->data, ir->data_capacity, ir->data_size, size, 256);
+
+    memory_copy((void*) data, ir->data + ir->data_size, size);
+    *out_offset = ir->data_size;
+    ir->data_size += size;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_insert_switch_data(wave_ir* ir, u32 case_count, u32* out_offset) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    const u32 padding = (sizeof(u64) - (ir->data_size % sizeof(u64))) % sizeof(u64); // the values are read in place
+    const u32 size = padding + sizeof(u64) * case_count + sizeof(wave_ir_block_index) * (case_count + 1);
+
+    IR_RESERVE(ir->data, ir->data_capacity, ir->data_size, size, 256);
+
+    *out_offset = ir->data_size + padding;
+    ir->data_size += size;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// ssa construction (see Braun et al., "Simple and Efficient Construction of Static Single Assignment Form")
+
+static error_code ir_write_variable(wave_ir* ir, u32 variable, wave_ir_block_index block, wave_ir_index value) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    IR_RESERVE(ir->definitions, ir->definition_capacity, ir->definition_count, 1, 64);
+
+    ir->definitions[ir->definition_count] = (wave_ir_definition) { .variable = variable, .value = value, .previous = WAVE_IR_BLOCK(ir, block)->last_definition };
+    WAVE_IR_BLOCK(ir, block)->last_definition = ir->definition_count;
+    ir->definition_count++;
+
+    ir->variables[variable].current_definition = value;
+    ir->variables[variable].current_block = block;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static void ir_discard_phi(wave_ir* ir, wave_ir_index phi) { // a phi one of whose operands is not known, the variable is read from memory instead
+    wave_ir_remove(ir, phi);
+
+    for (u32 i = 0; i < ir->definition_count; i++) {
+        if (ir->definitions[i].value == phi) {
+            ir->definitions[i].value = WAVE_IR_NONE;
+        }
+    }
+
+    for (u32 i = 0; i < ir->variable_count; i++) {
+        if (ir->variables[i].current_definition == phi) {
+            ir->variables[i].current_definition = WAVE_IR_NONE;
+        }
+    }
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+
+        if (instruction->opcode == IR_OPCODE_LOAD_LOCAL && instruction->variable_data.definition == phi) {
+            instruction->variable_data.definition = WAVE_IR_NONE;
+        } else if (instruction->opcode == IR_OPCODE_PHI) {
+            for (u32 j = 0; j < instruction->operand_count; j++) {
+                if (WAVE_IR_OPERAND(ir, instruction, j) == phi) {
+                    ir_discard_phi(ir, i);
+                    break;
+                }
+            }
+        }
+    }
+}
+
+static error_code ir_read_variable(wave_ir* ir, u32 variable, wave_ir_block_index block, wave_ir_index* out_value);
+
+static error_code ir_add_phi_operands(wave_ir* ir, wave_ir_index phi, u32 variable) {
+    const wave_ir_block_index block = WAVE_IR_INSTRUCTION(ir, phi)->block;
+
+    for (u32 i = 0; i < WAVE_IR_BLOCK(ir, block)->predecessor_count; i++) {
+        wave_ir_index value = WAVE_IR_NONE;
+        RUN_ERROR_CODE_FUNCTION(ir_read_variable, ir, variable, WAVE_IR_BLOCK(ir, block)->predecessors[i], &value);
+
+        if (WAVE_IR_INSTRUCTION(ir, phi)->opcode != IR_OPCODE_PHI) { // discarded while reading a cycle
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+
+        if (value == WAVE_IR_NONE) {
+            ir_discard_phi(ir, phi);
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+
+        RUN_ERROR_CODE_FUNCTION(ir_append_operand, ir, phi, value);
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code ir_read_variable(wave_ir* ir, u32 variable, wave_ir_block_index block, wave_ir_index* out_value) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    // local definitions
+
+    if (ir->variables[variable].current_block == block) {
+        *out_value = ir->variables[variable].current_definition;
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    for (u32 i = WAVE_IR_BLOCK(ir, block)->last_definition; i != U32_MAX; i = ir->definitions[i].previous) {
+        if (ir->definitions[i].variable == variable) {
+            *out_value = ir->definitions[i].value;
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+    }
+
+    // definitions of the predecessors
+
+    wave_ir_block* current_block = WAVE_IR_BLOCK(ir, block);
+    wave_ir_index value = WAVE_IR_NONE;
+
+    if (current_block->predecessor_count == 1 && current_block->sealed) {
+        RUN_ERROR_CODE_FUNCTION(ir_read_variable, ir, variable, current_block->predecessors[0], &value);
+    } else if (current_block->predecessor_count != 0 || !current_block->sealed) { // the entry block reads the variable from memory
+        wave_ir_instruction phi = (wave_ir_instruction) { .opcode = IR_OPCODE_PHI, .value_type = ir->variables[variable].type, .source_offset = 0 };
+        RUN_ERROR_CODE_FUNCTION(ir_insert, ir, phi, NULL, 0, block, WAVE_IR_BLOCK(ir, block)->first_instruction, &value);
+
+        if (!WAVE_IR_BLOCK(ir, block)->sealed) {
+            IR_RESERVE(ir->incomplete_phis, ir->incomplete_phi_capacity, ir->incomplete_phi_count, 1, 16);
+
+            ir->incomplete_phis[ir->incomplete_phi_count] = (wave_ir_incomplete_phi) { .phi = value, .variable = variable, .previous = WAVE_IR_BLOCK(ir, block)->last_incomplete_phi };
+            WAVE_IR_BLOCK(ir, block)->last_incomplete_phi = ir->incomplete_phi_count;
+            ir->incomplete_phi_count++;
+        } else {
+            RUN_ERROR_CODE_FUNCTION(ir_write_variable, ir, variable, block, value); // breaks cycles through loops
+            RUN_ERROR_CODE_FUNCTION(ir_add_phi_operands, ir, value, variable);
+
+            if (WAVE_IR_INSTRUCTION(ir, value)->opcode != IR_OPCODE_PHI) {
+                value = WAVE_IR_NONE;
+            }
+        }
+    }
+
+    RUN_ERROR_CODE_FUNCTION(ir_write_variable, ir, variable, block, value);
+    *out_value = value;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_seal_block(wave_ir* ir, wave_ir_block_index block) {
+    for (u32 i = WAVE_IR_BLOCK(ir, block)->last_incomplete_phi; i != U32_MAX; i = ir->incomplete_phis[i].previous) {
+        if (WAVE_IR_INSTRUCTION(ir, ir->incomplete_phis[i].phi)->opcode == IR_OPCODE_PHI) {
+            RUN_ERROR_CODE_FUNCTION(ir_add_phi_operands, ir, ir->incomplete_phis[i].phi, ir->incomplete_phis[i].variable);
+        }
+    }
+
+    WAVE_IR_BLOCK(ir, block)->last_incomplete_phi = U32_MAX;
+    WAVE_IR_BLOCK(ir, block)->sealed = true;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_add_variable(wave_ir* ir, u16 offset, wave_type type, bool promotable, u32* out_variable) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    IR_RESERVE(ir->variables, ir->variable_capacity, ir->variable_count, 1, 16);
+
+    ir->variables[ir->variable_count] = (wave_ir_variable) {
+        .offset = offset,
+        .type = type,
+        .promotable = promotable,
+        .current_definition = WAVE_IR_NONE,
+        .current_block = WAVE_IR_NONE
+    };
+
+    *out_variable = ir->variable_count;
+    ir->variable_count++;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_write_variable(wave_ir* ir, u32 variable, wave_ir_index value) {
+    if (!ir->variables[variable].promotable) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    return ir_write_variable(ir, variable, ir->current_block, value);
+}
+
+error_code wave_ir_read_variable(wave_ir* ir, u32 variable, wave_ir_index* out_value) {
+    if (!ir->variables[variable].promotable) {
+        *out_value = WAVE_IR_NONE;
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    return ir_read_variable(ir, variable, ir->current_block, out_value);
+}
+
+// editing
+
+static void ir_unlink(wave_ir* ir, wave_ir_index index) { // removes the instruction from the list of its block
+    wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+    wave_ir_block* block = WAVE_IR_BLOCK(ir, instruction->block);
+
+    if (instruction->previous != WAVE_IR_NONE) {
+        WAVE_IR_INSTRUCTION(ir, instruction->previous)->next = instruction->next;
+    } else {
+        block->first_instruction = instruction->next;
+    }
+
+    if (instruction->next != WAVE_IR_NONE) {
+        WAVE_IR_INSTRUCTION(ir, instruction->next)->previous = instruction->previous;
+    } else {
+        block->last_instruction = instruction->previous;
+    }
+}
+
+void wave_ir_remove(wave_ir* ir, wave_ir_index index) {
+    wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+    if (instruction->opcode == IR_OPCODE_NONE) {
+        return;
+    }
+
+    ir_unlink(ir, index);
+
+    instruction->opcode = IR_OPCODE_NONE;
+    instruction->operand_count = 0;
+    instruction->previous = WAVE_IR_NONE;
+    instruction->next = WAVE_IR_NONE;
+
+    ir->valid_analyses &= ~IR_ANALYSIS_USES;
+}
+
+void wave_ir_move(wave_ir* ir, wave_ir_index index, wave_ir_block_index block, wave_ir_index next) {
+    ir_unlink(ir, index);
+    ir_link(ir, index, block, next);
+}
+
+void wave_ir_remove_edge(wave_ir* ir, wave_ir_block_index from, wave_ir_block_index to) {
+    wave_ir_block* block = WAVE_IR_BLOCK(ir, to);
+
+    u32 predecessor = 0;
+    while (predecessor < block->predecessor_count && block->predecessors[predecessor] != from) {
+        predecessor++;
+    }
+
+    if (predecessor == block->predecessor_count) {
+        return;
+    }
+
+    for (u32 i = predecessor + 1; i < block->predecessor_count; i++) {
+        block->predecessors[i - 1] = block->predecessors[i];
+    }
+
+    block->predecessor_count--;
+
+    for (wave_ir_index i = block->first_instruction; i != WAVE_IR_NONE; i = WAVE_IR_INSTRUCTION(ir, i)->next) { // phis that were folded may precede the remaining ones
+        wave_ir_instruction* phi = WAVE_IR_INSTRUCTION(ir, i);
+        if (phi->opcode != IR_OPCODE_PHI || predecessor >= phi->operand_count) {
+            continue;
+        }
+
+        for (u32 j = predecessor + 1; j < phi->operand_count; j++) {
+            WAVE_IR_OPERAND(ir, phi, j - 1) = WAVE_IR_OPERAND(ir, phi, j);
+        }
+
+        phi->operand_count--;
+    }
+
+    ir->valid_analyses = IR_ANALYSIS_NONE;
+}
+
+void wave_ir_replace_uses(wave_ir* ir, const wave_ir_index* replacements) {
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        if (instruction->opcode == IR_OPCODE_NONE) {
+            continue;
+        }
+
+        for (u32 j = 0; j < instruction->operand_count; j++) {
+            wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, j);
+            if (operand != WAVE_IR_NONE && replacements[operand] != WAVE_IR_NONE) {
+                WAVE_IR_OPERAND(ir, instruction, j) = replacements[operand];
+            }
+        }
+
+        if (instruction->opcode == IR_OPCODE_LOAD_LOCAL && instruction->variable_data.definition != WAVE_IR_NONE && replacements[instruction->variable_data.definition] != WAVE_IR_NONE) {
+            instruction->variable_data.definition = replacements[instruction->variable_data.definition];
+        }
+    }
+
+    ir->valid_analyses &= ~IR_ANALYSIS_USES;
+}
+
+error_code wave_ir_inline(wave_ir* ir, wave_ir_index call, const wave_ir* callee, u16 frame_offset, u32* out_frame_size) {
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    const wave_ir_block_index call_block = WAVE_IR_INSTRUCTION(ir, call)->block;
+    const u32 source_offset = WAVE_IR_INSTRUCTION(ir, call)->source_offset;
+    const u32 argument_count = WAVE_IR_INSTRUCTION(ir, call)->operand_count;
+
+    bool single_block = true; // the body is copied right in front of the call, no jumps are needed
+    for (wave_ir_block_index i = 1; i < callee->block_count; i++) {
+        single_block = single_block && WAVE_IR_BLOCK(callee, i)->removed;
+    }
+
+    wave_ir_index* values = NULL; // the value of every instruction of @callee in @ir
+    wave_ir_block_index* blocks = NULL; // the block of @ir every block of @callee is copied into
+    wave_ir_index* returned_values = NULL; // the value every copied block passes to the continuation, in the order of its predecessors
+    bool* stored_parameters = NULL;
+
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &values, sizeof(wave_ir_index) * (callee->instruction_count + 1));
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &blocks, sizeof(wave_ir_block_index) * (callee->block_count + 1));
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &returned_values, sizeof(wave_ir_index) * (callee->block_count + 1));
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &stored_parameters, sizeof(bool) * (argument_count + 1));
+
+    memory_set_32(values, WAVE_IR_NONE, callee->instruction_count);
+    memory_clear(stored_parameters, sizeof(bool) * argument_count);
+
+    // the locals of the callee are placed behind @frame_offset, its parameters are the first variables
+
+    const u32 first_variable = ir->variable_count;
+    for (u32 i = 0; i < callee->variable_count; i++) {
+        u32 variable = 0;
+        RUN_ERROR_CODE_FUNCTION(wave_ir_add_variable, ir, callee->variables[i].offset + frame_offset, callee->variables[i].type, callee->variables[i].promotable, &variable);
+    }
+
+    // loads of parameters that are never stored to are replaced by the arguments, the other arguments are stored to the frame
+
+    for (wave_ir_index i = 0; i < callee->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(callee, i);
+        if (instruction->opcode == IR_OPCODE_STORE_LOCAL && instruction->variable_data.variable < argument_count) {
+            stored_parameters[instruction->variable_data.variable] = true;
+        }
+    }
+
+    u32 frame_size = 0;
+
+    for (u32 i = 0; i < argument_count; i++) {
+        if (!stored_parameters[i]) {
+            continue;
+        }
+
+        const wave_ir_variable* parameter = &ir->variables[first_variable + i];
+        wave_ir_instruction store = (wave_ir_instruction) {
+            .opcode = IR_OPCODE_STORE_LOCAL,
+            .operation = NODE_TYPE_NONE,
+            .value_type = WAVE_TYPE_NONE,
+            .source_offset = source_offset,
+            .variable_data = { .variable = first_variable + i, .offset = parameter->offset, .type = parameter->type, .definition = WAVE_IR_NONE }
+        };
+
+        wave_ir_index argument = WAVE_IR_OPERAND(ir, WAVE_IR_INSTRUCTION(ir, call), i);
+        wave_ir_index index = WAVE_IR_NONE;
+        RUN_ERROR_CODE_FUNCTION(ir_insert, ir, store, &argument, 1, call_block, call, &index);
+    }
+
+    // the instructions behind the call are moved to a new block the copied blocks jump to
+
+    blocks[0] = call_block;
+    for (wave_ir_block_index i = 1; i < callee->block_count; i++) {
+        blocks[i] = WAVE_IR_NONE;
+        if (!WAVE_IR_BLOCK(callee, i)->removed) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_add_block, ir, &blocks[i]);
+        }
+    }
+
+    wave_ir_block_index continuation = call_block;
+    if (!single_block) {
+        RUN_ERROR_CODE_FUNCTION(wave_ir_add_block, ir, &continuation);
+
+        wave_ir_index next = WAVE_IR_INSTRUCTION(ir, call)->next;
+        if (next != WAVE_IR_NONE) {
+            WAVE_IR_BLOCK(ir, continuation)->first_instruction = next;
+            WAVE_IR_BLOCK(ir, continuation)->last_instruction = WAVE_IR_BLOCK(ir, call_block)->last_instruction;
+            WAVE_IR_BLOCK(ir, call_block)->last_instruction = call;
+
+            WAVE_IR_INSTRUCTION(ir, call)->next = WAVE_IR_NONE;
+            WAVE_IR_INSTRUCTION(ir, next)->previous = WAVE_IR_NONE;
+
+            for (wave_ir_index i = next; i != WAVE_IR_NONE; i = WAVE_IR_INSTRUCTION(ir, i)->next) {
+                WAVE_IR_INSTRUCTION(ir, i)->block = continuation;
+            }
+        }
+
+        const wave_ir_block_index* successors = NULL;
+        u32 successor_count = wave_ir_get_successors(ir, continuation, &successors);
+        for (u32 i = 0; i < successor_count; i++) {
+            wave_ir_block* successor = WAVE_IR_BLOCK(ir, successors[i]);
+            for (u32 j = 0; j < successor->predecessor_count; j++) {
+                successor->predecessors[j] = successor->predecessors[j] == call_block ? continuation : successor->predecessors[j];
+            }
+        }
+    }
+
+    // copy the blocks, operands still refer to the instructions of the callee until all of them are copied
+
+    const wave_ir_index first_copy = ir->instruction_count;
+    u32 return_count = 0;
+
+    for (wave_ir_block_index i = 0; i < callee->block_count; i++) {
+        if (WAVE_IR_BLOCK(callee, i)->removed) {
+            continue;
+        }
+
+        const wave_ir_index next = i == 0 ? call : WAVE_IR_NONE; // the entry block is placed in front of the call
+
+        for (wave_ir_index j = WAVE_IR_BLOCK(callee, i)->first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(callee, j)->next) {
+            wave_ir_instruction instruction = *WAVE_IR_INSTRUCTION(callee, j);
+            const wave_ir_index* operands = callee->operands + instruction.operand_index;
+
+            switch (instruction.opcode) {
+                case IR_OPCODE_POP: {
+                    continue; // the locals are part of the frame of the caller, they are not on the stack
+                }
+
+                case IR_OPCODE_LOAD_LOCAL:
+                case IR_OPCODE_STORE_LOCAL: {
+                    u32 variable = instruction.variable_data.variable;
+                    if (instruction.opcode == IR_OPCODE_LOAD_LOCAL && variable < argument_count && !stored_parameters[variable]) {
+                        values[j] = WAVE_IR_OPERAND(ir, WAVE_IR_INSTRUCTION(ir, call), variable);
+                        continue;
+                    }
+
+                    instruction.variable_data.variable = first_variable + variable;
+                    instruction.variable_data.offset = ir->variables[first_variable + variable].offset;
+
+                    u32 variable_end = (u32) callee->variables[variable].offset + wave_type_get_size(callee->variables[variable].type);
+                    frame_size = variable_end > frame_size ? variable_end : frame_size;
+                    break;
+                }
+
+                case IR_OPCODE_JUMP:
+                case IR_OPCODE_BRANCH: {
+                    instruction.branch_data.targets[0] = blocks[instruction.branch_data.targets[0]];
+                    if (instruction.opcode == IR_OPCODE_BRANCH) {
+                        instruction.branch_data.targets[1] = blocks[instruction.branch_data.targets[1]];
+                    }
+
+                    break;
+                }
+
+                case IR_OPCODE_RETURN: {
+                    returned_values[return_count] = instruction.operand_count > 0 ? operands[0] : WAVE_IR_NONE;
+                    return_count++;
+
+                    if (single_block) {
+                        continue;
+                    }
+
+                    instruction = (wave_ir_instruction) { .opcode = IR_OPCODE_JUMP, .operation = NODE_TYPE_NONE, .value_type = WAVE_TYPE_NONE, .source_offset = instruction.source_offset, .branch_data = { .targets = { continuation, WAVE_IR_NONE } } };
+
+                    RUN_ERROR_CODE_FUNCTION(wave_ir_add_edge, ir, blocks[i], continuation);
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+            }
+
+            RUN_ERROR_CODE_FUNCTION(ir_insert, ir, instruction, operands, instruction.operand_count, blocks[i], next, &values[j]);
+        }
+
+        if (!single_block && wave_ir_get_terminator(callee, i) == WAVE_IR_NONE) { // falls off the end of the callee
+            wave_ir_instruction jump = (wave_ir_instruction) { .opcode = IR_OPCODE_JUMP, .operation = NODE_TYPE_NONE, .value_type = WAVE_TYPE_NONE, .source_offset = source_offset, .branch_data = { .targets = { continuation, WAVE_IR_NONE } } };
+
+            wave_ir_index index = WAVE_IR_NONE;
+            RUN_ERROR_CODE_FUNCTION(ir_insert, ir, jump, NULL, 0, blocks[i], WAVE_IR_NONE, &index);
+            RUN_ERROR_CODE_FUNCTION(wave_ir_add_edge, ir, blocks[i], continuation);
+
+            returned_values[return_count] = WAVE_IR_NONE;
+            return_count++;
+        }
+    }
+
+    // the copied blocks get the predecessors in the order of the callee, which the operands of its phis follow
+
+    for (wave_ir_block_index i = 1; i < callee->block_count; i++) {
+        const wave_ir_block* block = WAVE_IR_BLOCK(callee, i);
+        if (block->removed) {
+            continue;
+        }
+
+        for (u32 j = 0; j < block->predecessor_count; j++) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_add_edge, ir, blocks[block->predecessors[j]], blocks[i]);
+        }
+
+        WAVE_IR_BLOCK(ir, blocks[i])->sealed = true;
+    }
+
+    // resolve the operands now that every instruction has been copied
+
+    for (wave_ir_index i = first_copy; i < ir->instruction_count; i++) {
+        wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+
+        for (u32 j = 0; j < instruction->operand_count; j++) {
+            wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, j);
+            WAVE_IR_OPERAND(ir, instruction, j) = operand == WAVE_IR_NONE ? WAVE_IR_NONE : values[operand];
+        }
+
+        if (instruction->opcode == IR_OPCODE_LOAD_LOCAL && instruction->variable_data.definition != WAVE_IR_NONE) {
+            instruction->variable_data.definition = values[instruction->variable_data.definition];
+        }
+    }
+
+    // the returned values replace the call, they are merged by a phi if the callee returns from several blocks
+
+    for (u32 i = 0; i < return_count; i++) {
+        returned_values[i] = returned_values[i] == WAVE_IR_NONE ? WAVE_IR_NONE : values[returned_values[i]];
+    }
+
+    wave_ir_index result = WAVE_IR_NONE;
+    if (return_count == 1 || (return_count > 0 && returned_values[0] == WAVE_IR_NONE)) {
+        result = returned_values[0];
+    } else if (return_count > 1) { // every path returns a value (see @wave_ir_optimizer_can_inline)
+        wave_ir_instruction phi = (wave_ir_instruction) { .opcode = IR_OPCODE_PHI, .operation = NODE_TYPE_NONE, .value_type = WAVE_IR_INSTRUCTION(ir, call)->value_type, .source_offset = source_offset };
+        RUN_ERROR_CODE_FUNCTION(ir_insert, ir, phi, returned_values, return_count, continuation, WAVE_IR_BLOCK(ir, continuation)->first_instruction, &result);
+    }
+
+    if (continuation != call_block) {
+        WAVE_IR_BLOCK(ir, continuation)->sealed = true;
+    }
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        for (u32 j = 0; j < instruction->operand_count; j++) {
+            if (WAVE_IR_OPERAND(ir, instruction, j) == call) {
+                WAVE_IR_OPERAND(ir, instruction, j) = result;
+            }
+        }
+
+        if (instruction->opcode == IR_OPCODE_LOAD_LOCAL && instruction->variable_data.definition == call) {
+            instruction->variable_data.definition = result;
+        }
+    }
+
+    wave_ir_remove(ir, call);
+
+    ir->valid_analyses = IR_ANALYSIS_NONE;
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) values);
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) blocks);
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) returned_values);
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) stored_parameters);
+
+    *out_frame_size = frame_size;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+wave_ir_index wave_ir_get_terminator(const wave_ir* ir, wave_ir_block_index block) {
+    wave_ir_index last_instruction = WAVE_IR_BLOCK(ir, block)->last_instruction;
+    return last_instruction != WAVE_IR_NONE && WAVE_IR_IS_TERMINATOR(WAVE_IR_INSTRUCTION(ir, last_instruction)->opcode) ? last_instruction : WAVE_IR_NONE;
+}
+
+u32 wave_ir_get_successors(const wave_ir* ir, wave_ir_block_index block, const wave_ir_block_index** out_successors) {
+    wave_ir_index terminator = wave_ir_get_terminator(ir, block);
+    if (terminator == WAVE_IR_NONE) {
+        return 0;
+    }
+
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, terminator);
+    switch (instruction->opcode) {
+        case IR_OPCODE_JUMP: {
+            *out_successors = instruction->branch_data.targets;
+            return 1;
+        }
+
+        case IR_OPCODE_BRANCH: {
+            *out_successors = instruction->branch_data.targets;
+            return 2;
+        }
+
+        case IR_OPCODE_SWITCH: {
+            *out_successors = WAVE_IR_SWITCH_TARGETS(ir, instruction);
+            return instruction->switch_data.case_count + 1;
+        }
+
+        default: {
+            return 0;
+        }
+    }
+}
+
+// analyses
+
+error_code wave_ir_compute_order(wave_ir* ir) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(ir->order), sizeof(wave_ir_block_index) * ir->block_count * 3);
+
+    // depth first search, @order holds the post order in its first third and the search stack behind it
+
+    wave_ir_block_index* post_order = ir->order;
+    wave_ir_block_index* stack = ir->order + ir->block_count; // pairs of (block, next successor)
+    u32 post_order_count = 0;
+    u32 stack_count = 0;
+
+    for (u32 i = 0; i < ir->block_count; i++) {
+        ir->blocks[i].order_index = U32_MAX;
+    }
+
+    ir->blocks[0].order_index = 0; // marks the block as visited
+    stack[0] = 0;
+    stack[1] = 0;
+    stack_count = 1;
+
+    while (stack_count > 0) {
+        wave_ir_block_index block = stack[(stack_count - 1) * 2];
+        u32* next_successor = &stack[(stack_count - 1) * 2 + 1];
+
+        const wave_ir_block_index* successors = NULL;
+        u32 successor_count = wave_ir_get_successors(ir, block, &successors);
+
+        if (*next_successor < successor_count) {
+            wave_ir_block_index successor = successors[*next_successor];
+            (*next_successor)++;
+
+            if (ir->blocks[successor].order_index == U32_MAX) {
+                ir->blocks[successor].order_index = 0;
+
+                stack[stack_count * 2] = successor;
+                stack[stack_count * 2 + 1] = 0;
+                stack_count++;
+            }
+
+            continue;
+        }
+
+        post_order[post_order_count] = block;
+        post_order_count++;
+        stack_count--;
+    }
+
+    // reverse the post order in place
+
+    for (u32 i = 0; i < post_order_count / 2; i++) {
+        wave_ir_block_index block = post_order[i];
+        post_order[i] = post_order[post_order_count - 1 - i];
+        post_order[post_order_count - 1 - i] = block;
+    }
+
+    for (u32 i = 0; i < post_order_count; i++) {
+        ir->blocks[post_order[i]].order_index = i;
+    }
+
+    ir->order_count = post_order_count;
+    ir->valid_analyses |= IR_ANALYSIS_ORDER;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static wave_ir_block_index ir_intersect_dominators(const wave_ir* ir, wave_ir_block_index block1, wave_ir_block_index block2) {
+    while (block1 != block2) {
+        while (ir->blocks[block1].order_index > ir->blocks[block2].order_index) {
+            block1 = ir->blocks[block1].immediate_dominator;
+        }
+
+        while (ir->blocks[block2].order_index > ir->blocks[block1].order_index) {
+            block2 = ir->blocks[block2].immediate_dominator;
+        }
+    }
+
+    return block1;
+}
+
+error_code wave_ir_compute_dominators(wave_ir* ir) { // see Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm"
+    for (u32 i = 0; i < ir->block_count; i++) {
+        ir->blocks[i].immediate_dominator = WAVE_IR_NONE;
+    }
+
+    ir->blocks[0].immediate_dominator = 0;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (u32 i = 1; i < ir->order_count; i++) {
+            wave_ir_block* block = WAVE_IR_BLOCK(ir, ir->order[i]);
+            wave_ir_block_index immediate_dominator = WAVE_IR_NONE;
+
+            for (u32 j = 0; j < block->predecessor_count; j++) {
+                wave_ir_block_index predecessor = block->predecessors[j];
+                if (ir->blocks[predecessor].immediate_dominator == WAVE_IR_NONE) { // not processed yet or unreachable
+                    continue;
+                }
+
+                immediate_dominator = immediate_dominator == WAVE_IR_NONE ? predecessor : ir_intersect_dominators(ir, predecessor, immediate_dominator);
+            }
+
+            if (block->immediate_dominator != immediate_dominator) {
+                block->immediate_dominator = immediate_dominator;
+                changed = true;
+            }
+        }
+    }
+
+    ir->valid_analyses |= IR_ANALYSIS_DOMINATORS;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_compute_uses(wave_ir* ir) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    IR_RESERVE(ir->use_counts, ir->use_count_capacity, 0, ir->instruction_count, 64);
+    memory_clear(ir->use_counts, sizeof(u32) * ir->instruction_count);
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+
+        for (u32 j = 0; j < instruction->operand_count; j++) {
+            wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, j);
+            if (operand != WAVE_IR_NONE) {
+                ir->use_counts[operand]++;
+            }
+        }
+    }
+
+    ir->valid_analyses |= IR_ANALYSIS_USES;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+bool wave_ir_dominates(const wave_ir* ir, wave_ir_block_index dominator, wave_ir_block_index block) {
+    while (block != WAVE_IR_NONE) {
+        if (block == dominator) {
+            return true;
+        } else if (ir->blocks[block].immediate_dominator == block) {
+            return false;
+        }
+
+        block = ir->blocks[block].immediate_dominator;
+    }
+
+    return false;
+}
+
+bool wave_ir_has_side_effects(const wave_ir_instruction* instruction) {
+    switch (instruction->opcode) {
+        case IR_OPCODE_NONE:
+
+        case IR_OPCODE_CONSTANT:
+        case IR_OPCODE_STRING: // an unused string is never freed otherwise
+        case IR_OPCODE_PHI:
+        case IR_OPCODE_CONVERSION:
+        case IR_OPCODE_OPERATION:
+
+        case IR_OPCODE_LOAD_LOCAL:
+        case IR_OPCODE_LOAD_GLOBAL: {
+            return false;
+        }
+
+        default: { // stores, calls, the frame allocations of strings and terminators
+            return true;
+        }
+    }
+}
+
+// debugging
+
+static error_code ir_dump_append(const wave_ir* ir, ir_dump_line* line, str format, str_format_data* variables) {
+    const wave_memory_reallocation_function reallocate_memory = ir->reallocate_memory;
+
+    u32 length = 0;
+    str_format(format, variables, NULL, &length);
+
+    IR_RESERVE(line->buffer, line->capacity, line->length, length + 1, 128);
+
+    str_format(format, variables, line->buffer + line->length, &length);
+    line->length += length;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_ir_dump(const wave_ir* ir, cstr title, wave_compiler_message_function print_function) {
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    ir_dump_line line = (ir_dump_line) { .buffer = NULL, .length = 0, .capacity = 0 };
+
+    #define DUMP_APPEND(format, ...)                                                                    \
+        do {                                                                                            \
+            str_format_data dump_variables[] = { (str_format_data) 0, __VA_ARGS__ };                   \
+            RUN_ERROR_CODE_FUNCTION(ir_dump_append, ir, &line, "%n" format, dump_variables);            \
+        } while (0)
+
+    #define DUMP_LINE()                                                                                             \
+        do {                                                                                                        \
+            DUMP_APPEND("\n");                                                                                      \
+            RUN_ERROR_CODE_FUNCTION_TRACELESS(print_function, COMPILER_MESSAGE_TYPE_INFO, line.buffer, line.length); \
+            line.length = 0;                                                                                        \
+        } while (0)
+
+    if (ir->name != NULL) {
+        DUMP_APPEND("ir of %*s after %s:", ir->name_length, (str_format_data) ir->name, (str_format_data) title);
+    } else {
+        DUMP_APPEND("ir of entrypoint after %s:", (str_format_data) title);
+    }
+
+    DUMP_LINE();
+
+    for (wave_ir_block_index i = 0; i < ir->block_count; i++) {
+        const wave_ir_block* block = WAVE_IR_BLOCK(ir, i);
+        if (block->removed) {
+            continue;
+        }
+
+        DUMP_APPEND("  b%u32:", i);
+        for (u32 j = 0; j < block->predecessor_count; j++) {
+            if (j == 0) {
+                DUMP_APPEND(" ; predecessors b%u32", block->predecessors[j]);
+            } else {
+                DUMP_APPEND(", b%u32", block->predecessors[j]);
+            }
+        }
+
+        DUMP_LINE();
+
+        for (wave_ir_index j = block->first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+            const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+
+            DUMP_APPEND("    ");
+            if (instruction->value_type != WAVE_TYPE_NONE && instruction->value_type != WAVE_TYPE_VOID) {
+                DUMP_APPEND("%%%u32 = ", j);
+            }
+
+            DUMP_APPEND("%s", (str_format_data) (instruction->opcode == IR_OPCODE_OPERATION ? ir_operation_names[instruction->operation] : ir_opcode_names[instruction->opcode]));
+            if (instruction->value_type != WAVE_TYPE_NONE && instruction->value_type != WAVE_TYPE_VOID) {
+                DUMP_APPEND(" %s", (str_format_data) wave_type_get_string(instruction->value_type));
+            }
+
+            switch (instruction->opcode) {
+                case IR_OPCODE_CONSTANT: {
+                    union_number value = instruction->constant_data.value;
+
+                    switch (instruction->value_type) {
+                        case WAVE_TYPE_I8:  { DUMP_APPEND(" %i64", (str_format_data) (i64) value.value_i8);  break; }
+                        case WAVE_TYPE_I16: { DUMP_APPEND(" %i64", (str_format_data) (i64) value.value_i16); break; }
+                        case WAVE_TYPE_I32: { DUMP_APPEND(" %i64", (str_format_data) (i64) value.value_i32); break; }
+                        case WAVE_TYPE_I64: { DUMP_APPEND(" %i64", (str_format_data) value.value_i64); break; }
+
+                        case WAVE_TYPE_F32: { DUMP_APPEND(" 0x%x32", (str_format_data) value.value_u32); break; } // the bits of the float
+                        case WAVE_TYPE_F64: { DUMP_APPEND(" 0x%x64", (str_format_data) value.value_u64); break; }
+
+                        default: { DUMP_APPEND(" %u64", (str_format_data) value.value_u64); break; }
+                    }
+
+                    break;
+                }
+
+                case IR_OPCODE_STRING:
+                case IR_OPCODE_STRING_LOCAL: {
+                    u32 length = *((u32*) (ir->data + instruction->string_data.data_index));
+                    DUMP_APPEND(" \"%*s\"", length, (str_format_data) ((str) ir->data + instruction->string_data.data_index + sizeof(u32)));
+
+                    if (instruction->opcode == IR_OPCODE_STRING_LOCAL) {
+                        if (instruction->string_data.heap) {
+                            DUMP_APPEND(" heap");
+                        } else {
+                            DUMP_APPEND(" [%u32]", instruction->string_data.frame_offset);
+                        }
+                    }
+
+                    break;
+                }
+
+                case IR_OPCODE_CONVERSION: {
+                    DUMP_APPEND(" from %s", (str_format_data) wave_type_get_string(instruction->conversion_data.from_type));
+                    break;
+                }
+
+                case IR_OPCODE_LOAD_LOCAL:
+                case IR_OPCODE_LOAD_GLOBAL: { // the variable has the type of the value
+                    DUMP_APPEND(" [%u32]", instruction->variable_data.offset);
+                    break;
+                }
+
+                case IR_OPCODE_STORE_LOCAL:
+                case IR_OPCODE_STORE_GLOBAL: {
+                    DUMP_APPEND(" %s [%u32]", (str_format_data) wave_type_get_string(instruction->variable_data.type), instruction->variable_data.offset);
+                    break;
+                }
+
+                case IR_OPCODE_CALL: {
+                    if (instruction->call_data.native_function && !instruction->call_data.reference_function) {
+                        DUMP_APPEND(" native %u32", instruction->call_data.native_function_index);
+                    } else if (!instruction->call_data.reference_function) {
+                        DUMP_APPEND(" %x64", (str_format_data) instruction->call_data.symbol);
+                    } else {
+                        DUMP_APPEND(" dynamic");
+                    }
+
+                    break;
+                }
+
+                case IR_OPCODE_POP: {
+                    DUMP_APPEND(" %s", (str_format_data) wave_opcode_get_name(instruction->pop_data.opcode));
+                    break;
+                }
+
+                default: {
+                    break;
+                }
+            }
+
+            // operands, the operands of phis are listed with their predecessor
+
+            for (u32 k = 0; k < instruction->operand_count; k++) {
+                wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, k);
+
+                if (k != 0) {
+                    DUMP_APPEND(",");
+                }
+
+                DUMP_APPEND(" ");
+
+                if (operand == WAVE_IR_NONE) {
+                    DUMP_APPEND("_");
+                } else if (instruction->opcode == IR_OPCODE_PHI && k < block->predecessor_count) {
+                    DUMP_APPEND("[%%%u32, b%u32]", operand, block->predecessors[k]);
+                } else {
+                    DUMP_APPEND("%%%u32", operand);
+                }
+            }
+
+            if (instruction->opcode == IR_OPCODE_LOAD_LOCAL && instruction->variable_data.definition != WAVE_IR_NONE) {
+                DUMP_APPEND(" ; %%%u32", instruction->variable_data.definition);
+            } else if (instruction->opcode == IR_OPCODE_JUMP) {
+                DUMP_APPEND(" b%u32", instruction->branch_data.targets[0]);
+            } else if (instruction->opcode == IR_OPCODE_BRANCH) {
+                DUMP_APPEND(", b%u32, b%u32", instruction->branch_data.targets[0], instruction->branch_data.targets[1]);
+            } else if (instruction->opcode == IR_OPCODE_SWITCH) { // the case values are printed as their bits
+                DUMP_APPEND(", default b%u32", WAVE_IR_SWITCH_TARGETS(ir, instruction)[0]);
+                for (u32 k = 0; k < instruction->switch_data.case_count; k++) {
+                    DUMP_APPEND(", %u64: b%u32", (str_format_data) WAVE_IR_SWITCH_VALUES(ir, instruction)[k], WAVE_IR_SWITCH_TARGETS(ir, instruction)[k + 1]);
+                }
+            }
+
+            DUMP_LINE();
+        }
+    }
+
+    #undef DUMP_APPEND
+    #undef DUMP_LINE
+
+    if (line.buffer != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, line.buffer);
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+#undef IR_RESERVE
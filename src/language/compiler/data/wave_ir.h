@@ -0,0 +1,299 @@
+#ifndef WAVE_LANGUAGE_WAVE_IR
+#define WAVE_LANGUAGE_WAVE_IR
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "language/wave_common.h"
+
+#include "language/compiler/compiler.h"
+#include "language/compiler/data/wave_ast.h"
+#include "language/compiler/data/wave_compiler_common.h"
+
+/* Intermediate Representation
+*
+* A typed ssa form the syntax trees of a function body are lowered into before bytecode is emitted.
+* Instructions live in basic blocks, every instruction producing a value is the value itself and
+* refers to its operands by index. Local variables that cannot be referenced otherwise are
+* promotable, every load of them knows the value that was stored last (see @wave_ir_read_variable),
+* with phi instructions placed at the blocks where definitions meet. Loads and stores are kept as
+* explicit instructions, stores of promotable locals are removed once no load reads them anymore.
+*
+* The blocks end with a terminator, except for the last one, which falls off the end of the function.
+* Analyses (predecessor order, dominators, use counts) are computed on demand and marked invalid by
+* the passes that do not preserve them (see @wave_ir_optimizer_optimize).
+*
+* The optimized bodies of small functions are kept and copied into the functions calling them (see @wave_ir_inline).
+* */
+
+// Typedefs
+
+typedef enum {
+    IR_OPCODE_NONE, // a removed instruction
+
+    // values
+
+    IR_OPCODE_CONSTANT,
+    IR_OPCODE_STRING, // allocates a new string on the heap
+    IR_OPCODE_STRING_LOCAL, // allocates a new string in the stack frame, or on the heap once its variable escapes
+    IR_OPCODE_PHI, // one operand per predecessor, in the order of @wave_ir_block.predecessors
+    IR_OPCODE_CONVERSION,
+    IR_OPCODE_OPERATION, // unary or binary operation, the operation is stored as @node_type
+
+    // memory
+
+    IR_OPCODE_LOAD_LOCAL,
+    IR_OPCODE_STORE_LOCAL,
+    IR_OPCODE_LOAD_GLOBAL,
+    IR_OPCODE_STORE_GLOBAL,
+
+    // effects
+
+    IR_OPCODE_CALL, // the operands are the arguments, followed by the function reference of dynamic calls
+    IR_OPCODE_POP, // pops the operand with the opcode, which frees the object of a local at the end of its scope (see @parser_end_scope)
+
+    // terminators
+
+    IR_OPCODE_JUMP,
+    IR_OPCODE_BRANCH, // jumps to the first target if the operand is not zero, to the second one otherwise
+    IR_OPCODE_SWITCH, // jumps to the target of the case value equal to the integer operand, to the default target if there is none
+    IR_OPCODE_RETURN,
+    IR_OPCODE_EXIT,
+
+    IR_OPCODE_MAX
+} IR_OPCODES;
+typedef byte ir_opcode; // @IR_OPCODES
+
+typedef enum {
+    IR_ANALYSIS_NONE = 0,
+
+    IR_ANALYSIS_ORDER      = 0b1 << 0, // @wave_ir.order, the reachable blocks in reverse post order
+    IR_ANALYSIS_DOMINATORS = 0b1 << 1, // @wave_ir_block.immediate_dominator
+    IR_ANALYSIS_USES       = 0b1 << 2, // @wave_ir.use_counts
+
+    IR_ANALYSIS_ALL = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS | IR_ANALYSIS_USES
+} IR_ANALYSES;
+typedef byte ir_analysis; // @IR_ANALYSES
+
+typedef u32 wave_ir_index; // the index of an instruction in @wave_ir.instructions, which is also the value it produces
+typedef u32 wave_ir_block_index; // the index of a block in @wave_ir.blocks
+
+typedef struct {
+    ir_opcode opcode;
+    node_type operation; // @IR_OPCODE_OPERATION
+    wave_type value_type; // the type of the produced value, @WAVE_TYPE_NONE if the instruction produces none
+
+    u32 source_offset;
+
+    wave_ir_block_index block;
+    wave_ir_index previous; // the instructions of a block are linked in execution order
+    wave_ir_index next;
+
+    u32 operand_index; // the operands start at @wave_ir.operands[@operand_index]
+    u32 operand_count;
+
+    union { // opcode specific data
+        struct { // @IR_OPCODE_CONSTANT
+            union_number value; // stored in the width of @value_type, upper bytes are zero
+        } constant_data;
+
+        struct { // @IR_OPCODE_STRING, @IR_OPCODE_STRING_LOCAL
+            u32 data_index; // the offset of the string in @wave_ir.data (length followed by the characters)
+            u16 frame_offset; // @IR_OPCODE_STRING_LOCAL, the offset of the object in the stack frame
+            bool heap; // @IR_OPCODE_STRING_LOCAL, set once the variable the string is assigned to escapes
+        } string_data;
+
+        struct { // @IR_OPCODE_LOAD_LOCAL, @IR_OPCODE_STORE_LOCAL, @IR_OPCODE_LOAD_GLOBAL, @IR_OPCODE_STORE_GLOBAL
+            u32 variable; // the index into @wave_ir.variables, @U32_MAX for globals
+            u16 offset; // the offset into the stack frame or the globals array
+            wave_type type;
+            wave_ir_index definition; // @IR_OPCODE_LOAD_LOCAL, the value that was stored last, @WAVE_IR_NONE if it is not known (not an operand)
+        } variable_data;
+
+        struct { // @IR_OPCODE_CONVERSION
+            wave_type from_type; // converted to @value_type
+        } conversion_data;
+
+        struct { // @IR_OPCODE_CALL
+            bool native_function    : 1;
+            bool reference_function : 1;
+            bool error_function     : 1;
+
+            u16 native_function_index;
+
+            wave_symbol symbol;
+            u32 token_index; // the token of the function name, function calls are linked through patch holes created for it
+        } call_data;
+
+        struct { // @IR_OPCODE_POP
+            byte opcode; // the bytecode instruction that pops the local
+        } pop_data;
+
+        struct { // @IR_OPCODE_JUMP, @IR_OPCODE_BRANCH
+            wave_ir_block_index targets[2];
+        } branch_data;
+
+        struct { // @IR_OPCODE_SWITCH
+            u32 data_index; // the offset of the case values in @wave_ir.data, followed by the targets (see @WAVE_IR_SWITCH_VALUES)
+            u32 case_count;
+        } switch_data;
+    };
+} wave_ir_instruction;
+
+typedef struct {
+    wave_ir_index first_instruction; // @WAVE_IR_NONE if the block is empty
+    wave_ir_index last_instruction;
+
+    wave_ir_block_index* predecessors;
+    u32 predecessor_count;
+    u32 predecessor_capacity;
+
+    bool removed; // set once the block is found unreachable
+    bool sealed; // whether all predecessors are known, reads of variables in unsealed blocks create incomplete phis
+
+    u32 last_definition; // the last entry of @wave_ir.definitions written in the block, @U32_MAX if none
+    u32 last_incomplete_phi; // the last entry of @wave_ir.incomplete_phis of the block, @U32_MAX if none
+
+    // analyses
+
+    u32 order_index; // the index into @wave_ir.order, @U32_MAX if the block is unreachable
+    wave_ir_block_index immediate_dominator; // the block itself for the entry block
+} wave_ir_block;
+
+typedef struct {
+    u16 offset;
+    wave_type type;
+
+    bool promotable; // whether every access to the variable is a load or store instruction, so that its definitions can be tracked
+
+    wave_ir_index current_definition; // the definition in @current_block, which is usually the one that is read
+    wave_ir_block_index current_block;
+} wave_ir_variable;
+
+typedef struct {
+    u32 variable;
+    wave_ir_index value;
+    u32 previous; // the definition written before in the same block, @U32_MAX if none
+} wave_ir_definition;
+
+typedef struct {
+    wave_ir_index phi;
+    u32 variable;
+    u32 previous; // the incomplete phi created before in the same block, @U32_MAX if none
+} wave_ir_incomplete_phi;
+
+typedef struct {
+    wave_memory_allocation_function allocate_memory;
+    wave_memory_reallocation_function reallocate_memory;
+    wave_memory_deallocation_function deallocate_memory;
+
+    wave_ir_instruction* instructions;
+    u32 instruction_capacity;
+    u32 instruction_count;
+
+    wave_ir_index* operands; // the operands of all instructions, operands that are added later move the operands of their instruction to the end
+    u32 operand_capacity;
+    u32 operand_count;
+
+    wave_ir_block* blocks; // the first block is the entry of the function
+    u32 block_capacity;
+    u32 block_count;
+
+    wave_ir_block_index current_block; // the block instructions are appended to
+
+    byte* data; // the data referenced by instructions (e.g. @IR_OPCODE_STRING)
+    u32 data_capacity;
+    u32 data_size;
+
+    // ssa construction
+
+    wave_ir_variable* variables;
+    u32 variable_capacity;
+    u32 variable_count;
+
+    wave_ir_definition* definitions;
+    u32 definition_capacity;
+    u32 definition_count;
+
+    wave_ir_incomplete_phi* incomplete_phis;
+    u32 incomplete_phi_capacity;
+    u32 incomplete_phi_count;
+
+    // analyses
+
+    ir_analysis valid_analyses;
+
+    wave_ir_block_index* order; // @IR_ANALYSIS_ORDER
+    u32 order_count;
+
+    u32* use_counts; // @IR_ANALYSIS_USES, the amount of operands referring to every instruction
+    u32 use_count_capacity;
+
+    // debugging
+
+    cstr name; // the name of the function, only used by @wave_ir_dump
+    u32 name_length;
+} wave_ir;
+
+// Defines
+
+#define WAVE_IR_NONE (U32_MAX) /* marks the absence of an instruction or block */
+#define WAVE_IR_INSTRUCTION(ir, index) (&((ir)->instructions[index]))
+#define WAVE_IR_BLOCK(ir, index) (&((ir)->blocks[index]))
+#define WAVE_IR_OPERAND(ir, instruction, operand) ((ir)->operands[(instruction)->operand_index + (operand)])
+
+#define WAVE_IR_IS_TERMINATOR(opcode) ((opcode) >= IR_OPCODE_JUMP && (opcode) <= IR_OPCODE_EXIT)
+
+#define WAVE_IR_SWITCH_VALUES(ir, instruction) ((u64*) ((ir)->data + (instruction)->switch_data.data_index)) /* the case values in ascending order of their bits, stored in the width of the operand */
+#define WAVE_IR_SWITCH_TARGETS(ir, instruction) ((wave_ir_block_index*) (WAVE_IR_SWITCH_VALUES(ir, instruction) + (instruction)->switch_data.case_count)) /* the default target followed by the target of every case value */
+
+// Functions
+
+error_code wave_ir_new(wave_ir* ir, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
+error_code wave_ir_destroy(wave_ir* ir);
+
+error_code wave_ir_clear(wave_ir* ir); // removes all instructions, blocks and variables and starts a new entry block, the memory is kept for the next function
+error_code wave_ir_copy(wave_ir* ir, const wave_ir* source); // replaces the contents of @ir by a copy of the finished function body @source
+
+// building
+
+error_code wave_ir_add_block(wave_ir* ir, wave_ir_block_index* out_block); // the block is not sealed
+error_code wave_ir_add_edge(wave_ir* ir, wave_ir_block_index from, wave_ir_block_index to); // only before @to is sealed, the terminator of @from is set by the caller
+error_code wave_ir_seal_block(wave_ir* ir, wave_ir_block_index block); // completes the phis created while the predecessors of @block were unknown
+
+error_code wave_ir_append(wave_ir* ir, wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count, wave_ir_index* out_index); // appends to @wave_ir.current_block
+error_code wave_ir_insert(wave_ir* ir, wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count, wave_ir_block_index block, wave_ir_index next, wave_ir_index* out_index); // inserts in front of @next, at the end of @block if @next is @WAVE_IR_NONE
+error_code wave_ir_insert_data(wave_ir* ir, const void* data, u32 size, u32* out_offset);
+error_code wave_ir_insert_switch_data(wave_ir* ir, u32 case_count, u32* out_offset); // reserves the data of @IR_OPCODE_SWITCH, which is filled in through @WAVE_IR_SWITCH_VALUES and @WAVE_IR_SWITCH_TARGETS
+
+error_code wave_ir_add_variable(wave_ir* ir, u16 offset, wave_type type, bool promotable, u32* out_variable);
+error_code wave_ir_write_variable(wave_ir* ir, u32 variable, wave_ir_index value); // records @value as the definition of @variable in @wave_ir.current_block, ignored for variables that are not promotable
+error_code wave_ir_read_variable(wave_ir* ir, u32 variable, wave_ir_index* out_value); // the definition reaching the end of @wave_ir.current_block, @WAVE_IR_NONE if it is not known or @variable is not promotable
+
+// editing
+
+void wave_ir_remove(wave_ir* ir, wave_ir_index index); // unlinks the instruction from its block, its uses have to be removed before
+void wave_ir_move(wave_ir* ir, wave_ir_index index, wave_ir_block_index block, wave_ir_index next); // moves the instruction in front of @next, at the end of @block if @next is @WAVE_IR_NONE
+void wave_ir_remove_edge(wave_ir* ir, wave_ir_block_index from, wave_ir_block_index to); // removes the predecessor and its phi operands from @to
+void wave_ir_replace_uses(wave_ir* ir, const wave_ir_index* replacements); // replaces every operand (and load definition) i by @replacements[i], unless it is @WAVE_IR_NONE
+error_code wave_ir_inline(wave_ir* ir, wave_ir_index call, const wave_ir* callee, u16 frame_offset, u32* out_frame_size); // replaces @call by a copy of the function body @callee, whose locals are moved behind @frame_offset, @out_frame_size is the amount of bytes they take up
+
+wave_ir_index wave_ir_get_terminator(const wave_ir* ir, wave_ir_block_index block); // @WAVE_IR_NONE if the block falls off the end of the function
+u32 wave_ir_get_successors(const wave_ir* ir, wave_ir_block_index block, const wave_ir_block_index** out_successors); // the targets of the terminator, a block may appear more than once
+
+// analyses
+
+error_code wave_ir_compute_order(wave_ir* ir);
+error_code wave_ir_compute_dominators(wave_ir* ir); // requires @IR_ANALYSIS_ORDER
+error_code wave_ir_compute_uses(wave_ir* ir);
+
+bool wave_ir_dominates(const wave_ir* ir, wave_ir_block_index dominator, wave_ir_block_index block); // requires @IR_ANALYSIS_DOMINATORS
+bool wave_ir_has_side_effects(const wave_ir_instruction* instruction); // whether the instruction has to be kept even if its value is not used
+
+// debugging
+
+error_code wave_ir_dump(const wave_ir* ir, cstr title, wave_compiler_message_function print_function); // prints every block of @ir, one message per line
+
+#endif
@@ -0,0 +1,287 @@
+#include "wave_profile.h"
+
+#include "platform.h"
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "common/memory/memory.h"
+
+// Defines
+
+#define PROFILE_INITIAL_CAPACITY (32)
+
+#define PROFILE_FILE_MAGIC (0x46505657) /* "WVPF" */
+#define PROFILE_FILE_VERSION (1) /* increment whenever the layout of @wave_profile_record changes */
+
+// Typedefs
+
+typedef struct {
+    u32 magic;
+    u32 version;
+
+    u32 record_count; // followed by the records
+    u32 padding;
+} profile_file_header;
+
+// Functions
+
+static u64 profile_get_key(string_hash function, u32 source_offset, wave_profile_record_type type, u64 value) {
+    u64 key[] = { function, source_offset, type, value };
+    return hash_bytes((byte*) key, sizeof(key));
+}
+
+static error_code profile_add_count(wave_profile* profile, string_hash function, u32 source_offset, wave_profile_record_type type, u64 value, u64 count) {
+    const wave_memory_reallocation_function reallocate_memory = profile->reallocate_memory;
+
+    u64 key = profile_get_key(function, source_offset, type, value);
+
+    u32 index = wave_symbol_table_find(&(profile->table), key);
+    if (index == WAVE_SYMBOL_TABLE_NONE) {
+        if (profile->record_count >= profile->record_capacity) {
+            profile->record_capacity *= 2;
+            RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(profile->records), sizeof(wave_profile_record) * profile->record_capacity);
+        }
+
+        index = profile->record_count;
+        profile->records[index] = (wave_profile_record) {
+            .function = function,
+            .value = value,
+            .count = 0,
+
+            .source_offset = source_offset,
+            .type = type,
+            .padding = { 0 }
+        };
+
+        RUN_ERROR_CODE_FUNCTION(wave_symbol_table_set, &(profile->table), key, index);
+        profile->record_count++;
+    }
+
+    wave_profile_record* record = &(profile->records[index]);
+    record->count = record->count + count < record->count ? U64_MAX : record->count + count;
+
+    if (type == WAVE_PROFILE_RECORD_CALLS && record->count > profile->max_call_count) {
+        profile->max_call_count = record->count;
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_profile_new(wave_profile* profile, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
+    profile->allocate_memory = allocate_memory;
+    profile->reallocate_memory = reallocate_memory;
+    profile->deallocate_memory = deallocate_memory;
+
+    profile->records = NULL;
+    profile->record_capacity = PROFILE_INITIAL_CAPACITY;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(profile->records), sizeof(wave_profile_record) * profile->record_capacity);
+    profile->record_count = 0;
+
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_new, &(profile->table), PROFILE_INITIAL_CAPACITY * 2, allocate_memory, reallocate_memory, deallocate_memory);
+    profile->max_call_count = 0;
+
+    profile->sites = NULL;
+    profile->site_capacity = PROFILE_INITIAL_CAPACITY;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(profile->sites), sizeof(wave_profile_site) * profile->site_capacity);
+    profile->site_count = 0;
+
+    profile->executed_counts = NULL;
+    profile->taken_counts = NULL;
+    profile->counter_length = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_profile_destroy(wave_profile* profile) {
+    const wave_memory_deallocation_function deallocate_memory = profile->deallocate_memory;
+
+    #define PROFILE_DEALLOCATE(pointer) do { if (pointer != NULL) { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) pointer); pointer = NULL; } } while (0)
+
+    PROFILE_DEALLOCATE(profile->records);
+    PROFILE_DEALLOCATE(profile->sites);
+    PROFILE_DEALLOCATE(profile->executed_counts);
+    PROFILE_DEALLOCATE(profile->taken_counts);
+
+    #undef PROFILE_DEALLOCATE
+
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_destroy, &(profile->table));
+
+    profile->record_count = 0;
+    profile->site_count = 0;
+    profile->counter_length = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+void wave_profile_clear_sites(wave_profile* profile) {
+    profile->site_count = 0;
+}
+
+error_code wave_profile_add_site(wave_profile* profile, wave_profile_site site) {
+    const wave_memory_reallocation_function reallocate_memory = profile->reallocate_memory;
+
+    if (profile->site_count >= profile->site_capacity) {
+        profile->site_capacity *= 2;
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(profile->sites), sizeof(wave_profile_site) * profile->site_capacity);
+    }
+
+    profile->sites[profile->site_count] = site;
+    profile->site_count++;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_profile_attach(wave_profile* profile, wave_vm* vm) {
+    const wave_memory_allocation_function allocate_memory = profile->allocate_memory;
+    const wave_memory_reallocation_function reallocate_memory = profile->reallocate_memory;
+
+    u32 length = vm->bytecode_end - vm->bytecode_start;
+    if (profile->executed_counts == NULL) {
+        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(profile->executed_counts), sizeof(u32) * (length + 1));
+        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(profile->taken_counts), sizeof(u32) * (length + 1));
+    } else if (length > profile->counter_length) {
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(profile->executed_counts), sizeof(u32) * (length + 1));
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(profile->taken_counts), sizeof(u32) * (length + 1));
+    }
+
+    profile->counter_length = length;
+    memory_set_32(profile->executed_counts, 0, length);
+    memory_set_32(profile->taken_counts, 0, length);
+
+    vm->profile_executed_counts = profile->executed_counts;
+    vm->profile_taken_counts = profile->taken_counts;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_profile_detach(wave_profile* profile, wave_vm* vm) {
+    if (vm->profile_executed_counts == profile->executed_counts) {
+        vm->profile_executed_counts = NULL;
+        vm->profile_taken_counts = NULL;
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_profile_collect(wave_profile* profile) {
+    if (profile->executed_counts == NULL) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    for (u32 i = 0; i < profile->site_count; i++) {
+        const wave_profile_site* site = &(profile->sites[i]);
+        if (site->bytecode_offset >= profile->counter_length) {
+            continue;
+        }
+
+        u32 executed = profile->executed_counts[site->bytecode_offset];
+        u32 taken = profile->taken_counts[site->bytecode_offset];
+
+        u64 count = 0;
+        switch (site->counter) {
+            case WAVE_PROFILE_COUNTER_EXECUTED:  { count = executed; break; }
+            case WAVE_PROFILE_COUNTER_TAKEN:     { count = taken; break; }
+            case WAVE_PROFILE_COUNTER_NOT_TAKEN: { count = executed - taken; break; } // the counters wrap around together
+
+            default: {
+                return ERROR_CODE_EXECUTION_FAILED;
+            }
+        }
+
+        RUN_ERROR_CODE_FUNCTION(profile_add_count, profile, site->function, site->source_offset, site->type, site->value, count);
+    }
+
+    memory_set_32(profile->executed_counts, 0, profile->counter_length);
+    memory_set_32(profile->taken_counts, 0, profile->counter_length);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_profile_load(wave_profile* profile, str path, bool* out_loaded) {
+    const wave_memory_allocation_function allocate_memory = profile->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = profile->deallocate_memory;
+
+    *out_loaded = false;
+
+    bool file_exists = false;
+    RUN_ERROR_CODE_FUNCTION(platform_file_exists, path, &file_exists);
+    if (!file_exists) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    u32 file_length = 0;
+    if (platform_get_file_content_length(path, &file_length) != ERROR_CODE_EXECUTION_SUCCESSFUL || file_length < sizeof(profile_file_header)) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    byte* file = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &file, sizeof(byte) * (file_length + 1)); // reading appends a null terminator
+
+    u32 read_length = 0;
+    bool file_valid = platform_read_file_length(path, file_length, (str*) &file, &read_length) == ERROR_CODE_EXECUTION_SUCCESSFUL && read_length == file_length;
+
+    profile_file_header header = file_valid ? *((profile_file_header*) file) : (profile_file_header) { .magic = 0 };
+    file_valid = file_valid &&
+        header.magic == PROFILE_FILE_MAGIC && header.version == PROFILE_FILE_VERSION &&
+        (u64) header.record_count * sizeof(wave_profile_record) == file_length - sizeof(profile_file_header);
+
+    error_code result = ERROR_CODE_EXECUTION_SUCCESSFUL;
+    if (file_valid) {
+        const wave_profile_record* records = (const wave_profile_record*) (file + sizeof(profile_file_header));
+        for (u32 i = 0; i < header.record_count && result == ERROR_CODE_EXECUTION_SUCCESSFUL; i++) {
+            if (records[i].type >= WAVE_PROFILE_RECORD_MAX) {
+                continue;
+            }
+
+            result = profile_add_count(profile, records[i].function, records[i].source_offset, records[i].type, records[i].value, records[i].count);
+        }
+
+        *out_loaded = true;
+    }
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, file);
+
+    return result;
+}
+
+error_code wave_profile_save(const wave_profile* profile, str path) {
+    const wave_memory_allocation_function allocate_memory = profile->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = profile->deallocate_memory;
+
+    u32 file_length = sizeof(profile_file_header) + sizeof(wave_profile_record) * profile->record_count;
+
+    byte* file = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &file, sizeof(byte) * file_length);
+
+    *((profile_file_header*) file) = (profile_file_header) {
+        .magic = PROFILE_FILE_MAGIC,
+        .version = PROFILE_FILE_VERSION,
+
+        .record_count = profile->record_count,
+        .padding = 0
+    };
+
+    memory_copy((void*) profile->records, file + sizeof(profile_file_header), sizeof(wave_profile_record) * profile->record_count);
+
+    error_code result = platform_write_file(path, file, file_length);
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, file);
+
+    return result;
+}
+
+u64 wave_profile_get_count(const wave_profile* profile, string_hash function, u32 source_offset, wave_profile_record_type type, u64 value) {
+    u32 index = wave_symbol_table_find(&(profile->table), profile_get_key(function, source_offset, type, value));
+    return index == WAVE_SYMBOL_TABLE_NONE ? 0 : profile->records[index].count;
+}
+
+bool wave_profile_is_hot(const wave_profile* profile, string_hash function) {
+    u64 count = wave_profile_get_count(profile, function, 0, WAVE_PROFILE_RECORD_CALLS, 0);
+    return count > 0 && count >= profile->max_call_count / WAVE_PROFILE_HOT_RATIO;
+}
+
+#undef PROFILE_INITIAL_CAPACITY
+
+#undef PROFILE_FILE_MAGIC
+#undef PROFILE_FILE_VERSION
@@ -0,0 +1,116 @@
+#ifndef WAVE_LANGUAGE_WAVE_PROFILE
+#define WAVE_LANGUAGE_WAVE_PROFILE
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "common/data/string/hash.h"
+
+#include "language/wave_common.h"
+
+#include "language/compiler/data/wave_symbol_table.h"
+
+#include "language/runtime/wave_vm.h"
+
+// Defines
+
+#define WAVE_PROFILE_HOT_RATIO (8) /* a function is hot, if it is called at least 1 / @WAVE_PROFILE_HOT_RATIO times as often as the most called function */
+
+/* Profile
+*
+* Execution counts of a script fed back into the compiler, which uses them to inline hot functions and to
+* test the frequent cases of a switch first (see @wave_compiler_set_profile).
+*
+* While a profile is set, the compiler adds a site for every function, conditional branch and switch case
+* of the bytecode it emits. Once the profile is attached to the vm running that bytecode, the vm counts the calls
+* of every function, how often every conditional jump was executed and taken, and how often every jump table
+* entry was used, in two counters per bytecode offset (requires PROGRAM_FEATURE_WAVE_PROFILER).
+* @wave_profile_collect then adds the counters of every site to its record.
+*
+* Records are keyed by the name hash of the function and the source offset of the statement rather than by
+* bytecode offsets, which move whenever a function is compiled differently (e.g. because of this profile).
+* Collecting adds to the counts loaded before, so profiles of several runs accumulate.
+* */
+
+// Typedefs
+
+typedef enum {
+    WAVE_PROFILE_RECORD_CALLS = 0,    // how often the function was called
+    WAVE_PROFILE_RECORD_BRANCH,       // how often the condition of a branch was @value (0 or 1)
+    WAVE_PROFILE_RECORD_SWITCH,       // how often a switch was executed
+    WAVE_PROFILE_RECORD_SWITCH_CASE,  // how often a switch jumped to the case of @value
+
+    WAVE_PROFILE_RECORD_MAX
+} WAVE_PROFILE_RECORDS;
+typedef byte wave_profile_record_type; // @WAVE_PROFILE_RECORDS
+
+typedef enum {
+    WAVE_PROFILE_COUNTER_EXECUTED = 0, // how often the instruction at the offset was executed (or the function starting there was called)
+    WAVE_PROFILE_COUNTER_TAKEN,        // how often the jump at the offset was taken (or the jump table entry at the offset was used)
+    WAVE_PROFILE_COUNTER_NOT_TAKEN     // how often the conditional jump at the offset was executed without being taken
+} WAVE_PROFILE_COUNTERS;
+typedef byte wave_profile_counter; // @WAVE_PROFILE_COUNTERS
+
+typedef struct {
+    string_hash function; // the name hash of the function the statement was compiled into
+    u64 value;
+    u64 count;
+
+    u32 source_offset; // 0 for @WAVE_PROFILE_RECORD_CALLS
+    wave_profile_record_type type;
+    byte padding[3]; // records are stored as they are
+} wave_profile_record;
+
+typedef struct {
+    string_hash function;
+    u64 value;
+
+    u32 source_offset;
+    wave_profile_record_type type;
+
+    u32 bytecode_offset; // the offset of the counter, relative to the start of the bytecode
+    wave_profile_counter counter;
+} wave_profile_site; // where the count of a record is read from in the bytecode of the last compilation
+
+typedef struct {
+    wave_memory_allocation_function allocate_memory;
+    wave_memory_reallocation_function reallocate_memory;
+    wave_memory_deallocation_function deallocate_memory;
+
+    wave_profile_record* records;
+    u32 record_count;
+    u32 record_capacity;
+
+    wave_symbol_table table; // maps the key of every record to its index in @records (see @wave_profile_get_key)
+    u64 max_call_count;
+
+    wave_profile_site* sites;
+    u32 site_count;
+    u32 site_capacity;
+
+    u32* executed_counts; // the counters of the attached vm, one per byte of its bytecode, NULL if no vm is attached
+    u32* taken_counts;
+    u32 counter_length;
+} wave_profile;
+
+// Functions
+
+error_code wave_profile_new(wave_profile* profile, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
+error_code wave_profile_destroy(wave_profile* profile); // detach the profile from the vm first
+
+void wave_profile_clear_sites(wave_profile* profile); // called by the compiler before every compilation
+error_code wave_profile_add_site(wave_profile* profile, wave_profile_site site);
+
+error_code wave_profile_attach(wave_profile* profile, wave_vm* vm); // starts counting the execution of the bytecode of @vm, which has to be compiled with @profile set
+error_code wave_profile_detach(wave_profile* profile, wave_vm* vm);
+error_code wave_profile_collect(wave_profile* profile); // adds the counters of every site to its record and resets them
+
+error_code wave_profile_load(wave_profile* profile, str path, bool* out_loaded); // adds the records of the file to the profile, @out_loaded is false if it does not exist or is no profile
+error_code wave_profile_save(const wave_profile* profile, str path);
+
+u64 wave_profile_get_count(const wave_profile* profile, string_hash function, u32 source_offset, wave_profile_record_type type, u64 value); // 0 if there is no record
+bool wave_profile_is_hot(const wave_profile* profile, string_hash function); // whether the function is called often compared to the others (see @WAVE_PROFILE_HOT_RATIO)
+
+#endif
@@ -0,0 +1,111 @@
+#include "wave_struct_layout.h"
+
+#include "common/constants.h"
+
+// Functions
+
+static bool wave_struct_layout_field_precedes(const wave_struct_field* field1, const wave_struct_field* field2) {
+    if (field1->cold != field2->cold) {
+        return !field1->cold;
+    }
+
+    return field1->size > field2->size;
+}
+
+void wave_struct_layout_plan(wave_struct_layout* layout) {
+    wave_struct_field* fields = layout->fields;
+    u16 field_count = layout->field_count;
+
+    // mark cold fields, fields are only split if profile data is available
+
+    u32 max_access_count = 0;
+    for (u16 i = 0; i < field_count; i++) {
+        fields[i].size = (u16) wave_type_get_size(fields[i].type);
+        max_access_count = fields[i].access_count > max_access_count ? fields[i].access_count : max_access_count;
+    }
+
+    for (u16 i = 0; i < field_count; i++) {
+        fields[i].cold = max_access_count != 0 && (u64) fields[i].access_count * WAVE_STRUCT_LAYOUT_COLD_RATIO < max_access_count;
+    }
+
+    // stable insertion sort, structures only have a handful of fields
+
+    for (u16 i = 1; i < field_count; i++) {
+        wave_struct_field field = fields[i];
+
+        u16 j = i;
+        while (j > 0 && wave_struct_layout_field_precedes(&field, &fields[j - 1])) {
+            fields[j] = fields[j - 1];
+            j--;
+        }
+
+        fields[j] = field;
+    }
+
+    // assign offsets, padding can only occur between the hot and the cold fields
+
+    u16 offset = 0;
+    u16 alignment = 1;
+    layout->hot_size = 0;
+
+    for (u16 i = 0; i < field_count; i++) {
+        u16 size = fields[i].size != 0 ? fields[i].size : 1;
+
+        offset = (offset + size - 1) & ~(size - 1);
+        fields[i].offset = offset;
+        offset += fields[i].size;
+
+        alignment = size > alignment ? size : alignment;
+        if (!fields[i].cold) {
+            layout->hot_size = offset;
+        }
+    }
+
+    layout->alignment = alignment;
+    layout->size = (offset + alignment - 1) & ~(alignment - 1);
+}
+
+// columns are stored in field order, padding is only needed in front of the first cold column
+
+static u32 wave_struct_layout_get_column_offset(const wave_struct_layout* layout, u32 field_index, u32 element_count) {
+    u32 column_offset = 0;
+    for (u32 i = 0; i < field_index; i++) {
+        u32 size = layout->fields[i].size != 0 ? layout->fields[i].size : 1;
+        column_offset = (column_offset + size - 1) & ~(size - 1);
+        column_offset += layout->fields[i].size * element_count;
+    }
+
+    if (field_index < layout->field_count) {
+        u32 size = layout->fields[field_index].size != 0 ? layout->fields[field_index].size : 1;
+        column_offset = (column_offset + size - 1) & ~(size - 1);
+    }
+
+    return column_offset;
+}
+
+u32 wave_struct_layout_find_field(const wave_struct_layout* layout, string_hash name) {
+    for (u32 i = 0; i < layout->field_count; i++) {
+        if (layout->fields[i].name == name) {
+            return i;
+        }
+    }
+
+    return U32_MAX;
+}
+
+u32 wave_struct_layout_get_array_size(const wave_struct_layout* layout, u32 element_count) {
+    if (layout->layout_type == WAVE_STRUCT_LAYOUT_AOS) {
+        return layout->size * element_count;
+    }
+
+    return wave_struct_layout_get_column_offset(layout, layout->field_count, element_count);
+}
+
+u32 wave_struct_layout_get_soa_offset(const wave_struct_layout* layout, u32 field_index, u32 element_count, u32 element_index) {
+    const wave_struct_field* field = &layout->fields[field_index];
+    if (layout->layout_type == WAVE_STRUCT_LAYOUT_AOS) {
+        return layout->size * element_index + field->offset;
+    }
+
+    return wave_struct_layout_get_column_offset(layout, field_index, element_count) + field->size * element_index;
+}
@@ -0,0 +1,61 @@
+#ifndef WAVE_LANGUAGE_STRUCT_LAYOUT
+#define WAVE_LANGUAGE_STRUCT_LAYOUT
+
+// Includes
+
+#include "common/constants.h"
+#include "common/data/string/hash.h"
+
+#include "language/wave_common.h"
+
+// Defines
+
+#define WAVE_STRUCT_LAYOUT_COLD_RATIO (8) /* a field is cold, if it is accessed less than 1 / @WAVE_STRUCT_LAYOUT_COLD_RATIO times as often as the hottest field */
+
+// Typedefs
+
+typedef struct {
+    string_hash name;
+    wave_type type;
+
+    u16 size; // the size and alignment of the field
+    u16 offset; // the offset of the field inside the structure (or inside its column, see @wave_struct_layout_get_soa_offset)
+
+    u32 access_count; // profile data, 0 if no profile is available
+    bool cold; // hint for splitting the field into a separate cold structure
+} wave_struct_field;
+
+typedef enum {
+    WAVE_STRUCT_LAYOUT_AOS = 0, // array of structures, every element stores all of its fields next to each other
+    WAVE_STRUCT_LAYOUT_SOA      // structure of arrays, every field is stored in its own column of @element_count values
+} WAVE_STRUCT_LAYOUTS;
+typedef byte wave_struct_layout_type; // @WAVE_STRUCT_LAYOUTS
+
+typedef struct {
+    wave_struct_field* fields; // ordered by their position in the structure after @wave_struct_layout_plan
+    u16 field_count;
+
+    wave_struct_layout_type layout_type;
+
+    u16 size; // the size of the structure including its trailing padding
+    u16 alignment;
+    u16 hot_size; // the size of the leading hot fields, everything behind this offset may be split off
+} wave_struct_layout;
+
+// Functions
+
+/* Plans the memory layout of @layout by reordering its fields.
+*
+* Hot fields are placed in front of cold fields (see @WAVE_STRUCT_LAYOUT_COLD_RATIO),
+* and inside each group the fields are sorted by descending alignment, which removes
+* all padding between fields as every field size is a power of two.
+* The declaration order is kept for fields of the same size and temperature.
+* */
+void wave_struct_layout_plan(wave_struct_layout* layout);
+
+u32 wave_struct_layout_find_field(const wave_struct_layout* layout, string_hash name); // returns U32_MAX, if the field does not exist
+
+u32 wave_struct_layout_get_array_size(const wave_struct_layout* layout, u32 element_count); // the size of an array of @element_count structures in bytes
+u32 wave_struct_layout_get_soa_offset(const wave_struct_layout* layout, u32 field_index, u32 element_count, u32 element_index); // the offset of a field of the element at @element_index
+
+#endif
@@ -0,0 +1,189 @@
+#include "wave_symbol_table.h"
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+// Defines
+
+#define SYMBOL_TABLE_MIN_CAPACITY (16)
+#define SYMBOL_TABLE_GET_SLOT(table, name) ((u32) ((name) ^ ((name) >> 32)) & ((table)->capacity - 1))
+
+// Functions
+
+static error_code symbol_table_grow(wave_symbol_table* table) {
+    const wave_memory_allocation_function allocate_memory = table->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = table->deallocate_memory;
+
+    wave_symbol_table_entry* old_entries = table->entries;
+    u32 old_capacity = table->capacity;
+
+    wave_symbol_table_entry* entries = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &entries, sizeof(wave_symbol_table_entry) * old_capacity * 2);
+    for (u32 i = 0; i < old_capacity * 2; i++) {
+        entries[i].value = WAVE_SYMBOL_TABLE_NONE;
+    }
+
+    table->entries = entries;
+    table->capacity = old_capacity * 2;
+
+    for (u32 i = 0; i < old_capacity; i++) {
+        if (old_entries[i].value == WAVE_SYMBOL_TABLE_NONE) {
+            continue;
+        }
+
+        u32 slot = SYMBOL_TABLE_GET_SLOT(table, old_entries[i].name);
+        while (entries[slot].value != WAVE_SYMBOL_TABLE_NONE) {
+            slot = (slot + 1) & (table->capacity - 1);
+        }
+
+        entries[slot] = old_entries[i];
+    }
+
+    RUN_ERROR_CODE_FUNCTION(deallocate_memory, old_entries);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static u32 symbol_table_find_slot(const wave_symbol_table* table, string_hash name) { // the slot storing @name or the empty slot it would be inserted into
+    u32 slot = SYMBOL_TABLE_GET_SLOT(table, name);
+    while (table->entries[slot].value != WAVE_SYMBOL_TABLE_NONE && table->entries[slot].name != name) {
+        slot = (slot + 1) & (table->capacity - 1);
+    }
+
+    return slot;
+}
+
+static void symbol_table_remove_slot(wave_symbol_table* table, u32 slot) {
+    // shift the following entries of the probe sequence back, so that no tombstones are required
+
+    u32 mask = table->capacity - 1;
+    u32 next_slot = slot;
+    while (true) {
+        next_slot = (next_slot + 1) & mask;
+        if (table->entries[next_slot].value == WAVE_SYMBOL_TABLE_NONE) {
+            break;
+        }
+
+        u32 home_slot = SYMBOL_TABLE_GET_SLOT(table, table->entries[next_slot].name);
+        if (((next_slot - home_slot) & mask) >= ((next_slot - slot) & mask)) { // the entry may move to @slot without passing its home slot
+            table->entries[slot] = table->entries[next_slot];
+            slot = next_slot;
+        }
+    }
+
+    table->entries[slot].value = WAVE_SYMBOL_TABLE_NONE;
+    table->count--;
+}
+
+error_code wave_symbol_table_new(wave_symbol_table* table, u32 initial_capacity, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory) {
+    table->allocate_memory = allocate_memory;
+    table->reallocate_memory = reallocate_memory;
+    table->deallocate_memory = deallocate_memory;
+
+    u32 capacity = SYMBOL_TABLE_MIN_CAPACITY;
+    while (capacity < initial_capacity) {
+        capacity <<= 1;
+    }
+
+    table->entries = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(table->entries), sizeof(wave_symbol_table_entry) * capacity);
+    table->capacity = capacity;
+    table->count = 0;
+
+    for (u32 i = 0; i < capacity; i++) {
+        table->entries[i].value = WAVE_SYMBOL_TABLE_NONE;
+    }
+
+    table->undo_log = NULL;
+    table->undo_capacity = 0;
+    table->undo_count = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_symbol_table_destroy(wave_symbol_table* table) {
+    const wave_memory_deallocation_function deallocate_memory = table->deallocate_memory;
+
+    if (table->entries != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, table->entries);
+        table->entries = NULL;
+    }
+
+    if (table->undo_log != NULL) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, table->undo_log);
+        table->undo_log = NULL;
+    }
+
+    table->capacity = 0;
+    table->count = 0;
+    table->undo_capacity = 0;
+    table->undo_count = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+u32 wave_symbol_table_find(const wave_symbol_table* table, string_hash name) {
+    return table->entries[symbol_table_find_slot(table, name)].value;
+}
+
+error_code wave_symbol_table_set(wave_symbol_table* table, string_hash name, u32 value) {
+    if ((table->count + 1) * 2 > table->capacity) { // keep the load factor at or below 0.5
+        RUN_ERROR_CODE_FUNCTION(symbol_table_grow, table);
+    }
+
+    u32 slot = symbol_table_find_slot(table, name);
+    if (table->entries[slot].value == WAVE_SYMBOL_TABLE_NONE) {
+        table->entries[slot].name = name;
+        table->count++;
+    }
+
+    table->entries[slot].value = value;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_symbol_table_push(wave_symbol_table* table, string_hash name, u32 value) {
+    const wave_memory_reallocation_function reallocate_memory = table->reallocate_memory;
+
+    if (table->undo_count >= table->undo_capacity) {
+        table->undo_capacity = table->undo_capacity == 0 ? SYMBOL_TABLE_MIN_CAPACITY : table->undo_capacity * 2;
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(table->undo_log), sizeof(wave_symbol_table_undo_entry) * table->undo_capacity);
+    }
+
+    table->undo_log[table->undo_count] = (wave_symbol_table_undo_entry) { .name = name, .previous_value = wave_symbol_table_find(table, name) };
+    table->undo_count++;
+
+    return wave_symbol_table_set(table, name, value);
+}
+
+void wave_symbol_table_pop(wave_symbol_table* table) {
+    if (table->undo_count == 0) {
+        return;
+    }
+
+    table->undo_count--;
+    wave_symbol_table_undo_entry undo_entry = table->undo_log[table->undo_count];
+
+    u32 slot = symbol_table_find_slot(table, undo_entry.name);
+    if (table->entries[slot].value == WAVE_SYMBOL_TABLE_NONE) {
+        return;
+    }
+
+    if (undo_entry.previous_value == WAVE_SYMBOL_TABLE_NONE) {
+        symbol_table_remove_slot(table, slot);
+    } else {
+        table->entries[slot].value = undo_entry.previous_value;
+    }
+}
+
+void wave_symbol_table_clear(wave_symbol_table* table) {
+    for (u32 i = 0; i < table->capacity; i++) {
+        table->entries[i].value = WAVE_SYMBOL_TABLE_NONE;
+    }
+
+    table->count = 0;
+    table->undo_count = 0;
+}
+
+#undef SYMBOL_TABLE_MIN_CAPACITY
+#undef SYMBOL_TABLE_GET_SLOT
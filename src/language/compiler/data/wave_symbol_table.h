@@ -0,0 +1,66 @@
+#ifndef WAVE_LANGUAGE_WAVE_SYMBOL_TABLE
+#define WAVE_LANGUAGE_WAVE_SYMBOL_TABLE
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "common/data/string/hash.h"
+
+#include "language/wave_common.h"
+
+// Defines
+
+#define WAVE_SYMBOL_TABLE_NONE (U32_MAX) /* returned by @wave_symbol_table_find if a name is not part of the table; also marks empty slots */
+
+/* Symbol Table
+*
+* An open addressed hash table (linear probing) that maps the @string_hash of a name to a u32 value,
+* which is typically the index into the array that stores the symbols (locals, globals, functions, ...).
+*
+* Names are either set permanently (@wave_symbol_table_set) or pushed (@wave_symbol_table_push).
+* Every push records the value the name had before in an undo log, so that @wave_symbol_table_pop
+* restores shadowed names in reverse order when a scope ends.
+* */
+
+// Typedefs
+
+typedef struct {
+    string_hash name;
+    u32 value; // @WAVE_SYMBOL_TABLE_NONE if the slot is empty
+} wave_symbol_table_entry;
+
+typedef struct {
+    string_hash name;
+    u32 previous_value; // the value of @name before it was pushed, @WAVE_SYMBOL_TABLE_NONE if it was not part of the table
+} wave_symbol_table_undo_entry;
+
+typedef struct {
+    wave_memory_allocation_function allocate_memory;
+    wave_memory_reallocation_function reallocate_memory;
+    wave_memory_deallocation_function deallocate_memory;
+
+    wave_symbol_table_entry* entries;
+    u32 capacity; // always a power of two
+    u32 count;
+
+    wave_symbol_table_undo_entry* undo_log;
+    u32 undo_capacity;
+    u32 undo_count;
+} wave_symbol_table;
+
+// Functions
+
+error_code wave_symbol_table_new(wave_symbol_table* table, u32 initial_capacity, wave_memory_allocation_function allocate_memory, wave_memory_reallocation_function reallocate_memory, wave_memory_deallocation_function deallocate_memory);
+error_code wave_symbol_table_destroy(wave_symbol_table* table);
+
+u32 wave_symbol_table_find(const wave_symbol_table* table, string_hash name);
+
+error_code wave_symbol_table_set(wave_symbol_table* table, string_hash name, u32 value); // inserts or overwrites @name without recording it in the undo log; @value must not be @WAVE_SYMBOL_TABLE_NONE
+error_code wave_symbol_table_push(wave_symbol_table* table, string_hash name, u32 value); // inserts or shadows @name, undone by @wave_symbol_table_pop
+void wave_symbol_table_pop(wave_symbol_table* table); // undoes the last @wave_symbol_table_push
+
+void wave_symbol_table_clear(wave_symbol_table* table); // removes all names and clears the undo log
+
+#endif
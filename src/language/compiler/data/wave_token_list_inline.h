@@ -15,8 +15,8 @@
 #endif
 
 /* NOTE:
-* Tokens are partially sorted in a way, that the string matching algorithm can pick the first match,
-* meaning "abc" must not come before "abcdef" because then in some cases only "abc" is being matched.
+* The tokenizer builds its keyword hash table and operator jump table from these lists (see @initialize_token_lookup),
+* keywords match whole identifiers and operators always match the longest entry, so the order of the entries doesn't matter.
 *
 * Some tokens don't have a constant string representation.
 * */
@@ -47,3 +47,7 @@ wave_type token_get_wave_type(wave_token token) {
 wave_type wave_type_get_higher(wave_type type1, wave_type type2) {
     return type1 > type2 ? type1 : type2;
 }
+
+bool wave_type_is_integer(wave_type type) {
+    return type <= WAVE_TYPE_I64; // @WAVE_TYPE_U8 is the first type and @wave_type is unsigned
+}
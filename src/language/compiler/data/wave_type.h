@@ -11,4 +11,6 @@ wave_type token_get_wave_type(wave_token token);
 
 wave_type wave_type_get_higher(wave_type type1, wave_type type2);
 
+bool wave_type_is_integer(wave_type type); // whether @type is one of the signed or unsigned integer types
+
 #endif
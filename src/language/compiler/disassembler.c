@@ -125,7 +125,11 @@ error_code wave_disassemble(const wave_vm* vm, wave_disassembler_print_function
     while (bytecode_end - bytecode > 0) {
         opcode = (wave_opcode) GET_BYTE(); NEXT_BYTE();
         switch (opcode) {
-            case OPCODE_CJUMP:
+            case OPCODE_CJUMP: {
+                PRINT_INSTRUCTION(sizeof(i32), "[ 32bit branch_offset = %i ]", GET_I32());
+                NEXT_32();
+                break;
+            }
 
             case OPCODE_CJUMP_8_IF_0:
             case OPCODE_CJUMP_8_IF_1:
@@ -153,6 +157,12 @@ error_code wave_disassemble(const wave_vm* vm, wave_disassembler_print_function
                 break;
             }
 
+            case OPCODE_RETURN: {
+                PRINT_INSTRUCTION(sizeof(u8), "[ 8bit return_size = %u ]", GET_U8());
+                NEXT_8();
+                break;
+            }
+
             case OPCODE_ERR_TRY_START: {
                 PRINT_INSTRUCTION(sizeof(u32), "[ 32bit branch_offset = %u ]", GET_U32());
                 NEXT_32();
@@ -239,6 +249,61 @@ error_code wave_disassemble(const wave_vm* vm, wave_disassembler_print_function
                 break;
             }
 
+            case OPCODE_EXT: {
+                CHECK_OUT_OF_BOUNDS(sizeof(u8));
+
+                wave_opcode_extended extended_opcode = (wave_opcode_extended) GET_BYTE(); NEXT_BYTE();
+                switch (extended_opcode) {
+                    case OPCODE_EXT_ARR_FILL:
+                    case OPCODE_EXT_ARR_FIND:
+                    case OPCODE_EXT_ARR_PUSH: {
+                        CHECK_OUT_OF_BOUNDS(sizeof(u8));
+
+                        wave_type value_type = (wave_type) GET_BYTE(); NEXT_BYTE();
+                        PRINT_FORMAT(OPCODE_FORMAT "%s [ 8bit value_type = %u (%s) ]", OPCODE_ARGUMENTS, (str_format_data) wave_opcode_extended_get_name(extended_opcode), value_type, (str_format_data) wave_type_get_string(value_type));
+                        break;
+                    }
+
+                    case OPCODE_EXT_STORE_KEEP_8:
+                    case OPCODE_EXT_STORE_KEEP_16:
+                    case OPCODE_EXT_STORE_KEEP_32:
+                    case OPCODE_EXT_STORE_KEEP_64: {
+                        CHECK_OUT_OF_BOUNDS(sizeof(u16));
+
+                        PRINT_FORMAT(OPCODE_FORMAT "%s [ 16bit offset = %u ]", OPCODE_ARGUMENTS, (str_format_data) wave_opcode_extended_get_name(extended_opcode), GET_U16());
+                        NEXT_16();
+                        break;
+                    }
+
+                    case OPCODE_EXT_STR_NEW_LOCAL: {
+                        CHECK_OUT_OF_BOUNDS(sizeof(u16) + sizeof(u32));
+
+                        u16 offset = GET_U16(); NEXT_16();
+                        u32 length = GET_U32(); NEXT_32();
+                        CHECK_OUT_OF_BOUNDS(length);
+
+                        PRINT_FORMAT(OPCODE_FORMAT "%s [ 16bit offset = %u | 32bit length = %u | str string_data = \"%*s\" ]", OPCODE_ARGUMENTS, (str_format_data) wave_opcode_extended_get_name(extended_opcode), offset, length, length, (str_format_data) ((str) bytecode));
+                        NEXT_OFFSET(length);
+                        break;
+                    }
+
+                    case OPCODE_EXT_TAIL_CALL: {
+                        CHECK_OUT_OF_BOUNDS(sizeof(u32));
+
+                        PRINT_FORMAT(OPCODE_FORMAT "%s [ 32bit branch_offset = %u ]", OPCODE_ARGUMENTS, (str_format_data) wave_opcode_extended_get_name(extended_opcode), GET_U32());
+                        NEXT_32();
+                        break;
+                    }
+
+                    default: {
+                        PRINT_FORMAT(OPCODE_FORMAT "%s", OPCODE_ARGUMENTS, (str_format_data) wave_opcode_extended_get_name(extended_opcode));
+                        break;
+                    }
+                }
+
+                break;
+            }
+
             case OPCODE_DEBUG: {
                 debug_instruction_type type = (debug_instruction_type) GET_BYTE(); NEXT_BYTE();
                 switch (type) {
@@ -0,0 +1,1375 @@
+#include "ir_optimizer.h"
+
+#include "common/memory/memory.h"
+
+#include "language/wave_common.h"
+
+#include "language/compiler/optimizer.h"
+#include "language/compiler/data/wave_type.h"
+
+// Typedefs
+
+typedef error_code (*ir_optimizer_pass_function)(wave_ir* ir, bool* out_changed);
+
+typedef struct {
+    cstr name;
+
+    ir_analysis required_analyses; // computed before the pass runs, if they are not valid
+    ir_analysis preserved_analyses; // the analyses that stay valid if the pass changed the ir
+
+    ir_optimizer_pass_function run;
+} ir_optimizer_pass;
+
+typedef enum {
+    IR_LATTICE_TOP, // no value seen yet
+    IR_LATTICE_CONSTANT,
+    IR_LATTICE_BOTTOM // not constant
+} IR_LATTICE_STATES;
+typedef byte ir_lattice_state; // @IR_LATTICE_STATES
+
+typedef struct {
+    ir_lattice_state state;
+    union_number value;
+} ir_lattice_value;
+
+typedef struct {
+    wave_ir_block_index header;
+    wave_ir_block_index preheader; // the only predecessor of @header outside of the loop, which jumps to nothing but @header
+    wave_ir_block_index latch; // the only predecessor of @header inside of the loop, @WAVE_IR_NONE if there are several
+
+    bool* blocks; // whether a block belongs to the loop, indexed by block
+} ir_loop;
+
+// Defines
+
+#define IR_OPTIMIZER_IS_UNARY_OPERATION(type) ((type) >= NODE_TYPE_UNARY_OPERATION_PLUS && (type) <= NODE_TYPE_UNARY_OPERATION_NOT)
+
+#define IR_OPTIMIZER_ALLOCATE(pointer, count) /* one element more, so that empty functions do not allocate zero bytes */              \
+    do {                                                                                                                        \
+        (pointer) = NULL;                                                                                                       \
+        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(pointer), sizeof(*(pointer)) * ((count) + 1));                      \
+    } while (0)
+
+#define IR_OPTIMIZER_DEALLOCATE(pointer) do { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) (pointer)); } while (0)
+
+// Functions
+
+// helper
+
+static wave_ir_index ir_optimizer_resolve(const wave_ir_index* replacements, wave_ir_index index) { // follows a chain of replacements to the value that is kept
+    while (index != WAVE_IR_NONE && replacements[index] != WAVE_IR_NONE) {
+        index = replacements[index];
+    }
+
+    return index;
+}
+
+static void ir_optimizer_replace(wave_ir* ir, wave_ir_index* replacements) { // removes the replaced instructions and redirects their uses
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        replacements[i] = ir_optimizer_resolve(replacements, i) == i ? WAVE_IR_NONE : ir_optimizer_resolve(replacements, i);
+    }
+
+    wave_ir_replace_uses(ir, replacements);
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        if (replacements[i] != WAVE_IR_NONE) {
+            wave_ir_remove(ir, i);
+        }
+    }
+}
+
+// copy propagation
+
+static error_code ir_optimizer_propagate_copies(wave_ir* ir, bool* out_changed) { // forwards loads of promoted locals to the stored value and removes phis that merge a single value
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    wave_ir_index* replacements;
+    IR_OPTIMIZER_ALLOCATE(replacements, ir->instruction_count);
+    memory_set_32(replacements, WAVE_IR_NONE, ir->instruction_count);
+
+    bool changed = true;
+    while (changed) { // phis may only become copies once the phis they merge did
+        changed = false;
+
+        for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+            const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+            if (replacements[i] != WAVE_IR_NONE) {
+                continue;
+            }
+
+            wave_ir_index value = WAVE_IR_NONE;
+
+            if (instruction->opcode == IR_OPCODE_LOAD_LOCAL && instruction->variable_data.definition != WAVE_IR_NONE) {
+                value = ir_optimizer_resolve(replacements, instruction->variable_data.definition);
+            } else if (instruction->opcode == IR_OPCODE_PHI) {
+                for (u32 j = 0; j < instruction->operand_count; j++) {
+                    wave_ir_index operand = ir_optimizer_resolve(replacements, WAVE_IR_OPERAND(ir, instruction, j));
+                    if (operand == i || operand == value) {
+                        continue;
+                    } else if (value != WAVE_IR_NONE || operand == WAVE_IR_NONE) { // merges different values
+                        value = WAVE_IR_NONE;
+                        break;
+                    }
+
+                    value = operand;
+                }
+            }
+
+            if (value != WAVE_IR_NONE && value != i) {
+                replacements[i] = value;
+                changed = true;
+                *out_changed = true;
+            }
+        }
+    }
+
+    if (*out_changed) {
+        ir_optimizer_replace(ir, replacements);
+    }
+
+    IR_OPTIMIZER_DEALLOCATE(replacements);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// sparse conditional constant propagation (see Wegman and Zadeck, "Constant Propagation with Conditional Branches")
+
+static bool ir_optimizer_meet(ir_lattice_value* value, ir_lattice_value other) { // lowers @value by @other, returns whether it changed
+    if (other.state == IR_LATTICE_TOP || value->state == IR_LATTICE_BOTTOM) {
+        return false;
+    }
+
+    if (value->state == IR_LATTICE_TOP) {
+        *value = other;
+        return true;
+    } else if (other.state == IR_LATTICE_BOTTOM || value->value.value_u64 != other.value.value_u64) {
+        value->state = IR_LATTICE_BOTTOM;
+        return true;
+    }
+
+    return false;
+}
+
+static ir_lattice_value ir_optimizer_evaluate(const wave_ir* ir, const wave_ir_instruction* instruction, const ir_lattice_value* values, const bool* executable_edges, const u32* edge_offsets) {
+    const ir_lattice_value bottom = (ir_lattice_value) { .state = IR_LATTICE_BOTTOM };
+
+    switch (instruction->opcode) {
+        case IR_OPCODE_CONSTANT: {
+            return (ir_lattice_value) { .state = IR_LATTICE_CONSTANT, .value = instruction->constant_data.value };
+        }
+
+        case IR_OPCODE_OPERATION: {
+            const u32 operand_count = IR_OPTIMIZER_IS_UNARY_OPERATION(instruction->operation) ? 1 : 2;
+            if (instruction->operand_count < operand_count) {
+                return bottom;
+            }
+
+            ir_lattice_value operands[2];
+            for (u32 i = 0; i < operand_count; i++) {
+                wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, i);
+                operands[i] = operand == WAVE_IR_NONE ? bottom : values[operand];
+            }
+
+            operands[1] = operands[operand_count - 1];
+
+            if (operands[0].state == IR_LATTICE_BOTTOM || operands[1].state == IR_LATTICE_BOTTOM) {
+                return bottom;
+            } else if (operands[0].state == IR_LATTICE_TOP || operands[1].state == IR_LATTICE_TOP) {
+                return (ir_lattice_value) { .state = IR_LATTICE_TOP };
+            }
+
+            ir_lattice_value result = (ir_lattice_value) { .state = IR_LATTICE_CONSTANT };
+            return wave_optimizer_evaluate(instruction->operation, instruction->value_type, operands[0].value, operands[1].value, &result.value) ? result : bottom;
+        }
+
+        case IR_OPCODE_CONVERSION: {
+            wave_ir_index operand = instruction->operand_count != 0 ? WAVE_IR_OPERAND(ir, instruction, 0) : WAVE_IR_NONE;
+            if (operand == WAVE_IR_NONE || values[operand].state != IR_LATTICE_CONSTANT) {
+                return operand == WAVE_IR_NONE ? bottom : values[operand];
+            }
+
+            ir_lattice_value result = (ir_lattice_value) { .state = IR_LATTICE_CONSTANT };
+            return wave_optimizer_convert(instruction->conversion_data.from_type, instruction->value_type, values[operand].value, &result.value) ? result : bottom;
+        }
+
+        case IR_OPCODE_LOAD_LOCAL: { // the value of the last store
+            return instruction->variable_data.definition != WAVE_IR_NONE ? values[instruction->variable_data.definition] : bottom;
+        }
+
+        case IR_OPCODE_PHI: { // only the values flowing in over executable edges count
+            ir_lattice_value result = (ir_lattice_value) { .state = IR_LATTICE_TOP };
+
+            for (u32 i = 0; i < instruction->operand_count; i++) {
+                if (!executable_edges[edge_offsets[instruction->block] + i]) {
+                    continue;
+                }
+
+                wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, i);
+                ir_optimizer_meet(&result, operand == WAVE_IR_NONE ? bottom : values[operand]);
+            }
+
+            return result;
+        }
+
+        default: {
+            return bottom;
+        }
+    }
+}
+
+static bool ir_optimizer_mark_edge(const wave_ir* ir, wave_ir_block_index from, wave_ir_block_index to, bool* executable_blocks, bool* executable_edges, const u32* edge_offsets) {
+    bool changed = !executable_blocks[to];
+    executable_blocks[to] = true;
+
+    for (u32 i = 0; i < ir->blocks[to].predecessor_count; i++) {
+        if (ir->blocks[to].predecessors[i] == from && !executable_edges[edge_offsets[to] + i]) {
+            executable_edges[edge_offsets[to] + i] = true;
+            changed = true;
+        }
+    }
+
+    return changed;
+}
+
+static wave_ir_block_index ir_optimizer_get_switch_target(const wave_ir* ir, const wave_ir_instruction* instruction, u64 value) { // the target a switch takes for @value
+    const u64* values = WAVE_IR_SWITCH_VALUES(ir, instruction);
+
+    u32 low = 0;
+    u32 high = instruction->switch_data.case_count;
+    while (low < high) { // binary search, the values are sorted
+        u32 middle = low + (high - low) / 2;
+        if (values[middle] < value) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+
+    return WAVE_IR_SWITCH_TARGETS(ir, instruction)[low < instruction->switch_data.case_count && values[low] == value ? low + 1 : 0];
+}
+
+static error_code ir_optimizer_propagate_constants(wave_ir* ir, bool* out_changed) {
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    ir_lattice_value* values;
+    bool* executable_blocks;
+    u32* edge_offsets; // the index of the first incoming edge of every block in @executable_edges
+
+    IR_OPTIMIZER_ALLOCATE(values, ir->instruction_count);
+    IR_OPTIMIZER_ALLOCATE(executable_blocks, ir->block_count);
+    IR_OPTIMIZER_ALLOCATE(edge_offsets, ir->block_count);
+
+    u32 edge_count = 0;
+    for (u32 i = 0; i < ir->block_count; i++) {
+        edge_offsets[i] = edge_count;
+        edge_count += ir->blocks[i].predecessor_count;
+        executable_blocks[i] = false;
+    }
+
+    bool* executable_edges;
+    IR_OPTIMIZER_ALLOCATE(executable_edges, edge_count);
+    memory_clear(executable_edges, sizeof(bool) * edge_count);
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        values[i] = (ir_lattice_value) { .state = IR_LATTICE_TOP };
+    }
+
+    // evaluate the executable blocks in reverse post order until no value changes, every value can only be lowered twice
+
+    executable_blocks[0] = true;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (u32 i = 0; i < ir->order_count; i++) {
+            wave_ir_block_index block = ir->order[i];
+            if (!executable_blocks[block]) {
+                continue;
+            }
+
+            for (wave_ir_index j = ir->blocks[block].first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+                const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+
+                if (instruction->opcode == IR_OPCODE_JUMP) {
+                    changed |= ir_optimizer_mark_edge(ir, block, instruction->branch_data.targets[0], executable_blocks, executable_edges, edge_offsets);
+                } else if (instruction->opcode == IR_OPCODE_BRANCH) {
+                    wave_ir_index condition = WAVE_IR_OPERAND(ir, instruction, 0);
+                    ir_lattice_value value = condition == WAVE_IR_NONE ? (ir_lattice_value) { .state = IR_LATTICE_BOTTOM } : values[condition];
+
+                    if (value.state == IR_LATTICE_BOTTOM || (value.state == IR_LATTICE_CONSTANT && value.value.value_u64 != 0)) {
+                        changed |= ir_optimizer_mark_edge(ir, block, instruction->branch_data.targets[0], executable_blocks, executable_edges, edge_offsets);
+                    }
+
+                    if (value.state == IR_LATTICE_BOTTOM || (value.state == IR_LATTICE_CONSTANT && value.value.value_u64 == 0)) {
+                        changed |= ir_optimizer_mark_edge(ir, block, instruction->branch_data.targets[1], executable_blocks, executable_edges, edge_offsets);
+                    }
+                } else if (instruction->opcode == IR_OPCODE_SWITCH) {
+                    wave_ir_index condition = WAVE_IR_OPERAND(ir, instruction, 0);
+                    ir_lattice_value value = condition == WAVE_IR_NONE ? (ir_lattice_value) { .state = IR_LATTICE_BOTTOM } : values[condition];
+
+                    if (value.state == IR_LATTICE_CONSTANT) {
+                        changed |= ir_optimizer_mark_edge(ir, block, ir_optimizer_get_switch_target(ir, instruction, value.value.value_u64), executable_blocks, executable_edges, edge_offsets);
+                    } else if (value.state == IR_LATTICE_BOTTOM) {
+                        for (u32 k = 0; k <= instruction->switch_data.case_count; k++) {
+                            changed |= ir_optimizer_mark_edge(ir, block, WAVE_IR_SWITCH_TARGETS(ir, instruction)[k], executable_blocks, executable_edges, edge_offsets);
+                        }
+                    }
+                } else if (instruction->value_type != WAVE_TYPE_NONE) {
+                    changed |= ir_optimizer_meet(&values[j], ir_optimizer_evaluate(ir, instruction, values, executable_edges, edge_offsets));
+                }
+            }
+        }
+    }
+
+    // replace the constant values, the untaken branches and the blocks that are never executed
+
+    for (u32 i = 0; i < ir->block_count; i++) {
+        wave_ir_block* block = WAVE_IR_BLOCK(ir, i);
+        if (block->removed || !executable_blocks[i]) {
+            continue;
+        }
+
+        for (wave_ir_index j = block->first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+            wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+
+            if (values[j].state == IR_LATTICE_CONSTANT && instruction->opcode != IR_OPCODE_CONSTANT && !wave_ir_has_side_effects(instruction)) {
+                instruction->opcode = IR_OPCODE_CONSTANT;
+                instruction->operand_count = 0;
+                instruction->constant_data.value = values[j].value;
+
+                *out_changed = true;
+            } else if (instruction->opcode == IR_OPCODE_BRANCH && WAVE_IR_OPERAND(ir, instruction, 0) != WAVE_IR_NONE && values[WAVE_IR_OPERAND(ir, instruction, 0)].state == IR_LATTICE_CONSTANT) {
+                bool taken = values[WAVE_IR_OPERAND(ir, instruction, 0)].value.value_u64 != 0;
+
+                wave_ir_block_index target = instruction->branch_data.targets[taken ? 0 : 1];
+                wave_ir_block_index untaken_target = instruction->branch_data.targets[taken ? 1 : 0];
+
+                instruction->opcode = IR_OPCODE_JUMP;
+                instruction->operand_count = 0;
+                instruction->branch_data.targets[0] = target;
+
+                if (untaken_target != target) {
+                    wave_ir_remove_edge(ir, i, untaken_target);
+                }
+
+                *out_changed = true;
+            } else if (instruction->opcode == IR_OPCODE_SWITCH && WAVE_IR_OPERAND(ir, instruction, 0) != WAVE_IR_NONE && values[WAVE_IR_OPERAND(ir, instruction, 0)].state == IR_LATTICE_CONSTANT) {
+                wave_ir_block_index target = ir_optimizer_get_switch_target(ir, instruction, values[WAVE_IR_OPERAND(ir, instruction, 0)].value.value_u64);
+
+                // every edge is removed once for each time its target appears, except for a single one to the taken target
+
+                bool kept_edge = false;
+                for (u32 k = 0; k <= instruction->switch_data.case_count; k++) {
+                    wave_ir_block_index successor = WAVE_IR_SWITCH_TARGETS(ir, instruction)[k];
+                    if (successor == target && !kept_edge) {
+                        kept_edge = true;
+                    } else {
+                        wave_ir_remove_edge(ir, i, successor);
+                    }
+                }
+
+                instruction->opcode = IR_OPCODE_JUMP;
+                instruction->operand_count = 0;
+                instruction->branch_data.targets[0] = target;
+                instruction->branch_data.targets[1] = WAVE_IR_NONE;
+
+                *out_changed = true;
+            }
+        }
+    }
+
+    for (u32 i = 0; i < ir->block_count; i++) {
+        wave_ir_block* block = WAVE_IR_BLOCK(ir, i);
+        if (block->removed || executable_blocks[i]) {
+            continue;
+        }
+
+        const wave_ir_block_index* successors = NULL;
+        u32 successor_count = wave_ir_get_successors(ir, i, &successors);
+        for (u32 j = 0; j < successor_count; j++) {
+            wave_ir_remove_edge(ir, i, successors[j]);
+        }
+
+        while (block->first_instruction != WAVE_IR_NONE) {
+            wave_ir_remove(ir, block->first_instruction);
+        }
+
+        block->removed = true;
+        *out_changed = true;
+    }
+
+    IR_OPTIMIZER_DEALLOCATE(values);
+    IR_OPTIMIZER_DEALLOCATE(executable_blocks);
+    IR_OPTIMIZER_DEALLOCATE(edge_offsets);
+    IR_OPTIMIZER_DEALLOCATE(executable_edges);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// type conversions
+
+static bool ir_optimizer_is_exact_conversion(wave_type from_type, wave_type to_type) { // whether every value of @from_type is kept by the conversion, so that it can be converted back
+    const bool from_signed = from_type >= WAVE_TYPE_I8 && from_type <= WAVE_TYPE_I64;
+    const bool to_signed = to_type >= WAVE_TYPE_I8 && to_type <= WAVE_TYPE_I64;
+
+    if (wave_type_is_integer(from_type) && wave_type_is_integer(to_type)) {
+        return wave_type_get_size(to_type) > wave_type_get_size(from_type) && (to_signed || !from_signed);
+    } else if (to_type == WAVE_TYPE_F64) { // 53 bits of mantissa
+        return from_type == WAVE_TYPE_F32 || (wave_type_is_integer(from_type) && wave_type_get_size(from_type) <= sizeof(u32));
+    } else if (to_type == WAVE_TYPE_F32) { // 24 bits of mantissa
+        return wave_type_is_integer(from_type) && wave_type_get_size(from_type) <= sizeof(u16);
+    }
+
+    return false;
+}
+
+static bool ir_optimizer_is_truncated(node_type operation) { // whether the low bits of the result only depend on the low bits of the operands
+    switch (operation) {
+        case NODE_TYPE_UNARY_OPERATION_MINUS:
+        case NODE_TYPE_UNARY_OPERATION_BIT_NOT:
+
+        case NODE_TYPE_BINARY_OPERATION_ADD:
+        case NODE_TYPE_BINARY_OPERATION_SUB:
+        case NODE_TYPE_BINARY_OPERATION_MUL:
+
+        case NODE_TYPE_BINARY_OPERATION_BIT_AND:
+        case NODE_TYPE_BINARY_OPERATION_BIT_OR:
+        case NODE_TYPE_BINARY_OPERATION_BIT_XOR: {
+            return true;
+        }
+
+        default: {
+            return false;
+        }
+    }
+}
+
+static bool ir_optimizer_is_narrow(const wave_ir* ir, wave_ir_index value, wave_type type) { // whether converting @value to the integer @type folds away
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, value);
+
+    return instruction->opcode == IR_OPCODE_CONSTANT || (instruction->opcode == IR_OPCODE_CONVERSION && wave_type_is_integer(instruction->conversion_data.from_type) &&
+           wave_type_get_size(instruction->conversion_data.from_type) <= wave_type_get_size(type));
+}
+
+static bool ir_optimizer_fold_conversion(const wave_ir* ir, wave_ir_index index, wave_ir_index* replacements) { // folds the conversion into its operand, returns whether it changed
+    wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+
+    const wave_ir_index operand = ir_optimizer_resolve(replacements, WAVE_IR_OPERAND(ir, instruction, 0));
+    const wave_ir_instruction* operand_instruction = WAVE_IR_INSTRUCTION(ir, operand);
+
+    const wave_type from_type = instruction->conversion_data.from_type;
+    const wave_type to_type = instruction->value_type;
+
+    union_number value;
+
+    if (from_type == to_type) {
+        replacements[index] = operand;
+    } else if (operand_instruction->opcode == IR_OPCODE_CONSTANT && wave_optimizer_convert(from_type, to_type, operand_instruction->constant_data.value, &value)) {
+        instruction->opcode = IR_OPCODE_CONSTANT;
+        instruction->operand_count = 0;
+        instruction->constant_data.value = value;
+    } else if (operand_instruction->opcode == IR_OPCODE_CONVERSION && operand_instruction->operand_count != 0 && WAVE_IR_OPERAND(ir, operand_instruction, 0) != WAVE_IR_NONE) {
+        const wave_type original_type = operand_instruction->conversion_data.from_type;
+
+        // a conversion that keeps every value can be skipped, as well as an integer one whose bits are truncated afterwards anyway
+
+        const bool truncated = wave_type_is_integer(original_type) && wave_type_is_integer(from_type) && wave_type_is_integer(to_type) &&
+                               wave_type_get_size(to_type) <= wave_type_get_size(from_type);
+
+        if (!truncated && !ir_optimizer_is_exact_conversion(original_type, from_type)) {
+            return false;
+        }
+
+        WAVE_IR_OPERAND(ir, instruction, 0) = WAVE_IR_OPERAND(ir, operand_instruction, 0);
+        instruction->conversion_data.from_type = original_type;
+
+        if (original_type == to_type) {
+            replacements[index] = WAVE_IR_OPERAND(ir, instruction, 0);
+        }
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+static error_code ir_optimizer_narrow_conversion(wave_ir* ir, wave_ir_index index, bool* out_changed) { // computes an integer operation that is truncated right away in the narrower type
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+
+    const wave_ir_index operation = WAVE_IR_OPERAND(ir, instruction, 0);
+    const wave_ir_instruction* operation_instruction = WAVE_IR_INSTRUCTION(ir, operation);
+
+    const wave_type from_type = instruction->conversion_data.from_type;
+    const wave_type to_type = instruction->value_type;
+
+    if (operation_instruction->opcode != IR_OPCODE_OPERATION || operation_instruction->value_type != from_type || ir->use_counts[operation] != 1 || !ir_optimizer_is_truncated(operation_instruction->operation) ||
+        !wave_type_is_integer(from_type) || !wave_type_is_integer(to_type) || wave_type_get_size(to_type) >= wave_type_get_size(from_type)) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    // only worth it if the conversion of an operand folds away, so that no more conversions are executed than before
+
+    const u32 operand_count = IR_OPTIMIZER_IS_UNARY_OPERATION(operation_instruction->operation) ? 1 : 2;
+    if (operation_instruction->operand_count < operand_count) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    bool narrow = false;
+    wave_ir_index operands[2];
+
+    for (u32 i = 0; i < operand_count; i++) {
+        operands[i] = WAVE_IR_OPERAND(ir, operation_instruction, i);
+        if (operands[i] == WAVE_IR_NONE) {
+            return ERROR_CODE_EXECUTION_SUCCESSFUL;
+        }
+
+        narrow |= ir_optimizer_is_narrow(ir, operands[i], to_type);
+    }
+
+    if (!narrow) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    // the operands are converted in front of the conversion, which is left converting the narrow operation to its own type
+
+    const wave_ir_instruction operation_copy = *operation_instruction;
+    const wave_ir_block_index block = instruction->block;
+    const u32 source_offset = instruction->source_offset;
+
+    for (u32 i = 0; i < operand_count; i++) {
+        wave_ir_instruction conversion = (wave_ir_instruction) { .opcode = IR_OPCODE_CONVERSION, .value_type = to_type, .source_offset = source_offset, .conversion_data.from_type = from_type };
+        RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, conversion, &operands[i], 1, block, index, &operands[i]);
+    }
+
+    wave_ir_index narrow_operation;
+    wave_ir_instruction narrow_instruction = (wave_ir_instruction) { .opcode = IR_OPCODE_OPERATION, .operation = operation_copy.operation, .value_type = to_type, .source_offset = operation_copy.source_offset };
+    RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, narrow_instruction, operands, operand_count, block, index, &narrow_operation);
+
+    wave_ir_instruction* conversion = WAVE_IR_INSTRUCTION(ir, index); // inserting may move the instructions
+    WAVE_IR_OPERAND(ir, conversion, 0) = narrow_operation;
+    conversion->conversion_data.from_type = to_type;
+
+    *out_changed = true;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code ir_optimizer_simplify_conversions(wave_ir* ir, bool* out_changed) { // removes conversions that are undone or cancel out and narrows integer operations that are truncated
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    bool narrowed = true;
+    while (narrowed) { // the conversions of the narrowed operands may fold or be narrowed themselves
+        narrowed = false;
+
+        // fold the conversions until none changes, nothing is inserted while folding
+
+        wave_ir_index* replacements;
+        IR_OPTIMIZER_ALLOCATE(replacements, ir->instruction_count);
+        memory_set_32(replacements, WAVE_IR_NONE, ir->instruction_count);
+
+        bool folded = false;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+
+            for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+                const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+                if (instruction->opcode == IR_OPCODE_CONVERSION && replacements[i] == WAVE_IR_NONE && instruction->operand_count != 0 && WAVE_IR_OPERAND(ir, instruction, 0) != WAVE_IR_NONE) {
+                    changed |= ir_optimizer_fold_conversion(ir, i, replacements);
+                }
+            }
+
+            folded |= changed;
+        }
+
+        if (folded) {
+            ir_optimizer_replace(ir, replacements);
+            *out_changed = true;
+        }
+
+        IR_OPTIMIZER_DEALLOCATE(replacements);
+
+        // narrow the operations, which leaves conversions to the same type behind for the next round
+
+        if ((ir->valid_analyses & IR_ANALYSIS_USES) == 0) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_compute_uses, ir);
+        }
+
+        for (u32 i = 0; i < ir->order_count; i++) {
+            for (wave_ir_index j = ir->blocks[ir->order[i]].first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+                const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+                if (instruction->opcode == IR_OPCODE_CONVERSION && instruction->operand_count != 0 && WAVE_IR_OPERAND(ir, instruction, 0) != WAVE_IR_NONE) {
+                    RUN_ERROR_CODE_FUNCTION(ir_optimizer_narrow_conversion, ir, j, &narrowed);
+                }
+            }
+        }
+
+        if (narrowed) {
+            ir->valid_analyses &= ~IR_ANALYSIS_USES;
+            *out_changed = true;
+        }
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// global value numbering
+
+static bool ir_optimizer_is_commutative(node_type operation) {
+    switch (operation) {
+        case NODE_TYPE_BINARY_OPERATION_ADD:
+        case NODE_TYPE_BINARY_OPERATION_MUL:
+
+        case NODE_TYPE_BINARY_OPERATION_EQUAL:
+        case NODE_TYPE_BINARY_OPERATION_UNEQUAL:
+        case NODE_TYPE_BINARY_OPERATION_AND:
+        case NODE_TYPE_BINARY_OPERATION_OR:
+
+        case NODE_TYPE_BINARY_OPERATION_BIT_AND:
+        case NODE_TYPE_BINARY_OPERATION_BIT_OR:
+        case NODE_TYPE_BINARY_OPERATION_BIT_XOR: {
+            return true;
+        }
+
+        default: {
+            return false;
+        }
+    }
+}
+
+static bool ir_optimizer_is_numbered(const wave_ir_instruction* instruction) { // values that only depend on their operands
+    return instruction->opcode == IR_OPCODE_CONSTANT || instruction->opcode == IR_OPCODE_OPERATION || instruction->opcode == IR_OPCODE_CONVERSION;
+}
+
+static void ir_optimizer_get_operands(const wave_ir* ir, const wave_ir_instruction* instruction, wave_ir_index out_operands[2]) { // in a canonical order
+    out_operands[0] = instruction->operand_count > 0 ? WAVE_IR_OPERAND(ir, instruction, 0) : WAVE_IR_NONE;
+    out_operands[1] = instruction->operand_count > 1 ? WAVE_IR_OPERAND(ir, instruction, 1) : WAVE_IR_NONE;
+
+    if (instruction->opcode == IR_OPCODE_OPERATION && ir_optimizer_is_commutative(instruction->operation) && out_operands[0] > out_operands[1]) {
+        wave_ir_index operand = out_operands[0];
+        out_operands[0] = out_operands[1];
+        out_operands[1] = operand;
+    }
+}
+
+static u64 ir_optimizer_hash(const wave_ir* ir, const wave_ir_instruction* instruction) {
+    wave_ir_index operands[2];
+    ir_optimizer_get_operands(ir, instruction, operands);
+
+    u64 hash = ((u64) instruction->opcode << 56) ^ ((u64) instruction->operation << 48) ^ ((u64) instruction->value_type << 40);
+    hash ^= instruction->opcode == IR_OPCODE_CONSTANT ? instruction->constant_data.value.value_u64 : ((u64) operands[0] << 32 | operands[1]);
+    hash ^= instruction->opcode == IR_OPCODE_CONVERSION ? instruction->conversion_data.from_type : 0;
+
+    hash ^= hash >> 33; // mixes the high bits into the ones used for the index
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+
+    return hash;
+}
+
+static bool ir_optimizer_is_equal(const wave_ir* ir, const wave_ir_instruction* instruction1, const wave_ir_instruction* instruction2) {
+    if (instruction1->opcode != instruction2->opcode || instruction1->value_type != instruction2->value_type || instruction1->operand_count != instruction2->operand_count) {
+        return false;
+    }
+
+    switch (instruction1->opcode) {
+        case IR_OPCODE_CONSTANT: {
+            return instruction1->constant_data.value.value_u64 == instruction2->constant_data.value.value_u64;
+        }
+
+        case IR_OPCODE_OPERATION: {
+            if (instruction1->operation != instruction2->operation) {
+                return false;
+            }
+
+            break;
+        }
+
+        case IR_OPCODE_CONVERSION: {
+            if (instruction1->conversion_data.from_type != instruction2->conversion_data.from_type) {
+                return false;
+            }
+
+            break;
+        }
+
+        default: {
+            return false;
+        }
+    }
+
+    wave_ir_index operands1[2];
+    wave_ir_index operands2[2];
+    ir_optimizer_get_operands(ir, instruction1, operands1);
+    ir_optimizer_get_operands(ir, instruction2, operands2);
+
+    return operands1[0] == operands2[0] && operands1[1] == operands2[1] && operands1[0] != WAVE_IR_NONE;
+}
+
+static error_code ir_optimizer_number_values(wave_ir* ir, bool* out_changed) { // replaces values computed before in a dominating block
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    u32 table_capacity = 16;
+    while (table_capacity < ir->instruction_count * 2) {
+        table_capacity *= 2;
+    }
+
+    wave_ir_index* table; // open addressing, values with the same number that do not dominate each other share the table
+    wave_ir_index* replacements;
+
+    IR_OPTIMIZER_ALLOCATE(table, table_capacity);
+    IR_OPTIMIZER_ALLOCATE(replacements, ir->instruction_count);
+    memory_set_32(table, WAVE_IR_NONE, table_capacity);
+    memory_set_32(replacements, WAVE_IR_NONE, ir->instruction_count);
+
+    for (u32 i = 0; i < ir->order_count; i++) { // dominators come first in reverse post order
+        wave_ir_block_index block = ir->order[i];
+
+        for (wave_ir_index j = ir->blocks[block].first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+            wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+
+            for (u32 k = 0; k < instruction->operand_count; k++) { // so that values using replaced operands get the same number
+                wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, k);
+                if (operand != WAVE_IR_NONE && replacements[operand] != WAVE_IR_NONE) {
+                    WAVE_IR_OPERAND(ir, instruction, k) = replacements[operand];
+                }
+            }
+
+            if (!ir_optimizer_is_numbered(instruction)) {
+                continue;
+            }
+
+            u32 slot = (u32) ir_optimizer_hash(ir, instruction) & (table_capacity - 1);
+            while (table[slot] != WAVE_IR_NONE) {
+                const wave_ir_instruction* leader = WAVE_IR_INSTRUCTION(ir, table[slot]);
+                if (ir_optimizer_is_equal(ir, leader, instruction) && wave_ir_dominates(ir, leader->block, block)) {
+                    break;
+                }
+
+                slot = (slot + 1) & (table_capacity - 1);
+            }
+
+            if (table[slot] != WAVE_IR_NONE) {
+                replacements[j] = table[slot];
+                *out_changed = true;
+            } else {
+                table[slot] = j;
+            }
+        }
+    }
+
+    if (*out_changed) {
+        ir_optimizer_replace(ir, replacements);
+    }
+
+    IR_OPTIMIZER_DEALLOCATE(table);
+    IR_OPTIMIZER_DEALLOCATE(replacements);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// dead code elimination
+
+static void ir_optimizer_mark_live(const wave_ir* ir, wave_ir_index index, bool* live, wave_ir_index* worklist) { // marks @index and the values it depends on
+    if (live[index]) {
+        return;
+    }
+
+    live[index] = true;
+
+    u32 worklist_count = 1;
+    worklist[0] = index;
+
+    while (worklist_count > 0) {
+        worklist_count--;
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, worklist[worklist_count]);
+
+        for (u32 i = 0; i < instruction->operand_count; i++) {
+            wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, i);
+            if (operand != WAVE_IR_NONE && !live[operand]) {
+                live[operand] = true;
+                worklist[worklist_count] = operand;
+                worklist_count++;
+            }
+        }
+    }
+}
+
+static error_code ir_optimizer_eliminate_dead_code(wave_ir* ir, bool* out_changed) {
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    bool* live;
+    bool* consumed; // whether a live instruction uses the value
+    bool* loaded_variables;
+    wave_ir_index* worklist;
+
+    IR_OPTIMIZER_ALLOCATE(live, ir->instruction_count);
+    IR_OPTIMIZER_ALLOCATE(consumed, ir->instruction_count);
+    IR_OPTIMIZER_ALLOCATE(loaded_variables, ir->variable_count);
+    IR_OPTIMIZER_ALLOCATE(worklist, ir->instruction_count);
+
+    memory_clear(live, sizeof(bool) * ir->instruction_count);
+
+    // stores of promoted locals are only kept while a load may read them
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        if (!wave_ir_has_side_effects(instruction) || (instruction->opcode == IR_OPCODE_STORE_LOCAL && ir->variables[instruction->variable_data.variable].promotable)) {
+            continue;
+        }
+
+        ir_optimizer_mark_live(ir, i, live, worklist);
+    }
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        memory_clear(consumed, sizeof(bool) * ir->instruction_count);
+        memory_clear(loaded_variables, sizeof(bool) * ir->variable_count);
+
+        for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+            const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+            if (!live[i]) {
+                continue;
+            }
+
+            for (u32 j = 0; j < instruction->operand_count; j++) {
+                if (WAVE_IR_OPERAND(ir, instruction, j) != WAVE_IR_NONE) {
+                    consumed[WAVE_IR_OPERAND(ir, instruction, j)] = true;
+                }
+            }
+
+            if (instruction->opcode == IR_OPCODE_LOAD_LOCAL) {
+                loaded_variables[instruction->variable_data.variable] = true;
+            }
+        }
+
+        // a value that is kept for its side effects still needs an instruction consuming it off the stack, so one of its former users is kept as well
+
+        for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+            const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+            if (live[i] || instruction->opcode == IR_OPCODE_NONE) {
+                continue;
+            }
+
+            bool keep = instruction->opcode == IR_OPCODE_STORE_LOCAL && loaded_variables[instruction->variable_data.variable];
+            for (u32 j = 0; j < instruction->operand_count && !keep; j++) {
+                wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, j);
+                keep = operand != WAVE_IR_NONE && live[operand] && !consumed[operand];
+            }
+
+            if (keep) {
+                ir_optimizer_mark_live(ir, i, live, worklist);
+                changed = true;
+            }
+        }
+    }
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        if (!live[i] && WAVE_IR_INSTRUCTION(ir, i)->opcode != IR_OPCODE_NONE) {
+            wave_ir_remove(ir, i);
+            *out_changed = true;
+        }
+    }
+
+    IR_OPTIMIZER_DEALLOCATE(live);
+    IR_OPTIMIZER_DEALLOCATE(consumed);
+    IR_OPTIMIZER_DEALLOCATE(loaded_variables);
+    IR_OPTIMIZER_DEALLOCATE(worklist);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// loop optimizations
+
+static bool ir_optimizer_find_loop(const wave_ir* ir, wave_ir_block_index header, wave_ir_block_index* worklist, ir_loop* loop) { // the natural loop of the back edges to @header, false if there are none or it has no preheader
+    const wave_ir_block* header_block = WAVE_IR_BLOCK(ir, header);
+
+    loop->header = header;
+    loop->preheader = WAVE_IR_NONE;
+    loop->latch = WAVE_IR_NONE;
+
+    memory_clear(loop->blocks, sizeof(bool) * ir->block_count);
+    loop->blocks[header] = true;
+
+    // the blocks reaching a back edge without passing the header, the header dominates every one of them
+
+    u32 worklist_count = 0;
+    u32 latch_count = 0;
+
+    for (u32 i = 0; i < header_block->predecessor_count; i++) {
+        wave_ir_block_index predecessor = header_block->predecessors[i];
+        if (ir->blocks[predecessor].order_index == U32_MAX || !wave_ir_dominates(ir, header, predecessor)) {
+            continue;
+        }
+
+        loop->latch = predecessor;
+        latch_count++;
+
+        if (!loop->blocks[predecessor]) {
+            loop->blocks[predecessor] = true;
+            worklist[worklist_count] = predecessor;
+            worklist_count++;
+        }
+    }
+
+    if (latch_count == 0) {
+        return false;
+    } else if (latch_count > 1) {
+        loop->latch = WAVE_IR_NONE;
+    }
+
+    while (worklist_count > 0) {
+        worklist_count--;
+        const wave_ir_block* block = WAVE_IR_BLOCK(ir, worklist[worklist_count]);
+
+        for (u32 i = 0; i < block->predecessor_count; i++) {
+            wave_ir_block_index predecessor = block->predecessors[i];
+            if (loop->blocks[predecessor] || ir->blocks[predecessor].order_index == U32_MAX) {
+                continue;
+            }
+
+            loop->blocks[predecessor] = true;
+            worklist[worklist_count] = predecessor;
+            worklist_count++;
+        }
+    }
+
+    // instructions are moved in front of the jump of the preheader, so it must not branch anywhere else
+
+    for (u32 i = 0; i < header_block->predecessor_count; i++) {
+        wave_ir_block_index predecessor = header_block->predecessors[i];
+        if (loop->blocks[predecessor]) {
+            continue;
+        } else if (loop->preheader != WAVE_IR_NONE) {
+            return false;
+        }
+
+        loop->preheader = predecessor;
+    }
+
+    wave_ir_index terminator = loop->preheader != WAVE_IR_NONE ? wave_ir_get_terminator(ir, loop->preheader) : WAVE_IR_NONE;
+    return terminator != WAVE_IR_NONE && WAVE_IR_INSTRUCTION(ir, terminator)->opcode == IR_OPCODE_JUMP;
+}
+
+static bool ir_optimizer_writes_variable(const wave_ir* ir, const ir_loop* loop, const wave_ir_instruction* load) { // whether the local or global read by @load may be written inside of the loop
+    const bool global = load->opcode == IR_OPCODE_LOAD_GLOBAL;
+    const ir_opcode store_opcode = global ? IR_OPCODE_STORE_GLOBAL : IR_OPCODE_STORE_LOCAL;
+
+    const u32 load_start = load->variable_data.offset;
+    const u32 load_end = load_start + wave_type_get_size(load->variable_data.type);
+
+    for (u32 i = 0; i < ir->order_count; i++) {
+        if (!loop->blocks[ir->order[i]]) {
+            continue;
+        }
+
+        for (wave_ir_index j = ir->blocks[ir->order[i]].first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+            const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+
+            if (instruction->opcode == IR_OPCODE_CALL && global) { // the callee may write any global, but not the stack frame of the caller
+                return true;
+            } else if (instruction->opcode == store_opcode) {
+                const u32 store_start = instruction->variable_data.offset;
+                const u32 store_end = store_start + wave_type_get_size(instruction->variable_data.type);
+
+                if (store_start < load_end && load_start < store_end) {
+                    return true;
+                }
+            }
+        }
+    }
+
+    return false;
+}
+
+static bool ir_optimizer_is_invariant(const wave_ir* ir, const ir_loop* loop, const wave_ir_instruction* instruction) { // whether the instruction computes the same value in every iteration and may be executed before the loop
+    switch (instruction->opcode) {
+        case IR_OPCODE_CONVERSION: {
+            break;
+        }
+
+        case IR_OPCODE_OPERATION: { // an integer division is only moved if it cannot raise an error the loop would not have raised
+            const node_type operation = instruction->operation;
+
+            if ((operation == NODE_TYPE_BINARY_OPERATION_DIV || operation == NODE_TYPE_BINARY_OPERATION_MOD) && wave_type_is_integer(instruction->value_type)) {
+                const wave_ir_instruction* divisor = instruction->operand_count == 2 && WAVE_IR_OPERAND(ir, instruction, 1) != WAVE_IR_NONE ? WAVE_IR_INSTRUCTION(ir, WAVE_IR_OPERAND(ir, instruction, 1)) : NULL;
+                if (divisor == NULL || divisor->opcode != IR_OPCODE_CONSTANT || divisor->constant_data.value.value_u64 == 0) {
+                    return false;
+                }
+            }
+
+            break;
+        }
+
+        case IR_OPCODE_LOAD_LOCAL:
+        case IR_OPCODE_LOAD_GLOBAL: {
+            return !ir_optimizer_writes_variable(ir, loop, instruction);
+        }
+
+        default: { // constants are pushed by their users anyway
+            return false;
+        }
+    }
+
+    for (u32 i = 0; i < instruction->operand_count; i++) {
+        wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, i);
+        if (operand == WAVE_IR_NONE || (loop->blocks[WAVE_IR_INSTRUCTION(ir, operand)->block] && WAVE_IR_INSTRUCTION(ir, operand)->opcode != IR_OPCODE_CONSTANT)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static error_code ir_optimizer_move_invariants(wave_ir* ir, bool* out_changed) { // moves the values that do not change inside of a loop in front of it
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    ir_loop loop;
+    wave_ir_block_index* worklist;
+
+    IR_OPTIMIZER_ALLOCATE(loop.blocks, ir->block_count);
+    IR_OPTIMIZER_ALLOCATE(worklist, ir->block_count);
+
+    // inner loops come after the loops containing them in reverse post order, values moved out of them may be moved further
+
+    for (u32 i = ir->order_count; i > 0; i--) {
+        if (!ir_optimizer_find_loop(ir, ir->order[i - 1], worklist, &loop)) {
+            continue;
+        }
+
+        const wave_ir_index jump = wave_ir_get_terminator(ir, loop.preheader);
+
+        for (u32 j = i - 1; j < ir->order_count; j++) { // operands are defined before their users in reverse post order
+            if (!loop.blocks[ir->order[j]]) {
+                continue;
+            }
+
+            wave_ir_index next = WAVE_IR_NONE;
+            for (wave_ir_index k = ir->blocks[ir->order[j]].first_instruction; k != WAVE_IR_NONE; k = next) {
+                next = WAVE_IR_INSTRUCTION(ir, k)->next;
+
+                if (ir_optimizer_is_invariant(ir, &loop, WAVE_IR_INSTRUCTION(ir, k))) {
+                    for (u32 l = 0; l < WAVE_IR_INSTRUCTION(ir, k)->operand_count; l++) { // constant operands move along, so that every operand still dominates its user
+                        wave_ir_index operand = WAVE_IR_OPERAND(ir, WAVE_IR_INSTRUCTION(ir, k), l);
+                        if (WAVE_IR_INSTRUCTION(ir, operand)->opcode == IR_OPCODE_CONSTANT && loop.blocks[WAVE_IR_INSTRUCTION(ir, operand)->block]) {
+                            if (operand == next) {
+                                next = WAVE_IR_INSTRUCTION(ir, operand)->next;
+                            }
+
+                            wave_ir_move(ir, operand, loop.preheader, jump);
+                        }
+                    }
+
+                    wave_ir_move(ir, k, loop.preheader, jump);
+                    *out_changed = true;
+                }
+            }
+        }
+    }
+
+    IR_OPTIMIZER_DEALLOCATE(loop.blocks);
+    IR_OPTIMIZER_DEALLOCATE(worklist);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static wave_ir_index ir_optimizer_get_constant_operand(const wave_ir* ir, const wave_ir_instruction* instruction, wave_ir_index value, bool commutative) { // the constant combined with @value by a binary operation, @WAVE_IR_NONE if there is none
+    if (instruction->opcode != IR_OPCODE_OPERATION || instruction->operand_count != 2) {
+        return WAVE_IR_NONE;
+    }
+
+    wave_ir_index left = WAVE_IR_OPERAND(ir, instruction, 0);
+    wave_ir_index right = WAVE_IR_OPERAND(ir, instruction, 1);
+
+    if (commutative && right == value) {
+        right = left;
+        left = value;
+    }
+
+    return left == value && right != WAVE_IR_NONE && WAVE_IR_INSTRUCTION(ir, right)->opcode == IR_OPCODE_CONSTANT ? right : WAVE_IR_NONE;
+}
+
+static error_code ir_optimizer_reduce_scaled_variable(wave_ir* ir, const ir_loop* loop, wave_ir_index phi, wave_ir_index increment, wave_ir_index scaled, bool* out_changed) { // replaces @scaled = @phi * k by a phi of its own that is incremented by the increment of @phi times k
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, scaled);
+
+    const node_type scale_operation = instruction->operation;
+    const node_type increment_operation = WAVE_IR_INSTRUCTION(ir, increment)->operation;
+    const wave_type type = instruction->value_type;
+    const u32 source_offset = instruction->source_offset;
+
+    const wave_ir_index scale = ir_optimizer_get_constant_operand(ir, instruction, phi, scale_operation == NODE_TYPE_BINARY_OPERATION_MUL);
+    const wave_ir_index step = ir_optimizer_get_constant_operand(ir, WAVE_IR_INSTRUCTION(ir, increment), phi, increment_operation == NODE_TYPE_BINARY_OPERATION_ADD);
+
+    // (i + c) * k = i * k + c * k, and the same for subtractions and shifts, the integers wrap around on both sides
+
+    const union_number scale_value = WAVE_IR_INSTRUCTION(ir, scale)->constant_data.value;
+
+    union_number scaled_step;
+    if (!wave_optimizer_evaluate(scale_operation, type, WAVE_IR_INSTRUCTION(ir, step)->constant_data.value, scale_value, &scaled_step)) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    const wave_ir_block* header = WAVE_IR_BLOCK(ir, loop->header);
+    const u32 preheader_operand = header->predecessors[0] == loop->preheader ? 0 : 1;
+    const wave_ir_index jump = wave_ir_get_terminator(ir, loop->preheader);
+    const wave_ir_index start = WAVE_IR_OPERAND(ir, WAVE_IR_INSTRUCTION(ir, phi), preheader_operand);
+
+    // the start value is computed in the preheader, folded right away if it is a constant
+
+    union_number start_value;
+    wave_ir_index scaled_start;
+
+    if (WAVE_IR_INSTRUCTION(ir, start)->opcode == IR_OPCODE_CONSTANT && wave_optimizer_evaluate(scale_operation, type, WAVE_IR_INSTRUCTION(ir, start)->constant_data.value, scale_value, &start_value)) {
+        wave_ir_instruction constant = (wave_ir_instruction) { .opcode = IR_OPCODE_CONSTANT, .value_type = type, .source_offset = source_offset, .constant_data.value = start_value };
+        RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, constant, NULL, 0, loop->preheader, jump, &scaled_start);
+    } else {
+        wave_ir_index operands[2] = { start, WAVE_IR_NONE };
+
+        wave_ir_instruction constant = (wave_ir_instruction) { .opcode = IR_OPCODE_CONSTANT, .value_type = type, .source_offset = source_offset, .constant_data.value = scale_value };
+        RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, constant, NULL, 0, loop->preheader, jump, &operands[1]);
+
+        wave_ir_instruction operation = (wave_ir_instruction) { .opcode = IR_OPCODE_OPERATION, .operation = scale_operation, .value_type = type, .source_offset = source_offset };
+        RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, operation, operands, 2, loop->preheader, jump, &scaled_start);
+    }
+
+    wave_ir_index scaled_step_constant;
+    wave_ir_instruction constant = (wave_ir_instruction) { .opcode = IR_OPCODE_CONSTANT, .value_type = type, .source_offset = source_offset, .constant_data.value = scaled_step };
+    RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, constant, NULL, 0, loop->preheader, jump, &scaled_step_constant);
+
+    // the new phi is incremented right behind the increment of @phi, which is available at the end of the latch
+
+    wave_ir_index operands[2] = { scaled_start, scaled_start };
+
+    wave_ir_index scaled_phi;
+    wave_ir_instruction phi_instruction = (wave_ir_instruction) { .opcode = IR_OPCODE_PHI, .value_type = type, .source_offset = source_offset };
+    RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, phi_instruction, operands, 2, loop->header, header->first_instruction, &scaled_phi);
+
+    operands[0] = scaled_phi;
+    operands[1] = scaled_step_constant;
+
+    wave_ir_index scaled_increment;
+    wave_ir_instruction operation = (wave_ir_instruction) { .opcode = IR_OPCODE_OPERATION, .operation = increment_operation, .value_type = type, .source_offset = WAVE_IR_INSTRUCTION(ir, increment)->source_offset };
+    RUN_ERROR_CODE_FUNCTION(wave_ir_insert, ir, operation, operands, 2, WAVE_IR_INSTRUCTION(ir, increment)->block, WAVE_IR_INSTRUCTION(ir, increment)->next, &scaled_increment);
+
+    WAVE_IR_OPERAND(ir, WAVE_IR_INSTRUCTION(ir, scaled_phi), 1 - preheader_operand) = scaled_increment;
+
+    // the users of @scaled read the new phi instead, the multiplication is left to dead code elimination
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        wave_ir_instruction* user = WAVE_IR_INSTRUCTION(ir, i);
+
+        for (u32 j = 0; j < user->operand_count; j++) {
+            if (WAVE_IR_OPERAND(ir, user, j) == scaled) {
+                WAVE_IR_OPERAND(ir, user, j) = scaled_phi;
+            }
+        }
+    }
+
+    *out_changed = true;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code ir_optimizer_reduce_induction_variables(wave_ir* ir, bool* out_changed) { // replaces multiplications of a counter by a constant with a counter of their own
+    const wave_memory_allocation_function allocate_memory = ir->allocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = ir->deallocate_memory;
+
+    ir_loop loop;
+    wave_ir_block_index* worklist;
+
+    IR_OPTIMIZER_ALLOCATE(loop.blocks, ir->block_count);
+    IR_OPTIMIZER_ALLOCATE(worklist, ir->block_count);
+
+    for (u32 i = 0; i < ir->order_count; i++) {
+        if (!ir_optimizer_find_loop(ir, ir->order[i], worklist, &loop) || loop.latch == WAVE_IR_NONE || WAVE_IR_BLOCK(ir, loop.header)->predecessor_count != 2) {
+            continue;
+        }
+
+        const u32 latch_operand = WAVE_IR_BLOCK(ir, loop.header)->predecessors[0] == loop.latch ? 0 : 1;
+
+        // a basic induction variable is a phi of the header that is incremented by a constant on the back edge
+
+        for (wave_ir_index phi = WAVE_IR_BLOCK(ir, loop.header)->first_instruction; phi != WAVE_IR_NONE && WAVE_IR_INSTRUCTION(ir, phi)->opcode == IR_OPCODE_PHI; phi = WAVE_IR_INSTRUCTION(ir, phi)->next) {
+            const wave_ir_instruction* phi_instruction = WAVE_IR_INSTRUCTION(ir, phi);
+            if (!wave_type_is_integer(phi_instruction->value_type) || phi_instruction->operand_count != 2 || WAVE_IR_OPERAND(ir, phi_instruction, 0) == WAVE_IR_NONE || WAVE_IR_OPERAND(ir, phi_instruction, 1) == WAVE_IR_NONE) {
+                continue;
+            }
+
+            const wave_ir_index increment = WAVE_IR_OPERAND(ir, phi_instruction, latch_operand);
+            const wave_ir_instruction* increment_instruction = WAVE_IR_INSTRUCTION(ir, increment);
+
+            const bool add = increment_instruction->operation == NODE_TYPE_BINARY_OPERATION_ADD;
+            if ((!add && increment_instruction->operation != NODE_TYPE_BINARY_OPERATION_SUB) || increment_instruction->value_type != phi_instruction->value_type ||
+                !loop.blocks[increment_instruction->block] || ir_optimizer_get_constant_operand(ir, increment_instruction, phi, add) == WAVE_IR_NONE) {
+                continue;
+            }
+
+            // the values scaling it by a constant inside of the loop, the ones added while reducing are not in the order
+
+            for (u32 j = i; j < ir->order_count; j++) {
+                if (!loop.blocks[ir->order[j]]) {
+                    continue;
+                }
+
+                for (wave_ir_index k = ir->blocks[ir->order[j]].first_instruction; k != WAVE_IR_NONE; k = WAVE_IR_INSTRUCTION(ir, k)->next) {
+                    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, k);
+                    if (instruction->opcode != IR_OPCODE_OPERATION || instruction->value_type != phi_instruction->value_type) {
+                        continue;
+                    }
+
+                    const bool multiplication = instruction->operation == NODE_TYPE_BINARY_OPERATION_MUL;
+                    if ((multiplication || instruction->operation == NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT) && ir_optimizer_get_constant_operand(ir, instruction, phi, multiplication) != WAVE_IR_NONE) {
+                        RUN_ERROR_CODE_FUNCTION(ir_optimizer_reduce_scaled_variable, ir, &loop, phi, increment, k, out_changed);
+
+                        phi_instruction = WAVE_IR_INSTRUCTION(ir, phi); // inserting may move the instructions
+                    }
+                }
+            }
+        }
+    }
+
+    IR_OPTIMIZER_DEALLOCATE(loop.blocks);
+    IR_OPTIMIZER_DEALLOCATE(worklist);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+// inlining
+
+bool wave_ir_optimizer_can_inline(const wave_ir* ir, bool force, u32 max_cost) {
+    if (WAVE_IR_BLOCK(ir, 0)->predecessor_count != 0) { // the entry block is copied in front of the call
+        return false;
+    }
+
+    // objects would have to be added to the root set of the caller and freed by it, so only bodies working on numbers are inlined
+
+    for (u32 i = 0; i < ir->variable_count; i++) {
+        if (ir->variables[i].type > WAVE_TYPE_F64) {
+            return false;
+        }
+    }
+
+    u32 cost = 0;
+    bool leaf = true;
+    bool returns_value = false;
+    bool returns_nothing = false;
+
+    for (wave_ir_block_index i = 0; i < ir->block_count; i++) {
+        if (WAVE_IR_BLOCK(ir, i)->removed) {
+            continue;
+        }
+
+        if (wave_ir_get_terminator(ir, i) == WAVE_IR_NONE) { // falls off the end of the function
+            returns_nothing = true;
+        }
+
+        for (wave_ir_index j = WAVE_IR_BLOCK(ir, i)->first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+            const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, j);
+
+            switch (instruction->opcode) {
+                case IR_OPCODE_STRING:
+                case IR_OPCODE_STRING_LOCAL:
+                case IR_OPCODE_SWITCH: // refer to the data of the callee
+                case IR_OPCODE_EXIT: {
+                    return false;
+                }
+
+                case IR_OPCODE_CONSTANT:
+                case IR_OPCODE_PHI:
+                case IR_OPCODE_POP:
+                case IR_OPCODE_JUMP: { // pushed by their users, or not emitted once inlined
+                    break;
+                }
+
+                case IR_OPCODE_RETURN: {
+                    returns_value = returns_value || instruction->operand_count > 0;
+                    returns_nothing = returns_nothing || instruction->operand_count == 0;
+                    break;
+                }
+
+                case IR_OPCODE_CALL: {
+                    leaf = false;
+                    cost++;
+                    break;
+                }
+
+                default: {
+                    cost++;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (returns_value && returns_nothing) { // the value of the call would be missing on some paths
+        return false;
+    }
+
+    return force || (leaf && cost <= max_cost);
+}
+
+// pass manager
+
+static const ir_optimizer_pass ir_optimizer_passes[] = {
+    { .name = "copy propagation",     .required_analyses = IR_ANALYSIS_NONE,                                .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_propagate_copies },
+    { .name = "constant propagation", .required_analyses = IR_ANALYSIS_ORDER,                               .preserved_analyses = IR_ANALYSIS_NONE,                           .run = ir_optimizer_propagate_constants },
+    { .name = "type conversions",     .required_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_USES,            .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_simplify_conversions },
+    { .name = "value numbering",      .required_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS,      .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_number_values },
+    { .name = "loop invariant code motion", .required_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_move_invariants },
+    { .name = "induction variables",  .required_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS,      .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_reduce_induction_variables },
+    { .name = "copy propagation",     .required_analyses = IR_ANALYSIS_NONE,                                .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_propagate_copies }, // phis left with a single value by constant propagation
+    { .name = "dead code elimination", .required_analyses = IR_ANALYSIS_NONE,                               .preserved_analyses = IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS, .run = ir_optimizer_eliminate_dead_code }
+};
+
+error_code wave_ir_optimizer_optimize(wave_ir* ir, wave_compiler_message_function dump_function) {
+    for (u32 i = 0; i < ARRAY_LENGTH(ir_optimizer_passes); i++) {
+        const ir_optimizer_pass* pass = &ir_optimizer_passes[i];
+
+        // compute the missing analyses, dominators are computed on the block order
+
+        const ir_analysis required_analyses = pass->required_analyses;
+
+        if ((required_analyses & (IR_ANALYSIS_ORDER | IR_ANALYSIS_DOMINATORS)) != 0 && (ir->valid_analyses & IR_ANALYSIS_ORDER) == 0) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_compute_order, ir);
+        }
+
+        if ((required_analyses & IR_ANALYSIS_DOMINATORS) != 0 && (ir->valid_analyses & IR_ANALYSIS_DOMINATORS) == 0) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_compute_dominators, ir);
+        }
+
+        if ((required_analyses & IR_ANALYSIS_USES) != 0 && (ir->valid_analyses & IR_ANALYSIS_USES) == 0) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_compute_uses, ir);
+        }
+
+        // run the pass
+
+        const ir_optimizer_pass_function run_pass = pass->run;
+
+        bool changed = false;
+        RUN_ERROR_CODE_FUNCTION(run_pass, ir, &changed);
+
+        if (changed) {
+            ir->valid_analyses &= pass->preserved_analyses;
+        }
+
+        if (dump_function != NULL) {
+            RUN_ERROR_CODE_FUNCTION(wave_ir_dump, ir, pass->name, dump_function);
+        }
+    }
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+#undef IR_OPTIMIZER_IS_UNARY_OPERATION
+
+#undef IR_OPTIMIZER_ALLOCATE
+#undef IR_OPTIMIZER_DEALLOCATE
@@ -0,0 +1,17 @@
+#ifndef WAVE_LANGUAGE_IR_OPTIMIZER
+#define WAVE_LANGUAGE_IR_OPTIMIZER
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "language/compiler/compiler.h"
+#include "language/compiler/data/wave_ir.h"
+
+// Functions
+
+error_code wave_ir_optimizer_optimize(wave_ir* ir, wave_compiler_message_function dump_function); // runs the pass pipeline on the ir of a function body, @ir is dumped after every pass unless @dump_function is NULL
+bool wave_ir_optimizer_can_inline(const wave_ir* ir, bool force, u32 max_cost); // whether calls of the optimized function body @ir may be replaced by it (see @wave_ir_inline), @force skips the cost model for functions marked inline
+
+#endif
@@ -1,25 +1,600 @@
 #include "optimizer.h"
 
+#include "language/wave_common.h"
+
+#include "language/compiler/data/wave_type.h"
+
+// Typedefs
+
+typedef void (*optimizer_pass) (wave_ast* ast, wave_ast_index index);
+
+// Defines
+
+#define OPTIMIZER_IS_OPERATION(type) ((type) > NODE_TYPE_OPERATION_START && (type) < NODE_TYPE_OPERATION_END)
+#define OPTIMIZER_IS_UNARY_OPERATION(type) ((type) >= NODE_TYPE_UNARY_OPERATION_PLUS && (type) <= NODE_TYPE_UNARY_OPERATION_NOT)
+
+#define OPTIMIZER_IS_SIGNED_TYPE(type) ((type) >= WAVE_TYPE_I8 && (type) <= WAVE_TYPE_I64)
+#define OPTIMIZER_IS_FLOAT_TYPE(type) ((type) == WAVE_TYPE_F32 || (type) == WAVE_TYPE_F64)
+
+#define OPTIMIZER_BIT_COUNT(type) ((u32) wave_type_get_size(type) * 8)
+#define OPTIMIZER_BIT_MASK(type) (U64_MAX >> (64 - OPTIMIZER_BIT_COUNT(type)))
+
 // Functions
 
-static error_code wave_optimizer_constant_fold(const wave_ast* ast) {
+// helper
+
+static u64 optimizer_get_integer_value(wave_type type, union_number value) { // sign extended for signed types
+    switch (type) {
+        case WAVE_TYPE_U8:  { return value.value_u8;  }
+        case WAVE_TYPE_U16: { return value.value_u16; }
+        case WAVE_TYPE_U32: { return value.value_u32; }
+        case WAVE_TYPE_U64: { return value.value_u64; }
+
+        case WAVE_TYPE_I8:  { return (u64) (i64) value.value_i8;  }
+        case WAVE_TYPE_I16: { return (u64) (i64) value.value_i16; }
+        case WAVE_TYPE_I32: { return (u64) (i64) value.value_i32; }
+        case WAVE_TYPE_I64: { return (u64) value.value_i64; }
+
+        default: {
+            return 0;
+        }
+    }
+}
+
+static u64 optimizer_get_integer(const wave_ast_node* node) {
+    return optimizer_get_integer_value(node->value_type, node->constant_data.value);
+}
+
+static bool optimizer_get_integer_number(wave_type type, u64 value, union_number* out_number) { // truncates @value to the width of @type
+    union_number number = (union_number) { .value_u64 = 0 };
+
+    switch (wave_type_get_size(type)) {
+        case (sizeof(u8)):  { number.value_u8  = (u8)  value; break; }
+        case (sizeof(u16)): { number.value_u16 = (u16) value; break; }
+        case (sizeof(u32)): { number.value_u32 = (u32) value; break; }
+        case (sizeof(u64)): { number.value_u64 = (u64) value; break; }
+
+        default: {
+            return false;
+        }
+    }
+
+    *out_number = number;
+    return true;
+}
+
+static void optimizer_set_constant(wave_ast_node* node, union_number value) { // keeps the type and the list position of the node
+    node->type = NODE_TYPE_CONSTANT;
+    node->constant_data.value = value;
+}
+
+static void optimizer_set_integer(wave_ast_node* node, u64 value) {
+    union_number number;
+    if (optimizer_get_integer_number(node->value_type, value, &number)) {
+        optimizer_set_constant(node, number);
+    }
+}
+
+static void optimizer_replace(wave_ast* ast, wave_ast_index index, wave_ast_index source_index) { // moves the source node into the place of @index
+    wave_ast_node* node = WAVE_AST_NODE(ast, index);
+    wave_ast_index next_node = node->next_node;
+
+    *node = *WAVE_AST_NODE(ast, source_index);
+    node->next_node = next_node;
+}
+
+static const wave_ast_node* optimizer_get_constant(const wave_ast* ast, wave_ast_index index, wave_type value_type) { // NULL unless the node is a constant of @value_type
+    if (index == WAVE_AST_NONE) {
+        return NULL;
+    }
+
+    const wave_ast_node* node = WAVE_AST_NODE(ast, index);
+    return node->type == NODE_TYPE_CONSTANT && node->value_type == value_type ? node : NULL;
+}
+
+static bool optimizer_is_operand(const wave_ast* ast, wave_ast_index index, wave_type value_type) { // operands evaluated in another type are left alone
+    return index != WAVE_AST_NONE && WAVE_AST_NODE(ast, index)->value_type == value_type;
+}
+
+static void optimizer_visit(wave_ast* ast, wave_ast_index index, optimizer_pass pass) { // runs @pass on the children of a node before the node itself
+    if (index == WAVE_AST_NONE) {
+        return;
+    }
+
+    const wave_ast_node* node = WAVE_AST_NODE(ast, index);
+
+    switch (node->type) {
+        case NODE_TYPE_VARIABLE:
+        case NODE_TYPE_ASSIGNMENT: {
+            optimizer_visit(ast, node->variable_data.value_node, pass);
+            break;
+        }
+
+        case NODE_TYPE_TYPE_CONVERSION: {
+            optimizer_visit(ast, node->type_conversion_data.value_node, pass);
+            break;
+        }
+
+        case NODE_TYPE_STATEMENT_FUNCTION_CALL: {
+            for (wave_ast_index argument = node->function_call_data.first_argument; argument != WAVE_AST_NONE; argument = WAVE_AST_NODE(ast, argument)->next_node) {
+                optimizer_visit(ast, argument, pass);
+            }
+
+            break;
+        }
+
+        default: {
+            if (OPTIMIZER_IS_OPERATION(node->type)) {
+                optimizer_visit(ast, node->expression_data.left_node, pass);
+                optimizer_visit(ast, node->expression_data.right_node, pass);
+            }
+
+            break;
+        }
+    }
+
+    pass(ast, index);
+}
+
+bool wave_optimizer_has_side_effects(const wave_ast* ast, wave_ast_index index) {
+    if (index == WAVE_AST_NONE) {
+        return false;
+    }
+
+    const wave_ast_node* node = WAVE_AST_NODE(ast, index);
+
+    switch (node->type) {
+        case NODE_TYPE_CONSTANT:
+        case NODE_TYPE_VARIABLE: {
+            return false;
+        }
+
+        case NODE_TYPE_TYPE_CONVERSION: {
+            return wave_optimizer_has_side_effects(ast, node->type_conversion_data.value_node);
+        }
+
+        case NODE_TYPE_STRING: // allocates
+        case NODE_TYPE_ASSIGNMENT:
+        case NODE_TYPE_STATEMENT_FUNCTION_CALL: {
+            return true;
+        }
+
+        default: {
+            if (OPTIMIZER_IS_OPERATION(node->type)) {
+                return wave_optimizer_has_side_effects(ast, node->expression_data.left_node) || wave_optimizer_has_side_effects(ast, node->expression_data.right_node);
+            }
+
+            return true;
+        }
+    }
+}
+
+// constant folding
+
+static bool optimizer_fold_integer(node_type operation, wave_type type, u64 left, u64 right, u64* out_value) { // evaluates the operation the way the vm does, false if it cannot be evaluated at compile time
+    const bool is_signed = OPTIMIZER_IS_SIGNED_TYPE(type);
+    const u32 bit_count = OPTIMIZER_BIT_COUNT(type);
+    const u64 bit_mask = OPTIMIZER_BIT_MASK(type);
+
+    switch (operation) {
+        case NODE_TYPE_UNARY_OPERATION_MINUS:   { *out_value = (u64) 0 - left; return true; }
+        case NODE_TYPE_UNARY_OPERATION_ABS:     { *out_value = is_signed && (i64) left < 0 ? (u64) 0 - left : left; return true; }
+        case NODE_TYPE_UNARY_OPERATION_BIT_NOT: { *out_value = ~left; return true; }
+        case NODE_TYPE_UNARY_OPERATION_NOT:     { *out_value = left == 0; return true; }
+
+        case NODE_TYPE_BINARY_OPERATION_ADD: { *out_value = left + right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_SUB: { *out_value = left - right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_MUL: { *out_value = left * right; return true; }
+
+        case NODE_TYPE_BINARY_OPERATION_DIV:
+        case NODE_TYPE_BINARY_OPERATION_MOD: {
+            if (right == 0) { // raises an error at runtime
+                return false;
+            }
+
+            if (is_signed) {
+                if ((i64) left == (i64) (U64_MAX << (bit_count - 1)) && (i64) right == -1) { // overflows
+                    return false;
+                }
+
+                *out_value = (u64) (operation == NODE_TYPE_BINARY_OPERATION_DIV ? (i64) left / (i64) right : (i64) left % (i64) right);
+            } else {
+                *out_value = operation == NODE_TYPE_BINARY_OPERATION_DIV ? left / right : left % right;
+            }
+
+            return true;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_EQUAL:   { *out_value = left == right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_UNEQUAL: { *out_value = left != right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_AND:     { *out_value = left != 0 && right != 0; return true; }
+        case NODE_TYPE_BINARY_OPERATION_OR:      { *out_value = left != 0 || right != 0; return true; }
+
+        case NODE_TYPE_BINARY_OPERATION_LESS_THAN:          { *out_value = is_signed ? (i64) left <  (i64) right : left <  right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_LESS_THAN_EQUAL:    { *out_value = is_signed ? (i64) left <= (i64) right : left <= right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_GREATER_THAN:       { *out_value = is_signed ? (i64) left >  (i64) right : left >  right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_GREATER_THAN_EQUAL: { *out_value = is_signed ? (i64) left >= (i64) right : left >= right; return true; }
+
+        case NODE_TYPE_BINARY_OPERATION_BIT_AND: { *out_value = left & right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_BIT_OR:  { *out_value = left | right; return true; }
+        case NODE_TYPE_BINARY_OPERATION_BIT_XOR: { *out_value = left ^ right; return true; }
+
+        case NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT:
+        case NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_RIGHT: { // the vm shifts the unsigned value, shifting by the bit count or more is left to the vm
+            if ((right & bit_mask) >= bit_count) {
+                return false;
+            }
+
+            *out_value = operation == NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT ? left << right : (left & bit_mask) >> right;
+            return true;
+        }
+
+        default: { // @NODE_TYPE_BINARY_OPERATION_POW, ...
+            return false;
+        }
+    }
+}
+
+#define OPTIMIZER_FOLD_FLOAT(type)                                                                                              \
+    static bool CONCAT(optimizer_fold_, type)(node_type operation, type left, type right, type* out_value) {                    \
+        switch (operation) {                                                                                                    \
+            case NODE_TYPE_UNARY_OPERATION_MINUS: { *out_value = -left; return true; }                                          \
+            case NODE_TYPE_UNARY_OPERATION_ABS:   { *out_value = left < (type) 0 ? -left : left; return true; }                 \
+                                                                                                                                \
+            case NODE_TYPE_BINARY_OPERATION_ADD: { *out_value = left + right; return true; }                                    \
+            case NODE_TYPE_BINARY_OPERATION_SUB: { *out_value = left - right; return true; }                                    \
+            case NODE_TYPE_BINARY_OPERATION_MUL: { *out_value = left * right; return true; }                                    \
+            case NODE_TYPE_BINARY_OPERATION_DIV: {                                                                              \
+                if (right == (type) 0) { /* raises an error at runtime */                                                       \
+                    return false;                                                                                               \
+                }                                                                                                               \
+                                                                                                                                \
+                *out_value = left / right;                                                                                      \
+                return true;                                                                                                    \
+            }                                                                                                                   \
+                                                                                                                                \
+            case NODE_TYPE_BINARY_OPERATION_EQUAL:              { *out_value = (type) (left == right); return true; }           \
+            case NODE_TYPE_BINARY_OPERATION_UNEQUAL:            { *out_value = (type) (left != right); return true; }           \
+            case NODE_TYPE_BINARY_OPERATION_LESS_THAN:          { *out_value = (type) (left <  right); return true; }           \
+            case NODE_TYPE_BINARY_OPERATION_LESS_THAN_EQUAL:    { *out_value = (type) (left <= right); return true; }           \
+            case NODE_TYPE_BINARY_OPERATION_GREATER_THAN:       { *out_value = (type) (left >  right); return true; }           \
+            case NODE_TYPE_BINARY_OPERATION_GREATER_THAN_EQUAL: { *out_value = (type) (left >= right); return true; }           \
+                                                                                                                                \
+            default: { /* bitwise and logical operations work on the bits of floats */                                          \
+                return false;                                                                                                   \
+            }                                                                                                                   \
+        }                                                                                                                       \
+    }
+
+OPTIMIZER_FOLD_FLOAT(f32)
+OPTIMIZER_FOLD_FLOAT(f64)
+
+#undef OPTIMIZER_FOLD_FLOAT
+
+bool wave_optimizer_evaluate(node_type operation, wave_type type, union_number left, union_number right, union_number* out_value) {
+    if (wave_type_is_integer(type)) {
+        u64 value = 0;
+        return optimizer_fold_integer(operation, type, optimizer_get_integer_value(type, left), optimizer_get_integer_value(type, right), &value) && optimizer_get_integer_number(type, value, out_value);
+    } else if (type == WAVE_TYPE_F32) {
+        f32 value = 0.0F;
+        if (optimizer_fold_f32(operation, left.value_f32, right.value_f32, &value)) {
+            *out_value = (union_number) { .value_u64 = 0 };
+            out_value->value_f32 = value;
+            return true;
+        }
+    } else if (type == WAVE_TYPE_F64) {
+        f64 value = 0.0;
+        if (optimizer_fold_f64(operation, left.value_f64, right.value_f64, &value)) {
+            *out_value = (union_number) { .value_f64 = value };
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool wave_optimizer_convert(wave_type from_type, wave_type to_type, union_number value, union_number* out_value) {
+    const f64 float_value = from_type == WAVE_TYPE_F32 ? (f64) value.value_f32 : value.value_f64; // f32 values are exact in f64
+    const u64 integer_value = optimizer_get_integer_value(from_type, value);
+
+    if (wave_type_is_integer(to_type)) {
+        if (wave_type_is_integer(from_type)) { // the sign extended value is truncated, like the vm does
+            return optimizer_get_integer_number(to_type, integer_value, out_value);
+        } else if (!OPTIMIZER_IS_FLOAT_TYPE(from_type)) {
+            return false;
+        }
+
+        // converting a float that does not fit (or NaN) is left to the vm, it is undefined in c
+
+        const u32 value_bit_count = OPTIMIZER_BIT_COUNT(to_type) - (OPTIMIZER_IS_SIGNED_TYPE(to_type) ? 1 : 0);
+        const f64 maximum = (f64) (U64_BIT_1 >> (64 - value_bit_count)) + 1.0; // 2 ^ @value_bit_count
+        const f64 minimum = OPTIMIZER_IS_SIGNED_TYPE(to_type) ? -maximum : 0.0;
+        if (!(float_value >= minimum && float_value < maximum)) {
+            return false;
+        }
+
+        return optimizer_get_integer_number(to_type, OPTIMIZER_IS_SIGNED_TYPE(to_type) ? (u64) (i64) float_value : (u64) float_value, out_value);
+    }
+
+    *out_value = (union_number) { .value_u64 = 0 };
+
+    if (to_type == WAVE_TYPE_F32) {
+        if (OPTIMIZER_IS_FLOAT_TYPE(from_type)) {
+            out_value->value_f32 = (f32) float_value;
+        } else {
+            out_value->value_f32 = OPTIMIZER_IS_SIGNED_TYPE(from_type) ? (f32) (i64) integer_value : (f32) integer_value;
+        }
+    } else if (to_type == WAVE_TYPE_F64) {
+        if (OPTIMIZER_IS_FLOAT_TYPE(from_type)) {
+            out_value->value_f64 = float_value;
+        } else {
+            out_value->value_f64 = OPTIMIZER_IS_SIGNED_TYPE(from_type) ? (f64) (i64) integer_value : (f64) integer_value;
+        }
+    } else {
+        return false;
+    }
+
+    return wave_type_is_integer(from_type) || OPTIMIZER_IS_FLOAT_TYPE(from_type);
+}
+
+static void optimizer_fold_node(wave_ast* ast, wave_ast_index index) {
+    wave_ast_node* node = WAVE_AST_NODE(ast, index);
+
+    if (node->type == NODE_TYPE_TYPE_CONVERSION) {
+        const wave_ast_node* value = optimizer_get_constant(ast, node->type_conversion_data.value_node, node->type_conversion_data.from_type);
+
+        union_number converted;
+        if (value != NULL && wave_optimizer_convert(node->type_conversion_data.from_type, node->value_type, value->constant_data.value, &converted)) {
+            optimizer_set_constant(node, converted);
+        }
+
+        return;
+    }
+
+    if (!OPTIMIZER_IS_OPERATION(node->type)) {
+        return;
+    }
+
+    const wave_type type = node->value_type;
+
+    const wave_ast_node* left = optimizer_get_constant(ast, node->expression_data.left_node, type);
+    const wave_ast_node* right = OPTIMIZER_IS_UNARY_OPERATION(node->type) ? left : optimizer_get_constant(ast, node->expression_data.right_node, type);
+    if (left == NULL || right == NULL) {
+        return;
+    }
+
+    union_number value;
+    if (wave_optimizer_evaluate(node->type, type, left->constant_data.value, right->constant_data.value, &value)) {
+        optimizer_set_constant(node, value);
+    }
+}
+
+// operator strength reduction
+
+static u32 optimizer_get_power_of_two(u64 value) { // the exponent if @value is a power of two, U32_MAX otherwise
+    if (value == 0 || (value & (value - 1)) != 0) {
+        return U32_MAX;
+    }
+
+    u32 exponent = 0;
+    while (value > 1) {
+        value >>= 1;
+        exponent++;
+    }
+
+    return exponent;
+}
+
+static void optimizer_reduce_node(wave_ast* ast, wave_ast_index index) { // integers only, as identities like x + 0 do not hold for every float (-0.0, NaN, ...)
+    wave_ast_node* node = WAVE_AST_NODE(ast, index);
+
+    const wave_type type = node->value_type;
+    if (!OPTIMIZER_IS_OPERATION(node->type) || OPTIMIZER_IS_UNARY_OPERATION(node->type) || !wave_type_is_integer(type)) {
+        return;
+    }
+
+    wave_ast_index left_index = node->expression_data.left_node;
+    wave_ast_index right_index = node->expression_data.right_node;
+    if (!optimizer_is_operand(ast, left_index, type) || !optimizer_is_operand(ast, right_index, type)) {
+        return;
+    }
+
+    const u64 bit_mask = OPTIMIZER_BIT_MASK(type);
+
+    wave_ast_node* left = WAVE_AST_NODE(ast, left_index);
+    wave_ast_node* right = WAVE_AST_NODE(ast, right_index);
+
+    const bool left_constant = left->type == NODE_TYPE_CONSTANT;
+    const bool right_constant = right->type == NODE_TYPE_CONSTANT;
+
+    const u64 left_value = left_constant ? optimizer_get_integer(left) & bit_mask : 0;
+    const u64 right_value = right_constant ? optimizer_get_integer(right) & bit_mask : 0;
+
+    switch (node->type) {
+        case NODE_TYPE_BINARY_OPERATION_MUL: {
+            if (left_constant && !right_constant) { // constants are free of side effects, so the operands can be swapped
+                node->expression_data.left_node = right_index;
+                node->expression_data.right_node = left_index;
+
+                optimizer_reduce_node(ast, index);
+                return;
+            }
+
+            if (!right_constant) {
+                return;
+            }
+
+            if (right_value == 1) { // x * 1 = x
+                optimizer_replace(ast, index, left_index);
+                return;
+            }
+
+            u32 exponent = optimizer_get_power_of_two(right_value);
+            if (exponent != U32_MAX) { // x * 2^n = x << n
+                node->type = NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT;
+                optimizer_set_integer(right, exponent);
+            }
+
+            return;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_DIV: {
+            if (!right_constant) {
+                return;
+            }
+
+            if (right_value == 1) { // x / 1 = x
+                optimizer_replace(ast, index, left_index);
+                return;
+            }
+
+            u32 exponent = optimizer_get_power_of_two(right_value);
+            if (exponent != U32_MAX && !OPTIMIZER_IS_SIGNED_TYPE(type)) { // x / 2^n = x >> n, signed division rounds towards zero instead
+                node->type = NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_RIGHT;
+                optimizer_set_integer(right, exponent);
+            }
+
+            return;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_MOD: {
+            if (!right_constant || OPTIMIZER_IS_SIGNED_TYPE(type)) {
+                return;
+            }
+
+            if (right_value > 1 && optimizer_get_power_of_two(right_value) != U32_MAX) { // x % 2^n = x & (2^n - 1)
+                node->type = NODE_TYPE_BINARY_OPERATION_BIT_AND;
+                optimizer_set_integer(right, right_value - 1);
+            }
+
+            return;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_ADD:
+        case NODE_TYPE_BINARY_OPERATION_BIT_OR:
+        case NODE_TYPE_BINARY_OPERATION_BIT_XOR: { // x + 0 = 0 + x = x
+            if (right_constant && right_value == 0) {
+                optimizer_replace(ast, index, left_index);
+            } else if (left_constant && left_value == 0) {
+                optimizer_replace(ast, index, right_index);
+            }
+
+            return;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_SUB:
+        case NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT:
+        case NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_RIGHT: { // x - 0 = x
+            if (right_constant && right_value == 0) {
+                optimizer_replace(ast, index, left_index);
+            }
+
+            return;
+        }
+
+        default: {
+            return;
+        }
+    }
+}
+
+// dead branch elimination
+
+static void optimizer_eliminate_node(wave_ast* ast, wave_ast_index index) { // removes operands whose value cannot change the result, as long as evaluating them has no side effects
+    wave_ast_node* node = WAVE_AST_NODE(ast, index);
+
+    const wave_type type = node->value_type;
+    if (!OPTIMIZER_IS_OPERATION(node->type) || OPTIMIZER_IS_UNARY_OPERATION(node->type) || !wave_type_is_integer(type)) {
+        return;
+    }
+
+    wave_ast_index left_index = node->expression_data.left_node;
+    wave_ast_index right_index = node->expression_data.right_node;
+    if (!optimizer_is_operand(ast, left_index, type) || !optimizer_is_operand(ast, right_index, type)) {
+        return;
+    }
+
+    const u64 bit_mask = OPTIMIZER_BIT_MASK(type);
+
+    // find a constant operand that decides the result on its own
+
+    const wave_ast_node* constant = optimizer_get_constant(ast, right_index, type);
+    wave_ast_index other_index = left_index;
+    if (constant == NULL) {
+        constant = optimizer_get_constant(ast, left_index, type);
+        other_index = right_index;
+    }
+
+    if (constant == NULL || wave_optimizer_has_side_effects(ast, other_index)) {
+        return;
+    }
+
+    const u64 value = optimizer_get_integer(constant) & bit_mask;
+
+    switch (node->type) {
+        case NODE_TYPE_BINARY_OPERATION_MUL:
+        case NODE_TYPE_BINARY_OPERATION_BIT_AND:
+        case NODE_TYPE_BINARY_OPERATION_AND: { // x * 0 = x & 0 = x && 0 = 0
+            if (value == 0) {
+                optimizer_set_integer(node, 0);
+            }
+
+            break;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_BIT_OR: { // x | ~0 = ~0
+            if (value == bit_mask) {
+                optimizer_set_integer(node, bit_mask);
+            }
+
+            break;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_OR: { // x || 1 = 1
+            if (value != 0) {
+                optimizer_set_integer(node, 1);
+            }
+
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+}
+
+// passes
+
+static error_code wave_optimizer_constant_fold(wave_ast* ast) {
+    optimizer_visit(ast, ast->root_node, optimizer_fold_node);
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
-static error_code wave_optimizer_operator_strength_reduction(const wave_ast* ast) {
+static error_code wave_optimizer_operator_strength_reduction(wave_ast* ast) {
+    optimizer_visit(ast, ast->root_node, optimizer_reduce_node);
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
-static error_code wave_optimizer_eliminate_dead_branches(const wave_ast* ast) {
+static error_code wave_optimizer_eliminate_dead_branches(wave_ast* ast) {
+    optimizer_visit(ast, ast->root_node, optimizer_eliminate_node);
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
-error_code wave_optimizer_optimize(const wave_ast* ast) {
+error_code wave_optimizer_optimize(wave_ast* ast) {
     RUN_ERROR_CODE_FUNCTION(wave_optimizer_constant_fold, ast);
-    RUN_ERROR_CODE_FUNCTION(wave_optimizer_operator_strength_reduction, ast);
     RUN_ERROR_CODE_FUNCTION(wave_optimizer_eliminate_dead_branches, ast);
-
-    // TODO: add loop motion here? (move loop-irrelevant statements out of the loop)
+    RUN_ERROR_CODE_FUNCTION(wave_optimizer_constant_fold, ast); // eliminated operands leave constants behind
+    RUN_ERROR_CODE_FUNCTION(wave_optimizer_operator_strength_reduction, ast); // loop invariants are moved on the ir (see @wave_ir_optimizer_optimize)
 
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
+
+#undef OPTIMIZER_IS_OPERATION
+#undef OPTIMIZER_IS_UNARY_OPERATION
+
+#undef OPTIMIZER_IS_SIGNED_TYPE
+#undef OPTIMIZER_IS_FLOAT_TYPE
+
+#undef OPTIMIZER_BIT_COUNT
+#undef OPTIMIZER_BIT_MASK
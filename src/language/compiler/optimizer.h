@@ -10,6 +10,10 @@
 
 // Functions
 
-error_code wave_optimizer_optimize(const wave_ast* ast);
+error_code wave_optimizer_optimize(wave_ast* ast); // rewrites the tree below @ast->root_node in place, the result evaluates to the same value
+bool wave_optimizer_has_side_effects(const wave_ast* ast, wave_ast_index index); // whether evaluating the node does more than producing its value
+
+bool wave_optimizer_evaluate(node_type operation, wave_type type, union_number left, union_number right, union_number* out_value); // folds an operation on constants of @type (@right is ignored for unary operations), false if it has to be left to the vm
+bool wave_optimizer_convert(wave_type from_type, wave_type to_type, union_number value, union_number* out_value); // folds a conversion of a constant like @OPCODE_TYPE_CONV_STATIC, false if it has to be left to the vm
 
 #endif
@@ -1,18 +1,34 @@
 #include "parser.h"
 
+#include <stdatomic.h>
+
+#include "platform.h"
+
 #include "common/debug.h"
 
 #include "common/data/string/hash.h"
 #include "common/data/string/string.h"
 
+#include "common/memory/memory.h"
+
 #include "language/wave_common.h"
 #include "language/wave_limits.h"
 #include "language/wave_opcodes.h"
 
+#include "language/compiler/bytecode_optimizer.h"
 #include "language/compiler/compiler.h"
+#include "language/compiler/data/wave_arena.h"
+#include "language/compiler/data/wave_ast.h"
+#include "language/compiler/data/wave_compile_cache.h"
 #include "language/compiler/data/wave_compiler_common.h"
+#include "language/compiler/data/wave_ir.h"
 #include "language/compiler/data/wave_precedence.h"
+#include "language/compiler/data/wave_profile.h"
+#include "language/compiler/data/wave_symbol_table.h"
 #include "language/compiler/data/wave_type.h"
+#include "language/compiler/ir_optimizer.h"
+#include "language/compiler/optimizer.h"
+#include "language/compiler/tokenizer.h"
 
 // Parser Functions
 
@@ -38,17 +54,25 @@ typedef struct {
 } variable;
 
 typedef struct {
-    string_hash name;
+    wave_symbol symbol;
     wave_type type;
 
     bool initialized;
 
     u16 offset;
     u32 depth;
+    u32 shadowed_local; // the local @symbol referred to before this one was declared, restored once it goes out of scope (U32_MAX if none)
+
+    u32 ir_variable; // the index into @wave_ir.variables of the function body, U32_MAX if the local is not known to the ir
+
+    // escape analysis (heap object types only)
+
+    bool escapes; // whether the object may outlive the stack frame of the function, or the variable is reassigned
+    u32 allocation_index; // the @IR_OPCODE_STRING_LOCAL instruction that allocated the object, U32_MAX if the object is not allocated in the stack frame
 } wave_local;
 
 typedef struct {
-    string_hash name;
+    wave_symbol symbol;
     wave_type type;
 
     bool initialized;
@@ -57,18 +81,78 @@ typedef struct {
 } wave_global;
 
 typedef struct {
-    string_hash name;
+    wave_symbol symbol; // @WAVE_SYMBOL_NONE if the parameter is unnamed
     wave_type type;
     u16 offset;
 
     union_number default_value;
+
+    bool constant; // whether every call of the function passes @constant_value (see @analyze_units)
+    union_number constant_value;
 } parse_parameter;
 
 typedef struct {
-    string_hash name;
+    wave_symbol symbol;
     u32 branch_offset;
 } parse_label;
 
+typedef enum {
+    IR_EMIT_MODE_NONE, // removed, nothing is emitted
+    IR_EMIT_MODE_IN_PLACE, // emitted where it is, a value that is not used stays on the stack
+    IR_EMIT_MODE_INLINE, // emitted by its only user, the value is pushed right where the user needs it
+    IR_EMIT_MODE_TAIL_CALL, // a call emitted by the return of its value, which is left out as the call reuses the stack frame (see @OPCODE_EXT_TAIL_CALL)
+    IR_EMIT_MODE_CONSTANT, // pushed again by every user
+    IR_EMIT_MODE_SPILL, // emitted where it is and stored in a frame slot every user loads it from
+    IR_EMIT_MODE_PHI // a frame slot the predecessors of the block store their incoming value in
+} IR_EMIT_MODES;
+typedef byte ir_emit_mode; // @IR_EMIT_MODES
+
+typedef struct {
+    ir_emit_mode mode;
+    u16 slot; // the frame offset of @IR_EMIT_MODE_SPILL and @IR_EMIT_MODE_PHI values
+} ir_emit_value;
+
+typedef struct {
+    u32 offset_index; // the bytecode index of the branch offset
+    u32 end_index; // the end of the jump instruction, which the offset is relative to
+    bool short_offset; // the 16 bit offset of conditional jumps, 32 bit otherwise
+    bool table_offset; // the unsigned 16 bit offset of a switch table entry, which only jumps forward
+    wave_ir_block_index target;
+} ir_jump; // a jump to a block that has not been emitted yet, patched by @emit_ir
+
+typedef enum {
+    IR_SWITCH_KIND_COMPARE, // the value is compared with every case value, the most frequent ones of the profile first
+    IR_SWITCH_KIND_TABLE, // @OPCODE_TABLESWITCH indexed by the value minus the smallest case value
+    IR_SWITCH_KIND_LOOKUP // @OPCODE_LOOKUPSWITCH, which searches the sorted case values, a case that is taken most of the time is compared in front of it
+} IR_SWITCH_KINDS;
+typedef byte ir_switch_kind; // @IR_SWITCH_KINDS
+
+typedef struct {
+    u64 value; // stored in the width of the switch value, upper bytes are zero
+    wave_ir_block_index target;
+    wave_ir_index jump; // the jump at the end of the case body, its target is set once the end of the switch is known
+} parse_switch_case;
+
+typedef enum {
+    CALL_ARGUMENT_NONE, // no value seen yet, only used while the call graph is analyzed
+    CALL_ARGUMENT_CONSTANT,
+    CALL_ARGUMENT_PARAMETER, // a parameter of the caller that is passed on unchanged
+    CALL_ARGUMENT_UNKNOWN
+} CALL_ARGUMENT_KINDS;
+typedef byte call_argument_kind; // @CALL_ARGUMENT_KINDS
+
+typedef struct {
+    call_argument_kind kind;
+    u16 parameter; // @CALL_ARGUMENT_PARAMETER
+    union_number value; // @CALL_ARGUMENT_CONSTANT
+} parse_call_argument; // what is known about the value of an argument of every call
+
+typedef struct {
+    u32 function_index; // the index into @parser.functions of the callee
+    u32 first_argument; // the index into the call arguments of the unit
+    u16 argument_count;
+} parse_call_site;
+
 typedef struct {
     wave_function function_data;
     u16 locals_size;
@@ -77,6 +161,8 @@ typedef struct {
     bool initialized;
 
     bool inline_function;
+    bool inline_candidate; // whether the body is compiled before the others, so that calls of the function can be inlined (see @is_inline_candidate)
+    const wave_ir* inline_body; // the optimized body calls are replaced by, NULL if the function is not inlined
 } parse_function; // extends @wave_function
 #define PARSE_FUNCTION_NULL                 \
     (parse_function) {                      \
@@ -92,6 +178,8 @@ typedef struct {
         .branch_offset = 0,                 \
         .initialized = false,               \
         .inline_function = false,           \
+        .inline_candidate = false,          \
+        .inline_body = NULL,                \
     }
 
 typedef enum {
@@ -108,12 +196,63 @@ typedef byte patch_hole_type; // PATCH_HOLE_TYPES
 typedef struct {
     patch_hole_type type;
     u32 bytecode_index;
+    u32 token_index; // the token the patch hole was created for
 
     union {
-        string_hash identifier;
+        wave_symbol identifier;
     } patch_hole_data;
 } patch_hole;
 
+typedef struct {
+    u32 function_index; // the index into @parser.functions, @PARSE_UNIT_ENTRYPOINT for the entrypoint
+    u32 declaration_token_index; // the first token of the declaration, function calls are relocated relative to it
+    u32 body_token_index; // the opening curly bracket of the body
+    u32 function_start_offset;
+    str function_name_source_pointer;
+
+    parse_parameter* parameters;
+
+    // compile cache
+
+    bool cacheable;
+    u64 cache_key;
+    const wave_compile_cache_entry* cache_entry; // the bytecode the unit is linked from, NULL if the body is compiled
+
+    // inlining
+
+    bool inline_candidate; // whether the optimized body is kept if it can be inlined
+    wave_ir* inline_body; // the kept body, NULL if it cannot be inlined
+
+    // compiled body, positions are relative to @bytecode
+
+    byte* bytecode;
+    u32 bytecode_size;
+    u32 branch_offset;
+    u16 locals_size;
+
+    patch_hole* patch_holes;
+    u32 patch_hole_count;
+
+    compiler_error_list errors; // the errors raised while compiling the body, moved to the compiler once the unit is linked
+
+    // call graph, the direct calls of the optimized body (see @analyze_units)
+
+    parse_call_site* call_sites;
+    u32 call_site_count;
+
+    parse_call_argument* call_arguments;
+    u32 call_argument_count;
+
+    bool reachable; // whether the unit may be called from the entrypoint or an extern function, only those are linked
+    bool specialized; // whether the body was compiled again with its constant parameters, which makes it depend on its callers
+
+    // profile, the sites of the body added to the profile once the unit is linked (see @wave_compiler_set_profile)
+
+    wave_profile_site* profile_sites;
+    u32 profile_site_count;
+} parse_unit; // a function body that is compiled into its own bytecode and linked behind the declarations (see @parse_units)
+#define PARSE_UNIT_ENTRYPOINT (U32_MAX)
+
 typedef enum {
     COMPILER_SCOPE_GLOBAL = 0,
     COMPILER_SCOPE_FUNCTION,
@@ -141,26 +280,20 @@ static parsing_function parse_rule_function_table[] = {
     [PARSE_RULE_FUNC_CAST] = parse_type_conversion
 };
 
-static struct {
+static _Thread_local struct {
     wave_vm* vm;
 
     // tokens & token data
 
-    parse_token* tokenized_start;
-    parse_token* tokenized_end;
-    parse_token* tokenized_current;
-
-    parse_token* tokenized_stored;
-
-    byte* data_stack_start;
-    byte* data_stack_end;
+    wave_token_stream tokens; // either the whole token stream or a window of it that is refilled on demand (see @parser_get_token)
+    u32 token_index; // the index of the token following @current
 
     str current_file_name;
-    u32 current_line;
-    u32 current_row;
 
-    u32 previous_line;
-    u32 previous_row;
+    // symbol lookups (@global_symbols, @function_symbols, @native_symbols and @local_symbols), grown with the identifiers of the token stream
+
+    u32 symbol_count; // the amount of symbols the lookups cover
+    u32 symbol_capacity;
 
     // compiled bytecode result
 
@@ -180,6 +313,7 @@ static struct {
     u16 globals_count;
     u16 globals_capacity;
     u16 globals_offset; // the next free byte in the globals array
+    u32* global_symbols; // the index into @globals for every symbol, U32_MAX if the symbol is not a global
 
     // functions
 
@@ -188,9 +322,13 @@ static struct {
 
     parse_function* current_function;
 
-    parse_function* functions; // TODO: hash table
+    parse_function* functions;
     u32 functions_count;
     u32 functions_capacity;
+    u32* function_symbols; // the index of the first declaration in @functions for every symbol, U32_MAX if the symbol is not a function
+
+    u32* native_symbols; // the index into the native function stack of the vm for every symbol, U32_MAX if the symbol is not a native function
+    wave_symbol_table native_table; // maps the name hashes of native functions to their index, used to fill @native_symbols as new symbols appear
 
     u32* extern_functions;
     u32 extern_functions_capacity;
@@ -201,9 +339,21 @@ static struct {
     patch_hole* patch_holes;
     u32 patch_hole_capacity;
     u32 patch_hole_count;
-} parser;
 
-struct {
+    // function bodies
+
+    bool deferred_bodies; // whether the bodies are compiled once all declarations are parsed, which requires the whole token stream, otherwise they are compiled where they are declared
+
+    parse_unit* units;
+    u32 unit_count;
+    u32 unit_capacity;
+
+    // incremental compilation
+
+    wave_compile_cache* cache; // the functions compiled by earlier compilations, NULL if functions are not cached
+} parser; // every thread compiling function bodies works on a copy of the declarations (see @parse_unit_thread)
+
+static _Thread_local struct {
     u32 scope_depth;
 
     // global variables
@@ -218,6 +368,64 @@ struct {
     u16 locals_capacity;
     u16 locals_count;
     u16 locals_offset; // the next free byte in the locals array
+    u32* local_symbols; // the index of the innermost visible local in @locals for every symbol, U32_MAX if the symbol is not a local
+
+    bool non_escaping_context; // set while parsing the parameters of native functions, which do not keep references to objects passed to them
+
+    // expressions
+
+    wave_ast ast; // the tree of the expression that is being parsed, bytecode is generated once the expression is complete (see @generate_expression)
+    wave_ast_index expression_node; // the node produced by the last parse rule function
+
+    // intermediate representation
+
+    wave_ir ir; // the function body that is being parsed, statements are lowered into it and bytecode is emitted once the body is complete (see @emit_ir)
+    wave_ir_index expression_value; // the value of the last generated expression, @WAVE_IR_NONE if it has none
+
+    wave_ir_index* call_operands; // the lowered arguments of the calls that are being lowered, calls inside of arguments push theirs on top
+    u32 call_operand_capacity;
+    u32 call_operand_count;
+
+    ir_emit_value* emit_values; // one per instruction
+    u32 emit_value_capacity;
+
+    u32* block_offsets; // the bytecode index of every emitted block
+    u32 block_offset_capacity;
+
+    ir_jump* jumps;
+    u32 jump_capacity;
+    u32 jump_count;
+
+    parse_switch_case* switch_cases; // the cases of the switch statements that are being parsed, nested switches push theirs on top
+    u32 switch_case_capacity;
+    u32 switch_case_count;
+
+    wave_bytecode_optimizer bytecode_optimizer; // the peephole pass run over the emitted body (see @emit_ir)
+
+    // call graph
+
+    parse_call_site* call_sites; // the direct calls of the body that is being compiled, moved to its unit once it is complete
+    u32 call_site_capacity;
+    u32 call_site_count;
+
+    parse_call_argument* call_arguments;
+    u32 call_argument_capacity;
+    u32 call_argument_count;
+
+    // profile
+
+    wave_profile_site* profile_sites; // the counters of the body that is being compiled, moved to its unit once it is complete
+    u32 profile_site_capacity;
+    u32 profile_site_count;
+
+    u32* switch_order; // the order the cases of a switch are compared in (see @order_ir_switch_cases)
+    u32 switch_order_capacity;
+
+    // inlining
+
+    bool keep_inline_body; // whether the optimized body is copied to @inline_body if it can be inlined
+    wave_ir* inline_body;
+    bool inlined_calls; // whether calls of the body were replaced by the bodies of the called functions (see @inline_ir_calls)
 
     // labels
 
@@ -226,20 +434,45 @@ struct {
     u32 label_count;
 } function_parser; // TODO: merge with @parser
 
+typedef struct {
+    typeof(parser) parser; // the state of the parser once all declarations were parsed, only read while compiling units
+
+    const u32* unit_indices; // the units to compile, in declaration order
+    u32 unit_count;
+
+    _Atomic(u32) next_index; // the next entry of @unit_indices to compile
+    _Atomic(u32) error_index; // the first entry of @unit_indices that failed to compile, U32_MAX if none did
+
+    wave_arena* arena; // the arena the parser allocates from (see @wave_arena_current_allocate), NULL if it does not
+    wave_arena thread_arenas[COMPILER_MAX_THREAD_COUNT]; // the arenas of the started threads, adopted by @arena once they are joined
+    _Atomic(u32) thread_arena_count;
+} parse_unit_queue; // shared between the threads that compile function bodies
+
 // Defines
 
-#define PARSER_GET_DATA(type, offset) (*((type*) (parser.data_stack_start + (offset))))
+#define PARSER_GET_DATA_POINTER(type, offset) ((type*) (parser.tokens.data_stack_start + (offset)))
+#define PARSER_GET_DATA(type, offset) (*PARSER_GET_DATA_POINTER(type, offset))
+#define PARSER_GET_SYMBOL(token) ((wave_symbol) (token).data_index)
+#define PARSER_GET_IDENTIFIER(symbol) (parser.tokens.identifiers[symbol])
 
 #define PARSER_EXPECT_RETURN(return_expression, token, parse_function, message_format, ...) do { if (!parser_consume(token)) { PARSER_RAISE_ERROR(parse_function, message_format, __VA_ARGS__); return return_expression; } } while (0)
 #define PARSER_EXPECT(token, parse_function, message_format, ...) PARSER_EXPECT_RETURN(, token, parse_function, message_format, __VA_ARGS__)
 
+#define PARSER_NODE(operation, result_type, offset, ...) ((wave_ast_node) { .type = (operation), .value_type = (result_type), .source_offset = (offset), .next_node = WAVE_AST_NONE, __VA_ARGS__ })
+#define PARSER_INSTRUCTION(instruction_opcode, result_type, offset, ...) ((wave_ir_instruction) { .opcode = (instruction_opcode), .operation = NODE_TYPE_NONE, .value_type = (result_type), .source_offset = (offset), __VA_ARGS__ })
+
+#define PARSER_IS_SIGNED_TYPE(type) ((type) >= WAVE_TYPE_I8 && (type) <= WAVE_TYPE_I64)
+
 // error handling
 
-#define PARSER_RAISE_WARNING(function_name, message_format, ...) COMPILER_RAISE_WARNING(function_name, parser.current_file_name, parser.current_line, parser.current_row, message_format, __VA_ARGS__)
+#define PARSER_LINE(source_offset) wave_compiler_tokenizer_get_line(source_offset)
+#define PARSER_ROW(source_offset) wave_compiler_tokenizer_get_row(source_offset)
+
+#define PARSER_RAISE_WARNING(function_name, message_format, ...) COMPILER_RAISE_WARNING(function_name, parser.current_file_name, PARSER_LINE(parser.current.source_offset), PARSER_ROW(parser.current.source_offset), message_format, __VA_ARGS__)
 
-#define PARSER_RAISE_ERROR(function_name, message_format, ...) COMPILER_RAISE_ERROR(function_name, parser.current_file_name, parser.current_line, parser.current_row, message_format, __VA_ARGS__)
-#define PARSER_RAISE_ERROR_PREV(function_name, message_format, ...) COMPILER_RAISE_ERROR(function_name, parser.current_file_name, parser.previous_line, parser.previous_row, message_format, __VA_ARGS__)
-#define PARSER_RAISE_ERROR_AT(function_name, message_format, line, row, ...) COMPILER_RAISE_ERROR(function_name, parser.current_file_name, line, row, message_format, __VA_ARGS__)
+#define PARSER_RAISE_ERROR(function_name, message_format, ...) COMPILER_RAISE_ERROR(function_name, parser.current_file_name, PARSER_LINE(parser.current.source_offset), PARSER_ROW(parser.current.source_offset), message_format, __VA_ARGS__)
+#define PARSER_RAISE_ERROR_PREV(function_name, message_format, ...) COMPILER_RAISE_ERROR(function_name, parser.current_file_name, PARSER_LINE(parser.previous.source_offset), PARSER_ROW(parser.previous.source_offset), message_format, __VA_ARGS__)
+#define PARSER_RAISE_ERROR_AT(function_name, message_format, source_offset, ...) COMPILER_RAISE_ERROR(function_name, parser.current_file_name, PARSER_LINE(source_offset), PARSER_ROW(source_offset), message_format, __VA_ARGS__)
 
 // helper
 
@@ -282,6 +515,9 @@ static void parser_end_scope(void);
 
 // quick access
 
+static bool parser_reserve_symbols(u32 symbol_count);
+
+static parse_token parser_get_token(u32 index);
 static parse_token parser_peek(i32 offset);
 
 static void parser_advance(void);
@@ -291,8 +527,6 @@ static void parser_set(parse_token previous, parse_token current);
 static bool parser_consume(wave_token token);
 static bool parser_match(wave_token token);
 
-static void parser_update_position(void);
-
 // emit
 
 static void emit_byte(byte value);
@@ -301,10 +535,12 @@ static void emit_u8(u8 value);
 static void emit_u16(u16 value);
 static void emit_u32(u32 value);
 static void emit_u64(u64 value);
+static void emit_bytecode(const byte* bytecode, u32 size);
 
 // complex parse
 
 static void parse_expression(wave_type parent_expression_type); // any combination of arithmetic operations on numbers and/or variables
+static wave_ast_index parse_expression_node(wave_type parent_expression_type); // parses an expression into @function_parser.ast without generating code for it
 static void parse_declaration(void); // top level only: functions, global variables, the entrypoint ...
 static void parse_statement(void); // parses statements and variable declarations
 static void parse_block(void); // a separate scope that consists of zero or more statements
@@ -317,12 +553,16 @@ static void parse_variable_initializer_statement(void);
 static void parse_variable_string_initializer_statement(void);
 
 static void parse_function_call_statement(bool reference_function_call, wave_type* out_return_type);
+static void parse_identifier_statement(void); // an assignment or function call, the identifier is the current token
 
 static void parse_if_statement(void);
 static void parse_do_statement(void);
 static void parse_while_statement(void);
 static void parse_for_statement(void);
+static wave_ir_index parse_loop_condition(void); // the branch ending the header of the loop, its targets are set by @parse_loop_body
+static void parse_loop_body(wave_ir_block_index header_block, wave_ir_block_index continue_block, wave_ir_index branch); // continues behind the loop once the body is parsed
 static void parse_switch_statement(void);
+static wave_ir_block_index parse_switch_case_body(wave_ir_block_index switch_block, bool has_body, wave_ir_index* out_jump); // the block of a case, which ends with a jump to the end of the switch
 
 static void parse_return_statement(void);
 static void parse_exit_statement(void);
@@ -332,7 +572,8 @@ static void parse_label_statement(void);
 // parse declaration
 
 static void parse_function_parameters(parse_parameter** out_parameters, bool* out_function_forward_declared);
-static void parse_function_body(str function_name_source_pointer, u32 function_start_line, u32 function_start_row, const parse_parameter* parameters);
+static void parse_function_body(str function_name_source_pointer, u32 function_start_offset, const parse_parameter* parameters);
+static void parse_function_unit(u32 function_index, u32 declaration_token_index, str function_name_source_pointer, u32 function_start_offset, parse_parameter* parameters);
 
 static void parse_function_declaration(void);
 static void parse_entrypoint_declaration(void);
@@ -349,18 +590,81 @@ static void parse_precedence(wave_type expression_type, parsing_precedence prece
 
 // variables
 
-static wave_local* add_local(wave_type type, string_hash name, bool initialized);
-static u32 resolve_local(string_hash name, wave_local* out_variable);
-static void add_global(wave_type type, string_hash name);
-static bool resolve_global(string_hash name, wave_global* out_variable);
-
-static bool resolve_variable(string_hash name, wave_type* out_type);
-static bool emit_variable(string_hash name, bool evaluate, bool assign_expression);
+static wave_local* add_local(wave_type type, wave_symbol symbol, bool initialized);
+static void pop_local(void);
+static u32 resolve_local(wave_symbol symbol, wave_local* out_variable);
+static void mark_local_escaping(wave_symbol symbol);
+static void add_global(wave_type type, wave_symbol symbol);
+static bool resolve_global(wave_symbol symbol, wave_global* out_variable);
+
+static bool resolve_variable(wave_symbol symbol, wave_type* out_type);
+
+// code generation
+
+static void add_node(wave_ast_node node); // makes @node the result of the running parse rule function
+static void generate_expression(wave_ast_index root_node); // optimizes the tree below @root_node and lowers it into @function_parser.ir
+
+static wave_ir_index lower_instruction(wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count);
+static wave_ir_index lower_expression(wave_ast_index index);
+static wave_ir_index lower_variable(wave_symbol symbol, u32 source_offset, bool assign_expression, wave_ir_index value); // a load, or a store of @value if @assign_expression is set
+static void lower_store_local(const wave_local* local, u32 source_offset, wave_ir_index value);
+static wave_ir_index lower_function_call(const wave_ast_node* node);
+static void lower_terminator(ir_opcode opcode, wave_ir_index value); // ends the current block, the statements after it are lowered into a new unreachable one
+static void lower_jump(wave_ir_block_index target); // ends the current block with a jump to @target, which must not be sealed yet
+
+static bool inline_ir_calls(void); // replaces calls of functions with an inline body by a copy of it, returns whether any call was replaced
+static void emit_ir(bool optimize); // emits the bytecode of @function_parser.ir and clears it
+static void emit_ir_value(wave_ir_index index);
+static wave_ir_index get_ir_previous(wave_ir_index index); // the instruction emitted in front of @index, constants are pushed by their users instead
+static void stackify_ir_operands(wave_ir_index index, wave_ir_index* cursor); // marks the operands computed right in front of @index to be left on the stack for it
+static void mark_ir_tail_calls(void); // marks the calls whose value is returned right away to be emitted as tail calls
+static void record_ir_calls(void); // adds the direct calls of the optimized body to @function_parser.call_sites
+static void emit_ir_instruction(wave_ir_index index, wave_ir_block_index next_block); // @next_block is the block placed behind the one of @index, jumps to it are left out
+static void emit_ir_moves(wave_ir_block_index from, wave_ir_block_index to); // stores the phi operands of the edge in the slots of the phis
+static void emit_ir_jump(byte opcode, wave_ir_block_index target, bool short_offset);
+static void add_ir_jump(ir_jump jump);
+static ir_switch_kind get_ir_switch_kind(const wave_ir_instruction* instruction, u64* out_minimum, u64* out_span); // @out_minimum is the smallest case value and @out_span the distance to the largest one, in the width of the switch value
+static u64 get_ir_switch_case_count(const wave_ir_instruction* instruction, u32 case_index); // how often the profile jumped to the case, 0 without a profile
+static u32 get_ir_switch_hot_case(const wave_ir_instruction* instruction, ir_switch_kind kind); // the case compared in front of a lookup switch, U32_MAX if there is none
+static void order_ir_switch_cases(const wave_ir_instruction* instruction, u32* order); // the cases by descending frequency in the profile, ascending values without one
+static void emit_ir_switch(wave_ir_index index, wave_ir_block_index next_block);
+static wave_opcode_extended get_conversion_opcode(wave_type from_type, wave_type to_type); // the specialized form of @OPCODE_TYPE_CONV_STATIC, @OPCODE_EXT_MAX if there is none
+static void add_profile_site(wave_profile_record_type type, u32 source_offset, u64 value, u32 bytecode_offset, wave_profile_counter counter); // does nothing without a profile
+static void optimize_bytecode(u32 start_index); // runs the peephole pass over the bytecode emitted behind @start_index and moves the patch holes along
+static void emit_operation(node_type operation, wave_type result_expression_type, u32 source_offset);
+static void emit_load(wave_type type, u16 offset);
+static void emit_store(wave_type type, u16 offset);
 
 // functions
 
-static bool function_is_defined(string_hash name);
-static bool resolve_function(string_hash name, parse_function* out_function);
+static bool function_is_defined(wave_symbol symbol);
+static bool resolve_function(wave_symbol symbol, parse_function* out_function);
+
+// patch holes
+
+static void add_patch_hole(patch_hole_type type, wave_symbol identifier, u32 token_index);
+static void fix_patch_holes(void);
+
+// function units
+
+static error_code function_parser_new(void);
+static error_code function_parser_destroy(void);
+
+static bool is_inline_candidate(const parse_unit* unit);
+static void parse_unit_body(parse_unit* unit);
+static void parse_queued_units(parse_unit_queue* queue);
+static error_code parse_unit_thread(void* data);
+static void compile_units(const u32* unit_indices, u32 unit_count);
+static bool meet_call_argument(parse_call_argument* value, parse_call_argument argument);
+static void analyze_units(bool specialize); // marks the units that are reachable and, if @specialize is set, the parameters every call passes the same constant for
+static void link_unit(const parse_unit* unit);
+static void parse_units(void);
+
+// incremental compilation
+
+static u64 get_symbol_signature(wave_symbol symbol);
+static bool hash_declaration(u32 declaration_token_index, u64* out_key, u32* out_end_index);
+static void cache_unit(const parse_unit* unit);
 
 // other
 
@@ -377,33 +681,25 @@ static void parser_begin_scope(void) {
 static void parser_end_scope(void) {
     function_parser.scope_depth--;
 
-    while (function_parser.locals_count > 0 && function_parser.locals[function_parser.locals_count - 1].depth > function_parser.scope_depth) { // only pop the variables of the current scope off the stack
-        switch (function_parser.locals[function_parser.locals_count - 1].type) { // TODO: optimize using @OPCODE_POP_N
-            case WAVE_TYPE_U8:
-            case WAVE_TYPE_I8: {
-                emit_byte(OPCODE_POP_8);
-                break;
-            }
+    while (function_parser.locals_count > 0 && function_parser.locals[function_parser.locals_count - 1].depth > function_parser.scope_depth) { // only release the variables of the current scope
+        wave_local* local = &function_parser.locals[function_parser.locals_count - 1];
 
-            case WAVE_TYPE_U16:
-            case WAVE_TYPE_I16: {
-                emit_byte(OPCODE_POP_16);
-                break;
-            }
+        // the frame slots of the locals stay reserved until the function returns (see @OPCODE_CALL), so that the end of a scope
+        // inside of a loop keeps the stack balanced, only objects on the heap have to be freed
 
+        switch (local->type) {
+            case WAVE_TYPE_U8:
+            case WAVE_TYPE_I8:
+            case WAVE_TYPE_U16:
+            case WAVE_TYPE_I16:
             case WAVE_TYPE_U32:
             case WAVE_TYPE_I32:
             case WAVE_TYPE_F32:
-
-            case WAVE_TYPE_FUNC: {
-                emit_byte(OPCODE_POP_32);
-                break;
-            }
-
             case WAVE_TYPE_U64:
             case WAVE_TYPE_I64:
-            case WAVE_TYPE_F64: {
-                emit_byte(OPCODE_POP_64);
+            case WAVE_TYPE_F64:
+
+            case WAVE_TYPE_FUNC: {
                 break;
             }
 
@@ -412,7 +708,22 @@ static void parser_end_scope(void) {
 
             case WAVE_TYPE_ENUM:
             case WAVE_TYPE_STRUCT: {
-                emit_byte(OPCODE_POP_FREE);
+                // all uses of the variable have been parsed at this point, which is why its allocation can now be finalized
+
+                if (local->allocation_index != U32_MAX) {
+                    if (!local->escapes) {
+                        break; // the object lives in the stack frame and is not freed
+                    }
+
+                    WAVE_IR_INSTRUCTION(&function_parser.ir, local->allocation_index)->string_data.heap = true;
+                }
+
+                wave_ir_index address = lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_LOAD_LOCAL, local->type, parser.previous.source_offset, .variable_data = { .variable = local->ir_variable, .offset = local->offset, .type = local->type, .definition = WAVE_IR_NONE }), NULL, 0);
+                if (compiler_has_error()) {
+                    return;
+                }
+
+                lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_POP, WAVE_TYPE_NONE, parser.previous.source_offset, .pop_data = { .opcode = OPCODE_POP_FREE }), &address, 1);
                 break;
             }
 
@@ -422,40 +733,104 @@ static void parser_end_scope(void) {
             }
         }
 
-        function_parser.locals_count--;
+        if (compiler_has_error()) {
+            return;
+        }
+
+        pop_local();
     }
 }
 
 // quick access
 
-static parse_token parser_peek(i32 offset) {
-    return *(parser.tokenized_current + offset);
+static bool parser_reserve_symbols(u32 symbol_count) {
+    if (symbol_count <= parser.symbol_count) {
+        return true;
+    }
+
+    if (symbol_count > parser.symbol_capacity) {
+        u32 symbol_capacity = parser.symbol_capacity * 2;
+        if (symbol_capacity < symbol_count) {
+            symbol_capacity = symbol_count;
+        }
+
+        #define PARSER_GROW_SYMBOL_LOOKUP(pointer)                                                                                            \
+            do {                                                                                                                              \
+                if (parser.vm->reallocate_memory((void**) &(pointer), sizeof(u32) * symbol_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {    \
+                    PARSER_RAISE_ERROR("parser_reserve_symbols", "failed to reallocate symbol lookup");                                       \
+                    return false;                                                                                                             \
+                }                                                                                                                             \
+                                                                                                                                              \
+                memory_set_32((pointer) + parser.symbol_capacity, U32_MAX, symbol_capacity - parser.symbol_capacity);                         \
+            } while (0)
+
+        PARSER_GROW_SYMBOL_LOOKUP(parser.global_symbols);
+        PARSER_GROW_SYMBOL_LOOKUP(parser.function_symbols);
+        PARSER_GROW_SYMBOL_LOOKUP(parser.native_symbols);
+        PARSER_GROW_SYMBOL_LOOKUP(function_parser.local_symbols);
+
+        #undef PARSER_GROW_SYMBOL_LOOKUP
+
+        parser.symbol_capacity = symbol_capacity;
+    }
+
+    for (u32 i = parser.symbol_count; i < symbol_count; i++) {
+        parser.native_symbols[i] = wave_symbol_table_find(&parser.native_table, parser.tokens.identifiers[i].hash); // @WAVE_SYMBOL_TABLE_NONE equals U32_MAX
+    }
+
+    parser.symbol_count = symbol_count;
+
+    return true;
 }
 
-static void parser_advance(void) { // TODO: add out of bound check?
-    if (parser.tokenized_current >= parser.tokenized_end) {
-        PARSER_RAISE_ERROR("parser_advance", "unexpected: left the bounds fo the tokenized source");
-        return;
+static parse_token parser_get_token(u32 index) {
+    if (index >= parser.tokens.count && !parser.tokens.complete) {
+        if (wave_compiler_tokenizer_pull(&parser.tokens, index) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parser_get_token", "failed to tokenize source");
+            return (parse_token) { .token = WAVE_TOKEN_FILE_END, .data_index = 0, .source_offset = 0 };
+        }
+
+        if (!parser_reserve_symbols(parser.tokens.identifier_count)) {
+            return (parse_token) { .token = WAVE_TOKEN_FILE_END, .data_index = 0, .source_offset = 0 };
+        }
+    }
+
+    if (index >= parser.tokens.count) {
+        index = parser.tokens.count - 1; // @WAVE_TOKEN_FILE_END
     }
 
-    parser.previous = parser.current;
-    parser.current = *parser.tokenized_current;
-    parser.tokenized_current++;
+    index &= parser.tokens.window_mask;
+
+    return (parse_token) {
+        .token = parser.tokens.tokens[index],
+        .data_index = parser.tokens.data_indices[index],
+        .source_offset = parser.tokens.source_offsets[index]
+    };
+}
+
+static parse_token parser_peek(i32 offset) {
+    return parser_get_token((u32) ((i32) parser.token_index + offset));
+}
+
+static void parser_advance(void) {
+    parse_token current = parser_get_token(parser.token_index); // stays at @WAVE_TOKEN_FILE_END once the end has been reached
 
-    parser_update_position();
+    parser.previous = parser.token_index > 0 ? parser_get_token(parser.token_index - 1) : parser.current; // read again, pulling tokens may have moved its data
+    parser.current = current;
+    if (parser.token_index < parser.tokens.count) {
+        parser.token_index++;
+    }
 }
 
 static void parser_reverse(void) {
-    if (parser.tokenized_current <= parser.tokenized_start) {
+    if (parser.token_index < 2) {
         PARSER_RAISE_ERROR("parser_reverse", "unexpected: left the bounds fo the tokenized source");
         return;
     }
 
     parser.current = parser.previous;
-    parser.previous = *(parser.tokenized_current - 2);
-    parser.tokenized_current--;
-
-    parser_update_position();
+    parser.previous = parser_get_token(parser.token_index - 2);
+    parser.token_index--;
 }
 
 static void parser_set(parse_token previous, parse_token current) {
@@ -481,24 +856,23 @@ static bool parser_match(wave_token token) {
     return true;
 }
 
-static void parser_update_position(void) {
-    parser.previous_line = parser.previous.line;
-    parser.previous_row = parser.previous.row;
-
-    parser.current_line = parser.current.line;
-    parser.current_row = parser.current.row;
-}
-
 // emit
 
 #define BYTECODE_FITS_SIZE(size)                                                                                                                                \
     do {                                                                                                                                                        \
         if (parser.bytecode_current + (size) > parser.bytecode_end) {                                                                                           \
-            parser.bytecode_capacity += BYTECODE_STACK_GROW_SIZE;                                                                                               \
+            u32 bytecode_length = parser.bytecode_current - parser.bytecode_start;                                                                              \
+            while (bytecode_length + (size) > parser.bytecode_capacity) {                                                                                       \
+                parser.bytecode_capacity *= 2;                                                                                                                  \
+            }                                                                                                                                                   \
+                                                                                                                                                                \
             if (parser.vm->reallocate_memory((void**) &(parser.bytecode_start), sizeof(byte) * parser.bytecode_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {  \
                 PARSER_RAISE_ERROR("bytecode", "failed to reallocate bytecode");                                                                                \
                 return;                                                                                                                                         \
             }                                                                                                                                                   \
+                                                                                                                                                                \
+            parser.bytecode_current = parser.bytecode_start + bytecode_length;                                                                                  \
+            parser.bytecode_end = parser.bytecode_start + parser.bytecode_capacity;                                                                             \
         }                                                                                                                                                       \
     } while (0)
 
@@ -524,17 +898,32 @@ static void emit_u16(u16 value) { BYTECODE_FITS_SIZE(sizeof(u16)); BYTECODE_PUSH
 static void emit_u32(u32 value) { BYTECODE_FITS_SIZE(sizeof(u32)); BYTECODE_PUSH_DATA_UNSAFE(u32, value); }
 static void emit_u64(u64 value) { BYTECODE_FITS_SIZE(sizeof(u64)); BYTECODE_PUSH_DATA_UNSAFE(u64, value); }
 
+static void emit_bytecode(const byte* bytecode, u32 size) {
+    BYTECODE_FITS_SIZE(size);
+    memory_copy((void*) bytecode, parser.bytecode_current, size);
+    parser.bytecode_current += size;
+}
+
 #undef BYTECODE_FITS_SIZE
 #undef BYTECODE_PUSH_DATA_UNSAFE
 
 // complex parse
 
 static void parse_expression(wave_type parent_expression_type) {
-    parse_precedence(parent_expression_type, PRECEDENCE_ASSIGNMENT);
-    DEBUG_INFO("line: %u, row: %u", parser.current_line, parser.current_row);
+    wave_ast_clear(&function_parser.ast);
+
+    wave_ast_index root_node = parse_expression_node(parent_expression_type);
+    DEBUG_INFO("line: %u, row: %u", PARSER_LINE(parser.current.source_offset), PARSER_ROW(parser.current.source_offset));
     if (compiler_has_error()) {
         return;
     }
+
+    generate_expression(root_node);
+}
+
+static wave_ast_index parse_expression_node(wave_type parent_expression_type) {
+    parse_precedence(parent_expression_type, PRECEDENCE_ASSIGNMENT);
+    return function_parser.expression_node;
 }
 
 static void parse_declaration(void) {
@@ -589,8 +978,7 @@ static void parse_statement(void) {
         }
 
         case WAVE_TOKEN_IDENTIFIER: {
-            parser_advance();
-            parse_identifier(WAVE_TYPE_VOID, false);
+            parse_identifier_statement();
             break;
         }
 
@@ -618,7 +1006,7 @@ static void parse_statement(void) {
                 }
 
                 case WAVE_TYPE_STR: {
-
+                    parse_variable_string_initializer_statement();
                     break;
                 }
 
@@ -653,13 +1041,12 @@ static void parse_statement(void) {
 static void parse_block(void) {
     PARSER_EXPECT(WAVE_TOKEN_OP_CURLY_BRACKET_OPEN, "parse_block", "expected start of block statement, missing opening curly bracket ('{')");
 
-    u32 block_start_line = parser.current_line;
-    u32 block_start_row = parser.current_row;
+    u32 block_start_offset = parser.current.source_offset;
 
     while (parser.current.token != WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE && parser.current.token != WAVE_TOKEN_FILE_END) {
         parse_statement();
         if (compiler_has_error()) {
-            PARSER_RAISE_ERROR_AT("parse_block", "error in block statement", block_start_line, block_start_row);
+            PARSER_RAISE_ERROR_AT("parse_block", "error in block statement", block_start_offset);
             return;
         }
     }
@@ -680,7 +1067,7 @@ static void parse_variable_initializer_statement(void) {
     parser_advance();
 
     PARSER_EXPECT(WAVE_TOKEN_IDENTIFIER, "parse_variable_initializer_statement", "variable name expected");
-    string_hash identifier = PARSER_GET_DATA(wave_identifier, parser.previous.data_index).hash;
+    wave_symbol identifier = PARSER_GET_SYMBOL(parser.previous);
 
     wave_local* local_variable = add_local(variable_type, identifier, false);
 
@@ -698,21 +1085,9 @@ static void parse_variable_initializer_statement(void) {
 
     local_variable->initialized = true;
 
-    // emit variable setter
-
-    switch (wave_type_get_size(variable_type)) {
-        case (sizeof(u8)):  { emit_byte(OPCODE_STORE_8);  break; }
-        case (sizeof(u16)): { emit_byte(OPCODE_STORE_16); break; }
-        case (sizeof(u32)): { emit_byte(OPCODE_STORE_32); break; }
-        case (sizeof(u64)): { emit_byte(OPCODE_STORE_64); break; }
-
-        default: {
-            PARSER_RAISE_ERROR("parse_variable_initializer_statement", "unknown variable type");
-            return;
-        }
-    }
+    // lower variable setter
 
-    emit_u16(local_variable->offset);
+    lower_store_local(local_variable, parser.previous.source_offset, function_parser.expression_value);
 
     // end of statement
 
@@ -723,9 +1098,12 @@ static void parse_variable_string_initializer_statement(void) {
     PARSER_EXPECT(WAVE_TOKEN_KEYWORD_STR, "parse_variable_string_initializer_statement", "expected string type variable (\"%s\" keyword)", (str_format_data) keyword_tokens[WAVE_TOKEN_KEYWORD_STR].string);
 
     PARSER_EXPECT(WAVE_TOKEN_IDENTIFIER, "parse_variable_initializer_statement", "variable name expected");
-    string_hash identifier = PARSER_GET_DATA(wave_identifier, parser.previous.data_index).hash;
+    wave_symbol identifier = PARSER_GET_SYMBOL(parser.previous);
 
     wave_local* local_variable = add_local(WAVE_TYPE_STR, identifier, false);
+    if (local_variable == NULL) {
+        return;
+    }
 
     // check if the variable is an assign expression or if it has an initializer
 
@@ -733,14 +1111,45 @@ static void parse_variable_string_initializer_statement(void) {
         return;
     }
 
-    // TODO: assign expression
+    PARSER_EXPECT(WAVE_TOKEN_OP_ASSIGN, "parse_variable_string_initializer_statement", "expected initializer, missing assignment ('=')");
+
+    // string literals are placed in the stack frame, until the variable is found to escape (see @parser_end_scope)
+
+    u32 string_size = 0;
+    if (parser.current.token == WAVE_TOKEN_VALUE_STR) {
+        string_size = sizeof(u32) + PARSER_GET_DATA(u32, parser.current.data_index);
+    }
+
+    if (string_size != 0 && string_size <= WAVE_LIMIT_MAX_FRAME_OBJECT_SIZE && (u32) function_parser.locals_offset + string_size < WAVE_LIMIT_OPCODE_STR_NEW_LOCAL_HEAP) {
+        parser_advance();
+
+        u32 data_index = 0;
+        if (wave_ir_insert_data(&function_parser.ir, PARSER_GET_DATA_POINTER(byte, parser.previous.data_index), string_size, &data_index) != ERROR_CODE_EXECUTION_SUCCESSFUL) { // the length followed by the characters
+            PARSER_RAISE_ERROR("parse_variable_string_initializer_statement", "failed to reallocate intermediate representation data");
+            return;
+        }
+
+        function_parser.expression_value = lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_STRING_LOCAL, WAVE_TYPE_STR, parser.previous.source_offset, .string_data = { .data_index = data_index, .frame_offset = function_parser.locals_offset, .heap = false }), NULL, 0);
+        local_variable->allocation_index = function_parser.expression_value;
+
+        function_parser.locals_offset += string_size; // the frame space stays reserved, even if the string escapes
+    } else {
+        parse_expression(WAVE_TYPE_STR);
+    }
+
+    local_variable->initialized = true;
+
+    lower_store_local(local_variable, parser.previous.source_offset, function_parser.expression_value);
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_SEMICOLON, "parse_variable_string_initializer_statement", "expected semicolon (';')");
 }
 
 static void parse_function_call_statement(bool reference_function_call, wave_type* out_return_type) {
     PARSER_EXPECT(WAVE_TOKEN_IDENTIFIER, "parse_function_call_statement", "expected function name");
-    string_hash identifier_name = PARSER_GET_DATA(wave_identifier, parser.previous.data_index).hash;
+    wave_symbol identifier = PARSER_GET_SYMBOL(parser.previous);
+    u32 identifier_token_index = parser.token_index - 2; // the index of @parser.previous
 
-    DEBUG_INFO("parse_function_call_statement: identifier_name = %x64", identifier_name);
+    DEBUG_INFO("parse_function_call_statement: identifier_name = %x64", PARSER_GET_IDENTIFIER(identifier).hash);
 
     // resolve function
 
@@ -750,7 +1159,7 @@ static void parse_function_call_statement(bool reference_function_call, wave_typ
 
     if (reference_function_call) {
         wave_type type = WAVE_TYPE_NONE;
-        if (!resolve_variable(identifier_name, &type)) {
+        if (!resolve_variable(identifier, &type)) {
             PARSER_RAISE_ERROR("parse_function_call_statement", "unknown variable");
             return;
         }
@@ -760,61 +1169,54 @@ static void parse_function_call_statement(bool reference_function_call, wave_typ
             return;
         }
     } else {
-        bool function_defined = false;
-        for (u32 i = 0; i < parser.functions_count; i++) {
-            if (parser.functions[i].function_data.name == identifier_name) {
-                function = parser.functions[i];
-                function_defined = true;
-                break;
-            }
-        }
-
-        if (!function_defined) {
-            for (u32 i = 0; i < parser.vm->function_stack_length; i++) {
-                if (parser.vm->native_functions[i].function_data.name == identifier_name) {
-                    function.function_data = parser.vm->native_functions[i].function_data;
-                    native_function_index = i;
-
-                    function_defined = true;
-                    break;
-                }
-            }
-
-            if (!function_defined) {
+        if (!resolve_function(identifier, &function)) {
+            u32 native_index = parser.native_symbols[identifier];
+            if (native_index == U32_MAX) {
                 PARSER_RAISE_ERROR("parse_function_call_statement", "failed to resolve function, unknown function");
                 return;
             }
 
+            function = PARSE_FUNCTION_NULL;
+            function.function_data = parser.vm->native_functions[native_index].function_data;
+            native_function_index = (u16) native_index;
+
             native_function = true;
         }
     }
 
     *out_return_type = function.function_data.return_type;
 
-    // parse parameters
+    u32 source_offset = parser.previous.source_offset;
+
+    // parse parameters, every parameter becomes a node of the argument list
+
+    wave_ast_index first_argument = WAVE_AST_NONE;
+    wave_ast_index last_argument = WAVE_AST_NONE;
 
     PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_OPEN, "parse_function_call_statement", "expected parameter list, missing opening parentheses ('(')");
 
     for (u32 i = 0; i < function.function_data.parameter_count; i++) {
         wave_type parameter_type = function.function_data.parameters[i].type;
 
-        if (parser.current.token == WAVE_TOKEN_OP_PARENTHESES_CLOSE && function.function_data.parameters[i].has_default_value) {
-            union_number default_value = function.function_data.parameters[i].default_value;
-
+        bool default_value = parser.current.token == WAVE_TOKEN_OP_PARENTHESES_CLOSE && function.function_data.parameters[i].has_default_value;
+        if (default_value) {
             switch (parameter_type) {
                 case WAVE_TYPE_U8:
-                case WAVE_TYPE_I8: { emit_u8(default_value.value_u8); break; }
+                case WAVE_TYPE_I8:
 
                 case WAVE_TYPE_U16:
-                case WAVE_TYPE_I16: { emit_u16(default_value.value_u16); break; }
+                case WAVE_TYPE_I16:
 
                 case WAVE_TYPE_U32:
                 case WAVE_TYPE_I32:
-                case WAVE_TYPE_F32: { emit_u32(default_value.value_u32); break; }
+                case WAVE_TYPE_F32:
 
                 case WAVE_TYPE_U64:
                 case WAVE_TYPE_I64:
-                case WAVE_TYPE_F64: { emit_u64(default_value.value_u64); break; }
+                case WAVE_TYPE_F64: {
+                    add_node(PARSER_NODE(NODE_TYPE_CONSTANT, parameter_type, parser.current.source_offset, .constant_data = { .value = function.function_data.parameters[i].default_value }));
+                    break;
+                }
 
                 case WAVE_TYPE_FUNC:
 
@@ -832,25 +1234,44 @@ static void parse_function_call_statement(bool reference_function_call, wave_typ
                     return;
                 }
             }
+        } else {
+            if (parser.current.token == WAVE_TOKEN_OP_PARENTHESES_CLOSE) {
+                PARSER_RAISE_ERROR("parse_function_call_statement", "incomplete function call, expected %u parameters, got %u", function.function_data.parameter_count, i);
+                return;
+            } else if (parser.current.token == WAVE_TOKEN_FILE_END) {
+                PARSER_RAISE_ERROR("parse_function_call_statement", "incomplete function call, unexpected end of file, missing closing parentheses (')')");
+                return;
+            }
 
-            continue;
+            // parse parameter expression, objects passed to native functions do not escape
+
+            bool non_escaping_context = function_parser.non_escaping_context;
+            function_parser.non_escaping_context = native_function;
+
+            parse_expression_node(parameter_type);
+
+            function_parser.non_escaping_context = non_escaping_context;
         }
 
-        if (parser.current.token == WAVE_TOKEN_OP_PARENTHESES_CLOSE) {
-            PARSER_RAISE_ERROR("parse_function_call_statement", "incomplete function call, expected %u parameters, got %u", function.function_data.parameter_count, i);
-            return;
-        } else if (parser.current.token == WAVE_TOKEN_FILE_END) {
-            PARSER_RAISE_ERROR("parse_function_call_statement", "incomplete function call, unexpected end of file, missing closing parentheses (')')");
+        if (compiler_has_error()) {
             return;
         }
 
-        // parse parameter expression
+        // append the parameter to the argument list
+
+        if (last_argument != WAVE_AST_NONE) {
+            WAVE_AST_NODE(&function_parser.ast, last_argument)->next_node = function_parser.expression_node;
+        } else {
+            first_argument = function_parser.expression_node;
+        }
 
-        parse_expression(parameter_type);
+        last_argument = function_parser.expression_node;
 
         // continue to next parameter
 
-        if (i == function.function_data.parameter_count - 1) {
+        if (default_value) {
+            continue;
+        } else if (i == function.function_data.parameter_count - 1) {
             break;
         } else {
             PARSER_EXPECT(WAVE_TOKEN_OP_COMMA, "parse_function_call_statement", "expected parameter separation, missing comma (',') between parameters");
@@ -859,96 +1280,522 @@ static void parse_function_call_statement(bool reference_function_call, wave_typ
 
     PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_CLOSE, "parse_function_call_statement", "too many parameters for function call, expected %u parameters", function.function_data.parameter_count);
 
-    // emit function call
+    add_node(PARSER_NODE(NODE_TYPE_STATEMENT_FUNCTION_CALL, function.function_data.return_type, source_offset, .function_call_data = {
+        .native_function = native_function,
+        .reference_function = reference_function_call,
+        .error_function = function.function_data.error_function,
+        .native_function_index = native_function_index,
+        .symbol = identifier,
+        .token_index = identifier_token_index,
+        .first_argument = first_argument,
+        .argument_count = function.function_data.parameter_count
+    }));
+}
 
-    if (!function.initialized) {
-        // TODO: add the current bytecode offset to a list of "patch holes"
-    }
+static void parse_identifier_statement(void) {
+    parser_advance();
 
-    if (reference_function_call) {
-        emit_variable(identifier_name, true, false);
+    wave_ast_clear(&function_parser.ast);
+    function_parser.expression_node = WAVE_AST_NONE;
 
-        if (native_function) {
-            if (function.function_data.error_function) {
-                emit_byte(OPCODE_CALL_DYN_ERR);
-            } else {
-                emit_byte(OPCODE_CALL_DYN);
-            }
-        } else {
-            if (function.function_data.error_function) {
-                emit_byte(OPCODE_CALL_DYN_ERR);
-                emit_byte(OPCODE_ERR_CHECK);
-            } else {
-                emit_byte(OPCODE_CALL_DYN);
-            }
-        }
-    } else {
-        if (native_function) {
-            if (function.function_data.error_function) {
-                emit_byte(OPCODE_CALL_NATIVE_ERR);
-                emit_u16(native_function_index);
-            } else {
-                emit_byte(OPCODE_CALL_NATIVE);
-                emit_u16(native_function_index);
-            }
-        } else {
-            if (function.function_data.error_function) {
-                emit_byte(OPCODE_CALL);
-                emit_u16(function.branch_offset);
-                emit_byte(OPCODE_ERR_CHECK);
-            } else {
-                emit_byte(OPCODE_CALL);
-                emit_u32(function.branch_offset);
-            }
-        }
+    parse_identifier(WAVE_TYPE_VOID, true);
+    if (!compiler_has_error()) {
+        generate_expression(function_parser.expression_node);
     }
 }
 
 static void parse_if_statement(void) {}
 static void parse_do_statement(void) {}
-static void parse_while_statement(void) {}
-static void parse_for_statement(void) {}
-static void parse_switch_statement(void) {}
 
-static void parse_return_statement(void) {
-    DEBUG_ASSERT(function_parser.scope_depth >= 1, "not inside a function scope");
+static void parse_while_statement(void) {
+    PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_OPEN, "parse_while_statement", "expected loop condition, missing opening parentheses ('(')");
 
-    if ((*parser.current_function).function_data.return_type == WAVE_TYPE_NONE) {
-        goto parse_return_statement_end;
-    }
+    // the condition is checked in a header of its own, which stays unsealed until the back edge of the body is known
 
-    // TODO: pop stack
+    wave_ir_block_index header_block = WAVE_IR_NONE;
+    if (wave_ir_add_block(&function_parser.ir, &header_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_while_statement", "failed to reallocate intermediate representation blocks");
+        return;
+    }
 
-    parse_expression((*(parser.current_function)).function_data.return_type);
+    lower_jump(header_block);
+    if (compiler_has_error()) {
+        return;
+    }
 
-    parse_return_statement_end: {}
+    function_parser.ir.current_block = header_block;
+
+    wave_ir_index branch = parse_loop_condition();
+    if (compiler_has_error()) {
+        return;
+    }
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_CLOSE, "parse_while_statement", "expected end of loop condition, missing closing parentheses (')')");
+
+    parse_loop_body(header_block, header_block, branch);
+}
+
+static void parse_for_statement(void) {
+    wave_ir* ir = &function_parser.ir;
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_OPEN, "parse_for_statement", "expected loop declaration, missing opening parentheses ('(')");
+
+    // the declared variable is visible in the whole loop and popped behind it
+
+    parser_begin_scope();
+
+    wave_type declaration_type = token_get_wave_type(parser.current.token);
+    if (declaration_type != WAVE_TYPE_VOID && declaration_type != WAVE_TYPE_NONE) {
+        if (declaration_type > WAVE_TYPE_F64) {
+            PARSER_RAISE_ERROR("parse_for_statement", "loop variable has to be a number");
+            return;
+        }
+
+        parse_variable_initializer_statement(); // consumes the semicolon
+    } else {
+        if (parser.current.token == WAVE_TOKEN_IDENTIFIER) {
+            parse_identifier_statement();
+        }
+
+        PARSER_EXPECT(WAVE_TOKEN_OP_SEMICOLON, "parse_for_statement", "expected semicolon (';') behind the loop declaration");
+    }
+
+    if (compiler_has_error()) {
+        return;
+    }
+
+    wave_ir_block_index header_block = WAVE_IR_NONE;
+    wave_ir_block_index step_block = WAVE_IR_NONE;
+    if (wave_ir_add_block(ir, &header_block) != ERROR_CODE_EXECUTION_SUCCESSFUL || wave_ir_add_block(ir, &step_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_for_statement", "failed to reallocate intermediate representation blocks");
+        return;
+    }
+
+    lower_jump(header_block);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    ir->current_block = header_block;
+
+    // a loop without a condition only ends through a return or exit
+
+    wave_ir_index branch = WAVE_IR_NONE;
+    if (parser.current.token != WAVE_TOKEN_OP_SEMICOLON) {
+        branch = parse_loop_condition();
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_SEMICOLON, "parse_for_statement", "expected semicolon (';') behind the loop condition");
+
+    // the step is parsed in front of the body, into the block the body continues at, so that it ends with the back edge of the loop
+
+    ir->current_block = step_block;
+
+    if (parser.current.token == WAVE_TOKEN_IDENTIFIER) {
+        parse_identifier_statement();
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    lower_jump(header_block);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_CLOSE, "parse_for_statement", "expected end of loop step, missing closing parentheses (')')");
+
+    ir->current_block = header_block;
+
+    parse_loop_body(header_block, step_block, branch);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    parser_end_scope();
+}
+
+static wave_ir_index parse_loop_condition(void) {
+    // there is no type the condition is converted to, which is why its operands are compared in the type of the
+    // type conversion or variable it starts with (e.g. u32(a) < b, i < 10), other conditions are evaluated as i64
+
+    wave_type condition_type = token_get_wave_type(parser.current.token);
+    if (condition_type == WAVE_TYPE_VOID || condition_type == WAVE_TYPE_NONE) {
+        if (parser.current.token != WAVE_TOKEN_IDENTIFIER || !resolve_variable(PARSER_GET_SYMBOL(parser.current), &condition_type)) {
+            condition_type = WAVE_TYPE_I64;
+        }
+    }
+
+    if (condition_type > WAVE_TYPE_F64) {
+        PARSER_RAISE_ERROR("parse_loop_condition", "loop condition has to be a number");
+        return WAVE_IR_NONE;
+    }
+
+    u32 source_offset = parser.current.source_offset;
+
+    parse_expression(condition_type);
+    if (compiler_has_error()) {
+        return WAVE_IR_NONE;
+    }
+
+    wave_ir_index value = function_parser.expression_value;
+    return lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_BRANCH, WAVE_TYPE_NONE, source_offset, .branch_data = { .targets = { WAVE_IR_NONE, WAVE_IR_NONE } }), &value, 1);
+}
+
+static void parse_loop_body(wave_ir_block_index header_block, wave_ir_block_index continue_block, wave_ir_index branch) {
+    wave_ir* ir = &function_parser.ir;
+
+    // the header is the only predecessor of the body, so that the header of the loop dominates it
+
+    wave_ir_block_index body_block = WAVE_IR_NONE;
+    if (wave_ir_add_block(ir, &body_block) != ERROR_CODE_EXECUTION_SUCCESSFUL || wave_ir_add_edge(ir, header_block, body_block) != ERROR_CODE_EXECUTION_SUCCESSFUL || wave_ir_seal_block(ir, body_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_loop_body", "failed to reallocate intermediate representation blocks");
+        return;
+    }
+
+    if (branch == WAVE_IR_NONE) {
+        lower_jump(body_block);
+    } else {
+        WAVE_IR_INSTRUCTION(ir, branch)->branch_data.targets[0] = body_block;
+    }
+
+    if (compiler_has_error()) {
+        return;
+    }
+
+    ir->current_block = body_block;
+
+    if (!parser_match(WAVE_TOKEN_OP_SEMICOLON)) {
+        parser_begin_scope();
+
+        parse_block();
+        if (compiler_has_error()) {
+            return;
+        }
+
+        parser_end_scope();
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    // the body may have ended in another block (e.g. after a return), which then holds the back edge
+
+    lower_jump(continue_block);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    if ((continue_block != header_block && wave_ir_seal_block(ir, continue_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) || wave_ir_seal_block(ir, header_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_loop_body", "failed to reallocate intermediate representation");
+        return;
+    }
+
+    // the loop is left through the false target of the header, a loop without a condition leaves the block unreachable
+
+    wave_ir_block_index exit_block = WAVE_IR_NONE;
+    if (wave_ir_add_block(ir, &exit_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_loop_body", "failed to reallocate intermediate representation blocks");
+        return;
+    }
+
+    if (branch != WAVE_IR_NONE) {
+        WAVE_IR_INSTRUCTION(ir, branch)->branch_data.targets[1] = exit_block;
+        if (wave_ir_add_edge(ir, header_block, exit_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_loop_body", "failed to reallocate intermediate representation blocks");
+            return;
+        }
+    }
+
+    if (wave_ir_seal_block(ir, exit_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_loop_body", "failed to reallocate intermediate representation");
+        return;
+    }
+
+    ir->current_block = exit_block;
+}
+
+static void parse_switch_statement(void) {
+    wave_ir* ir = &function_parser.ir;
+    u32 source_offset = parser.previous.source_offset;
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_OPEN, "parse_switch_statement", "expected switch value, missing opening parentheses ('(')");
+
+    // there is no type the value is converted to, which is why it keeps the type of its variable, call or type conversion (e.g. u16(a + b))
+
+    wave_ast_clear(&function_parser.ast);
+
+    wave_ast_index value_node = parse_expression_node(WAVE_TYPE_VOID);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    const wave_ast_node* value_root = WAVE_AST_NODE(&function_parser.ast, value_node);
+    wave_type value_type = value_root->value_type;
+    if (value_root->type == NODE_TYPE_TYPE_CONVERSION && value_root->value_type == WAVE_TYPE_VOID) {
+        value_type = value_root->type_conversion_data.from_type;
+        value_node = value_root->type_conversion_data.value_node;
+    }
+
+    if (!wave_type_is_integer(value_type)) {
+        PARSER_RAISE_ERROR_AT("parse_switch_statement", "switch value has to be an integer", source_offset);
+        return;
+    }
+
+    generate_expression(value_node);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    wave_ir_index value = function_parser.expression_value;
+
+    u64 value_mask = wave_type_get_size(value_type) == sizeof(u64) ? U64_MAX : (((u64) 1 << (wave_type_get_size(value_type) * 8)) - 1);
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_PARENTHESES_CLOSE, "parse_switch_statement", "expected end of switch value, missing closing parentheses (')')");
+    PARSER_EXPECT(WAVE_TOKEN_OP_CURLY_BRACKET_OPEN, "parse_switch_statement", "expected start of switch case list, missing opening curly bracket ('{')");
+
+    // every case gets a block of its own, the switch instruction is added once all of them are known
+
+    wave_ir_block_index switch_block = ir->current_block;
+    const u32 first_case = function_parser.switch_case_count;
+
+    wave_ir_block_index default_target = WAVE_IR_NONE;
+    wave_ir_index default_jump = WAVE_IR_NONE;
+
+    while (parser.current.token != WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE && parser.current.token != WAVE_TOKEN_FILE_END) {
+        if (parser_consume(WAVE_TOKEN_KEYWORD_DEFAULT)) {
+            if (default_target != WAVE_IR_NONE) {
+                PARSER_RAISE_ERROR_PREV("parse_switch_statement", "switch already has a default case");
+                return;
+            }
+
+            PARSER_EXPECT(WAVE_TOKEN_OP_COLON, "parse_switch_statement", "expected colon (':') behind default case");
+
+            default_target = parse_switch_case_body(switch_block, true, &default_jump);
+            if (compiler_has_error()) {
+                return;
+            }
+
+            continue;
+        }
+
+        PARSER_EXPECT(WAVE_TOKEN_KEYWORD_CASE, "parse_switch_statement", "expected case (\"%s\" keyword) or default case (\"%s\" keyword)", (str_format_data) keyword_tokens[WAVE_TOKEN_KEYWORD_CASE].string, (str_format_data) keyword_tokens[WAVE_TOKEN_KEYWORD_DEFAULT].string);
+
+        // case values are folded to a constant, which is not lowered
+
+        u32 case_offset = parser.current.source_offset;
+
+        wave_ast_clear(&function_parser.ast);
+        function_parser.ast.root_node = parse_expression_node(value_type);
+        if (compiler_has_error()) {
+            return;
+        }
+
+        if (wave_optimizer_optimize(&function_parser.ast) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_switch_statement", "failed to optimize case value");
+            return;
+        }
+
+        const wave_ast_node* node = WAVE_AST_NODE(&function_parser.ast, function_parser.ast.root_node);
+        if (node->type != NODE_TYPE_CONSTANT || !wave_type_is_integer(node->value_type)) {
+            PARSER_RAISE_ERROR_AT("parse_switch_statement", "case value has to be a constant integer", case_offset);
+            return;
+        }
+
+        u64 case_value = 0; // sign extended, then truncated to the width of the switch value
+        switch (node->value_type) {
+            case WAVE_TYPE_U8:  { case_value = node->constant_data.value.value_u8;  break; }
+            case WAVE_TYPE_U16: { case_value = node->constant_data.value.value_u16; break; }
+            case WAVE_TYPE_U32: { case_value = node->constant_data.value.value_u32; break; }
+            case WAVE_TYPE_U64: { case_value = node->constant_data.value.value_u64; break; }
+
+            case WAVE_TYPE_I8:  { case_value = (u64) (i64) node->constant_data.value.value_i8;  break; }
+            case WAVE_TYPE_I16: { case_value = (u64) (i64) node->constant_data.value.value_i16; break; }
+            case WAVE_TYPE_I32: { case_value = (u64) (i64) node->constant_data.value.value_i32; break; }
+            default:            { case_value = (u64) node->constant_data.value.value_i64; break; }
+        }
+
+        case_value &= value_mask;
+        for (u32 i = first_case; i < function_parser.switch_case_count; i++) {
+            if (function_parser.switch_cases[i].value == case_value) {
+                PARSER_RAISE_ERROR_AT("parse_switch_statement", "duplicate case value", case_offset);
+                return;
+            }
+        }
+
+        PARSER_EXPECT(WAVE_TOKEN_OP_COLON, "parse_switch_statement", "expected colon (':') behind case value");
+
+        wave_ir_index jump = WAVE_IR_NONE;
+        wave_ir_block_index target = parse_switch_case_body(switch_block, true, &jump);
+        if (compiler_has_error()) {
+            return;
+        }
+
+        STACK_HELPER_PUSH(
+            function_parser.switch_cases,
+            ((parse_switch_case) {
+                .value = case_value,
+                .target = target,
+                .jump = jump
+            }),
+
+            sizeof(parse_switch_case),
+
+            function_parser.switch_case_capacity,
+            function_parser.switch_case_count,
+
+            SWITCH_CASE_STACK_GROW_SIZE,
+
+            "parse_switch_statement",
+            "failed to reallocate switch case stack"
+        );
+    }
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE, "parse_switch_statement", "expected end of switch case list, missing closing curly bracket ('}')");
+
+    // the default target has no other predecessor either, so that no target of the switch starts with phis
+
+    if (default_target == WAVE_IR_NONE) {
+        default_target = parse_switch_case_body(switch_block, false, &default_jump);
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    // the cases are sorted by their bits, which is the order the case values are searched in
+
+    parse_switch_case* cases = function_parser.switch_cases + first_case;
+    const u32 case_count = function_parser.switch_case_count - first_case;
+
+    for (u32 i = 1; i < case_count; i++) {
+        parse_switch_case switch_case = cases[i];
+
+        u32 j = i;
+        while (j > 0 && cases[j - 1].value > switch_case.value) {
+            cases[j] = cases[j - 1];
+            j--;
+        }
+
+        cases[j] = switch_case;
+    }
+
+    u32 data_index = 0;
+    wave_ir_index switch_instruction = WAVE_IR_NONE;
+    if (wave_ir_insert_switch_data(ir, case_count, &data_index) != ERROR_CODE_EXECUTION_SUCCESSFUL ||
+        wave_ir_insert(ir, PARSER_INSTRUCTION(IR_OPCODE_SWITCH, WAVE_TYPE_NONE, source_offset, .switch_data = { .data_index = data_index, .case_count = case_count }), &value, 1, switch_block, WAVE_IR_NONE, &switch_instruction) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_switch_statement", "failed to reallocate intermediate representation");
+        return;
+    }
+
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, switch_instruction);
+    WAVE_IR_SWITCH_TARGETS(ir, instruction)[0] = default_target;
+    for (u32 i = 0; i < case_count; i++) {
+        WAVE_IR_SWITCH_VALUES(ir, instruction)[i] = cases[i].value;
+        WAVE_IR_SWITCH_TARGETS(ir, instruction)[i + 1] = cases[i].target;
+    }
+
+    // the cases continue behind the switch
+
+    wave_ir_block_index end_block = WAVE_IR_NONE;
+    if (wave_ir_add_block(ir, &end_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_switch_statement", "failed to reallocate intermediate representation blocks");
+        return;
+    }
+
+    for (u32 i = 0; i <= case_count; i++) {
+        wave_ir_instruction* jump = WAVE_IR_INSTRUCTION(ir, i < case_count ? cases[i].jump : default_jump);
+        jump->branch_data.targets[0] = end_block;
+
+        if (wave_ir_add_edge(ir, jump->block, end_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_switch_statement", "failed to reallocate intermediate representation blocks");
+            return;
+        }
+    }
+
+    if (wave_ir_seal_block(ir, end_block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_switch_statement", "failed to reallocate intermediate representation");
+        return;
+    }
+
+    ir->current_block = end_block;
+    function_parser.switch_case_count = first_case;
+}
+
+static wave_ir_block_index parse_switch_case_body(wave_ir_block_index switch_block, bool has_body, wave_ir_index* out_jump) {
+    wave_ir* ir = &function_parser.ir;
+
+    wave_ir_block_index block = WAVE_IR_NONE;
+    if (wave_ir_add_block(ir, &block) != ERROR_CODE_EXECUTION_SUCCESSFUL || wave_ir_add_edge(ir, switch_block, block) != ERROR_CODE_EXECUTION_SUCCESSFUL || wave_ir_seal_block(ir, block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_switch_case_body", "failed to reallocate intermediate representation blocks");
+        return WAVE_IR_NONE;
+    }
+
+    ir->current_block = block;
+
+    if (has_body) {
+        parser_begin_scope();
+
+        parse_block();
+        if (compiler_has_error()) {
+            return WAVE_IR_NONE;
+        }
+
+        parser_end_scope();
+        if (compiler_has_error()) {
+            return WAVE_IR_NONE;
+        }
+    }
+
+    // the body may have ended in another block (e.g. after a return)
+
+    *out_jump = lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_JUMP, WAVE_TYPE_NONE, parser.previous.source_offset, .branch_data = { .targets = { WAVE_IR_NONE, WAVE_IR_NONE } }), NULL, 0);
+
+    return block;
+}
+
+static void parse_return_statement(void) {
+    DEBUG_ASSERT(function_parser.scope_depth >= 1, "not inside a function scope");
+
+    wave_ir_index value = WAVE_IR_NONE;
+    if ((*parser.current_function).function_data.return_type == WAVE_TYPE_NONE) {
+        goto parse_return_statement_end;
+    }
+
+    parse_expression((*(parser.current_function)).function_data.return_type);
+    value = function_parser.expression_value;
+
+    parse_return_statement_end: {}
 
     PARSER_EXPECT(WAVE_TOKEN_OP_SEMICOLON, "parse_return_statement", "expected semicolon (';') at the end of a statement");
 
-    emit_byte(OPCODE_RETURN);
+    lower_terminator(IR_OPCODE_RETURN, value);
 }
 
 static void parse_exit_statement(void) {
     DEBUG_ASSERT(function_parser.scope_depth >= 1, "not inside a function scope");
 
+    wave_ir_index value = WAVE_IR_NONE;
     if ((*parser.current_function).function_data.return_type == WAVE_TYPE_NONE) {
         goto parse_exit_statement_end;
     }
 
     parse_expression(WAVE_TYPE_U16);
+    value = function_parser.expression_value;
 
     parse_exit_statement_end: {}
 
     PARSER_EXPECT(WAVE_TOKEN_OP_SEMICOLON, "parse_exit_statement", "expected semicolon (';') at the end of a statement");
 
-    emit_byte(OPCODE_END);
+    lower_terminator(IR_OPCODE_EXIT, value);
 }
 
 static void parse_label_statement(void) {
     PARSER_EXPECT(WAVE_TOKEN_IDENTIFIER, "parse_label_statement", "missing label name, expected identifier token");
-    wave_identifier identifier = PARSER_GET_DATA(wave_identifier, parser.current.data_index);
     parse_label label = (parse_label) {
-        .name = identifier.hash,
+        .symbol = PARSER_GET_SYMBOL(parser.previous),
         .branch_offset = parser.bytecode_current - parser.bytecode_start
     };
 
@@ -988,7 +1835,7 @@ static void parse_function_parameters(parse_parameter** out_parameters, bool* ou
 
     while (!parser_match(WAVE_TOKEN_OP_PARENTHESES_CLOSE)) { // TODO: parse ( <type> <name>, <type> <name> = <expression> )
         wave_type parameter_type = WAVE_TYPE_NONE;
-        string_hash parameter_name = 0;
+        wave_symbol parameter_symbol = WAVE_SYMBOL_NONE;
 
         union_number default_value = (union_number) { .value_u64 = 0 };
 
@@ -1012,7 +1859,7 @@ static void parse_function_parameters(parse_parameter** out_parameters, bool* ou
         // parse name
 
         if (parser_match(WAVE_TOKEN_IDENTIFIER)) {
-            parameter_name = PARSER_GET_DATA(wave_identifier, parser.previous.data_index).hash;
+            parameter_symbol = PARSER_GET_SYMBOL(parser.previous);
 
             if (parser_match(WAVE_TOKEN_OP_ASSIGN)) {
                 if (function_forward_declared) {
@@ -1032,7 +1879,7 @@ static void parse_function_parameters(parse_parameter** out_parameters, bool* ou
         // push parameter to function parameter stack
 
         parse_parameter parameter = (parse_parameter) {
-            .name = parameter_name,
+            .symbol = parameter_symbol,
             .type = parameter_type,
             .offset = function_parser.locals_offset,
 
@@ -1080,13 +1927,12 @@ static void parse_function_parameters(parse_parameter** out_parameters, bool* ou
 
     function_data->return_type = WAVE_TYPE_NONE;
 
-    u32 return_type_start_line = parser.current_line;
-    u32 return_type_start_row = parser.current_row;
+    u32 return_type_start_offset = parser.current.source_offset;
 
     if (parser_match(WAVE_TOKEN_OP_COLON)) {
         function_data->return_type = token_get_wave_type(parser.current.token);
         if (function_data->return_type == WAVE_TYPE_NONE) {
-            PARSER_RAISE_ERROR_AT("parse_function_parameters", "unknown function return type, expected type token", return_type_start_line, return_type_start_row);
+            PARSER_RAISE_ERROR_AT("parse_function_parameters", "unknown function return type, expected type token", return_type_start_offset);
             *out_parameters = parameters;
             *out_function_forward_declared = false;
             return;
@@ -1103,12 +1949,24 @@ static void parse_function_parameters(parse_parameter** out_parameters, bool* ou
     *out_function_forward_declared = false;
 }
 
-static void parse_function_body(str function_name_source_pointer, u32 function_start_line, u32 function_start_row, const parse_parameter* parameters) {
+static void parse_function_body(str function_name_source_pointer, u32 function_start_offset, const parse_parameter* parameters) {
     function_parser.locals_offset = 0;
 
     parse_function* function = parser.current_function;
     wave_function* function_data = &parser.current_function->function_data;
 
+    // the body is lowered into the ir before any of its bytecode is emitted, the parameters are its first variables
+
+    if (wave_ir_clear(&function_parser.ir) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_function_body", "failed to reallocate intermediate representation");
+        return;
+    }
+
+    function_parser.ir.name = function_name_source_pointer;
+    while (function_name_source_pointer != NULL && wave_compiler_builtin_char_is_namespace(function_name_source_pointer[function_parser.ir.name_length])) {
+        function_parser.ir.name_length++;
+    }
+
     // emit debug information for disassembler (in front of root sets)
 
     emit_byte(OPCODE_DEBUG);
@@ -1116,10 +1974,12 @@ static void parse_function_body(str function_name_source_pointer, u32 function_s
 
     emit_u64(function->function_data.name); // function name
 
-    u32* debug_root_set_size = (u32*) parser.bytecode_current; emit_u32(0); // root_set_size
+    emit_u32(0); // root_set_size
+
+    // the bytecode may be reallocated while emitting, so the sizes that are patched later are addressed by offset
 
     if (function_name_source_pointer != NULL) {
-        u32* function_name_length = (u32*) parser.bytecode_current; emit_u32(0);
+        u32 function_name_length_offset = parser.bytecode_current - parser.bytecode_start; emit_u32(0);
 
         u32 length = 0;
         while (wave_compiler_builtin_char_is_namespace(*function_name_source_pointer)) {
@@ -1128,30 +1988,45 @@ static void parse_function_body(str function_name_source_pointer, u32 function_s
             length++;
         }
 
-        *function_name_length = length;
+        *((u32*) (parser.bytecode_start + function_name_length_offset)) = length;
     } else {
         emit_u32(0);
     }
 
     // make space for @globals_root_set_size @locals_root_set_size and @locals_stack_frame_size
 
-    u16* globals_root_set_size   = (u16*) parser.bytecode_current; emit_u16(0);
-    u16* locals_root_set_size    = (u16*) parser.bytecode_current; emit_u16(0);
+    emit_u16(0); // globals_root_set_size
+    emit_u16(0); // locals_root_set_size
 
     function->branch_offset = parser.bytecode_current - parser.bytecode_start; // @OPCODE_CALL expects to be passed the offset to @parameter_size (16bit), followed by @locals_stack_frame_size (16bit)
 
-    u16* parameter_size          = (u16*) parser.bytecode_current; emit_u16(0);
-    u16* locals_stack_frame_size = (u16*) parser.bytecode_current; emit_u16(0);
+    u16 parameter_size = 0; emit_u16(0);
+    emit_u16(0); // locals_stack_frame_size
 
     // add parameters as locals
 
     for (u16 i = 0; i < function_data->parameter_count; i++) {
-        add_local(parameters[i].type, parameters[i].name, true);
+        wave_local* local = add_local(parameters[i].type, parameters[i].symbol, true);
+        if (local == NULL) {
+            return;
+        }
 
-        *parameter_size += wave_type_get_size(parameters[i].type);
-    }
+        // a parameter every call passes the same constant for reads the constant, the argument is still passed
 
-    // parse function body
+        if (parameters[i].constant) {
+            wave_ir_index value = lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_CONSTANT, parameters[i].type, function_start_offset, .constant_data = { .value = parameters[i].constant_value }), NULL, 0);
+            if (compiler_has_error() || wave_ir_write_variable(&function_parser.ir, local->ir_variable, value) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+                PARSER_RAISE_ERROR("parse_function_body", "failed to reallocate intermediate representation");
+                return;
+            }
+        }
+
+        parameter_size += wave_type_get_size(parameters[i].type);
+    }
+
+    *((u16*) (parser.bytecode_start + function->branch_offset)) = parameter_size;
+
+    // parse function body
 
     PARSER_EXPECT(WAVE_TOKEN_OP_CURLY_BRACKET_OPEN, "parse_function_body", "expected start of function body, missing opening curly bracket ('{')");
 
@@ -1161,7 +2036,7 @@ static void parse_function_body(str function_name_source_pointer, u32 function_s
     while (parser.current.token != WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE && parser.current.token != WAVE_TOKEN_FILE_END) {
         parse_statement();
         if (compiler_has_error()) {
-            PARSER_RAISE_ERROR_AT("parse_function_body", "error in function ...", function_start_line, function_start_row); // TODO: print function name
+            PARSER_RAISE_ERROR_AT("parse_function_body", "error in function ...", function_start_offset); // TODO: print function name
             return;
         }
     }
@@ -1171,11 +2046,19 @@ static void parse_function_body(str function_name_source_pointer, u32 function_s
 
     WAVE_COMPILER_DEBUG("parse_function_body: parse function body end");
 
+    // emit the optimized body, values that are kept across statements take up frame slots behind the locals
+
+    emit_ir(true);
+    if (compiler_has_error()) {
+        PARSER_RAISE_ERROR_AT("parse_function_body", "error in function ...", function_start_offset);
+        return;
+    }
+
     // end function
 
-    function->locals_size = function_parser.locals_offset - *parameter_size;
+    function->locals_size = function_parser.locals_offset - parameter_size;
 
-    *locals_stack_frame_size = function->locals_size;
+    *((u16*) (parser.bytecode_start + function->branch_offset + sizeof(u16))) = function->locals_size; // @locals_stack_frame_size
     DEBUG_INFO("locals_stack_frame_size: %u", function->locals_size);
 
     // construct root sets
@@ -1192,12 +2075,112 @@ static void parse_function_body(str function_name_source_pointer, u32 function_s
     WAVE_COMPILER_DEBUG("parse_function_body: close");
 }
 
+static void parse_function_unit(u32 function_index, u32 declaration_token_index, str function_name_source_pointer, u32 function_start_offset, parse_parameter* parameters) { // takes ownership of @parameters
+    parse_unit unit = (parse_unit) {
+        .function_index = function_index,
+        .declaration_token_index = declaration_token_index,
+        .body_token_index = parser.token_index - 1, // the index of @parser.current
+        .function_start_offset = function_start_offset,
+        .function_name_source_pointer = function_name_source_pointer,
+
+        .parameters = parameters,
+
+        .cacheable = false,
+        .cache_key = 0,
+        .cache_entry = NULL,
+
+        .inline_candidate = false,
+        .inline_body = NULL,
+
+        .bytecode = NULL,
+        .bytecode_size = 0,
+        .branch_offset = 0,
+        .locals_size = 0,
+
+        .patch_holes = NULL,
+        .patch_hole_count = 0,
+
+        .errors = (compiler_error_list) { .vm = parser.vm, .error_count = 0, .error_capacity = 0, .errors = NULL },
+
+        .call_sites = NULL,
+        .call_site_count = 0,
+
+        .call_arguments = NULL,
+        .call_argument_count = 0,
+
+        .reachable = true,
+        .specialized = false,
+
+        .profile_sites = NULL,
+        .profile_site_count = 0
+    };
+
+    STACK_HELPER_PUSH(
+        parser.units,
+        unit,
+
+        sizeof(parse_unit),
+
+        parser.unit_capacity,
+        parser.unit_count,
+
+        FUNCTION_STACK_GROW_SIZE,
+
+        "parse_function_unit",
+        "failed to reallocate function unit stack"
+    );
+
+    if (!parser.deferred_bodies) { // the tokens of the body are only available while it is declared, the bodies declared before are inlined
+        parse_unit* compiled_unit = &parser.units[parser.unit_count - 1];
+        compiled_unit->inline_candidate = function_index != PARSE_UNIT_ENTRYPOINT && !parser.functions[function_index].function_data.error_function;
+
+        parse_unit_body(compiled_unit);
+        if (compiler_move_errors(&compiled_unit->errors) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_function_unit", "failed to move function errors");
+        }
+
+        if (function_index != PARSE_UNIT_ENTRYPOINT) {
+            parser.functions[function_index].inline_body = compiled_unit->inline_body;
+        }
+
+        return;
+    }
+
+    // skip the body, it is compiled once every declaration is known
+
+    PARSER_EXPECT(WAVE_TOKEN_OP_CURLY_BRACKET_OPEN, "parse_function_unit", "expected start of function body, missing opening curly bracket ('{')");
+
+    u32 depth = 1;
+    while (depth > 0) {
+        switch (parser.current.token) {
+            case WAVE_TOKEN_OP_CURLY_BRACKET_OPEN:  { depth++; break; }
+            case WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE: { depth--; break; }
+
+            case WAVE_TOKEN_FILE_END: {
+                PARSER_RAISE_ERROR("parse_function_unit", "expected end of function body, missing closing curly bracket ('}')");
+                return;
+            }
+
+            default: {
+                break;
+            }
+        }
+
+        parser_advance();
+    }
+}
+
 static void parse_function_declaration(void) {
     parse_function function = PARSE_FUNCTION_NULL;
 
+    u32 declaration_token_index = parser.token_index - 1; // the index of @parser.current
+
     // initialize state variables
 
-    function_parser.locals_count = 0;
+    while (function_parser.locals_count > 0) {
+        pop_local();
+    }
+
     function_parser.locals_offset = 0;
 
     function_parser.scope_depth = 0;
@@ -1216,11 +2199,11 @@ static void parse_function_declaration(void) {
 
     while (!parser_match(WAVE_TOKEN_KEYWORD_FUNC)) {
         switch (parser.current.token) {
-            case WAVE_TOKEN_KEYWORD_INLINE: { function.inline_function = true; parser_advance(); break; }
-            case WAVE_TOKEN_KEYWORD_EXTERN: { extern_function          = true; parser_advance(); break; }
-            case WAVE_TOKEN_KEYWORD_EVENT:  { event_function           = true; parser_advance(); break; }
-            case WAVE_TOKEN_KEYWORD_ERROR:  { function.function_data.error_function = true; parser_advance(); break; }
-            case WAVE_TOKEN_KEYWORD_ASM:    { asm_function             = true; parser_advance(); break; }
+            case WAVE_TOKEN_KEYWORD_INLINE: { function.inline_function = true; break; }
+            case WAVE_TOKEN_KEYWORD_EXTERN: { extern_function          = true; break; }
+            case WAVE_TOKEN_KEYWORD_EVENT:  { event_function           = true; break; }
+            case WAVE_TOKEN_KEYWORD_ERROR:  { function.function_data.error_function = true; break; }
+            case WAVE_TOKEN_KEYWORD_ASM:    { asm_function             = true; break; }
 
             default: {
                 PARSER_RAISE_ERROR("parse_function_declaration", "unknown function modifier");
@@ -1234,11 +2217,11 @@ static void parse_function_declaration(void) {
     // parse function name
 
     PARSER_EXPECT(WAVE_TOKEN_IDENTIFIER, "parse_function_declaration", "missing function name, expected identifier token");
-    wave_identifier identifier = PARSER_GET_DATA(wave_identifier, parser.previous.data_index);
+    wave_symbol function_symbol = PARSER_GET_SYMBOL(parser.previous);
+    wave_identifier identifier = PARSER_GET_IDENTIFIER(function_symbol);
     function.function_data.name = identifier.hash;
 
-    u32 function_start_line = parser.previous_line;
-    u32 function_start_row = parser.previous_row;
+    u32 function_start_offset = parser.previous.source_offset;
 
     // parse function parameters
 
@@ -1255,32 +2238,27 @@ static void parse_function_declaration(void) {
     if (!function_forward_declared || parser_match(WAVE_TOKEN_OP_SEMICOLON)) {
         function.initialized = false;
     } else {
-        for (u32 i = 0; i < parser.functions_count; i++) {
-            if (parser.functions[i].initialized && parser.functions[i].function_data.name == function.function_data.name) {
-                PARSER_RAISE_ERROR_AT("parse_function_declaration", "function already defined", function_start_line, function_start_row); // TODO: print function name
-                return;
-            }
+        u32 function_index = parser.function_symbols[function_symbol];
+        if (function_index != U32_MAX && parser.functions[function_index].initialized) {
+            PARSER_RAISE_ERROR_AT("parse_function_declaration", "function already defined", function_start_offset); // TODO: print function name
+            return;
         }
     }
 
-    // parse function body
-
-    parse_function_body(identifier.source_pointer, function_start_line, function_start_row, parameters); // TODO: add recursion support
-
-    if (parser.vm->deallocate_memory(parameters) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
-        PARSER_RAISE_ERROR("parse_function_declaration", "failed to deallocate function parameter stack");
-        return;
-    }
+    // store function data before its body is compiled, which lets the body call the function itself and the functions declared after it
 
     function.initialized = true;
 
-    // store function data
+    u32 function_index = parser.functions_count;
+    if (parser.function_symbols[function_symbol] == U32_MAX) {
+        parser.function_symbols[function_symbol] = function_index;
+    }
 
     STACK_HELPER_PUSH(
         parser.functions,
         function,
 
-        sizeof(wave_function),
+        sizeof(parse_function),
 
         parser.functions_capacity,
         parser.functions_count,
@@ -1296,7 +2274,7 @@ static void parse_function_declaration(void) {
     if (extern_function || event_function) {
         STACK_HELPER_PUSH(
             parser.extern_functions,
-            parser.functions_count,
+            function_index,
 
             sizeof(u32),
 
@@ -1310,14 +2288,11 @@ static void parse_function_declaration(void) {
         );
     }
 
-    // reset state variables
-
-    function_parser.locals_count = 0;
-    function_parser.locals_offset = 0;
+    parser.current_function = NULL;
 
-    function_parser.scope_depth = 0;
+    // parse function body
 
-    parser.current_function = NULL;
+    parse_function_unit(function_index, declaration_token_index, identifier.source_pointer, function_start_offset, parameters);
 }
 
 static void parse_entrypoint_declaration(void) {
@@ -1328,7 +2303,10 @@ static void parse_entrypoint_declaration(void) {
 
     // initialize state variables
 
-    function_parser.locals_count = 0;
+    while (function_parser.locals_count > 0) {
+        pop_local();
+    }
+
     function_parser.locals_offset = 0;
 
     function_parser.scope_depth = 0;
@@ -1340,8 +2318,8 @@ static void parse_entrypoint_declaration(void) {
 
     // parse entrypoint and parameters
 
-    u32 function_start_line = parser.current_line;
-    u32 function_start_row = parser.current_row;
+    u32 declaration_token_index = parser.token_index - 1; // the index of @parser.current
+    u32 function_start_offset = parser.current.source_offset;
 
     PARSER_EXPECT(WAVE_TOKEN_KEYWORD_ENTRYPOINT, "parse_entrypoint_declaration", "expected entrypoint keyword (\"%s\")", (str_format_data) keyword_tokens[WAVE_TOKEN_KEYWORD_ENTRYPOINT].string);
 
@@ -1349,8 +2327,6 @@ static void parse_entrypoint_declaration(void) {
 
     // parse function parameters
 
-    parser.current_scope_is_entrypoint_function = true;
-
     parse_parameter* parameters = NULL;
     bool function_forward_declared = false;
     parse_function_parameters(&parameters, &function_forward_declared);
@@ -1359,32 +2335,24 @@ static void parse_entrypoint_declaration(void) {
         return;
     }
 
-    // parse function body
-
-    if (!parser_match(WAVE_TOKEN_OP_SEMICOLON)) {
-        parse_function_body(NULL, function_start_line, function_start_row, parameters);
-    }
-
-    if (parser.vm->deallocate_memory(parameters) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
-        PARSER_RAISE_ERROR("parse_entrypoint_declaration", "failed to deallocate function parameter stack");
-        return;
-    }
+    // store entrypoint function
 
-    parser.current_scope_is_entrypoint_function = false;
     function.initialized = true;
 
-    // store entrypoint function
-
-    parser.entrypoint_function = *parser.current_function;
+    parser.entrypoint_function = function;
+    parser.current_function = NULL;
 
-    // reset state variables
+    // parse function body
 
-    function_parser.locals_count = 0;
-    function_parser.locals_offset = 0;
+    if (parser_match(WAVE_TOKEN_OP_SEMICOLON)) { // declared without a body
+        if (parser.vm->deallocate_memory(parameters) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_entrypoint_declaration", "failed to deallocate function parameter stack");
+        }
 
-    function_parser.scope_depth = 0;
+        return;
+    }
 
-    parser.current_function = NULL;
+    parse_function_unit(PARSE_UNIT_ENTRYPOINT, declaration_token_index, NULL, function_start_offset, parameters);
 }
 
 static void parse_global_variable_declaration(void) {
@@ -1395,12 +2363,16 @@ static void parse_global_variable_declaration(void) {
     if (parser_match(WAVE_TOKEN_OP_ASSIGN)) {
         parse_expression(variable_type);
 
+        if (compiler_has_error()) {
+            return;
+        }
+
         u16 prev_globals_offset = parser.globals_offset;
         switch (wave_type_get_size(variable_type)) {
-            case (sizeof(u8)):  { emit_byte(OPCODE_SET_GLOB_8);  parser.globals_offset += sizeof(u8);  break; }
-            case (sizeof(u16)): { emit_byte(OPCODE_SET_GLOB_16); parser.globals_offset += sizeof(u16); break; }
-            case (sizeof(u32)): { emit_byte(OPCODE_SET_GLOB_32); parser.globals_offset += sizeof(u32); break; }
-            case (sizeof(u64)): { emit_byte(OPCODE_SET_GLOB_64); parser.globals_offset += sizeof(u64); break; }
+            case (sizeof(u8)):  { parser.globals_offset += sizeof(u8);  break; }
+            case (sizeof(u16)): { parser.globals_offset += sizeof(u16); break; }
+            case (sizeof(u32)): { parser.globals_offset += sizeof(u32); break; }
+            case (sizeof(u64)): { parser.globals_offset += sizeof(u64); break; }
 
             default: {
                 PARSER_RAISE_ERROR("parse_global_variable_declaration", "unknown variable type");
@@ -1408,7 +2380,12 @@ static void parse_global_variable_declaration(void) {
             }
         }
 
-        emit_u16(prev_globals_offset);
+        wave_ir_index value = function_parser.expression_value;
+        lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_STORE_GLOBAL, WAVE_TYPE_NONE, parser.previous.source_offset, .variable_data = { .variable = U32_MAX, .offset = prev_globals_offset, .type = variable_type, .definition = WAVE_IR_NONE }), &value, 1);
+
+        if (function_parser.scope_depth == 0) { // declarations outside of functions are emitted right away
+            emit_ir(false);
+        }
     }
 
     PARSER_EXPECT(WAVE_TOKEN_OP_SEMICOLON, "parse_global_variable_declaration", "expected semicolon (';')");
@@ -1426,24 +2403,18 @@ static void parse_local_variable_declaration(void) {
 
     parser_advance();
 
-    string_hash variable_name = PARSER_GET_DATA(wave_identifier, parser.current.data_index).hash;
-    for (i32 i = ((i32) function_parser.locals_count) - 1; i >= 0; i--) {
-        wave_local* local = &function_parser.locals[i];
-        if (local->depth != -1 && local->depth < function_parser.scope_depth) {
-            break;
-        }
-
-        if (variable_name == local->name) {
-            PARSER_RAISE_ERROR("parse_local_variable_declaration", "local variable already defined");
-            return;
-        }
+    wave_symbol variable_symbol = PARSER_GET_SYMBOL(parser.current);
+    u32 local_index = function_parser.local_symbols[variable_symbol];
+    if (local_index != U32_MAX && function_parser.locals[local_index].depth >= function_parser.scope_depth) { // only locals of the current scope conflict, outer ones are shadowed
+        PARSER_RAISE_ERROR("parse_local_variable_declaration", "local variable already defined");
+        return;
     }
 
     if (parser.current.token == WAVE_TOKEN_OP_SQUARE_BRACKET_OPEN) {
         variable_type = WAVE_TYPE_ARR; // TODO: this if statement only covers the cases 1. <type>[] <name>; and 2. <type>[<number>] <name>; but not 3. <type>[<expression>] <name>;
     }
 
-    add_local(variable_type, variable_name, false);
+    add_local(variable_type, variable_symbol, false);
 }
 
 static void parse_enum_declaration(void) {}
@@ -1457,21 +2428,33 @@ static void parse_precedence(wave_type expression_type, parsing_precedence prece
 
     bool can_assign = precedence <= PRECEDENCE_ASSIGNMENT;
 
+    function_parser.expression_node = WAVE_AST_NONE;
+
     parse_rule *prefix_rule = parser_get_rule(parser.previous.token);
-    if (prefix_rule->prefix != PARSE_RULE_FUNC_NONE) {
-        parsing_function prefix_function = parse_rule_function_table[prefix_rule->prefix];
-        if (prefix_rule == NULL) {
-            PARSER_RAISE_ERROR("parse_precedence", "expected expression");
+    if (prefix_rule->prefix == PARSE_RULE_FUNC_NONE) {
+        PARSER_RAISE_ERROR_PREV("parse_precedence", "expected expression");
+        return;
+    }
+
+    parse_rule_function_table[prefix_rule->prefix](expression_type, can_assign);
+
+    // stop at the first error, the current token may not continue an expression anymore
+
+    while (!compiler_has_error() && precedence <= parser_get_rule(parser.current.token)->precedence) {
+        DEBUG_INFO("prec: %u --- line: %u, row: %u", parser_get_rule(parser.current.token)->precedence, PARSER_LINE(parser.current.source_offset), PARSER_ROW(parser.current.source_offset));
+        parser_advance();
+
+        parse_rule* infix_rule = parser_get_rule(parser.previous.token);
+        if (infix_rule->infix == PARSE_RULE_FUNC_NONE) {
+            PARSER_RAISE_ERROR_PREV("parse_precedence", "expected operator");
             return;
         }
 
-        prefix_function(expression_type, can_assign);
+        parse_rule_function_table[infix_rule->infix](expression_type, can_assign);
     }
 
-    while (precedence <= parser_get_rule(parser.current.token)->precedence) {
-        DEBUG_INFO("prec: %u --- line: %u, row: %u", parser_get_rule(parser.current.token)->precedence, parser.current_line, parser.current_row);
-        parser_advance();
-        parse_rule_function_table[parser_get_rule(parser.previous.token)->infix](expression_type, can_assign);
+    if (compiler_has_error()) {
+        return;
     }
 
     if (can_assign && parser_match(WAVE_TOKEN_OP_ASSIGN)) {
@@ -1484,7 +2467,7 @@ static void parse_precedence(wave_type expression_type, parsing_precedence prece
 
 // variables
 
-static wave_local* add_local(wave_type type, string_hash name, bool initialized) {
+static wave_local* add_local(wave_type type, wave_symbol symbol, bool initialized) {
     DEBUG_ASSERT(type != WAVE_TYPE_NONE, "unexpected variable type");
 
     umax type_size = wave_type_get_size(type);
@@ -1501,9 +2484,16 @@ static wave_local* add_local(wave_type type, string_hash name, bool initialized)
     }
 
     wave_local* local = &function_parser.locals[function_parser.locals_count];
+
+    local->symbol = symbol;
+    local->shadowed_local = U32_MAX;
+    if (symbol != WAVE_SYMBOL_NONE) {
+        local->shadowed_local = function_parser.local_symbols[symbol];
+        function_parser.local_symbols[symbol] = function_parser.locals_count;
+    }
+
     function_parser.locals_count++;
 
-    local->name = name;
     local->type = type;
 
     local->initialized = initialized;
@@ -1511,31 +2501,57 @@ static wave_local* add_local(wave_type type, string_hash name, bool initialized)
     local->offset = function_parser.locals_offset;
     local->depth = function_parser.scope_depth;
 
+    local->escapes = false;
+    local->allocation_index = U32_MAX;
+
+    // numbers (the types up to f64) can only be accessed through their symbol, which lets the ir track their values
+
+    local->ir_variable = U32_MAX;
+    if (wave_ir_add_variable(&function_parser.ir, local->offset, type, type <= WAVE_TYPE_F64, &local->ir_variable) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("add_local", "failed to reallocate intermediate representation variables");
+        return NULL;
+    }
+
     function_parser.locals_offset += type_size;
 
     return local;
 }
 
-static u32 resolve_local(string_hash name, wave_local* out_variable) {
-    for (u32 i = 0; i < function_parser.locals_count; i++) {
-        if (function_parser.locals[i].name == name) {
-            if (!function_parser.locals[i].initialized) {
-                PARSER_RAISE_ERROR("resolve_local", "cannot read variable in its own initializer");
-                goto resolve_local_end;
-            }
+static void pop_local(void) {
+    function_parser.locals_count--;
 
-            *out_variable = function_parser.locals[i];
-            return true;
+    wave_local* local = &function_parser.locals[function_parser.locals_count];
+    if (local->symbol != WAVE_SYMBOL_NONE) {
+        function_parser.local_symbols[local->symbol] = local->shadowed_local;
+    }
+}
+
+static u32 resolve_local(wave_symbol symbol, wave_local* out_variable) {
+    u32 index = function_parser.local_symbols[symbol];
+    if (index != U32_MAX) {
+        if (!function_parser.locals[index].initialized) {
+            PARSER_RAISE_ERROR("resolve_local", "cannot read variable in its own initializer");
+            goto resolve_local_end;
         }
+
+        *out_variable = function_parser.locals[index];
+        return true;
     }
 
     resolve_local_end: {}
 
-    *out_variable = (wave_local) { .name = 0, .type = WAVE_TYPE_NONE, .offset = 0, .depth = 0 };
+    *out_variable = (wave_local) { .symbol = WAVE_SYMBOL_NONE, .type = WAVE_TYPE_NONE, .offset = 0, .depth = 0, .shadowed_local = U32_MAX, .ir_variable = U32_MAX, .escapes = false, .allocation_index = U32_MAX };
     return false;
 }
 
-static void add_global(wave_type type, string_hash name) {
+static void mark_local_escaping(wave_symbol symbol) {
+    u32 index = function_parser.local_symbols[symbol];
+    if (index != U32_MAX) {
+        function_parser.locals[index].escapes = true;
+    }
+}
+
+static void add_global(wave_type type, wave_symbol symbol) {
     DEBUG_ASSERT(type != WAVE_TYPE_NONE, "unexpected variable type");
 
     umax type_size = wave_type_get_size(type);
@@ -1551,43 +2567,46 @@ static void add_global(wave_type type, string_hash name) {
         }
     }
 
+    if (parser.global_symbols[symbol] == U32_MAX) {
+        parser.global_symbols[symbol] = parser.globals_count;
+    }
+
     wave_global* global = &parser.globals[parser.globals_count];
     parser.globals_count++;
 
-    global->name = name;
+    global->symbol = symbol;
     global->offset = parser.globals_offset;
     global->type = type;
 
     parser.globals_offset += type_size;
 }
 
-static bool resolve_global(string_hash name, wave_global* out_variable) {
-    for (u32 i = 0; i < parser.globals_count; i++) {
-        if (parser.globals[i].name == name) {
-            if (!parser.globals[i].initialized) {
-                PARSER_RAISE_ERROR("resolve_global", "cannot read variable in its own initializer");
-                goto resolve_global_end;
-            }
-
-            *out_variable = parser.globals[i];
-            return true;
+static bool resolve_global(wave_symbol symbol, wave_global* out_variable) {
+    u32 index = parser.global_symbols[symbol];
+    if (index != U32_MAX) {
+        if (!parser.globals[index].initialized) {
+            PARSER_RAISE_ERROR("resolve_global", "cannot read variable in its own initializer");
+            goto resolve_global_end;
         }
+
+        *out_variable = parser.globals[index];
+        return true;
     }
 
     resolve_global_end: {}
 
-    *out_variable = (wave_global) { .name = 0, .type = WAVE_TYPE_NONE, .offset = 0, .initialized = false };
+    *out_variable = (wave_global) { .symbol = WAVE_SYMBOL_NONE, .type = WAVE_TYPE_NONE, .offset = 0, .initialized = false };
     return false;
 }
 
-static bool resolve_variable(string_hash name, wave_type* out_type) {
+static bool resolve_variable(wave_symbol symbol, wave_type* out_type) {
     wave_local local_variable;
     wave_global global_variable;
 
-    if (resolve_local(name, &local_variable)) {
+    if (resolve_local(symbol, &local_variable)) {
         *out_type = local_variable.type;
         return true;
-    } else if (resolve_global(name, &global_variable)) {
+    } else if (resolve_global(symbol, &global_variable)) {
         *out_type = global_variable.type;
         return true;
     } else {
@@ -1596,88 +2615,2668 @@ static bool resolve_variable(string_hash name, wave_type* out_type) {
     }
 }
 
-static bool emit_variable(string_hash name, bool evaluate, bool assign_expression) {
-    byte get_operation;
-    byte set_operation;
+// code generation
 
-    wave_local local_variable;
-    wave_global global_variable;
+static void add_node(wave_ast_node node) {
+    wave_ast_index index = WAVE_AST_NONE;
+    if (wave_ast_insert(&function_parser.ast, node, &index) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("add_node", "failed to reallocate syntax tree");
+        return;
+    }
 
-    u16 offset = 0;
+    function_parser.expression_node = index;
+}
 
-    if (resolve_local(name, &local_variable)) {
-        switch (wave_type_get_size(local_variable.type)) {
-            case (sizeof(u8)):  { get_operation = OPCODE_LOAD_8;  set_operation = OPCODE_STORE_8;  break; }
-            case (sizeof(u16)): { get_operation = OPCODE_LOAD_16; set_operation = OPCODE_STORE_16; break; }
-            case (sizeof(u32)): { get_operation = OPCODE_LOAD_32; set_operation = OPCODE_STORE_32; break; }
-            case (sizeof(u64)): { get_operation = OPCODE_LOAD_64; set_operation = OPCODE_STORE_64; break; }
+static void generate_expression(wave_ast_index root_node) {
+    function_parser.ast.root_node = root_node;
+    function_parser.expression_value = WAVE_IR_NONE;
 
-            default: {
-                PARSER_RAISE_ERROR("emit_variable", "unknown variable type");
-                return false;
+    if (wave_optimizer_optimize(&function_parser.ast) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("generate_expression", "failed to optimize expression");
+        return;
+    }
+
+    function_parser.expression_value = lower_expression(function_parser.ast.root_node);
+}
+
+// lowering
+
+static wave_ir_index lower_instruction(wave_ir_instruction instruction, const wave_ir_index* operands, u32 operand_count) {
+    wave_ir_index index = WAVE_IR_NONE;
+    if (wave_ir_append(&function_parser.ir, instruction, operands, operand_count, &index) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("lower_instruction", "failed to reallocate intermediate representation");
+        return WAVE_IR_NONE;
+    }
+
+    return index;
+}
+
+static wave_ir_index lower_expression(wave_ast_index index) {
+    if (index == WAVE_AST_NONE || compiler_has_error()) {
+        return WAVE_IR_NONE;
+    }
+
+    const wave_ast_node* node = WAVE_AST_NODE(&function_parser.ast, index); // lowering does not add nodes, the pointer stays valid
+
+    switch (node->type) {
+        case NODE_TYPE_CONSTANT: {
+            // constants are compared by their bits, which is why the bytes above the pushed width are cleared
+
+            union_number value = { .value_u64 = 0 };
+            switch (node->value_type) {
+                case WAVE_TYPE_U8:
+                case WAVE_TYPE_I8: { value.value_u8 = node->constant_data.value.value_u8; break; }
+
+                case WAVE_TYPE_U16:
+                case WAVE_TYPE_I16: { value.value_u16 = node->constant_data.value.value_u16; break; }
+
+                case WAVE_TYPE_U32:
+                case WAVE_TYPE_I32:
+                case WAVE_TYPE_F32: { value.value_u32 = node->constant_data.value.value_u32; break; }
+
+                default: { // 64 bit numbers and null references
+                    value = node->constant_data.value;
+                    break;
+                }
             }
+
+            return lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_CONSTANT, node->value_type, node->source_offset, .constant_data = { .value = value }), NULL, 0);
         }
 
-        offset = local_variable.offset;
-    } else if (resolve_global(name, &global_variable)) {
-        switch (wave_type_get_size(global_variable.type)) {
-            case (sizeof(u8)):  { get_operation = OPCODE_GET_GLOB_8;  set_operation = OPCODE_SET_GLOB_8;  break; }
-            case (sizeof(u16)): { get_operation = OPCODE_GET_GLOB_16; set_operation = OPCODE_SET_GLOB_16; break; }
-            case (sizeof(u32)): { get_operation = OPCODE_GET_GLOB_32; set_operation = OPCODE_SET_GLOB_32; break; }
-            case (sizeof(u64)): { get_operation = OPCODE_GET_GLOB_64; set_operation = OPCODE_SET_GLOB_64; break; }
+        case NODE_TYPE_STRING: {
+            u32 string_length = *((u32*) (function_parser.ast.data + node->string_data.data_index));
 
-            default: {
-                PARSER_RAISE_ERROR("emit_variable", "unknown variable type");
-                return false;
+            u32 data_index = 0;
+            if (wave_ir_insert_data(&function_parser.ir, function_parser.ast.data + node->string_data.data_index, sizeof(u32) + string_length, &data_index) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+                PARSER_RAISE_ERROR_AT("lower_expression", "failed to reallocate intermediate representation data", node->source_offset);
+                return WAVE_IR_NONE;
             }
+
+            return lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_STRING, WAVE_TYPE_STR, node->source_offset, .string_data = { .data_index = data_index, .frame_offset = 0, .heap = true }), NULL, 0);
         }
 
-        offset = global_variable.offset;
-    } else {
-        return false;
+        case NODE_TYPE_VARIABLE: {
+            return lower_variable(node->variable_data.symbol, node->source_offset, false, WAVE_IR_NONE);
+        }
+
+        case NODE_TYPE_ASSIGNMENT: {
+            wave_ir_index value = lower_expression(node->variable_data.value_node);
+            return lower_variable(node->variable_data.symbol, node->source_offset, true, value);
+        }
+
+        case NODE_TYPE_TYPE_CONVERSION: {
+            wave_ir_index value = lower_expression(node->type_conversion_data.value_node);
+            return lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_CONVERSION, node->value_type, node->source_offset, .conversion_data = { .from_type = node->type_conversion_data.from_type }), &value, 1);
+        }
+
+        case NODE_TYPE_STATEMENT_FUNCTION_CALL: {
+            return lower_function_call(node);
+        }
+
+        default: {
+            break;
+        }
+    }
+
+    // operations take their operands in the order they are pushed, unary operations only have a left one
+
+    wave_ir_index operands[2] = { lower_expression(node->expression_data.left_node), WAVE_IR_NONE };
+    u32 operand_count = 1;
+
+    if (node->expression_data.right_node != WAVE_AST_NONE) {
+        operands[1] = lower_expression(node->expression_data.right_node);
+        operand_count = 2;
+    }
+
+    wave_ir_instruction instruction = PARSER_INSTRUCTION(IR_OPCODE_OPERATION, node->value_type, node->source_offset);
+    instruction.operation = node->type;
+
+    return lower_instruction(instruction, operands, operand_count);
+}
+
+static wave_ir_index lower_variable(wave_symbol symbol, u32 source_offset, bool assign_expression, wave_ir_index value) {
+    wave_local local_variable;
+    wave_global global_variable;
+
+    if (resolve_local(symbol, &local_variable)) {
+        if (assign_expression) {
+            lower_store_local(&local_variable, source_offset, value);
+            return WAVE_IR_NONE;
+        }
+
+        wave_ir_index definition = WAVE_IR_NONE; // the value stored last, if it is known
+        if (wave_ir_read_variable(&function_parser.ir, local_variable.ir_variable, &definition) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR_AT("lower_variable", "failed to reallocate intermediate representation", source_offset);
+            return WAVE_IR_NONE;
+        }
+
+        return lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_LOAD_LOCAL, local_variable.type, source_offset, .variable_data = { .variable = local_variable.ir_variable, .offset = local_variable.offset, .type = local_variable.type, .definition = definition }), NULL, 0);
+    } else if (resolve_global(symbol, &global_variable)) {
+        wave_ir_instruction instruction = PARSER_INSTRUCTION(assign_expression ? IR_OPCODE_STORE_GLOBAL : IR_OPCODE_LOAD_GLOBAL, assign_expression ? WAVE_TYPE_NONE : global_variable.type, source_offset, .variable_data = { .variable = U32_MAX, .offset = global_variable.offset, .type = global_variable.type, .definition = WAVE_IR_NONE });
+        if (assign_expression) {
+            lower_instruction(instruction, &value, 1);
+            return WAVE_IR_NONE;
+        }
+
+        return lower_instruction(instruction, NULL, 0);
+    }
+
+    return WAVE_IR_NONE;
+}
+
+static void lower_store_local(const wave_local* local, u32 source_offset, wave_ir_index value) {
+    lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_STORE_LOCAL, WAVE_TYPE_NONE, source_offset, .variable_data = { .variable = local->ir_variable, .offset = local->offset, .type = local->type, .definition = WAVE_IR_NONE }), &value, 1);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    // a value of another type is stored in the width of the variable, which makes the value in memory unknown
+
+    wave_ir_index definition = value;
+    if (value == WAVE_IR_NONE || WAVE_IR_INSTRUCTION(&function_parser.ir, value)->value_type != local->type) {
+        definition = WAVE_IR_NONE;
+    }
+
+    if (wave_ir_write_variable(&function_parser.ir, local->ir_variable, definition) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR_AT("lower_store_local", "failed to reallocate intermediate representation", source_offset);
+        return;
+    }
+}
+
+static wave_ir_index lower_function_call(const wave_ast_node* node) {
+    u32 first_operand = function_parser.call_operand_count;
+
+    for (wave_ast_index argument = node->function_call_data.first_argument; argument != WAVE_AST_NONE; argument = WAVE_AST_NODE(&function_parser.ast, argument)->next_node) {
+        wave_ir_index value = lower_expression(argument);
+        STACK_HELPER_PUSH(function_parser.call_operands, value, sizeof(wave_ir_index), function_parser.call_operand_capacity, function_parser.call_operand_count, CALL_OPERAND_STACK_GROW_SIZE, "lower_function_call", "failed to reallocate call operand stack", WAVE_IR_NONE);
+    }
+
+    if (node->function_call_data.reference_function) {
+        wave_ir_index function_reference = lower_variable(node->function_call_data.symbol, node->source_offset, false, WAVE_IR_NONE);
+        STACK_HELPER_PUSH(function_parser.call_operands, function_reference, sizeof(wave_ir_index), function_parser.call_operand_capacity, function_parser.call_operand_count, CALL_OPERAND_STACK_GROW_SIZE, "lower_function_call", "failed to reallocate call operand stack", WAVE_IR_NONE);
+    }
+
+    wave_ir_index index = lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_CALL, node->value_type, node->source_offset, .call_data = {
+        .native_function = node->function_call_data.native_function,
+        .reference_function = node->function_call_data.reference_function,
+        .error_function = node->function_call_data.error_function,
+
+        .native_function_index = node->function_call_data.native_function_index,
+
+        .symbol = node->function_call_data.symbol,
+        .token_index = node->function_call_data.token_index
+    }), function_parser.call_operands + first_operand, function_parser.call_operand_count - first_operand);
+
+    function_parser.call_operand_count = first_operand;
+
+    return index;
+}
+
+static void lower_terminator(ir_opcode opcode, wave_ir_index value) {
+    lower_instruction(PARSER_INSTRUCTION(opcode, WAVE_TYPE_NONE, parser.previous.source_offset), &value, value == WAVE_IR_NONE ? 0 : 1);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    wave_ir_block_index block = WAVE_IR_NONE;
+    if (wave_ir_add_block(&function_parser.ir, &block) != ERROR_CODE_EXECUTION_SUCCESSFUL || wave_ir_seal_block(&function_parser.ir, block) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("lower_terminator", "failed to reallocate intermediate representation blocks");
+        return;
+    }
+
+    function_parser.ir.current_block = block;
+}
+
+static void lower_jump(wave_ir_block_index target) {
+    wave_ir_block_index block = function_parser.ir.current_block;
+
+    lower_instruction(PARSER_INSTRUCTION(IR_OPCODE_JUMP, WAVE_TYPE_NONE, parser.previous.source_offset, .branch_data = { .targets = { target, WAVE_IR_NONE } }), NULL, 0);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    if (wave_ir_add_edge(&function_parser.ir, block, target) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("lower_jump", "failed to reallocate intermediate representation blocks");
+        return;
     }
+}
+
+static bool inline_ir_calls(void) { // every inlined body gets its own part of the stack frame behind the locals
+    wave_ir* ir = &function_parser.ir;
+
+    bool inlined_calls = false;
+    u32 inlined_instruction_count = 0;
+
+    const wave_ir_index instruction_count = ir->instruction_count; // calls inside of the inlined bodies are kept
+    for (wave_ir_index i = 0; i < instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        if (instruction->opcode != IR_OPCODE_CALL || instruction->call_data.native_function || instruction->call_data.reference_function || instruction->call_data.error_function) {
+            continue;
+        }
+
+        u32 function_index = parser.function_symbols[instruction->call_data.symbol];
+        const wave_ir* body = function_index != U32_MAX ? parser.functions[function_index].inline_body : NULL;
+        if (body == NULL || inlined_instruction_count + body->instruction_count > INLINE_MAX_GROWTH) {
+            continue;
+        }
+
+        u32 frame_size = 0;
+        if (wave_ir_inline(ir, i, body, function_parser.locals_offset, &frame_size) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("inline_ir_calls", "failed to reallocate intermediate representation");
+            return false;
+        }
+
+        if ((u32) function_parser.locals_offset + frame_size >= WAVE_LIMIT_MAX_LOCALS_OFFSET) {
+            PARSER_RAISE_ERROR("inline_ir_calls", "too many local variables defined");
+            return false;
+        }
+
+        function_parser.locals_offset += frame_size;
+
+        inlined_calls = true;
+        inlined_instruction_count += body->instruction_count;
+    }
+
+    return inlined_calls;
+}
+
+// bytecode emission
+
+static void emit_ir(bool optimize) {
+    wave_ir* ir = &function_parser.ir;
+
+    if (optimize) {
+        const wave_compiler_message_function dump_function = wave_compiler_get_ir_dump_function();
+        if (dump_function != NULL && wave_ir_dump(ir, "lowering", dump_function) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("emit_ir", "failed to dump intermediate representation");
+            return;
+        }
+
+        bool inlined_calls = inline_ir_calls();
+        if (compiler_has_error()) {
+            return;
+        }
+
+        function_parser.inlined_calls = function_parser.inlined_calls || inlined_calls;
+
+        if (dump_function != NULL && inlined_calls && wave_ir_dump(ir, "inlining", dump_function) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("emit_ir", "failed to dump intermediate representation");
+            return;
+        }
+
+        if (wave_ir_optimizer_optimize(ir, dump_function) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("emit_ir", "failed to optimize intermediate representation");
+            return;
+        }
+
+        // the optimized body is kept for the callers, the bytecode emission does not change it
+
+        const wave_profile* profile = wave_compiler_get_profile();
+        u32 max_inline_cost = profile != NULL && wave_profile_is_hot(profile, parser.current_function->function_data.name) ? INLINE_MAX_HOT_COST : INLINE_MAX_COST; // a hot function is worth a larger copy in every caller
+
+        if (function_parser.keep_inline_body && wave_ir_optimizer_can_inline(ir, parser.current_function->inline_function, max_inline_cost)) {
+            function_parser.inline_body = NULL;
+            if (parser.vm->allocate_memory((void**) &function_parser.inline_body, sizeof(wave_ir)) != ERROR_CODE_EXECUTION_SUCCESSFUL ||
+                wave_ir_new(function_parser.inline_body, parser.vm->allocate_memory, parser.vm->reallocate_memory, parser.vm->deallocate_memory) != ERROR_CODE_EXECUTION_SUCCESSFUL ||
+                wave_ir_copy(function_parser.inline_body, ir) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+                PARSER_RAISE_ERROR("emit_ir", "failed to allocate inline body");
+                return;
+            }
+        }
+
+        record_ir_calls();
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    if (wave_ir_compute_uses(ir) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("emit_ir", "failed to reallocate intermediate representation analyses");
+        return;
+    }
+
+    #define EMIT_IR_RESERVE(pointer, capacity, count)                                                                                       \
+        do {                                                                                                                                \
+            if ((count) >= (capacity)) {                                                                                                    \
+                (capacity) = (count) + 1;                                                                                                   \
+                if (parser.vm->reallocate_memory((void**) &(pointer), sizeof(*(pointer)) * (capacity)) != ERROR_CODE_EXECUTION_SUCCESSFUL) { \
+                    PARSER_RAISE_ERROR("emit_ir", "failed to reallocate intermediate representation emitter");                              \
+                    return;                                                                                                                 \
+                }                                                                                                                           \
+            }                                                                                                                               \
+        } while (0)
+
+    EMIT_IR_RESERVE(function_parser.emit_values, function_parser.emit_value_capacity, ir->instruction_count);
+    EMIT_IR_RESERVE(function_parser.block_offsets, function_parser.block_offset_capacity, ir->block_count);
+
+    #undef EMIT_IR_RESERVE
+
+    ir_emit_value* values = function_parser.emit_values;
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+
+        ir_emit_mode mode = IR_EMIT_MODE_IN_PLACE;
+        if (instruction->opcode == IR_OPCODE_NONE) {
+            mode = IR_EMIT_MODE_NONE;
+        } else if (instruction->opcode == IR_OPCODE_CONSTANT && ir->use_counts[i] > 0) {
+            mode = IR_EMIT_MODE_CONSTANT;
+        } else if (instruction->opcode == IR_OPCODE_PHI) {
+            mode = IR_EMIT_MODE_PHI;
+        }
+
+        values[i] = (ir_emit_value) { .mode = mode, .slot = 0 };
+    }
+
+    // values computed right in front of their only user stay on the stack, the users of a tree are visited from the last one
+
+    for (wave_ir_block_index i = 0; i < ir->block_count; i++) {
+        if (WAVE_IR_BLOCK(ir, i)->removed) {
+            continue;
+        }
+
+        for (wave_ir_index j = WAVE_IR_BLOCK(ir, i)->last_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->previous) {
+            if (values[j].mode != IR_EMIT_MODE_IN_PLACE) {
+                continue;
+            }
+
+            // a switch value that is compared with a case is pushed again for the next one, which is why it stays in its frame slot
+
+            u64 minimum = 0;
+            u64 span = 0;
+            if (WAVE_IR_INSTRUCTION(ir, j)->opcode == IR_OPCODE_SWITCH) {
+                ir_switch_kind kind = get_ir_switch_kind(WAVE_IR_INSTRUCTION(ir, j), &minimum, &span);
+                if (kind == IR_SWITCH_KIND_COMPARE || get_ir_switch_hot_case(WAVE_IR_INSTRUCTION(ir, j), kind) != U32_MAX) {
+                    continue;
+                }
+            }
+
+            wave_ir_index cursor = get_ir_previous(j);
+            stackify_ir_operands(j, &cursor);
+        }
+    }
+
+    if (optimize) {
+        mark_ir_tail_calls();
+    }
+
+    // the other values are kept in frame slots behind the locals
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        if (values[i].mode != IR_EMIT_MODE_PHI && (values[i].mode != IR_EMIT_MODE_IN_PLACE || ir->use_counts[i] == 0)) {
+            continue;
+        }
+
+        u16 slot_size = wave_type_get_size(WAVE_IR_INSTRUCTION(ir, i)->value_type);
+        if ((u32) function_parser.locals_offset + slot_size >= WAVE_LIMIT_MAX_LOCALS_OFFSET) {
+            PARSER_RAISE_ERROR("emit_ir", "too many local variables defined");
+            return;
+        }
+
+        values[i].mode = values[i].mode == IR_EMIT_MODE_PHI ? IR_EMIT_MODE_PHI : IR_EMIT_MODE_SPILL;
+        values[i].slot = function_parser.locals_offset;
+        function_parser.locals_offset += slot_size;
+    }
+
+    // blocks are laid out in the order they were created, jumps to the next block are left out
+
+    const u32 body_start_index = parser.bytecode_current - parser.bytecode_start;
+    function_parser.jump_count = 0;
+
+    for (wave_ir_block_index i = 0; i < ir->block_count; i++) {
+        const wave_ir_block* block = WAVE_IR_BLOCK(ir, i);
+        if (block->removed) {
+            continue;
+        }
+
+        function_parser.block_offsets[i] = parser.bytecode_current - parser.bytecode_start;
+
+        wave_ir_block_index next_block = i + 1;
+        while (next_block < ir->block_count && WAVE_IR_BLOCK(ir, next_block)->removed) {
+            next_block++;
+        }
+
+        for (wave_ir_index j = block->first_instruction; j != WAVE_IR_NONE; j = WAVE_IR_INSTRUCTION(ir, j)->next) {
+            if (values[j].mode != IR_EMIT_MODE_IN_PLACE && values[j].mode != IR_EMIT_MODE_SPILL) {
+                continue;
+            }
+
+            emit_ir_instruction(j, next_block < ir->block_count ? next_block : WAVE_IR_NONE);
+            if (values[j].mode == IR_EMIT_MODE_SPILL) {
+                emit_store(WAVE_IR_INSTRUCTION(ir, j)->value_type, values[j].slot);
+            }
+
+            if (compiler_has_error()) {
+                return;
+            }
+        }
+    }
+
+    // link the jumps now that every block has been placed
+
+    for (u32 i = 0; i < function_parser.jump_count; i++) {
+        const ir_jump* jump = &function_parser.jumps[i];
+        i64 offset = (i64) function_parser.block_offsets[jump->target] - (i64) jump->end_index;
+
+        if (jump->table_offset) {
+            if (offset < 0 || offset > U16_MAX) {
+                PARSER_RAISE_ERROR("emit_ir", "switch case target is too far away");
+                return;
+            }
+
+            *((u16*) (parser.bytecode_start + jump->offset_index)) = (u16) offset;
+        } else if (jump->short_offset) {
+            if (offset < I16_MIN || offset > I16_MAX) {
+                PARSER_RAISE_ERROR("emit_ir", "conditional branch target is too far away");
+                return;
+            }
+
+            *((i16*) (parser.bytecode_start + jump->offset_index)) = (i16) offset;
+        } else {
+            *((i32*) (parser.bytecode_start + jump->offset_index)) = (i32) offset;
+        }
+    }
+
+    if (optimize) {
+        optimize_bytecode(body_start_index);
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    if (wave_ir_clear(ir) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("emit_ir", "failed to reallocate intermediate representation");
+        return;
+    }
+}
+
+static wave_ir_index get_ir_previous(wave_ir_index index) {
+    const wave_ir* ir = &function_parser.ir;
+
+    index = WAVE_IR_INSTRUCTION(ir, index)->previous;
+    while (index != WAVE_IR_NONE && function_parser.emit_values[index].mode == IR_EMIT_MODE_CONSTANT) {
+        index = WAVE_IR_INSTRUCTION(ir, index)->previous;
+    }
+
+    return index;
+}
+
+static void stackify_ir_operands(wave_ir_index index, wave_ir_index* cursor) {
+    const wave_ir* ir = &function_parser.ir;
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+
+    // the operands are pushed in order, so the last one has to be computed right in front of the instruction
+
+    for (u32 i = instruction->operand_count; i > 0; i--) {
+        wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, i - 1);
+        if (operand == WAVE_IR_NONE || operand != *cursor) {
+            continue; // pushed again or loaded from its slot
+        }
+
+        if (function_parser.emit_values[operand].mode != IR_EMIT_MODE_IN_PLACE || ir->use_counts[operand] != 1 || WAVE_IR_INSTRUCTION(ir, operand)->block != instruction->block) {
+            continue;
+        }
+
+        function_parser.emit_values[operand].mode = IR_EMIT_MODE_INLINE;
+
+        *cursor = get_ir_previous(operand);
+        stackify_ir_operands(operand, cursor);
+    }
+}
+
+static void mark_ir_tail_calls(void) {
+    const wave_ir* ir = &function_parser.ir;
+
+    if (parser.current_scope_is_entrypoint_function) { // there is no caller to return to
+        return;
+    }
+
+    // the stack frame is dropped by a tail call, so it must not hold objects that still have to be freed (by the root sets) or that the arguments point into
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        if (instruction->opcode == IR_OPCODE_STRING_LOCAL || (instruction->opcode == IR_OPCODE_POP && instruction->pop_data.opcode == OPCODE_POP_FREE)) {
+            return;
+        }
+    }
+
+    for (wave_ir_block_index i = 0; i < ir->block_count; i++) {
+        const wave_ir_block* block = WAVE_IR_BLOCK(ir, i);
+        if (block->removed || block->last_instruction == WAVE_IR_NONE) {
+            continue;
+        }
+
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, block->last_instruction);
+        if (instruction->opcode != IR_OPCODE_RETURN || instruction->operand_count != 1) {
+            continue;
+        }
+
+        // the call has to be computed right in front of the return, a conversion of its value would be the operand instead
+
+        wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, 0);
+        if (operand == WAVE_IR_NONE || function_parser.emit_values[operand].mode != IR_EMIT_MODE_INLINE) {
+            continue;
+        }
+
+        const wave_ir_instruction* call = WAVE_IR_INSTRUCTION(ir, operand);
+        if (call->opcode != IR_OPCODE_CALL || call->call_data.native_function || call->call_data.reference_function || call->call_data.error_function) {
+            continue;
+        }
+
+        function_parser.emit_values[operand].mode = IR_EMIT_MODE_TAIL_CALL;
+    }
+}
+
+static void record_ir_calls(void) {
+    const wave_ir* ir = &function_parser.ir;
+    const wave_function* caller = &parser.current_function->function_data;
+
+    // the parameters are the first variables, a parameter that is never stored to is passed on unchanged
+
+    u64 stored_parameters = 0;
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        if (instruction->opcode == IR_OPCODE_STORE_LOCAL && instruction->variable_data.variable < 64) {
+            stored_parameters |= (u64) 1 << instruction->variable_data.variable;
+        }
+    }
+
+    for (wave_ir_index i = 0; i < ir->instruction_count; i++) {
+        const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, i);
+        if (instruction->opcode != IR_OPCODE_CALL || instruction->call_data.native_function || instruction->call_data.reference_function) {
+            continue;
+        }
+
+        u32 function_index = parser.function_symbols[instruction->call_data.symbol];
+        if (function_index == U32_MAX) {
+            continue;
+        }
+
+        const wave_function* callee = &parser.functions[function_index].function_data;
+
+        parse_call_site call_site = (parse_call_site) { .function_index = function_index, .first_argument = function_parser.call_argument_count, .argument_count = instruction->operand_count };
+        STACK_HELPER_PUSH(function_parser.call_sites, call_site, sizeof(parse_call_site), function_parser.call_site_capacity, function_parser.call_site_count, CALL_SITE_STACK_GROW_SIZE, "record_ir_calls", "failed to reallocate call site stack");
+
+        for (u32 j = 0; j < instruction->operand_count; j++) {
+            parse_call_argument argument = (parse_call_argument) { .kind = CALL_ARGUMENT_UNKNOWN, .parameter = 0, .value = (union_number) { .value_u64 = 0 } };
+
+            wave_ir_index operand = WAVE_IR_OPERAND(ir, instruction, j);
+            const wave_ir_instruction* value = operand != WAVE_IR_NONE ? WAVE_IR_INSTRUCTION(ir, operand) : NULL;
+
+            if (value != NULL && j < callee->parameter_count && value->value_type == callee->parameters[j].type) {
+                if (value->opcode == IR_OPCODE_CONSTANT) {
+                    argument.kind = CALL_ARGUMENT_CONSTANT;
+                    argument.value = value->constant_data.value;
+                } else if (value->opcode == IR_OPCODE_LOAD_LOCAL && value->variable_data.variable < caller->parameter_count && value->variable_data.variable < 64 && (stored_parameters & ((u64) 1 << value->variable_data.variable)) == 0) {
+                    argument.kind = CALL_ARGUMENT_PARAMETER;
+                    argument.parameter = value->variable_data.variable;
+                }
+            }
+
+            STACK_HELPER_PUSH(function_parser.call_arguments, argument, sizeof(parse_call_argument), function_parser.call_argument_capacity, function_parser.call_argument_count, CALL_SITE_STACK_GROW_SIZE, "record_ir_calls", "failed to reallocate call argument stack");
+        }
+    }
+}
+
+static void emit_ir_value(wave_ir_index index) {
+    const ir_emit_value* value = &function_parser.emit_values[index];
+
+    switch (value->mode) {
+        case IR_EMIT_MODE_INLINE:
+        case IR_EMIT_MODE_TAIL_CALL:
+        case IR_EMIT_MODE_CONSTANT: {
+            emit_ir_instruction(index, WAVE_IR_NONE);
+            break;
+        }
+
+        case IR_EMIT_MODE_SPILL:
+        case IR_EMIT_MODE_PHI: {
+            emit_load(WAVE_IR_INSTRUCTION(&function_parser.ir, index)->value_type, value->slot);
+            break;
+        }
+
+        default: {
+            break;
+        }
+    }
+}
+
+static void emit_ir_instruction(wave_ir_index index, wave_ir_block_index next_block) {
+    const wave_ir* ir = &function_parser.ir;
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index); // emitting does not add instructions, the pointer stays valid
+
+    if (instruction->opcode == IR_OPCODE_SWITCH) { // pushes its operand itself
+        emit_ir_switch(index, next_block);
+        return;
+    }
+
+    for (u32 i = 0; i < instruction->operand_count; i++) {
+        if (WAVE_IR_OPERAND(ir, instruction, i) != WAVE_IR_NONE) {
+            emit_ir_value(WAVE_IR_OPERAND(ir, instruction, i));
+        }
+    }
+
+    switch (instruction->opcode) {
+        case IR_OPCODE_CONSTANT: {
+            union_number value = instruction->constant_data.value;
+
+            switch (instruction->value_type) {
+                case WAVE_TYPE_U8:
+                case WAVE_TYPE_I8: { emit_byte(OPCODE_PUSH_8); emit_u8(value.value_u8); break; }
+
+                case WAVE_TYPE_U16:
+                case WAVE_TYPE_I16: { emit_byte(OPCODE_PUSH_16); emit_u16(value.value_u16); break; }
+
+                case WAVE_TYPE_U32:
+                case WAVE_TYPE_I32:
+                case WAVE_TYPE_F32: { emit_byte(OPCODE_PUSH_32); emit_u32(value.value_u32); break; }
+
+                default: { // 64 bit numbers and null references
+                    emit_byte(OPCODE_PUSH_64);
+                    emit_u64(value.value_u64);
+                    break;
+                }
+            }
+
+            break;
+        }
+
+        case IR_OPCODE_STRING:
+        case IR_OPCODE_STRING_LOCAL: {
+            u32 string_length = *((u32*) (ir->data + instruction->string_data.data_index));
+
+            if (instruction->opcode == IR_OPCODE_STRING) {
+                emit_byte(OPCODE_STR_NEW);
+            } else {
+                emit_byte(OPCODE_EXT);
+                emit_byte(OPCODE_EXT_STR_NEW_LOCAL);
+                emit_u16(instruction->string_data.heap ? WAVE_LIMIT_OPCODE_STR_NEW_LOCAL_HEAP : instruction->string_data.frame_offset);
+            }
+
+            emit_u32(string_length);
+            emit_bytecode(ir->data + instruction->string_data.data_index + sizeof(u32), string_length);
+            break;
+        }
+
+        case IR_OPCODE_CONVERSION: {
+            number_type convert_from = (number_type) instruction->conversion_data.from_type;
+            number_type convert_to = (number_type) instruction->value_type;
+
+            if (wave_type_is_integer(convert_from) && wave_type_is_integer(convert_to) && wave_type_get_size(convert_from) == wave_type_get_size(convert_to)) {
+                break; // only the signedness changes, the bits stay the same
+            }
+
+            wave_opcode_extended conversion_opcode = get_conversion_opcode(convert_from, convert_to);
+            if (conversion_opcode != OPCODE_EXT_MAX) {
+                emit_bytes(OPCODE_EXT, conversion_opcode);
+                break;
+            }
+
+            emit_byte(OPCODE_TYPE_CONV_STATIC);
+            emit_byte((convert_from << 4) | (convert_to << 0));
+            break;
+        }
+
+        case IR_OPCODE_OPERATION: {
+            emit_operation(instruction->operation, instruction->value_type, instruction->source_offset);
+            break;
+        }
+
+        case IR_OPCODE_LOAD_LOCAL:  { emit_load(instruction->variable_data.type, instruction->variable_data.offset);  break; }
+        case IR_OPCODE_STORE_LOCAL: { emit_store(instruction->variable_data.type, instruction->variable_data.offset); break; }
+
+        case IR_OPCODE_LOAD_GLOBAL:
+        case IR_OPCODE_STORE_GLOBAL: {
+            bool store = instruction->opcode == IR_OPCODE_STORE_GLOBAL;
+
+            switch (wave_type_get_size(instruction->variable_data.type)) {
+                case (sizeof(u8)):  { emit_byte(store ? OPCODE_SET_GLOB_8  : OPCODE_GET_GLOB_8);  break; }
+                case (sizeof(u16)): { emit_byte(store ? OPCODE_SET_GLOB_16 : OPCODE_GET_GLOB_16); break; }
+                case (sizeof(u32)): { emit_byte(store ? OPCODE_SET_GLOB_32 : OPCODE_GET_GLOB_32); break; }
+                case (sizeof(u64)): { emit_byte(store ? OPCODE_SET_GLOB_64 : OPCODE_GET_GLOB_64); break; }
+
+                default: {
+                    PARSER_RAISE_ERROR_AT("emit_ir_instruction", "unknown variable type", instruction->source_offset);
+                    return;
+                }
+            }
+
+            emit_u16(instruction->variable_data.offset);
+            break;
+        }
+
+        case IR_OPCODE_CALL: { // the function reference of dynamic calls is the last operand
+            if (instruction->call_data.reference_function) {
+                emit_byte(instruction->call_data.error_function ? OPCODE_CALL_DYN_ERR : OPCODE_CALL_DYN);
+                if (instruction->call_data.error_function && !instruction->call_data.native_function) {
+                    emit_byte(OPCODE_ERR_CHECK);
+                }
+            } else if (instruction->call_data.native_function) {
+                emit_byte(instruction->call_data.error_function ? OPCODE_CALL_NATIVE_ERR : OPCODE_CALL_NATIVE);
+                emit_u16(instruction->call_data.native_function_index);
+            } else {
+                // the branch offset is linked after parsing, which keeps the bytecode of the function independent of where the callee is placed
+
+                if (function_parser.emit_values[index].mode == IR_EMIT_MODE_TAIL_CALL) {
+                    emit_bytes(OPCODE_EXT, OPCODE_EXT_TAIL_CALL);
+                } else {
+                    emit_byte(OPCODE_CALL);
+                }
+
+                add_patch_hole(PATCH_HOLE_TYPE_FUNCTION_CALL, instruction->call_data.symbol, instruction->call_data.token_index);
+                emit_u32(0);
+
+                if (instruction->call_data.error_function) {
+                    emit_byte(OPCODE_ERR_CHECK);
+                }
+            }
+
+            break;
+        }
+
+        case IR_OPCODE_POP: {
+            emit_byte(instruction->pop_data.opcode);
+            break;
+        }
+
+        case IR_OPCODE_JUMP: {
+            emit_ir_moves(instruction->block, instruction->branch_data.targets[0]);
+            if (instruction->branch_data.targets[0] != next_block) {
+                emit_ir_jump(OPCODE_CJUMP, instruction->branch_data.targets[0], false);
+            }
+
+            break;
+        }
+
+        case IR_OPCODE_BRANCH: {
+            wave_ir_block_index true_target = instruction->branch_data.targets[0];
+            wave_ir_block_index false_target = instruction->branch_data.targets[1];
+
+            byte jump_opcode = OPCODE_NOP;
+            byte pop_opcode = OPCODE_NOP;
+            switch (wave_type_get_size(WAVE_IR_INSTRUCTION(ir, WAVE_IR_OPERAND(ir, instruction, 0))->value_type)) {
+                case (sizeof(u8)):  { jump_opcode = OPCODE_CJUMP_8_IF_0;  pop_opcode = OPCODE_POP_8;  break; }
+                case (sizeof(u16)): { jump_opcode = OPCODE_CJUMP_16_IF_0; pop_opcode = OPCODE_POP_16; break; }
+                case (sizeof(u32)): { jump_opcode = OPCODE_CJUMP_32_IF_0; pop_opcode = OPCODE_POP_32; break; }
+                case (sizeof(u64)): { jump_opcode = OPCODE_CJUMP_64_IF_0; pop_opcode = OPCODE_POP_64; break; }
+
+                default: {
+                    PARSER_RAISE_ERROR_AT("emit_ir_instruction", "invalid branch condition type", instruction->source_offset);
+                    return;
+                }
+            }
+
+            // the condition is only popped when the jump is taken, phis of the false target are stored behind the true path
+
+            const wave_ir_block* false_block = WAVE_IR_BLOCK(ir, false_target);
+            bool false_moves = false_block->first_instruction != WAVE_IR_NONE && WAVE_IR_INSTRUCTION(ir, false_block->first_instruction)->opcode == IR_OPCODE_PHI;
+
+            u32 jump_index = parser.bytecode_current - parser.bytecode_start;
+            add_profile_site(WAVE_PROFILE_RECORD_BRANCH, instruction->source_offset, 0, jump_index, WAVE_PROFILE_COUNTER_TAKEN);
+            add_profile_site(WAVE_PROFILE_RECORD_BRANCH, instruction->source_offset, 1, jump_index, WAVE_PROFILE_COUNTER_NOT_TAKEN);
+
+            u32 false_offset_index = 0;
+            if (false_moves) {
+                emit_byte(jump_opcode);
+                false_offset_index = parser.bytecode_current - parser.bytecode_start;
+                emit_u16(0);
+            } else {
+                emit_ir_jump(jump_opcode, false_target, true);
+            }
+
+            emit_byte(pop_opcode);
+            emit_ir_moves(instruction->block, true_target);
+            if (true_target != next_block || false_moves) {
+                emit_ir_jump(OPCODE_CJUMP, true_target, false);
+            }
+
+            if (false_moves) {
+                i64 offset = (i64) (parser.bytecode_current - parser.bytecode_start) - (i64) (false_offset_index + sizeof(u16));
+                if (offset > I16_MAX) {
+                    PARSER_RAISE_ERROR_AT("emit_ir_instruction", "conditional branch target is too far away", instruction->source_offset);
+                    return;
+                }
+
+                *((i16*) (parser.bytecode_start + false_offset_index)) = (i16) offset;
+
+                emit_ir_moves(instruction->block, false_target);
+                if (false_target != next_block) {
+                    emit_ir_jump(OPCODE_CJUMP, false_target, false);
+                }
+            }
+
+            break;
+        }
+
+        case IR_OPCODE_RETURN: { // a tail call returns by itself
+            wave_ir_index value = instruction->operand_count > 0 ? WAVE_IR_OPERAND(ir, instruction, 0) : WAVE_IR_NONE;
+            if (value != WAVE_IR_NONE && function_parser.emit_values[value].mode == IR_EMIT_MODE_TAIL_CALL) {
+                break;
+            }
+
+            // the value is moved to the start of the stack frame, in place of the parameters
+
+            emit_byte(OPCODE_RETURN);
+            emit_u8(value == WAVE_IR_NONE ? 0 : (u8) wave_type_get_size(WAVE_IR_INSTRUCTION(ir, value)->value_type));
+            break;
+        }
+
+        case IR_OPCODE_EXIT: { emit_byte(OPCODE_END); break; }
+
+        default: {
+            PARSER_RAISE_ERROR_AT("emit_ir_instruction", "unable to generate bytecode, unexpected instruction", instruction->source_offset);
+            return;
+        }
+    }
+}
+
+static void emit_ir_moves(wave_ir_block_index from, wave_ir_block_index to) {
+    const wave_ir* ir = &function_parser.ir;
+    const wave_ir_block* block = WAVE_IR_BLOCK(ir, to);
+
+    u32 predecessor = 0;
+    while (predecessor < block->predecessor_count && block->predecessors[predecessor] != from) {
+        predecessor++;
+    }
+
+    // every incoming value is pushed before the first one is stored, as the phis may read each other
+
+    wave_ir_index last_phi = WAVE_IR_NONE;
+    for (wave_ir_index i = block->first_instruction; i != WAVE_IR_NONE && WAVE_IR_INSTRUCTION(ir, i)->opcode == IR_OPCODE_PHI; i = WAVE_IR_INSTRUCTION(ir, i)->next) {
+        emit_ir_value(WAVE_IR_OPERAND(ir, WAVE_IR_INSTRUCTION(ir, i), predecessor));
+        last_phi = i;
+    }
+
+    for (wave_ir_index i = last_phi; i != WAVE_IR_NONE; i = WAVE_IR_INSTRUCTION(ir, i)->previous) {
+        emit_store(WAVE_IR_INSTRUCTION(ir, i)->value_type, function_parser.emit_values[i].slot);
+    }
+}
+
+static void emit_ir_jump(byte opcode, wave_ir_block_index target, bool short_offset) {
+    emit_byte(opcode);
+
+    u32 offset_index = parser.bytecode_current - parser.bytecode_start;
+    if (short_offset) {
+        emit_u16(0);
+    } else {
+        emit_u32(0);
+    }
+
+    add_ir_jump((ir_jump) {
+        .offset_index = offset_index,
+        .end_index = parser.bytecode_current - parser.bytecode_start,
+        .short_offset = short_offset,
+        .table_offset = false,
+        .target = target
+    });
+}
+
+static void add_ir_jump(ir_jump jump) {
+    STACK_HELPER_PUSH(
+        function_parser.jumps,
+        jump,
+
+        sizeof(ir_jump),
+
+        function_parser.jump_capacity,
+        function_parser.jump_count,
+
+        IR_JUMP_STACK_GROW_SIZE,
+
+        "add_ir_jump",
+        "failed to reallocate jump stack"
+    );
+}
+
+static ir_switch_kind get_ir_switch_kind(const wave_ir_instruction* instruction, u64* out_minimum, u64* out_span) {
+    const wave_ir* ir = &function_parser.ir;
+
+    const u64* values = WAVE_IR_SWITCH_VALUES(ir, instruction);
+    const u32 case_count = instruction->switch_data.case_count;
+
+    *out_minimum = 0;
+    *out_span = 0;
+    if (case_count == 0) {
+        return IR_SWITCH_KIND_COMPARE;
+    }
+
+    // the values are sorted by their bits, which puts negative values behind the others
+
+    wave_type value_type = WAVE_IR_INSTRUCTION(ir, WAVE_IR_OPERAND(ir, instruction, 0))->value_type;
+    u32 value_bit_count = wave_type_get_size(value_type) * 8;
+    u64 value_mask = value_bit_count == U64_BIT_COUNT ? U64_MAX : (((u64) 1 << value_bit_count) - 1);
+
+    u32 first_index = 0;
+    if (PARSER_IS_SIGNED_TYPE(value_type)) {
+        while (first_index < case_count && ((values[first_index] >> (value_bit_count - 1)) & 0b1) == 0) {
+            first_index++;
+        }
+
+        first_index = first_index == case_count ? 0 : first_index;
+    }
+
+    *out_minimum = values[first_index];
+    *out_span = (values[(first_index + case_count - 1) % case_count] - values[first_index]) & value_mask;
+
+    if (case_count < SWITCH_MIN_TABLE_CASE_COUNT) {
+        return IR_SWITCH_KIND_COMPARE;
+    } else if (*out_span < SWITCH_MAX_TABLE_LENGTH && *out_span < (u64) case_count * SWITCH_MAX_TABLE_DENSITY) {
+        return IR_SWITCH_KIND_TABLE;
+    } else if (case_count >= SWITCH_MIN_LOOKUP_CASE_COUNT && case_count <= SWITCH_MAX_TABLE_LENGTH) {
+        return IR_SWITCH_KIND_LOOKUP;
+    }
+
+    return IR_SWITCH_KIND_COMPARE; // the cases are compared in the order of @order_ir_switch_cases
+}
+
+static u64 get_ir_switch_case_count(const wave_ir_instruction* instruction, u32 case_index) {
+    const wave_profile* profile = wave_compiler_get_profile();
+    if (profile == NULL) {
+        return 0;
+    }
+
+    const u64 value = WAVE_IR_SWITCH_VALUES(&function_parser.ir, instruction)[case_index];
+    return wave_profile_get_count(profile, parser.current_function->function_data.name, instruction->source_offset, WAVE_PROFILE_RECORD_SWITCH_CASE, value);
+}
+
+static u32 get_ir_switch_hot_case(const wave_ir_instruction* instruction, ir_switch_kind kind) {
+    const wave_profile* profile = wave_compiler_get_profile();
+    if (profile == NULL || kind != IR_SWITCH_KIND_LOOKUP) { // a jump table is reached as fast as a single comparison
+        return U32_MAX;
+    }
+
+    u64 execution_count = wave_profile_get_count(profile, parser.current_function->function_data.name, instruction->source_offset, WAVE_PROFILE_RECORD_SWITCH, 0);
+    for (u32 i = 0; i < instruction->switch_data.case_count; i++) {
+        u64 count = get_ir_switch_case_count(instruction, i);
+        if (count > 0 && count > execution_count / SWITCH_HOT_CASE_RATIO) {
+            return i;
+        }
+    }
+
+    return U32_MAX;
+}
+
+static void order_ir_switch_cases(const wave_ir_instruction* instruction, u32* order) {
+    const u32 case_count = instruction->switch_data.case_count;
+
+    for (u32 i = 0; i < case_count; i++) {
+        order[i] = i;
+    }
+
+    if (wave_compiler_get_profile() == NULL) {
+        return;
+    }
+
+    // insertion sort, which keeps cases taken equally often in ascending order of their values
+
+    for (u32 i = 1; i < case_count; i++) {
+        u64 count = get_ir_switch_case_count(instruction, i);
+
+        u32 j = i;
+        while (j > 0 && get_ir_switch_case_count(instruction, order[j - 1]) < count) {
+            order[j] = order[j - 1];
+            j--;
+        }
+
+        order[j] = i;
+    }
+}
+
+static void emit_ir_switch(wave_ir_index index, wave_ir_block_index next_block) {
+    const wave_ir* ir = &function_parser.ir;
+    const wave_ir_instruction* instruction = WAVE_IR_INSTRUCTION(ir, index);
+
+    const u64* values = WAVE_IR_SWITCH_VALUES(ir, instruction);
+    const wave_ir_block_index* targets = WAVE_IR_SWITCH_TARGETS(ir, instruction);
+    const u32 case_count = instruction->switch_data.case_count;
+
+    wave_ir_index value = WAVE_IR_OPERAND(ir, instruction, 0);
+    u32 value_size = wave_type_get_size(WAVE_IR_INSTRUCTION(ir, value)->value_type);
+    u64 value_mask = value_size == sizeof(u64) ? U64_MAX : (((u64) 1 << (value_size * 8)) - 1);
+
+    u16 size_field = 0; // log2 of the value size, in the upper two bits of the switch field
+    byte push_opcode = OPCODE_NOP;
+    byte equals_opcode = OPCODE_NOP;
+    byte jump_opcode = OPCODE_NOP;
+    byte skip_opcode = OPCODE_NOP;
+    byte pop_opcode = OPCODE_NOP;
+    byte subtract_opcode = OPCODE_NOP;
+    switch (value_size) {
+        case (sizeof(u8)):  { size_field = 0; push_opcode = OPCODE_PUSH_8;  equals_opcode = OPCODE_EQU_8;  jump_opcode = OPCODE_CJUMP_8_IF_1;  skip_opcode = OPCODE_CJUMP_8_IF_0;  pop_opcode = OPCODE_POP_8;  subtract_opcode = OPCODE_U8_SUB;  break; }
+        case (sizeof(u16)): { size_field = 1; push_opcode = OPCODE_PUSH_16; equals_opcode = OPCODE_EQU_16; jump_opcode = OPCODE_CJUMP_16_IF_1; skip_opcode = OPCODE_CJUMP_16_IF_0; pop_opcode = OPCODE_POP_16; subtract_opcode = OPCODE_U16_SUB; break; }
+        case (sizeof(u32)): { size_field = 2; push_opcode = OPCODE_PUSH_32; equals_opcode = OPCODE_EQU_32; jump_opcode = OPCODE_CJUMP_32_IF_1; skip_opcode = OPCODE_CJUMP_32_IF_0; pop_opcode = OPCODE_POP_32; subtract_opcode = OPCODE_U32_SUB; break; }
+        case (sizeof(u64)): { size_field = 3; push_opcode = OPCODE_PUSH_64; equals_opcode = OPCODE_EQU_64; jump_opcode = OPCODE_CJUMP_64_IF_1; skip_opcode = OPCODE_CJUMP_64_IF_0; pop_opcode = OPCODE_POP_64; subtract_opcode = OPCODE_U64_SUB; break; }
+
+        default: {
+            PARSER_RAISE_ERROR_AT("emit_ir_switch", "invalid switch value type", instruction->source_offset);
+            return;
+        }
+    }
+
+    #define EMIT_IR_SWITCH_VALUE(constant)                                 \
+        do {                                                               \
+            emit_byte(push_opcode);                                        \
+            switch (value_size) {                                          \
+                case (sizeof(u8)):  { emit_u8((u8) (constant));   break; } \
+                case (sizeof(u16)): { emit_u16((u16) (constant)); break; } \
+                case (sizeof(u32)): { emit_u32((u32) (constant)); break; } \
+                default:            { emit_u64((u64) (constant)); break; } \
+            }                                                              \
+        } while (0)
+
+    #define EMIT_IR_SWITCH_HAS_PHIS(target) (WAVE_IR_BLOCK(ir, target)->first_instruction != WAVE_IR_NONE && WAVE_IR_INSTRUCTION(ir, WAVE_IR_BLOCK(ir, target)->first_instruction)->opcode == IR_OPCODE_PHI)
+    #define EMIT_IR_SWITCH_IS_INDIRECT(target) ((target) <= instruction->block || EMIT_IR_SWITCH_HAS_PHIS(target)) /* table offsets only jump forward and cannot store phis */
+    #define EMIT_IR_SWITCH_OFFSET() (parser.bytecode_current - parser.bytecode_start)
+
+    u64 minimum = 0;
+    u64 span = 0;
+    ir_switch_kind kind = get_ir_switch_kind(instruction, &minimum, &span);
+
+    // the cases compared in front of the switch instruction, which are all of them for a chain of comparisons
+
+    u32 compare_count = 0;
+    if (kind == IR_SWITCH_KIND_COMPARE) {
+        compare_count = case_count;
+    } else if (get_ir_switch_hot_case(instruction, kind) != U32_MAX) {
+        compare_count = 1;
+    }
+
+    if (compare_count > function_parser.switch_order_capacity) {
+        function_parser.switch_order_capacity = compare_count;
+        if (parser.vm->reallocate_memory((void**) &function_parser.switch_order, sizeof(u32) * function_parser.switch_order_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR_AT("emit_ir_switch", "failed to reallocate switch case order", instruction->source_offset);
+            return;
+        }
+    }
+
+    if (kind == IR_SWITCH_KIND_COMPARE) {
+        order_ir_switch_cases(instruction, function_parser.switch_order);
+    } else if (compare_count > 0) {
+        function_parser.switch_order[0] = get_ir_switch_hot_case(instruction, kind);
+    }
+
+    // every case is a comparison followed by a conditional jump, which only pops the result if it is taken
+
+    for (u32 i = 0; i < compare_count; i++) {
+        u32 case_index = function_parser.switch_order[i];
+
+        emit_ir_value(value);
+        EMIT_IR_SWITCH_VALUE(values[case_index]);
+        emit_byte(equals_opcode);
+
+        if (i == 0) { // every execution reaches the first comparison
+            add_profile_site(WAVE_PROFILE_RECORD_SWITCH, instruction->source_offset, 0, EMIT_IR_SWITCH_OFFSET(), WAVE_PROFILE_COUNTER_EXECUTED);
+        }
+
+        wave_ir_block_index target = targets[case_index + 1];
+        if (!EMIT_IR_SWITCH_HAS_PHIS(target)) {
+            add_profile_site(WAVE_PROFILE_RECORD_SWITCH_CASE, instruction->source_offset, values[case_index], EMIT_IR_SWITCH_OFFSET(), WAVE_PROFILE_COUNTER_TAKEN);
+            emit_ir_jump(jump_opcode, target, true);
+            emit_byte(pop_opcode);
+            continue;
+        }
+
+        // the phis of the target are stored in front of the jump to it, other values skip it
+
+        add_profile_site(WAVE_PROFILE_RECORD_SWITCH_CASE, instruction->source_offset, values[case_index], EMIT_IR_SWITCH_OFFSET(), WAVE_PROFILE_COUNTER_NOT_TAKEN);
+        emit_byte(skip_opcode);
+        u32 skip_offset_index = EMIT_IR_SWITCH_OFFSET();
+        emit_u16(0);
+
+        emit_byte(pop_opcode);
+        emit_ir_moves(instruction->block, target);
+        emit_ir_jump(OPCODE_CJUMP, target, false);
+
+        i64 offset = (i64) EMIT_IR_SWITCH_OFFSET() - (i64) (skip_offset_index + sizeof(u16));
+        if (offset > I16_MAX) {
+            PARSER_RAISE_ERROR_AT("emit_ir_switch", "conditional branch target is too far away", instruction->source_offset);
+            return;
+        }
+
+        *((i16*) (parser.bytecode_start + skip_offset_index)) = (i16) offset;
+    }
+
+    if (compiler_has_error()) {
+        return;
+    }
+
+    u32 table_index = 0; // the first entry of the jump table
+    u32 entry_size = 0;
+    u32 offset_position = 0; // the offset of the branch offset in an entry
+    u32 end_index = 0; // the end of the switch instruction, which the table offsets are relative to
+
+    bool indirect_targets = false; // whether any case is reached through a trampoline behind the default path
+    switch (kind) {
+        case IR_SWITCH_KIND_COMPARE: {
+            break;
+        }
+
+        case IR_SWITCH_KIND_TABLE: {
+            // the table starts at the smallest case value, the entries in between the case values continue behind it
+
+            emit_ir_value(value);
+            if (minimum != 0) {
+                EMIT_IR_SWITCH_VALUE(minimum);
+                emit_byte(subtract_opcode);
+            }
+
+            u32 length = (u32) span + 1;
+
+            add_profile_site(WAVE_PROFILE_RECORD_SWITCH, instruction->source_offset, 0, EMIT_IR_SWITCH_OFFSET(), WAVE_PROFILE_COUNTER_EXECUTED);
+            emit_byte(OPCODE_TABLESWITCH);
+            emit_u16((u16) ((size_field << (U16_BIT_COUNT - 2)) | length));
+
+            table_index = EMIT_IR_SWITCH_OFFSET();
+            entry_size = sizeof(u16);
+            offset_position = 0;
+
+            for (u32 i = 0; i < length; i++) {
+                emit_u16(0);
+            }
+
+            end_index = EMIT_IR_SWITCH_OFFSET();
+
+            for (u32 i = 0; i < case_count; i++) {
+                u32 entry_index = table_index + entry_size * (u32) ((values[i] - minimum) & value_mask);
+                add_profile_site(WAVE_PROFILE_RECORD_SWITCH_CASE, instruction->source_offset, values[i], entry_index, WAVE_PROFILE_COUNTER_TAKEN);
+
+                if (EMIT_IR_SWITCH_IS_INDIRECT(targets[i + 1])) {
+                    indirect_targets = true;
+                    continue;
+                }
+
+                add_ir_jump((ir_jump) {
+                    .offset_index = entry_index,
+                    .end_index = end_index,
+                    .short_offset = false,
+                    .table_offset = true,
+                    .target = targets[i + 1]
+                });
+            }
+
+            break;
+        }
+
+        case IR_SWITCH_KIND_LOOKUP: {
+            // the vm searches the values in ascending order of their bits, which is the order they are stored in
+
+            emit_ir_value(value);
+
+            if (compare_count == 0) { // the executions are counted by the comparison in front of it otherwise
+                add_profile_site(WAVE_PROFILE_RECORD_SWITCH, instruction->source_offset, 0, EMIT_IR_SWITCH_OFFSET(), WAVE_PROFILE_COUNTER_EXECUTED);
+            }
+
+            emit_byte(OPCODE_LOOKUPSWITCH);
+            emit_u16((u16) ((size_field << (U16_BIT_COUNT - 2)) | case_count));
+
+            table_index = EMIT_IR_SWITCH_OFFSET();
+            entry_size = value_size + sizeof(u16);
+            offset_position = value_size;
+
+            for (u32 i = 0; i < case_count; i++) {
+                switch (value_size) {
+                    case (sizeof(u8)):  { emit_u8((u8) values[i]);   break; }
+                    case (sizeof(u16)): { emit_u16((u16) values[i]); break; }
+                    case (sizeof(u32)): { emit_u32((u32) values[i]); break; }
+                    default:            { emit_u64(values[i]);       break; }
+                }
+
+                emit_u16(0);
+            }
+
+            end_index = EMIT_IR_SWITCH_OFFSET();
+
+            for (u32 i = 0; i < case_count; i++) {
+                add_profile_site(WAVE_PROFILE_RECORD_SWITCH_CASE, instruction->source_offset, values[i], table_index + entry_size * i, WAVE_PROFILE_COUNTER_TAKEN);
+
+                if (EMIT_IR_SWITCH_IS_INDIRECT(targets[i + 1])) {
+                    indirect_targets = true;
+                    continue;
+                }
+
+                add_ir_jump((ir_jump) {
+                    .offset_index = table_index + entry_size * i + offset_position,
+                    .end_index = end_index,
+                    .short_offset = false,
+                    .table_offset = true,
+                    .target = targets[i + 1]
+                });
+            }
+
+            break;
+        }
+
+        default: {
+            PARSER_RAISE_ERROR_AT("emit_ir_switch", "unknown switch kind", instruction->source_offset);
+            return;
+        }
+    }
+
+    if (compiler_has_error()) {
+        return;
+    }
+
+    // the default path, followed by the trampolines of the cases that cannot be reached from the table
+
+    emit_ir_moves(instruction->block, targets[0]);
+    if (targets[0] != next_block || indirect_targets) {
+        emit_ir_jump(OPCODE_CJUMP, targets[0], false);
+    }
+
+    for (u32 i = 0; indirect_targets && i < case_count; i++) {
+        wave_ir_block_index target = targets[i + 1];
+        if (!EMIT_IR_SWITCH_IS_INDIRECT(target)) {
+            continue;
+        }
+
+        u32 entry_index = kind == IR_SWITCH_KIND_TABLE ? (u32) ((values[i] - minimum) & value_mask) : i;
+        u32 offset = EMIT_IR_SWITCH_OFFSET() - end_index;
+        if (offset > U16_MAX) {
+            PARSER_RAISE_ERROR_AT("emit_ir_switch", "switch case target is too far away", instruction->source_offset);
+            return;
+        }
+
+        *((u16*) (parser.bytecode_start + table_index + entry_size * entry_index + offset_position)) = (u16) offset;
+
+        emit_ir_moves(instruction->block, target);
+        emit_ir_jump(OPCODE_CJUMP, target, false);
+    }
+
+    #undef EMIT_IR_SWITCH_VALUE
+    #undef EMIT_IR_SWITCH_HAS_PHIS
+    #undef EMIT_IR_SWITCH_IS_INDIRECT
+    #undef EMIT_IR_SWITCH_OFFSET
+}
+
+static wave_opcode_extended get_conversion_opcode(wave_type from_type, wave_type to_type) {
+    static const struct {
+        wave_type from_type;
+        wave_type to_type;
+        wave_opcode_extended opcode;
+    } conversion_opcodes[] = {
+        { WAVE_TYPE_U16, WAVE_TYPE_U8,  OPCODE_EXT_U16_TO_U8  },
+        { WAVE_TYPE_U32, WAVE_TYPE_U8,  OPCODE_EXT_U32_TO_U8  },
+        { WAVE_TYPE_U32, WAVE_TYPE_U16, OPCODE_EXT_U32_TO_U16 },
+        { WAVE_TYPE_U64, WAVE_TYPE_U8,  OPCODE_EXT_U64_TO_U8  },
+        { WAVE_TYPE_U64, WAVE_TYPE_U16, OPCODE_EXT_U64_TO_U16 },
+        { WAVE_TYPE_U64, WAVE_TYPE_U32, OPCODE_EXT_U64_TO_U32 },
+
+        { WAVE_TYPE_U8,  WAVE_TYPE_U16, OPCODE_EXT_U8_TO_U16  },
+        { WAVE_TYPE_U8,  WAVE_TYPE_U32, OPCODE_EXT_U8_TO_U32  },
+        { WAVE_TYPE_U8,  WAVE_TYPE_U64, OPCODE_EXT_U8_TO_U64  },
+        { WAVE_TYPE_U16, WAVE_TYPE_U32, OPCODE_EXT_U16_TO_U32 },
+        { WAVE_TYPE_U16, WAVE_TYPE_U64, OPCODE_EXT_U16_TO_U64 },
+        { WAVE_TYPE_U32, WAVE_TYPE_U64, OPCODE_EXT_U32_TO_U64 },
+
+        { WAVE_TYPE_I8,  WAVE_TYPE_I16, OPCODE_EXT_I8_TO_I16  },
+        { WAVE_TYPE_I8,  WAVE_TYPE_I32, OPCODE_EXT_I8_TO_I32  },
+        { WAVE_TYPE_I8,  WAVE_TYPE_I64, OPCODE_EXT_I8_TO_I64  },
+        { WAVE_TYPE_I16, WAVE_TYPE_I32, OPCODE_EXT_I16_TO_I32 },
+        { WAVE_TYPE_I16, WAVE_TYPE_I64, OPCODE_EXT_I16_TO_I64 },
+        { WAVE_TYPE_I32, WAVE_TYPE_I64, OPCODE_EXT_I32_TO_I64 },
+
+        { WAVE_TYPE_I32, WAVE_TYPE_F32, OPCODE_EXT_I32_TO_F32 },
+        { WAVE_TYPE_I32, WAVE_TYPE_F64, OPCODE_EXT_I32_TO_F64 },
+        { WAVE_TYPE_U32, WAVE_TYPE_F64, OPCODE_EXT_U32_TO_F64 },
+        { WAVE_TYPE_I64, WAVE_TYPE_F64, OPCODE_EXT_I64_TO_F64 },
+        { WAVE_TYPE_F32, WAVE_TYPE_I32, OPCODE_EXT_F32_TO_I32 },
+        { WAVE_TYPE_F64, WAVE_TYPE_I32, OPCODE_EXT_F64_TO_I32 },
+        { WAVE_TYPE_F64, WAVE_TYPE_I64, OPCODE_EXT_F64_TO_I64 },
+        { WAVE_TYPE_F32, WAVE_TYPE_F64, OPCODE_EXT_F32_TO_F64 },
+        { WAVE_TYPE_F64, WAVE_TYPE_F32, OPCODE_EXT_F64_TO_F32 }
+    };
+
+    // integers are only told apart by their width, unless they are sign extended (the unsigned types come first, ordered by width, followed by the signed ones)
+
+    if (wave_type_is_integer(from_type) && wave_type_is_integer(to_type)) {
+        const wave_type first_type = PARSER_IS_SIGNED_TYPE(from_type) && wave_type_get_size(to_type) > wave_type_get_size(from_type) ? WAVE_TYPE_I8 : WAVE_TYPE_U8;
+
+        from_type = first_type + (from_type - WAVE_TYPE_U8) % (WAVE_TYPE_I8 - WAVE_TYPE_U8);
+        to_type = first_type + (to_type - WAVE_TYPE_U8) % (WAVE_TYPE_I8 - WAVE_TYPE_U8);
+    }
+
+    for (u32 i = 0; i < ARRAY_LENGTH(conversion_opcodes); i++) {
+        if (conversion_opcodes[i].from_type == from_type && conversion_opcodes[i].to_type == to_type) {
+            return conversion_opcodes[i].opcode;
+        }
+    }
+
+    return OPCODE_EXT_MAX;
+}
+
+static void add_profile_site(wave_profile_record_type type, u32 source_offset, u64 value, u32 bytecode_offset, wave_profile_counter counter) {
+    if (wave_compiler_get_profile() == NULL) {
+        return;
+    }
+
+    wave_profile_site site = (wave_profile_site) {
+        .function = parser.current_function->function_data.name,
+        .value = value,
+
+        .source_offset = source_offset,
+        .type = type,
+
+        .bytecode_offset = bytecode_offset,
+        .counter = counter
+    };
+
+    STACK_HELPER_PUSH(function_parser.profile_sites, site, sizeof(wave_profile_site), function_parser.profile_site_capacity, function_parser.profile_site_count, PROFILE_SITE_STACK_GROW_SIZE, "add_profile_site", "failed to reallocate profile site stack");
+}
+
+static void optimize_bytecode(u32 start_index) {
+    wave_bytecode_optimizer* optimizer = &function_parser.bytecode_optimizer;
+
+    u32 size = (parser.bytecode_current - parser.bytecode_start) - start_index;
+    if (wave_bytecode_optimizer_optimize(optimizer, parser.bytecode_start + start_index, &size) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("optimize_bytecode", "failed to reallocate peephole optimizer");
+        return;
+    }
+
+    parser.bytecode_current = parser.bytecode_start + start_index + size;
+
+    // the calls in removed code do not need to be linked anymore
+
+    u32 patch_hole_count = 0;
+    for (u32 i = 0; i < parser.patch_hole_count; i++) {
+        patch_hole hole = parser.patch_holes[i];
+        if (hole.bytecode_index >= start_index) {
+            u32 relocated_index = wave_bytecode_optimizer_relocate(optimizer, hole.bytecode_index - start_index);
+            if (relocated_index == U32_MAX) {
+                continue;
+            }
+
+            hole.bytecode_index = start_index + relocated_index;
+        }
+
+        parser.patch_holes[patch_hole_count++] = hole;
+    }
+
+    parser.patch_hole_count = patch_hole_count;
+
+    // the counters of removed instructions are never reached
+
+    u32 profile_site_count = 0;
+    for (u32 i = 0; i < function_parser.profile_site_count; i++) {
+        wave_profile_site site = function_parser.profile_sites[i];
+        if (site.bytecode_offset >= start_index) {
+            u32 relocated_offset = wave_bytecode_optimizer_relocate(optimizer, site.bytecode_offset - start_index);
+            if (relocated_offset == U32_MAX) {
+                continue;
+            }
+
+            site.bytecode_offset = start_index + relocated_offset;
+
+            // a negated condition flips the jump of a branch (see @wave_bytecode_optimizer_optimize)
+
+            byte opcode = parser.bytecode_start[site.bytecode_offset];
+            if (site.type == WAVE_PROFILE_RECORD_BRANCH && opcode >= OPCODE_CJUMP_8_IF_0 && opcode <= OPCODE_CJUMP_64_IF_1 && (opcode - OPCODE_CJUMP_8_IF_0) % 2 == 1) {
+                site.counter = site.counter == WAVE_PROFILE_COUNTER_TAKEN ? WAVE_PROFILE_COUNTER_NOT_TAKEN : WAVE_PROFILE_COUNTER_TAKEN;
+            }
+        }
+
+        function_parser.profile_sites[profile_site_count++] = site;
+    }
+
+    function_parser.profile_site_count = profile_site_count;
+
+    const wave_compiler_message_function dump_function = wave_compiler_get_ir_dump_function();
+    if (dump_function != NULL && wave_bytecode_optimizer_dump(optimizer, function_parser.ir.name, function_parser.ir.name_length, dump_function) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("optimize_bytecode", "failed to dump peephole statistics");
+        return;
+    }
+}
+
+static void emit_load(wave_type type, u16 offset) {
+    switch (wave_type_get_size(type)) {
+        case (sizeof(u8)):  { emit_byte(OPCODE_LOAD_8);  break; }
+        case (sizeof(u16)): { emit_byte(OPCODE_LOAD_16); break; }
+        case (sizeof(u32)): { emit_byte(OPCODE_LOAD_32); break; }
+        case (sizeof(u64)): { emit_byte(OPCODE_LOAD_64); break; }
+
+        default: {
+            PARSER_RAISE_ERROR("emit_load", "unknown variable type");
+            return;
+        }
+    }
+
+    emit_u16(offset);
+}
+
+static void emit_store(wave_type type, u16 offset) {
+    switch (wave_type_get_size(type)) {
+        case (sizeof(u8)):  { emit_byte(OPCODE_STORE_8);  break; }
+        case (sizeof(u16)): { emit_byte(OPCODE_STORE_16); break; }
+        case (sizeof(u32)): { emit_byte(OPCODE_STORE_32); break; }
+        case (sizeof(u64)): { emit_byte(OPCODE_STORE_64); break; }
+
+        default: {
+            PARSER_RAISE_ERROR("emit_store", "unknown variable type");
+            return;
+        }
+    }
+
+    emit_u16(offset);
+}
+
+static void emit_operation(node_type operation, wave_type result_expression_type, u32 source_offset) {
+    // macros
+
+    #define DEFAULT_CASE() default: { PARSER_RAISE_ERROR_AT("emit_operation", "invalid expression variable type", source_offset); return; }
+    #define TYPE_CASE(operation, type) case CONCAT2(WAVE_TYPE_, type): { emit_byte(CONCAT4(OPCODE_, type, _, operation)); break; }
+    #define TYPE_CASES(operation)   \
+        TYPE_CASE(operation, U8)    \
+        TYPE_CASE(operation, U16)   \
+        TYPE_CASE(operation, U32)   \
+        TYPE_CASE(operation, U64)   \
+                                    \
+        TYPE_CASE(operation, I8)    \
+        TYPE_CASE(operation, I16)   \
+        TYPE_CASE(operation, I32)   \
+        TYPE_CASE(operation, I64)   \
+                                    \
+        TYPE_CASE(operation, F32)   \
+        TYPE_CASE(operation, F64)   \
+
+    #define CASE_ARITHMETIC_OPCODE(node_type, operation)    \
+        case node_type: {                                   \
+            switch (result_expression_type) {               \
+                TYPE_CASES(operation)                       \
+                DEFAULT_CASE()                              \
+            }                                               \
+                                                            \
+            break;                                          \
+        }
+
+    #define CASE_BITWISE_OPCODE(node_type, operation)                                                                               \
+        case node_type: {                                                                                                           \
+            switch (result_expression_type) {                                                                                       \
+                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(CONCAT3(OPCODE_, operation, _8));  break; }                       \
+                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(CONCAT3(OPCODE_, operation, _16)); break; }                       \
+                case WAVE_TYPE_U32: case WAVE_TYPE_I32: case WAVE_TYPE_F32: { emit_byte(CONCAT3(OPCODE_, operation, _32)); break; }    \
+                case WAVE_TYPE_U64: case WAVE_TYPE_I64: case WAVE_TYPE_F64: { emit_byte(CONCAT3(OPCODE_, operation, _64)); break; }    \
+                                                                                                                                    \
+                DEFAULT_CASE()                                                                                                      \
+            }                                                                                                                       \
+                                                                                                                                    \
+            break;                                                                                                                  \
+        }
+
+    switch (operation) {
+        // unary operations
+
+        case NODE_TYPE_UNARY_OPERATION_MINUS: {
+            switch (result_expression_type) {
+                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(OPCODE_I8_NEG);  break; }
+                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_I16_NEG); break; }
+                case WAVE_TYPE_U32: case WAVE_TYPE_I32: { emit_byte(OPCODE_I32_NEG); break; }
+                case WAVE_TYPE_U64: case WAVE_TYPE_I64: { emit_byte(OPCODE_I64_NEG); break; }
+
+                case WAVE_TYPE_F32: { emit_byte(OPCODE_F32_NEG); break; }
+                case WAVE_TYPE_F64: { emit_byte(OPCODE_F64_NEG); break; }
+
+                DEFAULT_CASE()
+            }
+
+            break;
+        }
+
+        case NODE_TYPE_UNARY_OPERATION_ABS: {
+            switch (result_expression_type) {
+                case WAVE_TYPE_I8:  { emit_byte(OPCODE_I8_ABS);  break; }
+                case WAVE_TYPE_I16: { emit_byte(OPCODE_I16_ABS); break; }
+                case WAVE_TYPE_I32: { emit_byte(OPCODE_I32_ABS); break; }
+                case WAVE_TYPE_I64: { emit_byte(OPCODE_I64_ABS); break; }
+
+                case WAVE_TYPE_F32: { emit_byte(OPCODE_F32_ABS); break; }
+                case WAVE_TYPE_F64: { emit_byte(OPCODE_F64_ABS); break; }
+
+                case WAVE_TYPE_U8:
+                case WAVE_TYPE_U16:
+                case WAVE_TYPE_U32:
+                case WAVE_TYPE_U64: {
+                    break;
+                }
+
+                DEFAULT_CASE()
+            }
+
+            break;
+        }
+
+        CASE_BITWISE_OPCODE(NODE_TYPE_UNARY_OPERATION_BIT_NOT, BNOT)
+        CASE_BITWISE_OPCODE(NODE_TYPE_UNARY_OPERATION_NOT, NOT)
+
+        // binary operations
+
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_ADD, ADD)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_SUB, SUB)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_MUL, MUL)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_DIV, DIV)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_MOD, MOD)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_POW, POW)
+
+        case NODE_TYPE_BINARY_OPERATION_EQUAL: {
+            switch (result_expression_type) {
+                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(OPCODE_EQU_8);  break; }
+                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_EQU_16); break; }
+                case WAVE_TYPE_U32: case WAVE_TYPE_I32: { emit_byte(OPCODE_EQU_32); break; }
+                case WAVE_TYPE_U64: case WAVE_TYPE_I64: { emit_byte(OPCODE_EQU_64); break; }
+
+                case WAVE_TYPE_F32: {
+                    emit_byte(OPCODE_F32_EQU);
+                    break;
+                }
+
+                case WAVE_TYPE_F64: {
+                    emit_byte(OPCODE_F64_EQU);
+                    break;
+                }
+
+                DEFAULT_CASE()
+            }
+
+            break;
+        }
+
+        case NODE_TYPE_BINARY_OPERATION_UNEQUAL: {
+            switch (result_expression_type) {
+                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(OPCODE_NEQ_8);  break; }
+                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_NEQ_16); break; }
+                case WAVE_TYPE_U32: case WAVE_TYPE_I32: { emit_byte(OPCODE_NEQ_32); break; }
+                case WAVE_TYPE_U64: case WAVE_TYPE_I64: { emit_byte(OPCODE_NEQ_64); break; }
+
+                case WAVE_TYPE_F32: {
+                    emit_byte(OPCODE_F32_NEQ);
+                    break;
+                }
+
+                case WAVE_TYPE_F64: {
+                    emit_byte(OPCODE_F64_NEQ);
+                    break;
+                }
+
+                DEFAULT_CASE()
+            }
+
+            break;
+        }
+
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_AND, AND)
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_OR, OR)
+
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_BIT_AND, BAND)
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_BIT_OR, BOR)
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_BIT_XOR, XOR)
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT, SHIFT_L)
+        CASE_BITWISE_OPCODE(NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_RIGHT, SHIFT_R)
+
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_LESS_THAN, LT)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_LESS_THAN_EQUAL, LE)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_GREATER_THAN, GT)
+        CASE_ARITHMETIC_OPCODE(NODE_TYPE_BINARY_OPERATION_GREATER_THAN_EQUAL, GE)
+
+        default: {
+            PARSER_RAISE_ERROR_AT("emit_operation", "unable to generate expression, unexpected node type", source_offset);
+            return;
+        }
+    }
+
+    #undef DEFAULT_CASE
+    #undef TYPE_CASE
+    #undef TYPE_CASES
+    #undef CASE_ARITHMETIC_OPCODE
+    #undef CASE_BITWISE_OPCODE
+}
+
+// functions
+
+static bool function_is_defined(wave_symbol symbol) {
+    return parser.function_symbols[symbol] != U32_MAX || parser.native_symbols[symbol] != U32_MAX;
+}
+
+static bool resolve_function(wave_symbol symbol, parse_function* out_function) {
+    u32 index = parser.function_symbols[symbol];
+    if (index != U32_MAX) {
+        *out_function = parser.functions[index];
+        return true;
+    }
+
+    *out_function = PARSE_FUNCTION_NULL;
+    return false;
+}
+
+// patch holes
+
+static void add_patch_hole(patch_hole_type type, wave_symbol identifier, u32 token_index) { // the patch hole is placed at the current bytecode position
+    STACK_HELPER_PUSH(
+        parser.patch_holes,
+        ((patch_hole) {
+            .type = type,
+            .bytecode_index = parser.bytecode_current - parser.bytecode_start,
+            .token_index = token_index,
+            .patch_hole_data.identifier = identifier
+        }),
+
+        sizeof(patch_hole),
+
+        parser.patch_hole_capacity,
+        parser.patch_hole_count,
+
+        PATCH_HOLE_STACK_GROW_SIZE,
+
+        "add_patch_hole",
+        "failed to reallocate patch hole stack"
+    );
+}
+
+static void fix_patch_holes(void) {
+    for (u32 i = 0; i < parser.patch_hole_count; i++) {
+        patch_hole* hole = &parser.patch_holes[i];
+
+        switch (hole->type) {
+            case PATCH_HOLE_TYPE_FUNCTION_CALL: {
+                u32 function_index = parser.function_symbols[hole->patch_hole_data.identifier];
+                if (function_index == U32_MAX || !parser.functions[function_index].initialized) {
+                    PARSER_RAISE_ERROR("fix_patch_holes", "failed to link function call, unknown function");
+                    return;
+                }
+
+                *((u32*) (parser.bytecode_start + hole->bytecode_index)) = parser.functions[function_index].branch_offset;
+                break;
+            }
+
+            default: {
+                PARSER_RAISE_ERROR("fix_patch_holes", "unknown patch hole type");
+                return;
+            }
+        }
+    }
+}
+
+// function units
+
+static error_code function_parser_new(void) {
+    const wave_memory_allocation_function allocate_memory = parser.vm->allocate_memory;
+
+    function_parser.scope_depth = 0;
+
+    function_parser.accessed_globals = NULL;
+    function_parser.accessed_globals_capacity = 32;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.accessed_globals, sizeof(u16) * function_parser.accessed_globals_capacity);
+    function_parser.accessed_globals_count = 0;
+
+    function_parser.locals = NULL;
+    function_parser.locals_capacity = 32;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.locals, sizeof(wave_local) * function_parser.locals_capacity);
+    function_parser.locals_count = 0;
+    function_parser.locals_offset = 0;
+
+    function_parser.local_symbols = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.local_symbols, sizeof(u32) * parser.symbol_capacity);
+    memory_set_32(function_parser.local_symbols, U32_MAX, parser.symbol_capacity);
+
+    function_parser.non_escaping_context = false;
+
+    RUN_ERROR_CODE_FUNCTION(wave_ast_new, &function_parser.ast, 64, allocate_memory, parser.vm->reallocate_memory, parser.vm->deallocate_memory);
+    function_parser.expression_node = WAVE_AST_NONE;
+
+    RUN_ERROR_CODE_FUNCTION(wave_ir_new, &function_parser.ir, allocate_memory, parser.vm->reallocate_memory, parser.vm->deallocate_memory);
+    function_parser.expression_value = WAVE_IR_NONE;
+
+    function_parser.call_operands = NULL;
+    function_parser.call_operand_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.call_operands, sizeof(wave_ir_index) * function_parser.call_operand_capacity);
+    function_parser.call_operand_count = 0;
+
+    function_parser.emit_values = NULL;
+    function_parser.emit_value_capacity = 64;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.emit_values, sizeof(ir_emit_value) * function_parser.emit_value_capacity);
+
+    function_parser.block_offsets = NULL;
+    function_parser.block_offset_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.block_offsets, sizeof(u32) * function_parser.block_offset_capacity);
+
+    function_parser.jumps = NULL;
+    function_parser.jump_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.jumps, sizeof(ir_jump) * function_parser.jump_capacity);
+    function_parser.jump_count = 0;
+
+    function_parser.switch_cases = NULL;
+    function_parser.switch_case_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.switch_cases, sizeof(parse_switch_case) * function_parser.switch_case_capacity);
+    function_parser.switch_case_count = 0;
+
+    RUN_ERROR_CODE_FUNCTION(wave_bytecode_optimizer_new, &function_parser.bytecode_optimizer, allocate_memory, parser.vm->reallocate_memory, parser.vm->deallocate_memory);
+
+    function_parser.call_sites = NULL;
+    function_parser.call_site_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.call_sites, sizeof(parse_call_site) * function_parser.call_site_capacity);
+    function_parser.call_site_count = 0;
+
+    function_parser.call_arguments = NULL;
+    function_parser.call_argument_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.call_arguments, sizeof(parse_call_argument) * function_parser.call_argument_capacity);
+    function_parser.call_argument_count = 0;
+
+    function_parser.profile_sites = NULL;
+    function_parser.profile_site_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.profile_sites, sizeof(wave_profile_site) * function_parser.profile_site_capacity);
+    function_parser.profile_site_count = 0;
+
+    function_parser.switch_order = NULL;
+    function_parser.switch_order_capacity = 16;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.switch_order, sizeof(u32) * function_parser.switch_order_capacity);
+
+    function_parser.keep_inline_body = false;
+    function_parser.inline_body = NULL;
+    function_parser.inlined_calls = false;
+
+    function_parser.labels = NULL;
+    function_parser.label_capacity = 32;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.labels, sizeof(parse_label) * function_parser.label_capacity);
+    function_parser.label_count = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static error_code function_parser_destroy(void) {
+    const wave_memory_deallocation_function deallocate_memory = parser.vm->deallocate_memory;
+
+    #define FUNCTION_PARSER_DEALLOCATE(pointer) do { if (pointer != NULL) { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) pointer); pointer = NULL; } } while (0)
+
+    FUNCTION_PARSER_DEALLOCATE(function_parser.accessed_globals);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.locals);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.local_symbols);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.labels);
+
+    FUNCTION_PARSER_DEALLOCATE(function_parser.call_operands);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.emit_values);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.block_offsets);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.jumps);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.switch_cases);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.call_sites);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.call_arguments);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.profile_sites);
+    FUNCTION_PARSER_DEALLOCATE(function_parser.switch_order);
+
+    #undef FUNCTION_PARSER_DEALLOCATE
+
+    RUN_ERROR_CODE_FUNCTION(wave_ast_destroy, &function_parser.ast);
+    RUN_ERROR_CODE_FUNCTION(wave_ir_destroy, &function_parser.ir);
+    RUN_ERROR_CODE_FUNCTION(wave_bytecode_optimizer_destroy, &function_parser.bytecode_optimizer);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static bool is_inline_candidate(const parse_unit* unit) { // only decides the order units are compiled in, whether the body is inlined depends on its optimized ir (see @wave_ir_optimizer_can_inline)
+    if (unit->function_index == PARSE_UNIT_ENTRYPOINT || parser.functions[unit->function_index].function_data.error_function) {
+        return false;
+    } else if (parser.functions[unit->function_index].inline_function) {
+        return true;
+    }
+
+    // small bodies that do not call other functions, larger ones if the profile calls them often
+
+    const wave_profile* profile = wave_compiler_get_profile();
+    u32 max_token_count = profile != NULL && wave_profile_is_hot(profile, parser.functions[unit->function_index].function_data.name) ? INLINE_MAX_HOT_BODY_TOKEN_COUNT : INLINE_MAX_BODY_TOKEN_COUNT;
+
+    u32 depth = 0;
+    for (u32 index = unit->body_token_index; index - unit->body_token_index < max_token_count; index++) {
+        switch (parser_get_token(index).token) {
+            case WAVE_TOKEN_OP_CURLY_BRACKET_OPEN: {
+                depth++;
+                break;
+            }
+
+            case WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE: {
+                depth--;
+                if (depth == 0) {
+                    return true;
+                }
+
+                break;
+            }
+
+            case WAVE_TOKEN_IDENTIFIER: {
+                if (parser_get_token(index + 1).token == WAVE_TOKEN_OP_PARENTHESES_OPEN) {
+                    return false;
+                }
+
+                break;
+            }
+
+            case WAVE_TOKEN_FILE_END: {
+                return false;
+            }
+
+            default: {
+                break;
+            }
+        }
+    }
+
+    return false;
+}
+
+static void parse_unit_body(parse_unit* unit) { // compiles the body starting at @parser.current into the bytecode of @unit
+    compiler_error_list* previous_errors = compiler_set_error_list(&unit->errors);
+
+    // the declarations may be shared with other threads, which is why the function is compiled into a copy
+
+    parse_function function = unit->function_index == PARSE_UNIT_ENTRYPOINT ? parser.entrypoint_function : parser.functions[unit->function_index];
+    parser.current_function = &function;
+    parser.current_scope_is_entrypoint_function = unit->function_index == PARSE_UNIT_ENTRYPOINT;
+
+    function_parser.keep_inline_body = unit->inline_candidate;
+    function_parser.inline_body = NULL;
+    function_parser.inlined_calls = false;
+
+    function_parser.call_site_count = 0;
+    function_parser.call_argument_count = 0;
+    function_parser.profile_site_count = 0;
+
+    // swap the bytecode and patch holes of the parser with the ones of the unit
+
+    byte* bytecode_start = parser.bytecode_start;
+    byte* bytecode_end = parser.bytecode_end;
+    byte* bytecode_current = parser.bytecode_current;
+    u32 bytecode_capacity = parser.bytecode_capacity;
+
+    patch_hole* patch_holes = parser.patch_holes;
+    u32 patch_hole_capacity = parser.patch_hole_capacity;
+    u32 patch_hole_count = parser.patch_hole_count;
+
+    parser.bytecode_start = NULL;
+    parser.bytecode_capacity = BYTECODE_STACK_INITIAL_CAPACITY;
+    parser.patch_holes = NULL;
+    parser.patch_hole_capacity = PATCH_HOLE_STACK_GROW_SIZE;
+    parser.patch_hole_count = 0;
+
+    if (parser.vm->allocate_memory((void**) &parser.bytecode_start, sizeof(byte) * parser.bytecode_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL ||
+        parser.vm->allocate_memory((void**) &parser.patch_holes, sizeof(patch_hole) * parser.patch_hole_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_unit_body", "failed to allocate function unit");
+        parser.bytecode_current = parser.bytecode_start;
+        goto parse_unit_body_end;
+    }
+
+    parser.bytecode_end = parser.bytecode_start + parser.bytecode_capacity;
+    parser.bytecode_current = parser.bytecode_start;
+
+    // compile body
+
+    while (function_parser.locals_count > 0) {
+        pop_local();
+    }
+
+    function_parser.locals_offset = 0;
+    function_parser.scope_depth = 0;
+
+    parse_function_body(unit->function_name_source_pointer, unit->function_start_offset, unit->parameters);
+
+    while (function_parser.locals_count > 0) {
+        pop_local();
+    }
+
+    function_parser.locals_offset = 0;
+    function_parser.scope_depth = 0;
+
+    parse_unit_body_end: {}
+
+    unit->bytecode = parser.bytecode_start;
+    unit->bytecode_size = parser.bytecode_current - parser.bytecode_start;
+    unit->branch_offset = function.branch_offset;
+    unit->locals_size = function.locals_size;
+
+    unit->patch_holes = parser.patch_holes;
+    unit->patch_hole_count = parser.patch_hole_count;
+
+    unit->inline_body = function_parser.inline_body;
+    unit->cacheable = unit->cacheable && !function_parser.inlined_calls && !unit->specialized; // the inlined bodies and the callers are not part of the cache key
+
+    // the call graph is kept until the units are linked, the buffers of the function parser are reused for the next body
+
+    unit->call_sites = NULL;
+    unit->call_site_count = 0;
+    unit->call_arguments = NULL;
+    unit->call_argument_count = 0;
+
+    if (function_parser.call_site_count > 0) {
+        if (parser.vm->allocate_memory((void**) &unit->call_sites, sizeof(parse_call_site) * function_parser.call_site_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_unit_body", "failed to allocate call graph");
+        } else {
+            memory_copy(function_parser.call_sites, unit->call_sites, sizeof(parse_call_site) * function_parser.call_site_count);
+            unit->call_site_count = function_parser.call_site_count;
+        }
+    }
+
+    if (function_parser.call_argument_count > 0) {
+        if (parser.vm->allocate_memory((void**) &unit->call_arguments, sizeof(parse_call_argument) * function_parser.call_argument_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_unit_body", "failed to allocate call graph");
+        } else {
+            memory_copy(function_parser.call_arguments, unit->call_arguments, sizeof(parse_call_argument) * function_parser.call_argument_count);
+            unit->call_argument_count = function_parser.call_argument_count;
+        }
+    }
+
+    unit->profile_sites = NULL;
+    unit->profile_site_count = 0;
+
+    if (function_parser.profile_site_count > 0) {
+        if (parser.vm->allocate_memory((void**) &unit->profile_sites, sizeof(wave_profile_site) * function_parser.profile_site_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_unit_body", "failed to allocate profile sites");
+        } else {
+            memory_copy(function_parser.profile_sites, unit->profile_sites, sizeof(wave_profile_site) * function_parser.profile_site_count);
+            unit->profile_site_count = function_parser.profile_site_count;
+        }
+    }
+
+    function_parser.keep_inline_body = false;
+    function_parser.inline_body = NULL;
+
+    // restore parser
+
+    parser.bytecode_start = bytecode_start;
+    parser.bytecode_end = bytecode_end;
+    parser.bytecode_current = bytecode_current;
+    parser.bytecode_capacity = bytecode_capacity;
+
+    parser.patch_holes = patch_holes;
+    parser.patch_hole_capacity = patch_hole_capacity;
+    parser.patch_hole_count = patch_hole_count;
+
+    parser.current_function = NULL;
+    parser.current_scope_is_entrypoint_function = false;
+
+    compiler_set_error_list(previous_errors);
+}
+
+static void parse_queued_units(parse_unit_queue* queue) {
+    while (true) {
+        u32 queue_index = atomic_fetch_add(&queue->next_index, 1);
+        if (queue_index >= queue->unit_count) {
+            break;
+        }
+
+        if (queue_index > atomic_load(&queue->error_index)) { // only the errors of the first failed unit are reported
+            continue;
+        }
+
+        parse_unit* unit = &parser.units[queue->unit_indices[queue_index]];
+
+        parser.token_index = unit->body_token_index;
+        parser_advance();
+
+        parse_unit_body(unit);
+
+        if (unit->errors.error_count > 0) {
+            u32 error_index = atomic_load(&queue->error_index);
+            while (queue_index < error_index && !atomic_compare_exchange_weak(&queue->error_index, &error_index, queue_index)) {}
+        }
+    }
+}
+
+static error_code parse_unit_thread(void* data) {
+    parse_unit_queue* queue = (parse_unit_queue*) data;
+
+    parser = queue->parser;
+
+    if (queue->arena != NULL) { // the memory functions of the vm allocate from the arena of the calling thread
+        wave_arena* arena = &queue->thread_arenas[atomic_fetch_add(&queue->thread_arena_count, 1)];
+        RUN_ERROR_CODE_FUNCTION(wave_arena_new, arena, queue->arena->chunk_size, queue->arena->allocate_memory, queue->arena->deallocate_memory);
+        wave_arena_set_current(arena);
+    }
+
+    RUN_ERROR_CODE_FUNCTION(function_parser_new);
+
+    parse_queued_units(queue);
+
+    RUN_ERROR_CODE_FUNCTION(function_parser_destroy);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+static void compile_units(const u32* unit_indices, u32 unit_count) {
+    if (unit_count == 0) {
+        return;
+    }
+
+    PARSER_LINE(0); // build the line offsets up front, every thread reads them when raising an error
+
+    parse_unit_queue queue = (parse_unit_queue) {
+        .parser = parser,
+
+        .unit_indices = unit_indices,
+        .unit_count = unit_count
+    };
+
+    atomic_init(&queue.next_index, 0);
+    atomic_init(&queue.error_index, U32_MAX);
+
+    queue.arena = parser.vm->allocate_memory == wave_arena_current_allocate ? wave_arena_get_current() : NULL;
+    atomic_init(&queue.thread_arena_count, 0);
+
+    // the calling thread compiles units as well, the others are started on top of it
+
+    u32 thread_count = 1;
+    #if COMPILER_PARALLEL_BODIES != 0
+        if (platform_get_processor_count(&thread_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            thread_count = 1;
+        }
+
+        thread_count = thread_count > COMPILER_MAX_THREAD_COUNT ? COMPILER_MAX_THREAD_COUNT : thread_count;
+        thread_count = thread_count > unit_count ? unit_count : thread_count;
+
+        if (wave_compiler_get_ir_dump_function() != NULL) { // keeps the dumps of different functions from interleaving
+            thread_count = 1;
+        }
+    #endif
+
+    platform_thread threads[COMPILER_MAX_THREAD_COUNT];
+    u32 started_thread_count = 0;
+    for (u32 i = 1; i < thread_count; i++) {
+        if (platform_thread_create(&threads[started_thread_count], parse_unit_thread, &queue) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            break; // the units are shared by the threads that did start
+        }
+
+        started_thread_count++;
+    }
+
+    parse_queued_units(&queue);
+
+    bool threads_failed = false;
+    for (u32 i = 0; i < started_thread_count; i++) {
+        error_code thread_result = ERROR_CODE_EXECUTION_FAILED;
+        if (platform_thread_join(threads[i], &thread_result) != ERROR_CODE_EXECUTION_SUCCESSFUL || thread_result != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            threads_failed = true;
+        }
+    }
+
+    if (queue.arena != NULL) { // the units and errors of the threads were allocated from their arenas
+        u32 thread_arena_count = atomic_load(&queue.thread_arena_count);
+        for (u32 i = 0; i < thread_arena_count; i++) {
+            wave_arena_adopt(queue.arena, &queue.thread_arenas[i]);
+        }
+    }
+
+    if (threads_failed) {
+        PARSER_RAISE_ERROR("compile_units", "failed to compile function bodies on worker threads");
+        return;
+    }
+}
+
+static bool meet_call_argument(parse_call_argument* value, parse_call_argument argument) { // lowers @value by @argument, returns whether it changed
+    if (argument.kind == CALL_ARGUMENT_NONE || value->kind == CALL_ARGUMENT_UNKNOWN) {
+        return false;
+    }
+
+    if (value->kind == CALL_ARGUMENT_NONE) {
+        *value = argument;
+        return true;
+    } else if (argument.kind == CALL_ARGUMENT_UNKNOWN || value->value.value_u64 != argument.value.value_u64) {
+        value->kind = CALL_ARGUMENT_UNKNOWN;
+        return true;
+    }
+
+    return false;
+}
+
+static void analyze_units(bool specialize) { // interprocedural constant propagation over the call graph (see Callahan et al., "Interprocedural Constant Propagation")
+    const u32 function_count = parser.functions_count;
+
+    bool* reachable_functions = NULL;
+    u32* parameter_offsets = NULL; // the index of the first parameter of every function in @parameter_values
+    parse_call_argument* parameter_values = NULL;
+
+    u32 parameter_count = 0;
+
+    if (parser.vm->allocate_memory((void**) &reachable_functions, sizeof(bool) * (function_count + 1)) != ERROR_CODE_EXECUTION_SUCCESSFUL ||
+        parser.vm->allocate_memory((void**) &parameter_offsets, sizeof(u32) * (function_count + 1)) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("analyze_units", "failed to allocate call graph");
+        goto analyze_units_end;
+    }
+
+    for (u32 i = 0; i < function_count; i++) {
+        parameter_offsets[i] = parameter_count;
+        parameter_count += parser.functions[i].function_data.parameter_count;
+    }
+
+    if (parser.vm->allocate_memory((void**) &parameter_values, sizeof(parse_call_argument) * (parameter_count + 1)) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("analyze_units", "failed to allocate call graph");
+        goto analyze_units_end;
+    }
+
+    const parse_call_argument unknown = (parse_call_argument) { .kind = CALL_ARGUMENT_UNKNOWN, .parameter = 0, .value = (union_number) { .value_u64 = 0 } };
+
+    for (u32 i = 0; i < parameter_count; i++) {
+        parameter_values[i] = (parse_call_argument) { .kind = CALL_ARGUMENT_NONE, .parameter = 0, .value = (union_number) { .value_u64 = 0 } };
+    }
+
+    // the functions the host may call receive any value, as well as every function if there is no entrypoint to start from
+
+    #define ANALYZE_UNITS_ADD_ROOT(function_index)                                                                  \
+        do {                                                                                                        \
+            reachable_functions[function_index] = true;                                                             \
+            for (u16 k = 0; k < parser.functions[function_index].function_data.parameter_count; k++) {              \
+                parameter_values[parameter_offsets[function_index] + k] = unknown;                                  \
+            }                                                                                                       \
+        } while (0)
+
+    for (u32 i = 0; i < function_count; i++) {
+        reachable_functions[i] = false;
+        if (!parser.entrypoint_function.initialized || parser.functions[i].function_data.error_function) {
+            ANALYZE_UNITS_ADD_ROOT(i);
+        }
+    }
+
+    for (u32 i = 0; i < parser.extern_functions_count; i++) {
+        ANALYZE_UNITS_ADD_ROOT(parser.extern_functions[i]);
+    }
+
+    for (u32 i = 0; i < parser.patch_hole_count; i++) { // calls outside of function bodies
+        u32 function_index = parser.function_symbols[parser.patch_holes[i].patch_hole_data.identifier];
+        if (function_index != U32_MAX) {
+            ANALYZE_UNITS_ADD_ROOT(function_index);
+        }
+    }
+
+    // propagate the arguments along the calls of the reachable units until no parameter changes, every parameter can only be lowered twice
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+
+        for (u32 i = 0; i < parser.unit_count; i++) {
+            const parse_unit* unit = &parser.units[i];
+
+            const bool entrypoint = unit->function_index == PARSE_UNIT_ENTRYPOINT;
+            if (!entrypoint && !reachable_functions[unit->function_index]) {
+                continue;
+            }
+
+            // the calls of cached bodies are only known through their relocations, their arguments were not recorded
+
+            if (unit->cache_entry != NULL) {
+                for (u32 j = 0; j < unit->cache_entry->relocation_count; j++) {
+                    const u32 function_index = parser.function_symbols[PARSER_GET_SYMBOL(parser_get_token(unit->declaration_token_index + unit->cache_entry->relocations[j].token_offset))];
+                    if (function_index == U32_MAX) {
+                        continue;
+                    }
+
+                    changed |= !reachable_functions[function_index];
+                    reachable_functions[function_index] = true;
+
+                    for (u16 k = 0; k < parser.functions[function_index].function_data.parameter_count; k++) {
+                        changed |= meet_call_argument(&parameter_values[parameter_offsets[function_index] + k], unknown);
+                    }
+                }
+
+                continue;
+            }
+
+            for (u32 j = 0; j < unit->call_site_count; j++) {
+                const parse_call_site* call_site = &unit->call_sites[j];
+                const u32 function_index = call_site->function_index;
+
+                changed |= !reachable_functions[function_index];
+                reachable_functions[function_index] = true;
+
+                for (u16 k = 0; k < parser.functions[function_index].function_data.parameter_count; k++) {
+                    parse_call_argument argument = k < call_site->argument_count ? unit->call_arguments[call_site->first_argument + k] : unknown;
+                    if (argument.kind == CALL_ARGUMENT_PARAMETER) {
+                        argument = entrypoint ? unknown : parameter_values[parameter_offsets[unit->function_index] + argument.parameter];
+                    }
+
+                    changed |= meet_call_argument(&parameter_values[parameter_offsets[function_index] + k], argument);
+                }
+            }
+        }
+    }
+
+    #undef ANALYZE_UNITS_ADD_ROOT
+
+    // the units that are compiled again with their constant parameters, the bodies that were inlined are already part of their callers
+
+    for (u32 i = 0; i < parser.unit_count; i++) {
+        parse_unit* unit = &parser.units[i];
+        if (unit->function_index == PARSE_UNIT_ENTRYPOINT) {
+            continue;
+        }
+
+        unit->reachable = reachable_functions[unit->function_index];
+        if (!specialize || !unit->reachable || unit->cache_entry != NULL || unit->inline_body != NULL) {
+            continue;
+        }
+
+        for (u16 j = 0; j < parser.functions[unit->function_index].function_data.parameter_count; j++) {
+            const parse_call_argument* value = &parameter_values[parameter_offsets[unit->function_index] + j];
+            if (value->kind == CALL_ARGUMENT_CONSTANT) {
+                unit->parameters[j].constant = true;
+                unit->parameters[j].constant_value = value->value;
+                unit->specialized = true;
+                unit->inline_candidate = false; // its body could not be inlined
+            }
+        }
+    }
+
+    analyze_units_end: {}
+
+    if ((reachable_functions != NULL && parser.vm->deallocate_memory(reachable_functions) != ERROR_CODE_EXECUTION_SUCCESSFUL) ||
+        (parameter_offsets != NULL && parser.vm->deallocate_memory(parameter_offsets) != ERROR_CODE_EXECUTION_SUCCESSFUL) ||
+        (parameter_values != NULL && parser.vm->deallocate_memory(parameter_values) != ERROR_CODE_EXECUTION_SUCCESSFUL)) {
+        PARSER_RAISE_ERROR("analyze_units", "failed to deallocate call graph");
+    }
+}
+
+static void link_unit(const parse_unit* unit) { // appends the bytecode of @unit and moves its patch holes behind the ones of the parser
+    parse_function* function = unit->function_index == PARSE_UNIT_ENTRYPOINT ? &parser.entrypoint_function : &parser.functions[unit->function_index];
+    u32 unit_start = parser.bytecode_current - parser.bytecode_start;
+
+    if (unit->cache_entry != NULL) {
+        const wave_compile_cache_entry* entry = unit->cache_entry;
+
+        emit_bytecode(entry->bytecode, entry->bytecode_size);
+        if (compiler_has_error()) {
+            return;
+        }
+
+        function->branch_offset = unit_start + entry->branch_offset;
+        function->locals_size = entry->locals_size;
+
+        // the callee identifiers are at the same position inside the unchanged declaration
+
+        for (u32 i = 0; i < entry->relocation_count; i++) {
+            u32 token_index = unit->declaration_token_index + entry->relocations[i].token_offset;
+
+            STACK_HELPER_PUSH(
+                parser.patch_holes,
+                ((patch_hole) {
+                    .type = PATCH_HOLE_TYPE_FUNCTION_CALL,
+                    .bytecode_index = unit_start + entry->relocations[i].bytecode_index,
+                    .token_index = token_index,
+                    .patch_hole_data.identifier = PARSER_GET_SYMBOL(parser_get_token(token_index))
+                }),
+
+                sizeof(patch_hole),
+
+                parser.patch_hole_capacity,
+                parser.patch_hole_count,
+
+                PATCH_HOLE_STACK_GROW_SIZE,
+
+                "link_unit",
+                "failed to reallocate patch hole stack"
+            );
+        }
+
+        return;
+    }
+
+    emit_bytecode(unit->bytecode, unit->bytecode_size);
+    if (compiler_has_error()) {
+        return;
+    }
+
+    function->branch_offset = unit_start + unit->branch_offset;
+    function->locals_size = unit->locals_size;
+
+    for (u32 i = 0; i < unit->patch_hole_count; i++) {
+        patch_hole hole = unit->patch_holes[i];
+        hole.bytecode_index += unit_start;
+
+        STACK_HELPER_PUSH(
+            parser.patch_holes,
+            hole,
+
+            sizeof(patch_hole),
+
+            parser.patch_hole_capacity,
+            parser.patch_hole_count,
+
+            PATCH_HOLE_STACK_GROW_SIZE,
+
+            "link_unit",
+            "failed to reallocate patch hole stack"
+        );
+    }
+
+    // the units are compiled into their own bytecode, the counters of the vm are relative to the linked one
+
+    wave_profile* profile = wave_compiler_get_profile();
+    if (profile == NULL) {
+        return;
+    }
+
+    wave_profile_site calls = (wave_profile_site) {
+        .function = function->function_data.name,
+        .value = 0,
+
+        .source_offset = 0,
+        .type = WAVE_PROFILE_RECORD_CALLS,
+
+        .bytecode_offset = function->branch_offset,
+        .counter = WAVE_PROFILE_COUNTER_EXECUTED
+    };
+
+    if (unit->function_index != PARSE_UNIT_ENTRYPOINT && wave_profile_add_site(profile, calls) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("link_unit", "failed to add profile site");
+        return;
+    }
+
+    for (u32 i = 0; i < unit->profile_site_count; i++) {
+        wave_profile_site site = unit->profile_sites[i];
+        site.bytecode_offset += unit_start;
+
+        if (wave_profile_add_site(profile, site) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("link_unit", "failed to add profile site");
+            return;
+        }
+    }
+}
+
+static void parse_units(void) { // compiles the deferred bodies and links all units in declaration order, so the bytecode does not depend on the threads used
+    if (parser.deferred_bodies && parser.unit_count > 0) {
+        u32* unit_indices = NULL;
+        if (parser.vm->allocate_memory((void**) &unit_indices, sizeof(u32) * parser.unit_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_units", "failed to allocate unit queue");
+            return;
+        }
+
+        // the bodies that may be inlined are compiled first, their callers are compiled once the inline bodies are known
+
+        u32 candidate_count = 0;
+        for (u32 i = 0; i < parser.unit_count; i++) {
+            parse_unit* unit = &parser.units[i];
+
+            unit->inline_candidate = is_inline_candidate(unit);
+            if (unit->inline_candidate) {
+                parser.functions[unit->function_index].inline_candidate = true;
+
+                unit_indices[candidate_count] = i;
+                candidate_count++;
+            }
+        }
+
+        // every name is declared at this point, so the declarations are hashed against their final environment
+
+        u32 unit_count = candidate_count;
+        for (u32 i = 0; i < parser.unit_count; i++) {
+            parse_unit* unit = &parser.units[i];
+            if (unit->inline_candidate) { // compiled in any case, which keeps their inline bodies
+                continue;
+            }
+
+            u32 declaration_end_index = 0;
+            if (unit->function_index != PARSE_UNIT_ENTRYPOINT && wave_compiler_get_profile() == NULL && hash_declaration(unit->declaration_token_index, &unit->cache_key, &declaration_end_index)) { // the profile is not part of the cache key
+                unit->cacheable = true;
+                unit->cache_entry = wave_compile_cache_find(parser.cache, unit->cache_key);
+            }
+
+            if (unit->cache_entry == NULL) {
+                unit_indices[unit_count] = i;
+                unit_count++;
+            }
+        }
+
+        compile_units(unit_indices, candidate_count);
+
+        for (u32 i = 0; i < candidate_count; i++) { // read by the threads compiling the other units
+            const parse_unit* unit = &parser.units[unit_indices[i]];
+            parser.functions[unit->function_index].inline_body = unit->inline_body;
+        }
+
+        if (!compiler_has_error()) {
+            compile_units(unit_indices + candidate_count, unit_count - candidate_count);
+        }
+
+        if (parser.vm->deallocate_memory(unit_indices) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_units", "failed to deallocate unit queue");
+            return;
+        }
+
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    // drop the units that are never called, the bodies every call passes a constant to are compiled again if the whole token stream is available
+
+    bool unit_errors = false;
+    for (u32 i = 0; i < parser.unit_count; i++) {
+        unit_errors = unit_errors || parser.units[i].errors.error_count > 0;
+    }
+
+    if (!unit_errors) {
+        analyze_units(parser.deferred_bodies);
+        if (compiler_has_error()) {
+            return;
+        }
+
+        u32* unit_indices = NULL;
+        if (parser.vm->allocate_memory((void**) &unit_indices, sizeof(u32) * (parser.unit_count + 1)) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_units", "failed to allocate unit queue");
+            return;
+        }
+
+        u32 unit_count = 0;
+        for (u32 i = 0; i < parser.unit_count; i++) {
+            parse_unit* unit = &parser.units[i];
+            if (!unit->specialized) {
+                continue;
+            }
+
+            #define PARSE_UNITS_DEALLOCATE(pointer) do { if ((pointer) != NULL && parser.vm->deallocate_memory((void*) (pointer)) != ERROR_CODE_EXECUTION_SUCCESSFUL) { PARSER_RAISE_ERROR("parse_units", "failed to deallocate function unit"); } (pointer) = NULL; } while (0)
+
+            PARSE_UNITS_DEALLOCATE(unit->bytecode);
+            PARSE_UNITS_DEALLOCATE(unit->patch_holes);
+            PARSE_UNITS_DEALLOCATE(unit->call_sites);
+            PARSE_UNITS_DEALLOCATE(unit->call_arguments);
+            PARSE_UNITS_DEALLOCATE(unit->profile_sites);
+
+            #undef PARSE_UNITS_DEALLOCATE
+
+            unit_indices[unit_count] = i;
+            unit_count++;
+        }
+
+        if (!compiler_has_error()) {
+            compile_units(unit_indices, unit_count);
+        }
+
+        if (parser.vm->deallocate_memory(unit_indices) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            PARSER_RAISE_ERROR("parse_units", "failed to deallocate unit queue");
+            return;
+        }
+
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    // link
+
+    for (u32 i = 0; i < parser.unit_count; i++) {
+        parse_unit* unit = &parser.units[i];
+        if (unit->errors.error_count > 0) {
+            if (compiler_move_errors(&unit->errors) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+                PARSER_RAISE_ERROR("parse_units", "failed to move function errors");
+            }
+
+            return;
+        } else if (!unit->reachable) {
+            continue;
+        }
+
+        link_unit(unit);
+        if (compiler_has_error()) {
+            return;
+        }
+    }
+
+    // store the compiled units once every cached one was linked, storing may move the cache entries
+
+    for (u32 i = 0; i < parser.unit_count; i++) {
+        if (parser.units[i].cacheable && parser.units[i].cache_entry == NULL) {
+            cache_unit(&parser.units[i]);
+        }
+    }
+}
+
+// incremental compilation
+
+static u64 get_symbol_signature(wave_symbol symbol) { // hashes everything the bytecode referring to @symbol depends on, 0 if the symbol is not declared yet
+    u32 index = parser.global_symbols[symbol];
+    if (index != U32_MAX) {
+        u64 signature[] = { WAVE_TOKEN_KEYWORD_GLOBAL, parser.globals[index].type, parser.globals[index].offset };
+        return hash_bytes((byte*) signature, sizeof(signature));
+    }
+
+    index = parser.function_symbols[symbol];
+    if (index != U32_MAX) {
+        const wave_function* function_data = &parser.functions[index].function_data;
+
+        u64 signature[] = { WAVE_TOKEN_KEYWORD_FUNC, function_data->return_type, function_data->error_function, function_data->parameter_count, parser.functions[index].inline_candidate }; // callers of candidates may inline them
+        u64 hash = hash_bytes((byte*) signature, sizeof(signature));
+
+        for (u16 i = 0; i < function_data->parameter_count; i++) {
+            u64 parameter[] = { function_data->parameters[i].type, function_data->parameters[i].has_default_value, function_data->parameters[i].default_value.value_u64 };
+            hash = hash_bytes_seeded((byte*) parameter, sizeof(parameter), hash);
+        }
+
+        return hash;
+    }
+
+    index = parser.native_symbols[symbol];
+    if (index != U32_MAX) {
+        u64 signature[] = { WAVE_TOKEN_KEYWORD_EXTERN, index };
+        return hash_bytes((byte*) signature, sizeof(signature));
+    }
+
+    return 0;
+}
+
+static bool hash_declaration(u32 declaration_token_index, u64* out_key, u32* out_end_index) { // returns false if the declaration cannot be cached
+    if (parser.cache == NULL) {
+        return false;
+    }
+
+    u64 key = parser.vm->function_hash; // the native function indices are part of the bytecode
+    u32 depth = 0;
+
+    for (u32 index = declaration_token_index; index < parser.tokens.count; index++) {
+        parse_token token = parser_get_token(index);
+
+        u64 token_data[3] = { token.token, 0, 0 };
+        switch (token.token) {
+            case WAVE_TOKEN_IDENTIFIER: {
+                wave_symbol symbol = PARSER_GET_SYMBOL(token);
+                token_data[1] = PARSER_GET_IDENTIFIER(symbol).hash;
+                token_data[2] = get_symbol_signature(symbol); // changed callees and globals invalidate the declaration
+                break;
+            }
+
+            case WAVE_TOKEN_VALUE_INTEGER: {
+                token_data[1] = PARSER_GET_DATA(u64, token.data_index);
+                break;
+            }
+
+            case WAVE_TOKEN_VALUE_FLOAT: {
+                wave_float float_value = PARSER_GET_DATA(wave_float, token.data_index);
+                token_data[1] = *((u64*) &float_value.f64);
+                token_data[2] = *((u32*) &float_value.f32);
+                break;
+            }
+
+            case WAVE_TOKEN_VALUE_STR: {
+                u32 string_length = PARSER_GET_DATA(u32, token.data_index);
+                token_data[1] = string_length;
+                key = hash_bytes_seeded((byte*) PARSER_GET_DATA_POINTER(char, token.data_index + sizeof(u32)), string_length, key);
+                break;
+            }
+
+            case WAVE_TOKEN_OP_CURLY_BRACKET_OPEN: {
+                depth++;
+                break;
+            }
+
+            case WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE: {
+                if (depth == 0) {
+                    return false;
+                }
+
+                depth--;
+                break;
+            }
+
+            case WAVE_TOKEN_OP_SEMICOLON: {
+                if (depth == 0) { // forward declarations have no body to cache
+                    return false;
+                }
+
+                break;
+            }
+
+            case WAVE_TOKEN_FILE_END: {
+                return false;
+            }
+
+            default: {
+                break;
+            }
+        }
+
+        key = hash_bytes_seeded((byte*) token_data, sizeof(token_data), key);
 
-    if (assign_expression) {
-        parse_expression(WAVE_TYPE_VOID);
-        if (evaluate) {
-            emit_byte(set_operation);
-            emit_u16(offset);
+        if (depth == 0 && token.token == WAVE_TOKEN_OP_CURLY_BRACKET_CLOSE) {
+            *out_key = key;
+            *out_end_index = index;
+            return true;
         }
-    } else if (evaluate) {
-        emit_byte(get_operation);
-        emit_u16(offset);
     }
 
-    return true;
+    return false;
 }
 
-// functions
+static void cache_unit(const parse_unit* unit) {
+    // the function calls become relocations relative to the unit and its declaration
 
-static bool function_is_defined(string_hash name) {
-    for (u32 i = 0; i < parser.functions_count; i++) {
-        if (parser.functions[i].function_data.name == name) {
-            return true;
-        }
+    wave_compile_cache_relocation* relocations = NULL;
+    if (unit->patch_hole_count > 0 && parser.vm->allocate_memory((void**) &relocations, sizeof(wave_compile_cache_relocation) * unit->patch_hole_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("cache_unit", "failed to allocate relocations");
+        return;
     }
-    for (u32 i = 0; i < parser.vm->function_stack_length; i++) {
-        if (parser.vm->native_functions[i].function_data.name == name) {
-            return true;
-        }
+
+    for (u32 i = 0; i < unit->patch_hole_count; i++) {
+        const patch_hole* hole = &unit->patch_holes[i];
+        DEBUG_ASSERT(hole->type == PATCH_HOLE_TYPE_FUNCTION_CALL, "unexpected patch hole type inside of a function");
+
+        relocations[i] = (wave_compile_cache_relocation) {
+            .bytecode_index = hole->bytecode_index,
+            .token_offset = hole->token_index - unit->declaration_token_index
+        };
     }
 
-    return false;
-}
+    error_code result = wave_compile_cache_store(
+        parser.cache,
+        unit->cache_key,
 
-static bool resolve_function(string_hash name, parse_function* out_function) {
-    for (u32 i = 0; i < parser.functions_count; i++) {
-        if (parser.functions[i].function_data.name == name) {
-            *out_function = parser.functions[i];
-            return true;
-        }
+        unit->bytecode,
+        unit->bytecode_size,
+        unit->branch_offset,
+        unit->locals_size,
+
+        relocations,
+        unit->patch_hole_count
+    );
+
+    if (relocations != NULL && parser.vm->deallocate_memory(relocations) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("cache_unit", "failed to deallocate relocations");
+        return;
     }
 
-    *out_function = PARSE_FUNCTION_NULL;
-    return false;
+    if (result != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("cache_unit", "failed to store function in the compile cache");
+        return;
+    }
 }
 
 // Parse Rule Functions
@@ -1689,13 +5288,14 @@ static void parse_literal(wave_type expression_type, bool can_assign) {
 
     // cast the literal to the desired type
 
+    union_number value = (union_number) { .value_u64 = 0 };
+
     switch (expression_type) {
         case WAVE_TYPE_U8:
         case WAVE_TYPE_I8: {
-            emit_byte(OPCODE_PUSH_8);
             switch (token->token) {
-                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { emit_u8(1); break; }
-                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { emit_u8(0); break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { value.value_u8 = 1; break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { value.value_u8 = 0; break; }
 
                 default: { goto parser_literal_error_case; }
             }
@@ -1705,10 +5305,9 @@ static void parse_literal(wave_type expression_type, bool can_assign) {
 
         case WAVE_TYPE_U16:
         case WAVE_TYPE_I16: {
-            emit_byte(OPCODE_PUSH_16);
             switch (token->token) {
-                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { emit_u16(1); break; }
-                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { emit_u16(0); break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { value.value_u16 = 1; break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { value.value_u16 = 0; break; }
 
                 default: { goto parser_literal_error_case; }
             }
@@ -1719,13 +5318,12 @@ static void parse_literal(wave_type expression_type, bool can_assign) {
         case WAVE_TYPE_U32:
         case WAVE_TYPE_I32:
         case WAVE_TYPE_F32: {
-            emit_byte(OPCODE_PUSH_32);
             switch (token->token) {
-                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { emit_u32(1); break; }
-                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { emit_u32(0); break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { value.value_u32 = 1; break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { value.value_u32 = 0; break; }
 
-                case WAVE_TOKEN_KEYWORD_VALUE_NAN: { f32 temp = F32_NAN; emit_u32(*((u32*) &temp)); break; }
-                case WAVE_TOKEN_KEYWORD_VALUE_INF: { f32 temp = F32_INF; emit_u32(*((u32*) &temp)); break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_NAN: { value.value_f32 = F32_NAN; break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_INF: { value.value_f32 = F32_INF; break; }
 
                 default: { goto parser_literal_error_case; }
             }
@@ -1736,13 +5334,12 @@ static void parse_literal(wave_type expression_type, bool can_assign) {
         case WAVE_TYPE_U64:
         case WAVE_TYPE_I64:
         case WAVE_TYPE_F64: {
-            emit_byte(OPCODE_PUSH_64);
             switch (token->token) {
-                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { emit_u64(1); break; }
-                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { emit_u64(0); break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_TRUE:  { value.value_u64 = 1; break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_FALSE: { value.value_u64 = 0; break; }
 
-                case WAVE_TOKEN_KEYWORD_VALUE_NAN: { f64 temp = F64_NAN; emit_u64(*((u64*) &temp)); break; }
-                case WAVE_TOKEN_KEYWORD_VALUE_INF: { f64 temp = F64_INF; emit_u64(*((u64*) &temp)); break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_NAN: { value.value_f64 = F64_NAN; break; }
+                case WAVE_TOKEN_KEYWORD_VALUE_INF: { value.value_f64 = F64_INF; break; }
 
                 default: { goto parser_literal_error_case; }
             }
@@ -1758,8 +5355,7 @@ static void parse_literal(wave_type expression_type, bool can_assign) {
 
         case WAVE_TYPE_FUNC: {
             if (token->token == WAVE_TOKEN_KEYWORD_VALUE_NULL) {
-                emit_byte(OPCODE_PUSH_64);
-                emit_u64(0);
+                value.value_u64 = 0; // pushed as a 64 bit value (see @emit_ir_instruction)
                 break;
             } else {
                 goto parser_literal_error_case;
@@ -1772,6 +5368,8 @@ static void parse_literal(wave_type expression_type, bool can_assign) {
             return;
         }
     }
+
+    add_node(PARSER_NODE(NODE_TYPE_CONSTANT, expression_type, token->source_offset, .constant_data = { .value = value }));
 }
 
 static void parse_number(wave_type expression_type, bool can_assign) {
@@ -1779,6 +5377,8 @@ static void parse_number(wave_type expression_type, bool can_assign) {
 
     // implicit cast to current expression type
 
+    union_number value = (union_number) { .value_u64 = 0 };
+
     switch (number.token) {
         case WAVE_TOKEN_VALUE_INTEGER: {
             u64 integer = PARSER_GET_DATA(u64, number.data_index);
@@ -1797,18 +5397,18 @@ static void parse_number(wave_type expression_type, bool can_assign) {
             */
 
             switch (expression_type) {
-                case WAVE_TYPE_U8:  { emit_byte(OPCODE_PUSH_8);  emit_u8((u8) integer);   break; }
-                case WAVE_TYPE_U16: { emit_byte(OPCODE_PUSH_16); emit_u16((u16) integer); break; }
-                case WAVE_TYPE_U32: { emit_byte(OPCODE_PUSH_32); emit_u32((u32) integer); break; }
-                case WAVE_TYPE_U64: { emit_byte(OPCODE_PUSH_64); emit_u64((u64) integer); break; }
+                case WAVE_TYPE_U8:  { value.value_u8  = (u8)  integer; break; }
+                case WAVE_TYPE_U16: { value.value_u16 = (u16) integer; break; }
+                case WAVE_TYPE_U32: { value.value_u32 = (u32) integer; break; }
+                case WAVE_TYPE_U64: { value.value_u64 = (u64) integer; break; }
 
-                case WAVE_TYPE_I8:  { emit_byte(OPCODE_PUSH_8);  i8 temp  = (i8) integer;  emit_u8(*((u8*) (&temp)));   break; }
-                case WAVE_TYPE_I16: { emit_byte(OPCODE_PUSH_16); i16 temp = (i16) integer; emit_u16(*((u16*) (&temp))); break; }
-                case WAVE_TYPE_I32: { emit_byte(OPCODE_PUSH_32); i32 temp = (i32) integer; emit_u32(*((u32*) (&temp))); break; }
-                case WAVE_TYPE_I64: { emit_byte(OPCODE_PUSH_64); i64 temp = (i64) integer; emit_u64(*((u64*) (&temp))); break; }
+                case WAVE_TYPE_I8:  { value.value_i8  = (i8)  integer; break; }
+                case WAVE_TYPE_I16: { value.value_i16 = (i16) integer; break; }
+                case WAVE_TYPE_I32: { value.value_i32 = (i32) integer; break; }
+                case WAVE_TYPE_I64: { value.value_i64 = (i64) integer; break; }
 
-                case WAVE_TYPE_F32: { emit_byte(OPCODE_PUSH_32); f32 temp = (f32) integer; emit_u32(*((u32*) (&temp))); break; }
-                case WAVE_TYPE_F64: { emit_byte(OPCODE_PUSH_64); f64 temp = (f64) integer; emit_u64(*((u64*) (&temp))); break; }
+                case WAVE_TYPE_F32: { value.value_f32 = (f32) integer; break; }
+                case WAVE_TYPE_F64: { value.value_f64 = (f64) integer; break; }
 
                 default: {
                     PARSER_RAISE_ERROR("parse_number", "invalid expression variable type");
@@ -1835,18 +5435,18 @@ static void parse_number(wave_type expression_type, bool can_assign) {
             // for floats the tokenizer stores both float sizes and the better fitting one is chosen
 
             switch (expression_type) {
-                case WAVE_TYPE_U8:  { emit_byte(OPCODE_PUSH_8);  emit_u8((u8) f32_value);   break; }
-                case WAVE_TYPE_U16: { emit_byte(OPCODE_PUSH_16); emit_u16((u16) f32_value); break; }
-                case WAVE_TYPE_U32: { emit_byte(OPCODE_PUSH_32); emit_u32((u32) f32_value); break; }
-                case WAVE_TYPE_U64: { emit_byte(OPCODE_PUSH_64); emit_u64((u64) f64_value); break; }
+                case WAVE_TYPE_U8:  { value.value_u8  = (u8)  f32_value; break; }
+                case WAVE_TYPE_U16: { value.value_u16 = (u16) f32_value; break; }
+                case WAVE_TYPE_U32: { value.value_u32 = (u32) f32_value; break; }
+                case WAVE_TYPE_U64: { value.value_u64 = (u64) f64_value; break; }
 
-                case WAVE_TYPE_I8:  { emit_byte(OPCODE_PUSH_8);  i8 temp  = (i8) f32_value;  emit_u8(*((u8*) (&temp)));   break; }
-                case WAVE_TYPE_I16: { emit_byte(OPCODE_PUSH_16); i16 temp = (i16) f32_value; emit_u16(*((u16*) (&temp))); break; }
-                case WAVE_TYPE_I32: { emit_byte(OPCODE_PUSH_32); i32 temp = (i32) f32_value; emit_u32(*((u32*) (&temp))); break; }
-                case WAVE_TYPE_I64: { emit_byte(OPCODE_PUSH_64); i64 temp = (i64) f64_value; emit_u64(*((u64*) (&temp))); break; }
+                case WAVE_TYPE_I8:  { value.value_i8  = (i8)  f32_value; break; }
+                case WAVE_TYPE_I16: { value.value_i16 = (i16) f32_value; break; }
+                case WAVE_TYPE_I32: { value.value_i32 = (i32) f32_value; break; }
+                case WAVE_TYPE_I64: { value.value_i64 = (i64) f64_value; break; }
 
-                case WAVE_TYPE_F32: { emit_byte(OPCODE_PUSH_32); emit_u32(*((u32*) (&f32_value))); break; }
-                case WAVE_TYPE_F64: { emit_byte(OPCODE_PUSH_64); emit_u64(*((u64*) (&f64_value))); break; }
+                case WAVE_TYPE_F32: { value.value_f32 = f32_value; break; }
+                case WAVE_TYPE_F64: { value.value_f64 = f64_value; break; }
 
                 default: {
                     PARSER_RAISE_ERROR("parse_number", "invalid expression variable type");
@@ -1862,51 +5462,81 @@ static void parse_number(wave_type expression_type, bool can_assign) {
             return;
         }
     }
+
+    add_node(PARSER_NODE(NODE_TYPE_CONSTANT, expression_type, number.source_offset, .constant_data = { .value = value }));
 }
 
 static void parse_string(wave_type expression_type, bool can_assign) {
     parser_advance();
 
     parse_token token = parser.previous;
-    u32 string_length = PARSER_GET_DATA(u32, token.data_index);
-    str string_start = PARSER_GET_DATA(str, token.data_index + sizeof(u32));
+    u32 string_size = sizeof(u32) + PARSER_GET_DATA(u32, token.data_index);
 
-    emit_byte(OPCODE_STR_NEW);
-    emit_u32(string_length);
-    for (u32 i = 0; i < string_length; i++) {
-        emit_byte(*((byte*) string_start));
-        string_start++;
+    // the token data is copied into the tree, it may leave the token window before the bytecode is generated
+
+    u32 data_index = 0;
+    if (wave_ast_insert_data(&function_parser.ast, PARSER_GET_DATA_POINTER(byte, token.data_index), string_size, &data_index) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        PARSER_RAISE_ERROR("parse_string", "failed to reallocate syntax tree data");
+        return;
     }
+
+    add_node(PARSER_NODE(NODE_TYPE_STRING, WAVE_TYPE_STR, token.source_offset, .string_data = { .data_index = data_index }));
 }
 
 static void parse_identifier(wave_type expression_type, bool can_assign) {
-    string_hash name = PARSER_GET_DATA(wave_identifier, parser.previous.data_index).hash;
+    wave_symbol symbol = PARSER_GET_SYMBOL(parser.previous);
+    u32 source_offset = parser.previous.source_offset;
 
     // resolve the variable (local or global)
 
     wave_type type = WAVE_TYPE_NONE;
-    if (resolve_variable(name, &type)) {
+    if (resolve_variable(symbol, &type)) {
         DEBUG_ASSERT(type != WAVE_TYPE_NONE, "unknown variable type");
 
         // check if the variable is an assign expression
 
         bool assign = parser_match(WAVE_TOKEN_OP_ASSIGN) && can_assign;
 
-        emit_variable(name, true, assign);
+        // any use of an object other than passing it to a native function may let it outlive the stack frame (returning it, storing it, ...)
 
-        // if the variable is used in an expression cast it to the desired type
+        switch (type) {
+            case WAVE_TYPE_STR:
+            case WAVE_TYPE_ARR:
 
-        if (!assign && type != expression_type) { // TODO: lookahead the desired type (maybe generate an ast and type check before code generation)
-            number_type convert_from = (number_type) type;
-            number_type convert_to = (number_type) expression_type;
+            case WAVE_TYPE_ENUM:
+            case WAVE_TYPE_STRUCT: {
+                if (assign || !function_parser.non_escaping_context) {
+                    mark_local_escaping(symbol);
+                }
 
-            emit_byte(OPCODE_TYPE_CONV_STATIC);
-            emit_byte((convert_from << 4) | (convert_to << 0));
+                break;
+            }
+
+            default: {
+                break;
+            }
+        }
+
+        if (assign) {
+            wave_ast_index value_node = parse_expression_node(type);
+            add_node(PARSER_NODE(NODE_TYPE_ASSIGNMENT, type, source_offset, .variable_data = { .symbol = symbol, .value_node = value_node }));
+            return;
+        }
+
+        add_node(PARSER_NODE(NODE_TYPE_VARIABLE, type, source_offset, .variable_data = { .symbol = symbol, .value_node = WAVE_AST_NONE }));
+
+        // if the variable is used in an expression cast it to the desired type
+
+        if (type != expression_type) { // TODO: lookahead the desired type (maybe type check the ast before code generation)
+            add_node(PARSER_NODE(NODE_TYPE_TYPE_CONVERSION, expression_type, source_offset, .type_conversion_data = { .value_node = function_parser.expression_node, .from_type = type }));
         }
-    } else if (function_is_defined(name)) {
+    } else if (function_is_defined(symbol)) {
         parser_reverse();
         wave_type function_return_type = WAVE_TYPE_NONE;
         parse_function_call_statement(false, &function_return_type);
+    } else if (parser.current.token == WAVE_TOKEN_OP_PARENTHESES_OPEN && !parser.deferred_bodies) {
+        PARSER_RAISE_ERROR_PREV("parse_identifier", "unknown function, functions need to be declared before they are called when the source is compiled as a stream");
+        return;
     } else {
         PARSER_RAISE_ERROR_PREV("parse_identifier", "unknown identifier");
         return;
@@ -1918,226 +5548,63 @@ static void parse_dot(wave_type expression_type, bool can_assign) {
 }
 
 static void parse_unary(wave_type expression_type, bool can_assign) {
-    wave_token operator_token = parser.previous.token;
-
-    // parse the expression first
-
-    parse_precedence(expression_type, PRECEDENCE_ASSIGNMENT);
-
-    // then emit the unary opcode
-
-    switch (operator_token) {
-        case WAVE_TOKEN_OP_NEG: {
-            switch (expression_type) {
-                case WAVE_TYPE_U8:
-                case WAVE_TYPE_I8: { emit_byte(OPCODE_I8_NEG); }
-
-                case WAVE_TYPE_U16:
-                case WAVE_TYPE_I16: { emit_byte(OPCODE_I16_NEG); }
-
-                case WAVE_TYPE_U32:
-                case WAVE_TYPE_I32: { emit_byte(OPCODE_I32_NEG); }
-
-                case WAVE_TYPE_U64:
-                case WAVE_TYPE_I64: { emit_byte(OPCODE_I64_NEG); }
-
-                case WAVE_TYPE_F32: { emit_byte(OPCODE_F32_NEG); }
-                case WAVE_TYPE_F64: { emit_byte(OPCODE_F64_NEG); }
-
-                default: {
-                    PARSER_RAISE_ERROR("parse_unary", "invalid expression variable type");
-                    return;
-                }
-            }
-
-            break;
-        }
-
-        case WAVE_TOKEN_OP_ABS: {
-            switch (expression_type) {
-                case WAVE_TYPE_I8: { emit_byte(OPCODE_I8_ABS); }
-                case WAVE_TYPE_I16: { emit_byte(OPCODE_I16_ABS); }
-                case WAVE_TYPE_I32: { emit_byte(OPCODE_I32_ABS); }
-                case WAVE_TYPE_I64: { emit_byte(OPCODE_I64_ABS); }
-
-                case WAVE_TYPE_F32: { emit_byte(OPCODE_F32_ABS); }
-                case WAVE_TYPE_F64: { emit_byte(OPCODE_F64_ABS); }
-
-                case WAVE_TYPE_U8:
-                case WAVE_TYPE_U16:
-                case WAVE_TYPE_U32:
-                case WAVE_TYPE_U64: {
-                    break;
-                }
-
-                default: {
-                    PARSER_RAISE_ERROR("parse_unary", "invalid expression variable type");
-                    return;
-                }
-            }
-
-            break;
-        }
+    parse_token operator_token = parser.previous;
 
-        case WAVE_TOKEN_OP_BIT_NOT: {
-            switch (expression_type) {
-                case WAVE_TYPE_U8: case WAVE_TYPE_I8: { emit_byte(OPCODE_BNOT_8); }
-                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_BNOT_16); }
-                case WAVE_TYPE_U32: case WAVE_TYPE_I32: case WAVE_TYPE_F32: { emit_byte(OPCODE_BNOT_32); }
-                case WAVE_TYPE_U64: case WAVE_TYPE_I64: case WAVE_TYPE_F64: { emit_byte(OPCODE_BNOT_64); }
-
-                default: {
-                    PARSER_RAISE_ERROR("parse_unary", "invalid expression variable type");
-                    return;
-                }
-            }
-
-            break;
-        }
-
-        case WAVE_TOKEN_OP_NOT: {
-            switch (expression_type) {
-                case WAVE_TYPE_U8: case WAVE_TYPE_I8: { emit_byte(OPCODE_NOT_8); }
-                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_NOT_16); }
-                case WAVE_TYPE_U32: case WAVE_TYPE_I32: case WAVE_TYPE_F32: { emit_byte(OPCODE_NOT_32); }
-                case WAVE_TYPE_U64: case WAVE_TYPE_I64: case WAVE_TYPE_F64: { emit_byte(OPCODE_NOT_64); }
-
-                default: {
-                    PARSER_RAISE_ERROR("parse_unary", "invalid expression variable type");
-                    return;
-                }
-            }
-
-            break;
-        }
+    node_type operation = NODE_TYPE_NONE;
+    switch (operator_token.token) {
+        case WAVE_TOKEN_OP_NEG:     { operation = NODE_TYPE_UNARY_OPERATION_MINUS;   break; }
+        case WAVE_TOKEN_OP_ABS:     { operation = NODE_TYPE_UNARY_OPERATION_ABS;     break; }
+        case WAVE_TOKEN_OP_BIT_NOT: { operation = NODE_TYPE_UNARY_OPERATION_BIT_NOT; break; }
+        case WAVE_TOKEN_OP_NOT:     { operation = NODE_TYPE_UNARY_OPERATION_NOT;     break; }
 
         default: {
             PARSER_RAISE_ERROR("parse_unary", "unable to parse unary expression, unexpected operator token");
             return;
         }
     }
+
+    // the operand binds tighter than any binary operator (-a + b is (-a) + b)
+
+    parse_precedence(expression_type, PRECEDENCE_UNARY);
+
+    add_node(PARSER_NODE(operation, expression_type, operator_token.source_offset, .expression_data = { .left_node = function_parser.expression_node, .right_node = WAVE_AST_NONE }));
 }
 
 static void parse_binary(wave_type expression_type, bool can_assign) {
-    wave_token operator_token = parser.previous.token;
-    parse_rule* rule = parser_get_rule(operator_token);
+    parse_token operator_token = parser.previous;
+    parse_rule* rule = parser_get_rule(operator_token.token);
+
+    wave_ast_index left_node = function_parser.expression_node;
 
     // obtain the left and right expression parts type
 
     parse_precedence(expression_type, (parsing_precedence) (rule->precedence + 1));
     wave_type result_expression_type = wave_type_get_higher(expression_type, expression_type);
 
-    // macros
-
-    #define DEFAULT_CASE() default: { PARSER_RAISE_ERROR("parse_binary", "invalid expression variable type"); return; }
-    #define TYPE_CASE(operation, type) case CONCAT2(WAVE_TYPE_, type): { emit_byte(CONCAT4(OPCODE_, type, _, operation)); break; }
-    #define TYPE_CASES(operation)   \
-        TYPE_CASE(operation, U8)    \
-        TYPE_CASE(operation, U16)   \
-        TYPE_CASE(operation, U32)   \
-        TYPE_CASE(operation, U64)   \
-                                    \
-        TYPE_CASE(operation, I8)    \
-        TYPE_CASE(operation, I16)   \
-        TYPE_CASE(operation, I32)   \
-        TYPE_CASE(operation, I64)   \
-                                    \
-        TYPE_CASE(operation, F32)   \
-        TYPE_CASE(operation, F64)   \
-
-    #define CASE_ARITHMETIC_OPCODE(opcode, operation)   \
-        case opcode: {                                  \
-            switch (result_expression_type) {           \
-                TYPE_CASES(operation)                   \
-                DEFAULT_CASE()                          \
-            }                                           \
-                                                        \
-            break;                                      \
-        }
-
-    #define CASE_BITWISE_OPCODE(opcode, operation)                                                                                  \
-        case opcode: {                                                                                                              \
-            switch (result_expression_type) {                                                                                       \
-                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(CONCAT3(OPCODE_, operation, _8));  break; }                       \
-                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(CONCAT3(OPCODE_, operation, _16)); break; }                       \
-                case WAVE_TYPE_U32: case WAVE_TYPE_I32: case WAVE_TYPE_F32: { emit_byte(CONCAT3(OPCODE_, operation, _32)); break; }    \
-                case WAVE_TYPE_U64: case WAVE_TYPE_I64: case WAVE_TYPE_F64: { emit_byte(CONCAT3(OPCODE_, operation, _64)); break; }    \
-                                                                                                                                    \
-                DEFAULT_CASE()                                                                                                      \
-            }                                                                                                                       \
-                                                                                                                                    \
-            break;                                                                                                                  \
-        }
-
-    // then emit the binary expression opcode
-
-    switch (operator_token) { // TODO: add mid-expression assign support (TOKEN_OP_ASSIGN_ADD, ..ASSIGN_SUB, ...);
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_POS, ADD)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_NEG, SUB)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_MUL, MUL)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_DIV, DIV)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_MOD, MOD)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_POW, POW)
-
-        case WAVE_TOKEN_OP_EQUAL: {
-            switch (result_expression_type) {
-                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(OPCODE_EQU_8);  break; }
-                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_EQU_16); break; }
-                case WAVE_TYPE_U32: case WAVE_TYPE_I32: { emit_byte(OPCODE_EQU_32); break; }
-                case WAVE_TYPE_U64: case WAVE_TYPE_I64: { emit_byte(OPCODE_EQU_64); break; }
-
-                case WAVE_TYPE_F32: {
-                    emit_byte(OPCODE_F32_EQU);
-                    break;
-                }
-
-                case WAVE_TYPE_F64: {
-                    emit_byte(OPCODE_F64_EQU);
-                    break;
-                }
-
-                DEFAULT_CASE()
-            }
-
-            break;
-        }
-
-        case WAVE_TOKEN_OP_UNEQUAL: {
-            switch (result_expression_type) {
-                case WAVE_TYPE_U8:  case WAVE_TYPE_I8:  { emit_byte(OPCODE_NEQ_8);  break; }
-                case WAVE_TYPE_U16: case WAVE_TYPE_I16: { emit_byte(OPCODE_NEQ_16); break; }
-                case WAVE_TYPE_U32: case WAVE_TYPE_I32: { emit_byte(OPCODE_NEQ_32); break; }
-                case WAVE_TYPE_U64: case WAVE_TYPE_I64: { emit_byte(OPCODE_NEQ_64); break; }
-
-                case WAVE_TYPE_F32: {
-                    emit_byte(OPCODE_F32_NEQ);
-                    break;
-                }
-
-                case WAVE_TYPE_F64: {
-                    emit_byte(OPCODE_F64_NEQ);
-                    break;
-                }
-
-                DEFAULT_CASE()
-            }
-
-            break;
-        }
-
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_AND, AND)
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_OR, OR)
-
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_BIT_AND, BAND)
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_BIT_OR, BOR)
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_BIT_XOR, XOR)
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_BIT_SHIFT_LEFT, SHIFT_L)
-        CASE_BITWISE_OPCODE(WAVE_TOKEN_OP_BIT_SHIFT_RIGHT, SHIFT_R)
-
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_LESS_THAN, LT)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_LESS_THAN_EQUAL, LE)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_GREATER_THAN, GT)
-        CASE_ARITHMETIC_OPCODE(WAVE_TOKEN_OP_GREATER_THAN_EQUAL, GE)
+    node_type operation = NODE_TYPE_NONE;
+    switch (operator_token.token) { // TODO: add mid-expression assign support (TOKEN_OP_ASSIGN_ADD, ..ASSIGN_SUB, ...);
+        case WAVE_TOKEN_OP_POS: { operation = NODE_TYPE_BINARY_OPERATION_ADD; break; }
+        case WAVE_TOKEN_OP_NEG: { operation = NODE_TYPE_BINARY_OPERATION_SUB; break; }
+        case WAVE_TOKEN_OP_MUL: { operation = NODE_TYPE_BINARY_OPERATION_MUL; break; }
+        case WAVE_TOKEN_OP_DIV: { operation = NODE_TYPE_BINARY_OPERATION_DIV; break; }
+        case WAVE_TOKEN_OP_MOD: { operation = NODE_TYPE_BINARY_OPERATION_MOD; break; }
+        case WAVE_TOKEN_OP_POW: { operation = NODE_TYPE_BINARY_OPERATION_POW; break; }
+
+        case WAVE_TOKEN_OP_EQUAL:   { operation = NODE_TYPE_BINARY_OPERATION_EQUAL;   break; }
+        case WAVE_TOKEN_OP_UNEQUAL: { operation = NODE_TYPE_BINARY_OPERATION_UNEQUAL; break; }
+        case WAVE_TOKEN_OP_AND:     { operation = NODE_TYPE_BINARY_OPERATION_AND;     break; }
+        case WAVE_TOKEN_OP_OR:      { operation = NODE_TYPE_BINARY_OPERATION_OR;      break; }
+
+        case WAVE_TOKEN_OP_BIT_AND:         { operation = NODE_TYPE_BINARY_OPERATION_BIT_AND;         break; }
+        case WAVE_TOKEN_OP_BIT_OR:          { operation = NODE_TYPE_BINARY_OPERATION_BIT_OR;          break; }
+        case WAVE_TOKEN_OP_BIT_XOR:         { operation = NODE_TYPE_BINARY_OPERATION_BIT_XOR;         break; }
+        case WAVE_TOKEN_OP_BIT_SHIFT_LEFT:  { operation = NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_LEFT;  break; }
+        case WAVE_TOKEN_OP_BIT_SHIFT_RIGHT: { operation = NODE_TYPE_BINARY_OPERATION_BIT_SHIFT_RIGHT; break; }
+
+        case WAVE_TOKEN_OP_LESS_THAN:          { operation = NODE_TYPE_BINARY_OPERATION_LESS_THAN;          break; }
+        case WAVE_TOKEN_OP_LESS_THAN_EQUAL:    { operation = NODE_TYPE_BINARY_OPERATION_LESS_THAN_EQUAL;    break; }
+        case WAVE_TOKEN_OP_GREATER_THAN:       { operation = NODE_TYPE_BINARY_OPERATION_GREATER_THAN;       break; }
+        case WAVE_TOKEN_OP_GREATER_THAN_EQUAL: { operation = NODE_TYPE_BINARY_OPERATION_GREATER_THAN_EQUAL; break; }
 
         default: {
             PARSER_RAISE_ERROR("parse_binary", "unable to parse binary expression, unexpected operator token");
@@ -2145,11 +5612,7 @@ static void parse_binary(wave_type expression_type, bool can_assign) {
         }
     }
 
-    #undef DEFAULT_CASE
-    #undef TYPE_CASE
-    #undef TYPE_CASES
-    #undef CASE_ARITHMETIC_OPCODE
-    #undef CASE_BITWISE_OPCODE
+    add_node(PARSER_NODE(operation, result_expression_type, operator_token.source_offset, .expression_data = { .left_node = left_node, .right_node = function_parser.expression_node }));
 }
 
 static void parse_grouping(wave_type expression_type, bool can_assign) {
@@ -2189,7 +5652,7 @@ static bool is_function_modifier(wave_token token) {
 
 // Exposed Functions
 
-error_code wave_compiler_parser_compile(wave_vm* vm, parse_token* tokenized_start, parse_token* tokenized_end, byte* data_stack_start, byte* data_stack_end) {
+error_code wave_compiler_parser_compile(wave_vm* vm, const wave_token_stream* tokens, wave_compile_cache* cache) {
     const wave_memory_allocation_function allocate_memory = vm->allocate_memory;
     const wave_memory_allocation_zero_function allocate_zero_memory = vm->allocate_zero_memory;
     const wave_memory_reallocation_function reallocate_memory = vm->reallocate_memory;
@@ -2199,29 +5662,51 @@ error_code wave_compiler_parser_compile(wave_vm* vm, parse_token* tokenized_star
 
     parser.vm = vm;
 
-    parser.tokenized_start   = tokenized_start;
-    parser.tokenized_end     = tokenized_end;
-    parser.tokenized_current = parser.tokenized_start;
-
-    parser.data_stack_start = data_stack_start;
-    parser.data_stack_end   = data_stack_end;
+    parser.tokens = *tokens;
+    parser.token_index = 0;
 
     parser.current_file_name = "undefined";
-    parser.current_line = 0;
-    parser.current_row = 0;
 
-    parser.previous_line = 0;
-    parser.previous_row = 0;
+    // symbol lookups
+
+    parser.symbol_count = 0;
+    parser.symbol_capacity = tokens->identifier_count > IDENTIFIER_STACK_INITIAL_CAPACITY ? tokens->identifier_count : IDENTIFIER_STACK_INITIAL_CAPACITY;
+
+    #define PARSER_ALLOCATE_SYMBOL_LOOKUP(pointer)                                                                  \
+        do {                                                                                                        \
+            pointer = NULL;                                                                                         \
+            RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &(pointer), sizeof(u32) * parser.symbol_capacity);    \
+            memory_set_32(pointer, U32_MAX, parser.symbol_capacity);                                                \
+        } while (0)
+
+    PARSER_ALLOCATE_SYMBOL_LOOKUP(parser.global_symbols);
+    PARSER_ALLOCATE_SYMBOL_LOOKUP(parser.function_symbols);
+    PARSER_ALLOCATE_SYMBOL_LOOKUP(parser.native_symbols);
+
+    #undef PARSER_ALLOCATE_SYMBOL_LOOKUP
+
+    RUN_ERROR_CODE_FUNCTION(function_parser_new); // allocates @function_parser.local_symbols
+
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_new, &parser.native_table, vm->function_stack_length, allocate_memory, reallocate_memory, deallocate_memory);
+    for (u32 i = 0; i < vm->function_stack_length; i++) {
+        if (wave_symbol_table_find(&parser.native_table, vm->native_functions[i].function_data.name) == WAVE_SYMBOL_TABLE_NONE) { // the first registered function with a name wins
+            RUN_ERROR_CODE_FUNCTION(wave_symbol_table_set, &parser.native_table, vm->native_functions[i].function_data.name, i);
+        }
+    }
+
+    if (!parser_reserve_symbols(tokens->identifier_count)) {
+        return ERROR_CODE_EXECUTION_FAILED;
+    }
 
     parser.bytecode_start = NULL;
-    parser.bytecode_capacity = BYTECODE_STACK_GROW_SIZE;
+    parser.bytecode_capacity = BYTECODE_STACK_INITIAL_CAPACITY;
     RUN_ERROR_CODE_FUNCTION(allocate_zero_memory, (void**) &parser.bytecode_start, sizeof(byte) * parser.bytecode_capacity);
     vm->bytecode_start = parser.bytecode_start;
     parser.bytecode_end = parser.bytecode_start + parser.bytecode_capacity;
     parser.bytecode_current = parser.bytecode_start;
 
-    parser.current  = (parse_token) { .token = WAVE_TOKEN_INVALID, .data_index = 0, .line = 0, .row = 0 };
-    parser.previous = (parse_token) { .token = WAVE_TOKEN_INVALID, .data_index = 0, .line = 0, .row = 0 };
+    parser.current  = (parse_token) { .token = WAVE_TOKEN_INVALID, .data_index = 0, .source_offset = 0 };
+    parser.previous = (parse_token) { .token = WAVE_TOKEN_INVALID, .data_index = 0, .source_offset = 0 };
 
     parser.globals = NULL;
     parser.globals_capacity = 32;
@@ -2234,7 +5719,7 @@ error_code wave_compiler_parser_compile(wave_vm* vm, parse_token* tokenized_star
     parser.current_function = NULL;
     parser.functions = NULL;
     parser.functions_capacity = 32;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &parser.functions, sizeof(wave_function) * parser.functions_capacity);
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &parser.functions, sizeof(parse_function) * parser.functions_capacity);
     parser.functions_count = 0;
 
     parser.extern_functions = NULL;
@@ -2247,32 +5732,23 @@ error_code wave_compiler_parser_compile(wave_vm* vm, parse_token* tokenized_star
     RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &parser.patch_holes, sizeof(patch_hole) * parser.patch_hole_capacity);
     parser.patch_hole_count = 0;
 
-    // initialize function parser
-
-    function_parser.scope_depth = 0;
-
-    function_parser.accessed_globals = NULL;
-
-    function_parser.accessed_globals = NULL;
-    function_parser.accessed_globals_capacity = 32;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.accessed_globals, sizeof(u16) * function_parser.accessed_globals_capacity);
-    function_parser.accessed_globals_count = 0;
+    parser.deferred_bodies = tokens->window_mask == U32_MAX;
 
-    function_parser.locals = NULL;
-    function_parser.locals_capacity = 32;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.locals, sizeof(wave_local) * function_parser.locals_capacity);
-    function_parser.locals_count = 0;
+    parser.units = NULL;
+    parser.unit_capacity = 32;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &parser.units, sizeof(parse_unit) * parser.unit_capacity);
+    parser.unit_count = 0;
 
-    function_parser.labels = NULL;
-    function_parser.label_capacity = 32;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &function_parser.labels, sizeof(parse_label) * function_parser.label_capacity);
-    function_parser.label_count = 0;
+    parser.cache = parser.deferred_bodies ? cache : NULL; // declarations are hashed once all of them are parsed, which requires the whole token stream
+    if (parser.cache != NULL) {
+        wave_compile_cache_begin(parser.cache);
+    }
 
     WAVE_COMPILER_DEBUG("wave_compiler_parser_compile: everything allocated");
 
     // macros
 
-    #define EMIT(function, value) do { function(value); if (compiler_has_error()) { vm->bytecode_start = parser.bytecode_start; vm->bytecode_end = parser.bytecode_current - 1; return ERROR_CODE_EXECUTION_FAILED; } } while (0)
+    #define EMIT(function, value) do { function(value); if (compiler_has_error()) { vm->bytecode_start = parser.bytecode_start; vm->bytecode_end = parser.bytecode_current; return ERROR_CODE_EXECUTION_FAILED; } } while (0)
 
     // function hash & function index
 
@@ -2294,6 +5770,12 @@ error_code wave_compiler_parser_compile(wave_vm* vm, parse_token* tokenized_star
         }
     }
 
+    // compile the function bodies and link them behind the declarations
+
+    if (!compiler_has_error()) {
+        parse_units();
+    }
+
     WAVE_COMPILER_DEBUG("wave_compiler_parser_compile: parser finished");
 
     // end of parser
@@ -2312,11 +5794,23 @@ error_code wave_compiler_parser_compile(wave_vm* vm, parse_token* tokenized_star
 
     // fix patch holes
 
+    if (!compiler_has_error()) {
+        fix_patch_holes();
+    }
+
+    // evict the cached functions that are no longer part of the source
+
+    if (parser.cache != NULL && !compiler_has_error()) {
+        RUN_ERROR_CODE_FUNCTION(wave_compile_cache_sweep, parser.cache);
+    }
+
     // resize bytecode
 
+    u32 bytecode_size = parser.bytecode_current - parser.bytecode_start;
+
     vm->bytecode_start = parser.bytecode_start;
-    vm->bytecode_end = parser.bytecode_current - 1;
-    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(vm->bytecode_start), vm->bytecode_end - vm->bytecode_start);
+    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(vm->bytecode_start), bytecode_size);
+    vm->bytecode_end = vm->bytecode_start + bytecode_size; // set after resizing, as the bytecode may have moved
 
     // return error, if any
 
@@ -2351,13 +5845,44 @@ error_code wave_compiler_parser_destroy(void) {
         PARSER_DEALLOCATE(parser.functions);
     }
 
+    PARSER_DEALLOCATE(parser.global_symbols);
+    PARSER_DEALLOCATE(parser.function_symbols);
+    PARSER_DEALLOCATE(parser.native_symbols);
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_destroy, &parser.native_table);
+
     PARSER_DEALLOCATE(parser.extern_functions);
 
     PARSER_DEALLOCATE(parser.patch_holes);
 
-    PARSER_DEALLOCATE(function_parser.accessed_globals);
-    PARSER_DEALLOCATE(function_parser.locals);
-    PARSER_DEALLOCATE(function_parser.labels);
+    if (parser.units != NULL) {
+        for (u32 i = 0; i < parser.unit_count; i++) {
+            parse_unit* unit = &parser.units[i];
+
+            PARSER_DEALLOCATE(unit->parameters);
+            PARSER_DEALLOCATE(unit->bytecode);
+            PARSER_DEALLOCATE(unit->patch_holes);
+            PARSER_DEALLOCATE(unit->call_sites);
+            PARSER_DEALLOCATE(unit->call_arguments);
+            PARSER_DEALLOCATE(unit->profile_sites);
+
+            if (unit->inline_body != NULL) {
+                RUN_ERROR_CODE_FUNCTION(wave_ir_destroy, unit->inline_body);
+                PARSER_DEALLOCATE(unit->inline_body);
+            }
+
+            for (u32 j = 0; j < unit->errors.error_count; j++) { // the errors of units that were not linked, allocated by @COMPILER_RAISE
+                if (unit->errors.errors[j].message != NULL) {
+                    RUN_ERROR_CODE_FUNCTION(platform_memory_deallocate, (void*) unit->errors.errors[j].message);
+                }
+            }
+
+            PARSER_DEALLOCATE(unit->errors.errors);
+        }
+
+        PARSER_DEALLOCATE(parser.units);
+    }
+
+    RUN_ERROR_CODE_FUNCTION(function_parser_destroy);
 
     #undef PARSER_DEALLOCATE
 
@@ -2366,7 +5891,12 @@ error_code wave_compiler_parser_destroy(void) {
 
 // Macros
 
+#undef PARSER_GET_DATA_POINTER
 #undef PARSER_GET_DATA
 
+#undef PARSER_NODE
+
+#undef PARSER_IS_SIGNED_TYPE
+
 #undef BYTECODE_FITS_SIZE
 #undef BYTECODE_PUSH_DATA_UNSAFE
@@ -1,13 +1,19 @@
 #include "tokenizer.h"
 
+#include <stdatomic.h>
+
 #include "common/constants.h"
+#include "common/defines.h"
 #include "common/error_codes.h"
 
+#include "common/memory/memory.h"
+
 #include "common/data/string/hash.h"
 #include "common/data/string/string.h"
 
 #include "language/compiler/compiler.h"
 #include "language/compiler/data/wave_compiler_common.h"
+#include "language/compiler/data/wave_symbol_table.h"
 
 #include "language/runtime/wave_vm.h"
 
@@ -27,19 +33,110 @@ static token_table_entry operator_tokens[] = {
     #include "language/compiler/data/wave_token_list_inline.h"
 };
 
+/* Token Lookup Tables
+*
+* Both tables are derived from @keyword_tokens and @operator_tokens once, when the tokenizer is used for the first time,
+* so they always match @wave_token_list_inline.h. @state guards the initialization, so that tokenizers started on several
+* threads at once build the tables only once and never read them half built.
+*
+*     @keyword_lookup   - hash table over (length, first char, last char) of a keyword, storing the index into @keyword_tokens + 1 (0 marks an empty slot);
+*                         the hash is collision free for the current keywords, newly added keywords fall back to linear probing
+*     @operator_lookup  - jump table indexed by the first char of an operator, pointing at a run of @operator_entries sorted by descending length, so the first match is the longest one
+*
+* Keywords that do not start with an identifier character (e.g. "??") are matched like operators.
+* */
+
+#define KEYWORD_LOOKUP_SIZE (256) /* must be a power of two and larger than the amount of keywords */
+#define KEYWORD_LOOKUP_HASH(length, first, last) ((((u32) (length)) + ((u32) (u8) (first)) * 30 + ((u32) (u8) (last)) * 9) & (KEYWORD_LOOKUP_SIZE - 1))
+
+#define OPERATOR_ENTRIES_SIZE (ARRAY_LENGTH(keyword_tokens) + ARRAY_LENGTH(operator_tokens))
+
+#define TOKEN_LOOKUP_UNINITIALIZED (0)
+#define TOKEN_LOOKUP_INITIALIZING (1)
+#define TOKEN_LOOKUP_INITIALIZED (2)
+
+typedef struct { wave_token token; cstr string; u32 length; } operator_table_entry;
+
+static struct {
+    atomic_uint state; // @TOKEN_LOOKUP_UNINITIALIZED, @TOKEN_LOOKUP_INITIALIZING or @TOKEN_LOOKUP_INITIALIZED
+
+    u8 keyword_lookup[KEYWORD_LOOKUP_SIZE];
+    u8 keyword_lengths[ARRAY_LENGTH(keyword_tokens)];
+
+    struct { u8 start; u8 count; } operator_lookup[U8_MAX + 1];
+    operator_table_entry operator_entries[OPERATOR_ENTRIES_SIZE];
+
+    u8 char_classes[U8_MAX + 1]; // @CHAR_CLASS_* flags for every char, replaces the char_is_* calls in the hot loops
+} token_lookup;
+
+#define CHAR_CLASS_WHITESPACE (0b001)
+#define CHAR_CLASS_NAMESPACE  (0b010) /* chars that may appear in identifiers */
+#define CHAR_CLASS_STRING     (0b100) /* chars that are copied as they are inside string literals */
+
+#define CHAR_HAS_CLASS(character, class) ((token_lookup.char_classes[(u8) (character)] & (class)) != 0)
+
+/* Word Wise Scanning
+*
+* The source is copied into a buffer that is padded by @TOKENIZER_SOURCE_PADDING null characters,
+* so a whole word can always be read from any position up to the null terminator.
+* Runs of spaces, comment bodies and string bodies are skipped a word at a time, and only the word
+* containing the end of the run is looked at char by char.
+* */
+
+#define TOKENIZER_SOURCE_PADDING (sizeof(u64))
+
+#if PROGRAM_FEATURE_32BIT_MODE == 0
+typedef u64 scan_word;
+#define SCAN_WORD_LOW_BITS  (0x0101010101010101ULL)
+#define SCAN_WORD_HIGH_BITS (0x8080808080808080ULL)
+#else
+typedef u32 scan_word;
+#define SCAN_WORD_LOW_BITS  (0x01010101)
+#define SCAN_WORD_HIGH_BITS (0x80808080)
+#endif
+
+#define SCAN_WORD_LOAD(pointer) scan_word_load(pointer)
+#define SCAN_WORD_REPEAT(character) (SCAN_WORD_LOW_BITS * (u8) (character))
+
+#define SCAN_WORD_HAS_LESS(word, value) ((((word) - SCAN_WORD_REPEAT(value)) & ~(word) & SCAN_WORD_HIGH_BITS) != 0) /* whether any byte is less than @value (@value <= 128) */
+#define SCAN_WORD_HAS_ZERO(word) SCAN_WORD_HAS_LESS(word, 1)
+#define SCAN_WORD_HAS_BYTE(word, character) SCAN_WORD_HAS_ZERO((word) ^ SCAN_WORD_REPEAT(character))
+
+#define SCAN_WORD_ZERO_BYTES(word) (~((((word) & ~SCAN_WORD_HIGH_BITS) + ~SCAN_WORD_HIGH_BITS) | (word) | ~SCAN_WORD_HIGH_BITS)) /* the high bit of every zero byte, without false positives */
+#define SCAN_WORD_IN_RANGE(word, low, high) ((((word) + SCAN_WORD_REPEAT(0x80 - (low))) & ~((word) + SCAN_WORD_REPEAT(0x7F - (high)))) & SCAN_WORD_HIGH_BITS) /* the high bit of every byte in [@low, @high], only valid if no byte has its high bit set */
+#define SCAN_WORD_NAMESPACE_BYTES(word) (SCAN_WORD_IN_RANGE((word) | SCAN_WORD_REPEAT(0x20), 'a', 'z') | SCAN_WORD_IN_RANGE(word, '0', '9') | SCAN_WORD_ZERO_BYTES((word) ^ SCAN_WORD_REPEAT('_'))) /* the high bit of every byte matching @CHAR_CLASS_NAMESPACE */
+#define SCAN_WORD_IS_NAMESPACE(word) (((word) & SCAN_WORD_HIGH_BITS) == 0 && SCAN_WORD_NAMESPACE_BYTES(word) == SCAN_WORD_HIGH_BITS)
+
+static inline scan_word scan_word_load(str pointer) {
+    scan_word word; // copied instead of dereferenced, the source is neither aligned nor typed as words
+    memory_copy(pointer, &word, sizeof(scan_word));
+    return word;
+}
+
 // error handling
 
-#define TOKENIZER_RAISE_ERROR(function_name, message_format, ...) COMPILER_RAISE_ERROR(function_name, tokenizer.current_file_name, tokenizer.current_line, (tokenizer.current_row_start + 1) - tokenizer.current_line_start, message_format, __VA_ARGS__)
+#define TOKENIZER_CURRENT_OFFSET() ((u32) (tokenizer.current_row_start - tokenizer.source_start))
+#define TOKENIZER_RAISE_ERROR(function_name, message_format, ...) COMPILER_RAISE_ERROR(function_name, tokenizer.current_file_name, wave_compiler_tokenizer_get_line(TOKENIZER_CURRENT_OFFSET()), wave_compiler_tokenizer_get_row(TOKENIZER_CURRENT_OFFSET()), message_format, __VA_ARGS__)
 
 // token stack access
 
+#define TOKEN_STREAM_SLOT(token_index) (tokenizer.streaming ? (token_index) & (TOKEN_WINDOW_SIZE - 1) : (token_index))
+#define TOKEN_HAS_DATA(token) ((token) == WAVE_TOKEN_VALUE_INTEGER || (token) == WAVE_TOKEN_VALUE_FLOAT || (token) == WAVE_TOKEN_VALUE_STR)
+
 #define DATA_STACK_FITS_SIZE(size)                                                                                                                                          \
     do {                                                                                                                                                                    \
         if (tokenizer.data_stack_current + (size) > tokenizer.data_stack_end) {                                                                                             \
-            tokenizer.data_stack_capacity += DATA_STACK_GROW_SIZE;                                                                                                          \
+            u32 data_stack_length = (u32) (tokenizer.data_stack_current - tokenizer.data_stack_start);                                                                      \
+            while (data_stack_length + (size) > tokenizer.data_stack_capacity) {                                                                                            \
+                tokenizer.data_stack_capacity *= 2;                                                                                                                         \
+            }                                                                                                                                                               \
+                                                                                                                                                                            \
             if (tokenizer.vm->reallocate_memory((void**) &(tokenizer.data_stack_start), sizeof(byte) * tokenizer.data_stack_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) { \
                 TOKENIZER_RAISE_ERROR("data_stack", "failed to reallocate data stack");                                                                                     \
             }                                                                                                                                                               \
+                                                                                                                                                                            \
+            tokenizer.data_stack_current = tokenizer.data_stack_start + data_stack_length;                                                                                  \
+            tokenizer.data_stack_end = tokenizer.data_stack_start + tokenizer.data_stack_capacity;                                                                          \
         }                                                                                                                                                                   \
     } while (0)
 
@@ -54,55 +151,81 @@ static token_table_entry operator_tokens[] = {
 #define NEXT_CHAR() do { source++; } while (0)
 #define GET_CHAR() *source
 
+#define SOURCE_AT_COMMENT() (source[0] == '/' && (source[1] == '/' || source[1] == '*'))
+
 // tokenization interface
 
 static struct {
     wave_vm* vm;
 
-    parse_token* token_stack_start;
-    parse_token* token_stack_end;
-    parse_token* token_stack_current;
-    u32 token_stack_capacity;
+    str source_start; // padded copy of the source (see @TOKENIZER_SOURCE_PADDING), identifiers point into it
+    str source_current; // the position tokenizing continues at
+    u32 source_length;
+
+    u32* line_offsets; // the source offset of the first char of every line, only built once a position is requested (see @wave_compiler_tokenizer_get_line)
+    u32 line_count;
+
+    bool streaming; // whether the token arrays are a ring of @TOKEN_WINDOW_SIZE tokens that is refilled on demand (see @wave_compiler_tokenizer_pull)
+    bool complete; // whether @WAVE_TOKEN_FILE_END has been pushed
+
+    wave_token* tokens; // the token stream is stored as separate arrays (see @wave_token_stream)
+    u32* token_data_indices;
+    u32* token_source_offsets;
+    u32 token_count;
+    u32 token_capacity;
 
     byte* data_stack_start;
     byte* data_stack_end;
     byte* data_stack_current;
     u32 data_stack_capacity;
 
-    str current_file_name;
-    u32 current_line;
+    wave_identifier* identifiers; // every distinct identifier, indexed by its @wave_symbol
+    u32 identifier_count;
+    u32 identifier_capacity;
+    wave_symbol_table identifier_table; // interns identifiers, maps their hash to their @wave_symbol
 
-    str current_line_start;
-    str current_row_start;
+    str current_file_name;
+    str current_row_start; // the start of the current token
 } tokenizer;
 
 // Tokenizer Functions
 
 static void push_token(wave_token token, bool has_data) {
-    if (tokenizer.token_stack_current + sizeof(parse_token) > tokenizer.token_stack_end) {
-        tokenizer.token_stack_capacity += TOKEN_STACK_GROW_SIZE;
-        if (tokenizer.vm->reallocate_memory((void**) &(tokenizer.token_stack_start), sizeof(parse_token) * tokenizer.token_stack_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
-            TOKENIZER_RAISE_ERROR("token_stack", "failed to reallocate token stack");
-            return;
-        }
+    if (!tokenizer.streaming && tokenizer.token_count >= tokenizer.token_capacity) {
+        tokenizer.token_capacity *= 2;
+
+        #define TOKEN_STREAM_REALLOCATE(array, type)                                                                                                \
+            do {                                                                                                                                    \
+                if (tokenizer.vm->reallocate_memory((void**) &(array), sizeof(type) * tokenizer.token_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) { \
+                    TOKENIZER_RAISE_ERROR("token_stack", "failed to reallocate token stack");                                                       \
+                    return;                                                                                                                         \
+                }                                                                                                                                   \
+            } while (0)
+
+        TOKEN_STREAM_REALLOCATE(tokenizer.tokens, wave_token);
+        TOKEN_STREAM_REALLOCATE(tokenizer.token_data_indices, u32);
+        TOKEN_STREAM_REALLOCATE(tokenizer.token_source_offsets, u32);
+
+        #undef TOKEN_STREAM_REALLOCATE
     }
 
-    *tokenizer.token_stack_current = (parse_token) {
-        .token = token,
-        .data_index = has_data ? (u32) (tokenizer.data_stack_current - tokenizer.data_stack_start) : 0,
-
-        .line = tokenizer.current_line,
-        .row = (tokenizer.current_row_start + 1) - tokenizer.current_line_start
-    };
-
-    tokenizer.token_stack_current++;
+    u32 slot = TOKEN_STREAM_SLOT(tokenizer.token_count);
+    tokenizer.tokens[slot] = token;
+    tokenizer.token_data_indices[slot] = has_data ? (u32) (tokenizer.data_stack_current - tokenizer.data_stack_start) : 0;
+    tokenizer.token_source_offsets[slot] = TOKENIZER_CURRENT_OFFSET();
+    tokenizer.token_count++;
 }
 
 static void skip_whitespaces(str source, str* out_source) {
-    while (char_is_whitespace(GET_CHAR())) {
-        if (GET_CHAR() == '\n') {
-            tokenizer.current_line_start = source + 1;
-            tokenizer.current_line++;
+    while (true) {
+        // skip indentation a word at a time
+
+        while (SCAN_WORD_LOAD(source) == SCAN_WORD_REPEAT(' ')) {
+            source += sizeof(scan_word);
+        }
+
+        if (!CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_WHITESPACE)) {
+            break;
         }
 
         NEXT_CHAR();
@@ -112,39 +235,49 @@ static void skip_whitespaces(str source, str* out_source) {
 }
 
 static void skip_comments(str source, str* out_source) {
-    if (GET_CHAR() == '/') {
-        NEXT_CHAR();
+    if (!SOURCE_AT_COMMENT()) {
+        goto skip_comments_end;
+    }
 
-        if (GET_CHAR() == '/') { // single line comment
-            NEXT_CHAR();
+    NEXT_CHAR();
 
-            while (GET_CHAR() != '\n' && GET_CHAR() != '\0') {
-                NEXT_CHAR();
-            }
+    if (GET_CHAR() == '/') { // single line comment
+        NEXT_CHAR();
 
-            if (GET_CHAR() == '\0') {
-                goto skip_comments_end;
+        while (true) {
+            scan_word word = SCAN_WORD_LOAD(source);
+            if (SCAN_WORD_HAS_ZERO(word) || SCAN_WORD_HAS_BYTE(word, '\n')) {
+                break;
             }
 
-            tokenizer.current_line_start = source + 1;
-            tokenizer.current_line++;
-        } else if (GET_CHAR() == '*') { // multi-line/inline comment
+            source += sizeof(scan_word);
+        }
+
+        while (GET_CHAR() != '\n' && GET_CHAR() != '\0') {
             NEXT_CHAR();
+        }
+    } else { // multi-line/inline comment
+        NEXT_CHAR();
 
-            while (true) {
-                if (GET_CHAR() == '\0') {
-                    goto skip_comments_end;
-                } else if (GET_CHAR() == '\n') {
-                    tokenizer.current_line_start = source + 1;
-                    tokenizer.current_line++;
-                }
+        while (true) {
+            // skip words not containing the end of the comment
 
-                if (source[0] == '*' && source[1] == '/') {
-                    NEXT_CHAR();
+            while (true) {
+                scan_word word = SCAN_WORD_LOAD(source);
+                if (SCAN_WORD_HAS_ZERO(word) || SCAN_WORD_HAS_BYTE(word, '*')) {
                     break;
                 }
 
-                NEXT_CHAR();
+                source += sizeof(scan_word);
+            }
+
+            if (GET_CHAR() == '\0') {
+                goto skip_comments_end;
+            }
+
+            if (source[0] == '*' && source[1] == '/') {
+                source += 2;
+                break;
             }
 
             NEXT_CHAR();
@@ -251,14 +384,39 @@ static void tokenize_number(str source, str* out_source) {
 static bool tokenize_string(str source, str* out_source) {
     DATA_STACK_FITS_SIZE(sizeof(u32));
 
-    byte* temp_data_stack = tokenizer.data_stack_current;
+    u32 length_index = (u32) (tokenizer.data_stack_current - tokenizer.data_stack_start); // the data stack may move while the string is pushed
     push_token(WAVE_TOKEN_VALUE_STR, true);
     TOKENIZER_PUSH_DATA_UNSAFE(u32, 0);
 
     u32 length = 0;
 
     wave_compiler_builtin_tokenize_string: {}
-    do {
+    while (GET_CHAR() != '"' && GET_CHAR() != '\0') {
+        // copy runs of plain chars at once, a run ends at a quote, an escape sequence or a control char
+
+        str run_start = source;
+        while (true) {
+            scan_word word = SCAN_WORD_LOAD(source);
+            if (SCAN_WORD_HAS_LESS(word, ' ') || SCAN_WORD_HAS_BYTE(word, '"') || SCAN_WORD_HAS_BYTE(word, '\\')) {
+                break;
+            }
+
+            source += sizeof(scan_word);
+        }
+
+        while (CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_STRING)) {
+            NEXT_CHAR();
+        }
+
+        u32 run_length = (u32) (source - run_start);
+        if (run_length != 0) {
+            DATA_STACK_FITS_SIZE(run_length);
+            memory_copy(run_start, tokenizer.data_stack_current, run_length);
+            tokenizer.data_stack_current += run_length;
+            length += run_length;
+            continue;
+        }
+
         if (GET_CHAR() == '\\') {
             NEXT_CHAR();
             char character = '\0';
@@ -275,38 +433,49 @@ static bool tokenize_string(str source, str* out_source) {
                 case ('\"'): { character = '\"'; break; }
 
                 case ('b'): {
+                    NEXT_CHAR();
+
                     u8 character_temp = 0;
-                    while (GET_CHAR() != '\'' && (GET_CHAR() == '0' || GET_CHAR() == '1' || GET_CHAR() == '_')) {
-                        if (GET_CHAR() == '_') {
-                            continue;
+                    while (GET_CHAR() == '0' || GET_CHAR() == '1' || GET_CHAR() == '_') {
+                        if (GET_CHAR() != '_') {
+                            character_temp = (character_temp << 1) | (GET_CHAR() - '0');
                         }
 
-                        character_temp = (character_temp << 1) & (GET_CHAR() - '0');
                         NEXT_CHAR();
                     }
 
+                    source--; // the last binary digit is skipped below
                     character = *((char*) &character_temp);
                     break;
                 }
 
+                case ('\0'): {
+                    continue; // reported below
+                }
+
                 default: {
                     character = GET_CHAR();
                     break;
                 }
             }
 
+            NEXT_CHAR();
+
+            DATA_STACK_FITS_SIZE(sizeof(char));
             TOKENIZER_PUSH_DATA_UNSAFE(char, character);
             length++;
             continue;
-        } if (GET_CHAR() == '\n' || GET_CHAR() == '\r' || GET_CHAR() == '\t' || GET_CHAR() == '\v') {
+        } else if (GET_CHAR() == '\n' || GET_CHAR() == '\r' || GET_CHAR() == '\t' || GET_CHAR() == '\v') {
             NEXT_CHAR();
             continue;
         }
 
+        DATA_STACK_FITS_SIZE(sizeof(char));
         TOKENIZER_PUSH_DATA_UNSAFE(char, GET_CHAR());
         NEXT_CHAR();
         length++;
-    } while (GET_CHAR() != '"' && GET_CHAR() != '\0');
+    }
+
     if (GET_CHAR() == '\0') {
         TOKENIZER_RAISE_ERROR("tokenize_string", "sudden end of file, encountered null character");
         return false;
@@ -315,7 +484,7 @@ static bool tokenize_string(str source, str* out_source) {
     // skip whitespace and comments in between concatenated string ("abc" "def" -> "abcdef")
 
     NEXT_CHAR();
-    while (char_is_whitespace(GET_CHAR()) || GET_CHAR() == '\\') {
+    while (CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_WHITESPACE) || SOURCE_AT_COMMENT()) {
         skip_whitespaces(source, &source);
         skip_comments(source, &source);
     }
@@ -324,7 +493,7 @@ static bool tokenize_string(str source, str* out_source) {
         NEXT_CHAR();
         goto wave_compiler_builtin_tokenize_string;
     } else {
-        *((u32*) temp_data_stack) = length;
+        *((u32*) (tokenizer.data_stack_start + length_index)) = length;
     }
 
     *out_source = source;
@@ -386,139 +555,289 @@ static void tokenize_character(str source, str* out_source) {
 }
 
 static void tokenize_identifier(str source, str* out_source) {
-    DATA_STACK_FITS_SIZE(sizeof(wave_identifier));
-
     u32 length = 0;
     str temp = source;
 
-    do {
+    while (SCAN_WORD_IS_NAMESPACE(SCAN_WORD_LOAD(source))) {
+        source += sizeof(scan_word);
+        length += sizeof(scan_word);
+    }
+
+    while (CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_NAMESPACE)) {
         NEXT_CHAR();
         length++;
-    } while (wave_compiler_builtin_char_is_namespace(GET_CHAR()));
-
-    push_token(WAVE_TOKEN_IDENTIFIER, true);
-    wave_identifier identifier = (wave_identifier) { .hash = hash_bytes((byte*) temp, length), .source_pointer = temp };
-    TOKENIZER_PUSH_DATA_UNSAFE(wave_identifier, identifier);
+    }
 
     *out_source = source;
+
+    // intern the identifier, only its first appearance is stored
+
+    string_hash hash = hash_bytes((byte*) temp, length);
+    wave_symbol symbol = wave_symbol_table_find(&tokenizer.identifier_table, hash);
+    if (symbol == WAVE_SYMBOL_TABLE_NONE) {
+        if (tokenizer.identifier_count >= tokenizer.identifier_capacity) {
+            tokenizer.identifier_capacity *= 2;
+            if (tokenizer.vm->reallocate_memory((void**) &(tokenizer.identifiers), sizeof(wave_identifier) * tokenizer.identifier_capacity) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+                TOKENIZER_RAISE_ERROR("tokenize_identifier", "failed to reallocate identifier stack");
+                return;
+            }
+        }
+
+        symbol = tokenizer.identifier_count;
+        if (wave_symbol_table_set(&tokenizer.identifier_table, hash, symbol) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+            TOKENIZER_RAISE_ERROR("tokenize_identifier", "failed to grow the identifier table");
+            return;
+        }
+
+        tokenizer.identifiers[symbol] = (wave_identifier) { .hash = hash, .source_pointer = temp };
+        tokenizer.identifier_count++;
+    }
+
+    push_token(WAVE_TOKEN_IDENTIFIER, false);
+    tokenizer.token_data_indices[TOKEN_STREAM_SLOT(tokenizer.token_count - 1)] = symbol;
 }
 
-static wave_token tokenize_keyword(str source, str* out_source) {
-    str temp = NULL;
-    wave_token token = WAVE_TOKEN_INVALID;
+static void initialize_token_lookup(void) {
+    if (atomic_load_explicit(&token_lookup.state, memory_order_acquire) == TOKEN_LOOKUP_INITIALIZED) {
+        return;
+    }
+
+    // the first thread builds the tables, all others wait until they are published
+
+    u32 expected_state = TOKEN_LOOKUP_UNINITIALIZED;
+    if (!atomic_compare_exchange_strong_explicit(&token_lookup.state, &expected_state, TOKEN_LOOKUP_INITIALIZING, memory_order_acquire, memory_order_acquire)) {
+        while (atomic_load_explicit(&token_lookup.state, memory_order_acquire) != TOKEN_LOOKUP_INITIALIZED) {}
+        return;
+    }
+
+    // keywords
 
+    u32 operator_entry_count = 0;
     for (u32 i = 0; i < ARRAY_LENGTH(keyword_tokens); i++) {
-        temp = source;
         cstr keyword = keyword_tokens[i].string;
+        u32 length = 0;
+        while (keyword[length] != '\0') {
+            length++;
+        }
+
+        token_lookup.keyword_lengths[i] = (u8) length;
+
+        if (!wave_compiler_builtin_char_is_namespace(keyword[0])) {
+            token_lookup.operator_entries[operator_entry_count++] = (operator_table_entry) { .token = keyword_tokens[i].token, .string = keyword, .length = length };
+            continue;
+        }
+
+        u32 slot = KEYWORD_LOOKUP_HASH(length, keyword[0], keyword[length - 1]);
+        while (token_lookup.keyword_lookup[slot] != 0) {
+            slot = (slot + 1) & (KEYWORD_LOOKUP_SIZE - 1);
+        }
+
+        token_lookup.keyword_lookup[slot] = (u8) (i + 1);
+    }
+
+    // operators
+
+    for (u32 i = 0; i < ARRAY_LENGTH(operator_tokens); i++) {
+        cstr operator = operator_tokens[i].string;
+        u32 length = 0;
+        while (operator[length] != '\0') {
+            length++;
+        }
+
+        token_lookup.operator_entries[operator_entry_count++] = (operator_table_entry) { .token = operator_tokens[i].token, .string = operator, .length = length };
+    }
+
+    // sort by first char and then by descending length (insertion sort, the table is tiny)
 
-        while (*temp == *keyword) {
-            temp++;
-            keyword++;
+    for (u32 i = 1; i < operator_entry_count; i++) {
+        operator_table_entry entry = token_lookup.operator_entries[i];
 
-            if (*keyword == '\0' && !char_is_letter(*temp) && !char_is_digit(*temp)) {
-                token = keyword_tokens[i].token;
-                source = temp;
+        u32 j = i;
+        while (j > 0) {
+            operator_table_entry* previous = &token_lookup.operator_entries[j - 1];
+            if ((u8) previous->string[0] < (u8) entry.string[0] || ((u8) previous->string[0] == (u8) entry.string[0] && previous->length >= entry.length)) {
                 break;
-            } else if (*temp == '\0') {
-                goto tokenize_keyword_end;
             }
+
+            token_lookup.operator_entries[j] = *previous;
+            j--;
         }
 
-        if (token != WAVE_TOKEN_INVALID) {
-            goto tokenize_keyword_end; // token found
+        token_lookup.operator_entries[j] = entry;
+    }
+
+    for (u32 i = 0; i < operator_entry_count; i++) {
+        u8 first = (u8) token_lookup.operator_entries[i].string[0];
+        if (token_lookup.operator_lookup[first].count == 0) {
+            token_lookup.operator_lookup[first].start = (u8) i;
         }
+
+        token_lookup.operator_lookup[first].count++;
     }
 
-    tokenize_keyword_end: {}
+    // char classes
 
-    *out_source = source;
+    for (u32 i = 1; i <= U8_MAX; i++) {
+        char character = (char) i;
+        u8 classes = 0;
+
+        if (char_is_whitespace(character)) {
+            classes |= CHAR_CLASS_WHITESPACE;
+        }
+
+        if (wave_compiler_builtin_char_is_namespace(character)) {
+            classes |= CHAR_CLASS_NAMESPACE;
+        }
 
-    return token;
+        if ((u8) character >= ' ' && character != '"' && character != '\\') {
+            classes |= CHAR_CLASS_STRING;
+        }
+
+        token_lookup.char_classes[i] = classes;
+    }
+
+    atomic_store_explicit(&token_lookup.state, TOKEN_LOOKUP_INITIALIZED, memory_order_release);
 }
 
-static wave_token tokenize_operator(str source, str* out_source) {
-    str temp = NULL;
-    wave_token token = WAVE_TOKEN_INVALID;
+static wave_token tokenize_keyword(str source, str* out_source) {
+    if (!CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_NAMESPACE)) {
+        *out_source = source;
+        return WAVE_TOKEN_INVALID;
+    }
 
-    for (u32 i = 0; i < ARRAY_LENGTH(operator_tokens); i++) {
-        temp = source;
-        cstr keyword = operator_tokens[i].string;
+    u32 length = 0;
+    while (CHAR_HAS_CLASS(source[length], CHAR_CLASS_NAMESPACE)) {
+        length++;
+    }
 
-        while (*temp == *keyword) {
-            temp++;
-            keyword++;
+    u32 slot = KEYWORD_LOOKUP_HASH(length, source[0], source[length - 1]);
+    while (token_lookup.keyword_lookup[slot] != 0) {
+        u32 index = token_lookup.keyword_lookup[slot] - 1;
+        if (token_lookup.keyword_lengths[index] == length) {
+            cstr keyword = keyword_tokens[index].string;
 
-            if (*keyword == '\0') {
-                token = operator_tokens[i].token;
-                source = temp;
-                break;
-            } else if (*temp == '\0') {
-                goto tokenize_operator_end;
+            u32 i = 0;
+            while (i < length && keyword[i] == source[i]) {
+                i++;
             }
-        }
 
-        if (token != WAVE_TOKEN_INVALID) {
-            goto tokenize_operator_end; // token found
+            if (i == length) {
+                *out_source = source + length;
+                return keyword_tokens[index].token;
+            }
         }
+
+        slot = (slot + 1) & (KEYWORD_LOOKUP_SIZE - 1);
     }
 
-    tokenize_operator_end: {}
+    *out_source = source;
+
+    return WAVE_TOKEN_INVALID;
+}
+
+static wave_token tokenize_operator(str source, str* out_source) {
+    u8 first = (u8) GET_CHAR();
+
+    const operator_table_entry* entry = &token_lookup.operator_entries[token_lookup.operator_lookup[first].start];
+    const operator_table_entry* entry_end = entry + token_lookup.operator_lookup[first].count;
+
+    for (; entry < entry_end; entry++) {
+        u32 i = 1; // the first char always matches
+        while (i < entry->length && entry->string[i] == source[i]) {
+            i++;
+        }
+
+        if (i == entry->length) {
+            *out_source = source + entry->length;
+            return entry->token;
+        }
+    }
 
     *out_source = source;
 
-    return token;
+    return WAVE_TOKEN_INVALID;
 }
 
-error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tokenized_start, parse_token** out_tokenized_end, byte** out_data_stack_start, byte** out_data_stack_end) {
+static error_code tokenizer_begin(wave_vm* vm, str source, bool streaming) {
     tokenizer.vm = vm;
 
+    initialize_token_lookup();
+
     const wave_memory_allocation_function allocate_memory = tokenizer.vm->allocate_memory;
     const wave_memory_reallocation_function reallocate_memory = tokenizer.vm->reallocate_memory;
+    const wave_memory_deallocation_function deallocate_memory = tokenizer.vm->deallocate_memory;
 
-    // token stack
+    // token stream
 
-    parse_token* token_stack_start = NULL;
-    u32 token_stack_capacity = TOKEN_STACK_GROW_SIZE;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &token_stack_start, sizeof(parse_token) * token_stack_capacity);
+    tokenizer.streaming = streaming;
+    tokenizer.complete = false;
 
-    tokenizer.token_stack_start    = token_stack_start;
-    tokenizer.token_stack_end      = token_stack_start + token_stack_capacity;
-    tokenizer.token_stack_current  = token_stack_start;
-    tokenizer.token_stack_capacity = token_stack_capacity;
+    tokenizer.token_count = 0;
+    tokenizer.token_capacity = streaming ? TOKEN_WINDOW_SIZE : TOKEN_STACK_INITIAL_CAPACITY;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &tokenizer.tokens, sizeof(wave_token) * tokenizer.token_capacity);
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &tokenizer.token_data_indices, sizeof(u32) * tokenizer.token_capacity);
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &tokenizer.token_source_offsets, sizeof(u32) * tokenizer.token_capacity);
 
     // data stack
 
     byte* data_stack_start = NULL;
-    u32 data_stack_capacity = DATA_STACK_GROW_SIZE;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &data_stack_start, sizeof(parse_token) * data_stack_capacity);
+    u32 data_stack_capacity = DATA_STACK_INITIAL_CAPACITY;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &data_stack_start, sizeof(byte) * data_stack_capacity);
 
     tokenizer.data_stack_start    = data_stack_start;
     tokenizer.data_stack_end      = data_stack_start + data_stack_capacity;
     tokenizer.data_stack_current  = data_stack_start;
     tokenizer.data_stack_capacity = data_stack_capacity;
 
+    // identifiers
+
+    tokenizer.identifiers = NULL;
+    tokenizer.identifier_count = 0;
+    tokenizer.identifier_capacity = IDENTIFIER_STACK_INITIAL_CAPACITY;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &tokenizer.identifiers, sizeof(wave_identifier) * tokenizer.identifier_capacity);
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_new, &tokenizer.identifier_table, tokenizer.identifier_capacity * 2, allocate_memory, reallocate_memory, deallocate_memory);
+
+    // padded source copy
+
+    u32 source_length = str_length(source);
+    str source_copy = NULL;
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &source_copy, sizeof(char) * (source_length + 1 + TOKENIZER_SOURCE_PADDING));
+    memory_copy(source, source_copy, source_length);
+    memory_clear(source_copy + source_length, 1 + TOKENIZER_SOURCE_PADDING);
+
+    tokenizer.source_start = source_copy;
+    tokenizer.source_current = source_copy;
+    tokenizer.source_length = source_length;
+
+    tokenizer.line_offsets = NULL;
+    tokenizer.line_count = 0;
+
     tokenizer.current_file_name = "undefined";
-    tokenizer.current_line = 1;
+    tokenizer.current_row_start = source_copy;
 
-    tokenizer.current_line_start = source;
-    tokenizer.current_row_start = source;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
 
-    // parsing tokens
+static error_code tokenize_source(u32 token_limit) { // tokenizes the source until @token_limit tokens exist or the source ends
+    str source = tokenizer.source_current;
+    error_code result = ERROR_CODE_EXECUTION_SUCCESSFUL;
 
-    while (GET_CHAR() != '\0') {
-        while (char_is_whitespace(GET_CHAR()) || GET_CHAR() == '\\') {
+    while (tokenizer.token_count < token_limit) {
+        while (CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_WHITESPACE) || SOURCE_AT_COMMENT()) {
             skip_whitespaces(source, &source);
             skip_comments(source, &source);
         }
 
+        tokenizer.current_row_start = source;
+
         if (GET_CHAR() == '\0') {
+            push_token(WAVE_TOKEN_FILE_END, false);
+            tokenizer.complete = true;
             break;
         }
 
         wave_token token = WAVE_TOKEN_INVALID;
 
-        tokenizer.current_row_start = source;
-
         // tokenizing numbers
 
         if (char_is_digit(GET_CHAR())) {
@@ -531,7 +850,8 @@ error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tok
         if (GET_CHAR() == '"') {
             NEXT_CHAR();
             if (!tokenize_string(source, &source)) {
-                return ERROR_CODE_EXECUTION_FAILED;
+                result = ERROR_CODE_EXECUTION_FAILED;
+                break;
             }
 
             continue;
@@ -543,7 +863,8 @@ error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tok
             NEXT_CHAR();
             tokenize_character(source, &source);
             if (GET_CHAR() != '\'') {
-                return ERROR_CODE_LANGUAGE_COMPILER_SUDDEN_END_OF_FILE;
+                result = ERROR_CODE_LANGUAGE_COMPILER_SUDDEN_END_OF_FILE;
+                break;
             }
 
             continue;
@@ -556,12 +877,13 @@ error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tok
             push_token(token, false);
             continue;
         } else if (GET_CHAR() == '\0') {
-            return ERROR_CODE_LANGUAGE_COMPILER_SUDDEN_END_OF_FILE;
+            result = ERROR_CODE_LANGUAGE_COMPILER_SUDDEN_END_OF_FILE;
+            break;
         }
 
         // tokenizing variable and function names (identifiers)
 
-        if (!char_is_digit(GET_CHAR()) && wave_compiler_builtin_char_is_namespace(GET_CHAR())) {
+        if (!char_is_digit(GET_CHAR()) && CHAR_HAS_CLASS(GET_CHAR(), CHAR_CLASS_NAMESPACE)) {
             tokenize_identifier(source, &source);
             continue;
         }
@@ -573,38 +895,114 @@ error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tok
             push_token(token, false);
             continue;
         } else if (GET_CHAR() == '\0') {
-            return ERROR_CODE_LANGUAGE_COMPILER_SUDDEN_END_OF_FILE;
+            result = ERROR_CODE_LANGUAGE_COMPILER_SUDDEN_END_OF_FILE;
+            break;
         }
 
         // if this executes something went wrong
 
-        return ERROR_CODE_LANGUAGE_COMPILER_UNKNOWN_CHARACTER;
+        result = ERROR_CODE_LANGUAGE_COMPILER_UNKNOWN_CHARACTER;
+        break;
     }
 
-    tokenizer.current_line_start = source;
-    tokenizer.current_row_start = source;
-    push_token(WAVE_TOKEN_FILE_END, false);
+    tokenizer.source_current = source;
+
+    return result;
+}
+
+static void tokenizer_get_stream(wave_token_stream* out_tokens) {
+    *out_tokens = (wave_token_stream) {
+        .tokens = tokenizer.tokens,
+        .data_indices = tokenizer.token_data_indices,
+        .source_offsets = tokenizer.token_source_offsets,
+        .count = tokenizer.token_count,
+        .window_mask = tokenizer.streaming ? TOKEN_WINDOW_SIZE - 1 : U32_MAX,
+        .complete = tokenizer.complete,
+
+        .data_stack_start = tokenizer.data_stack_start,
+        .data_stack_end = tokenizer.data_stack_end,
+
+        .identifiers = tokenizer.identifiers,
+        .identifier_count = tokenizer.identifier_count
+    };
+}
+
+error_code wave_compiler_tokenize(wave_vm* vm, str source, wave_token_stream* out_tokens) {
+    const wave_memory_reallocation_function reallocate_memory = vm->reallocate_memory;
+
+    RUN_ERROR_CODE_FUNCTION(tokenizer_begin, vm, source, false);
+    RUN_ERROR_CODE_FUNCTION(tokenize_source, U32_MAX);
 
     // shrink the allocated stacks to fit
 
-    u32 token_stack_length = tokenizer.token_stack_current - tokenizer.token_stack_start;
-    u32 data_stack_length  = tokenizer.data_stack_current  - tokenizer.data_stack_start;
-    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(tokenizer.token_stack_start), sizeof(parse_token) * (token_stack_length == 0 ? 0 : token_stack_length - 1));
-    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(tokenizer.data_stack_start),  sizeof(byte)        * (data_stack_length == 0 ? 0 : data_stack_length - 1));
+    u32 data_stack_length = (u32) (tokenizer.data_stack_current - tokenizer.data_stack_start);
+    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(tokenizer.tokens), sizeof(wave_token) * tokenizer.token_count);
+    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(tokenizer.token_data_indices), sizeof(u32) * tokenizer.token_count);
+    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(tokenizer.token_source_offsets), sizeof(u32) * tokenizer.token_count);
+    if (data_stack_length != 0) {
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(tokenizer.data_stack_start), sizeof(byte) * data_stack_length);
+    }
+
+    tokenizer.token_capacity = tokenizer.token_count;
+    tokenizer.data_stack_current = tokenizer.data_stack_start + data_stack_length;
+    tokenizer.data_stack_end = tokenizer.data_stack_current;
 
     // output result
 
-    *out_tokenized_start = tokenizer.token_stack_start;
-    *out_tokenized_end = tokenizer.token_stack_end;
+    tokenizer_get_stream(out_tokens);
 
-    *out_data_stack_start = tokenizer.data_stack_start;
-    *out_data_stack_end = tokenizer.data_stack_end;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_compiler_tokenizer_begin_stream(wave_vm* vm, str source, wave_token_stream* out_tokens) {
+    RUN_ERROR_CODE_FUNCTION(tokenizer_begin, vm, source, true);
+
+    tokenizer_get_stream(out_tokens);
 
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_compiler_tokenizer_pull(wave_token_stream* tokens, u32 token_index) {
+    while (tokenizer.streaming && !tokenizer.complete && token_index >= tokenizer.token_count) {
+        // drop the tokens behind the lookback of the window, and the data only they were referencing
 
+        u32 first_token = token_index > TOKEN_WINDOW_LOOKBACK ? token_index - TOKEN_WINDOW_LOOKBACK : 0;
+        if (first_token > tokenizer.token_count) {
+            first_token = tokenizer.token_count; // tokens are never skipped, the window only moves forward one refill at a time
+        }
+
+        u32 data_stack_length = (u32) (tokenizer.data_stack_current - tokenizer.data_stack_start);
+        u32 data_start = data_stack_length;
+        for (u32 i = first_token; i < tokenizer.token_count; i++) {
+            if (TOKEN_HAS_DATA(tokenizer.tokens[TOKEN_STREAM_SLOT(i)])) {
+                data_start = tokenizer.token_data_indices[TOKEN_STREAM_SLOT(i)];
+                break;
+            }
+        }
+
+        if (data_start != 0) {
+            memory_copy(tokenizer.data_stack_start + data_start, tokenizer.data_stack_start, data_stack_length - data_start); // copies ascending, so the ranges may overlap
+            tokenizer.data_stack_current -= data_start;
+
+            for (u32 i = first_token; i < tokenizer.token_count; i++) {
+                if (TOKEN_HAS_DATA(tokenizer.tokens[TOKEN_STREAM_SLOT(i)])) {
+                    tokenizer.token_data_indices[TOKEN_STREAM_SLOT(i)] -= data_start;
+                }
+            }
+        }
+
+        // refill the window
+
+        RUN_ERROR_CODE_FUNCTION(tokenize_source, first_token + TOKEN_WINDOW_SIZE);
+    }
+
+    tokenizer_get_stream(tokens);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
-#undef TOKEN_STACK_FITS_SIZE
+#undef TOKEN_STREAM_SLOT
+#undef TOKEN_HAS_DATA
 #undef DATA_STACK_FITS_SIZE
 #undef TOKENIZER_PUSH_TOKEN_UNSAFE
 #undef TOKENIZER_PUSH_DATA_UNSAFE
@@ -612,14 +1010,102 @@ error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tok
 
 #undef NEXT_CHAR
 #undef GET_CHAR
+#undef SOURCE_AT_COMMENT
+
+#undef CHAR_HAS_CLASS
+#undef SCAN_WORD_LOAD
+#undef SCAN_WORD_REPEAT
+#undef SCAN_WORD_HAS_LESS
+#undef SCAN_WORD_HAS_ZERO
+#undef SCAN_WORD_HAS_BYTE
+#undef SCAN_WORD_ZERO_BYTES
+#undef SCAN_WORD_IN_RANGE
+#undef SCAN_WORD_NAMESPACE_BYTES
+#undef SCAN_WORD_IS_NAMESPACE
+
+#undef KEYWORD_LOOKUP_SIZE
+#undef KEYWORD_LOOKUP_HASH
+#undef OPERATOR_ENTRIES_SIZE
+#undef TOKEN_LOOKUP_UNINITIALIZED
+#undef TOKEN_LOOKUP_INITIALIZING
+#undef TOKEN_LOOKUP_INITIALIZED
+
+// source positions
+
+static bool build_line_offsets(void) {
+    if (tokenizer.line_offsets != NULL) {
+        return true;
+    }
+
+    if (tokenizer.source_start == NULL) {
+        return false;
+    }
+
+    u32 line_count = 1;
+    for (u32 i = 0; i < tokenizer.source_length; i++) {
+        line_count += tokenizer.source_start[i] == '\n';
+    }
+
+    if (tokenizer.vm->allocate_memory((void**) &tokenizer.line_offsets, sizeof(u32) * line_count) != ERROR_CODE_EXECUTION_SUCCESSFUL) {
+        tokenizer.line_offsets = NULL;
+        return false;
+    }
+
+    tokenizer.line_offsets[0] = 0;
+    tokenizer.line_count = 1;
+    for (u32 i = 0; i < tokenizer.source_length; i++) {
+        if (tokenizer.source_start[i] == '\n') {
+            tokenizer.line_offsets[tokenizer.line_count++] = i + 1;
+        }
+    }
+
+    return true;
+}
+
+static u32 find_line_index(u32 source_offset) { // binary search for the last line starting at or before @source_offset
+    u32 low = 0;
+    u32 high = tokenizer.line_count;
+    while (high - low > 1) {
+        u32 middle = low + (high - low) / 2;
+        if (tokenizer.line_offsets[middle] <= source_offset) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+
+    return low;
+}
+
+u32 wave_compiler_tokenizer_get_line(u32 source_offset) {
+    if (!build_line_offsets()) {
+        return 0;
+    }
+
+    return find_line_index(source_offset) + 1;
+}
+
+u32 wave_compiler_tokenizer_get_row(u32 source_offset) {
+    if (!build_line_offsets()) {
+        return 0;
+    }
+
+    return source_offset - tokenizer.line_offsets[find_line_index(source_offset)] + 1;
+}
 
 error_code wave_compiler_tokenizer_destroy(void) {
     const wave_memory_deallocation_function deallocate_memory = tokenizer.vm->deallocate_memory;
 
     #define TOKENIZER_DEALLOCATE(pointer) do { if (pointer != NULL) { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) pointer); pointer = NULL; } } while (0)
 
-    TOKENIZER_DEALLOCATE(tokenizer.token_stack_start);
+    TOKENIZER_DEALLOCATE(tokenizer.source_start);
+    TOKENIZER_DEALLOCATE(tokenizer.line_offsets);
+    TOKENIZER_DEALLOCATE(tokenizer.tokens);
+    TOKENIZER_DEALLOCATE(tokenizer.token_data_indices);
+    TOKENIZER_DEALLOCATE(tokenizer.token_source_offsets);
     TOKENIZER_DEALLOCATE(tokenizer.data_stack_start);
+    TOKENIZER_DEALLOCATE(tokenizer.identifiers);
+    RUN_ERROR_CODE_FUNCTION(wave_symbol_table_destroy, &tokenizer.identifier_table);
 
     #undef TOKENIZER_DEALLOCATE
 
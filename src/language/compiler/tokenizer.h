@@ -23,7 +23,14 @@ static void tokenize_identifier(str source, str* out_source);
 static wave_token tokenize_keyword(str source, str* out_source);
 static wave_token tokenize_operator(str source, str* out_source);
 
-error_code wave_compiler_tokenize(wave_vm* vm, str source, parse_token** out_tokenized_start, parse_token** out_tokenized_end, byte** out_data_stack_start, byte** out_data_stack_end);
+error_code wave_compiler_tokenize(wave_vm* vm, str source, wave_token_stream* out_tokens); // tokenizes the whole source at once
+
+error_code wave_compiler_tokenizer_begin_stream(wave_vm* vm, str source, wave_token_stream* out_tokens); // prepares tokenizing the source on demand, tokens are then requested via @wave_compiler_tokenizer_pull
+error_code wave_compiler_tokenizer_pull(wave_token_stream* tokens, u32 token_index); // tokenizes until the token at @token_index is available and updates @tokens, this invalidates the data indices of tokens read before
+
+u32 wave_compiler_tokenizer_get_line(u32 source_offset); // resolves a source offset of the last tokenized source to a line (starting at 1), returns 0 if it can't be resolved
+u32 wave_compiler_tokenizer_get_row(u32 source_offset); // resolves a source offset of the last tokenized source to a row (starting at 1), returns 0 if it can't be resolved
+
 error_code wave_compiler_tokenizer_destroy(void);
 
 #endif
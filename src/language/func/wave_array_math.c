@@ -0,0 +1,5 @@
+#include "language/api/wave_api_include_start.h"
+
+#include "wave_array_math.h"
+
+#include "language/api/wave_api_include_end.h"
@@ -0,0 +1,192 @@
+#ifndef WAVE_LANGUAGE_ARRAY_MATH
+#define WAVE_LANGUAGE_ARRAY_MATH
+
+// Includes
+
+#include "common/constants.h"
+#include "common/error_codes.h"
+
+#include "language/runtime/wave_array.h"
+#include "language/runtime/wave_array_kernels.h"
+
+#include "language/api/wave_api_include_header.h"
+
+// Defines
+
+/* reads the f32 array at @offset in the stack into @data_variable and its length into @length_variable,
+ * returns an error if the array is null or does not store 32bit values
+ * */
+
+#define WAVE_ARRAY_MATH_GET_F32_ARRAY(data_variable, length_variable, offset)  \
+    do {                                                                        \
+        str array = NULL; STACK_GET(array, offset);                             \
+        if (array == NULL) {                                                    \
+            return ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION;          \
+        }                                                                       \
+                                                                                \
+        u32 array_field = WAVE_ARRAY_GET_FIELD(array);                          \
+        if (WAVE_ARRAY_GET_VALUE_SIZE(array_field) != sizeof(f32)) {            \
+            return ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_TYPE_MISMATCH;             \
+        }                                                                       \
+                                                                                \
+        data_variable = (f32*) WAVE_ARRAY_GET_DATA(array, array_field);         \
+        length_variable = WAVE_ARRAY_GET_LENGTH(array_field);                   \
+    } while (0)
+
+#define WAVE_ARRAY_MATH_CHECK_LENGTH(length1, length2)                          \
+    do {                                                                        \
+        if ((length1) != (length2)) {                                           \
+            return ERROR_CODE_LANGUAGE_RUNTIME_INDEX_OUT_OF_BOUNDS;             \
+        }                                                                       \
+    } while (0)
+
+/* Array Math Functions
+*
+* All arrays need to store f32 values and have the same length, the destination may be one of the source arrays.
+* The package is f32 only: native functions are registered per element type and only the f32 kernels have
+* vector implementations (see "wave_array_kernels.h"). Arrays only record their value size, so arrays of 64bit, 16bit
+* or 8bit values fail with ARRAY_TYPE_MISMATCH, while the elements of i32 and u32 arrays would be read as f32.
+* f64 and integer arrays have to be processed element by element in scripts.
+* */
+
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_add, sizeof(addr) * 3,
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(addr) * 2);
+    f32* values1 = NULL; u32 values1_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values1, values1_length, sizeof(addr));
+    f32* values2 = NULL; u32 values2_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values2, values2_length, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values1_length);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values2_length);
+
+    wave_array_f32_add(destination, values1, values2, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 3);
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_mul, sizeof(addr) * 3,
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(addr) * 2);
+    f32* values1 = NULL; u32 values1_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values1, values1_length, sizeof(addr));
+    f32* values2 = NULL; u32 values2_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values2, values2_length, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values1_length);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values2_length);
+
+    wave_array_f32_mul(destination, values1, values2, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 3);
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_fma, sizeof(addr) * 4,
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(addr) * 3);
+    f32* values1 = NULL; u32 values1_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values1, values1_length, sizeof(addr) * 2);
+    f32* values2 = NULL; u32 values2_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values2, values2_length, sizeof(addr));
+    f32* values3 = NULL; u32 values3_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values3, values3_length, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values1_length);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values2_length);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values3_length);
+
+    wave_array_f32_fma(destination, values1, values2, values3, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 4);
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_sin, sizeof(addr) * 2,
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(addr));
+    f32* values = NULL; u32 values_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values, values_length, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values_length);
+
+    wave_array_f32_sin(destination, values, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 2);
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_cos, sizeof(addr) * 2,
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(addr));
+    f32* values = NULL; u32 values_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values, values_length, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values_length);
+
+    wave_array_f32_cos(destination, values, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 2);
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_clamp, sizeof(addr) * 2 + sizeof(f32) * 2,
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(f32) * 2 + sizeof(addr));
+    f32* values = NULL; u32 values_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values, values_length, sizeof(f32) * 2);
+    f32 min = 0.0F; STACK_GET_F32(min, sizeof(f32));
+    f32 max = 0.0F; STACK_GET_F32(max, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, values_length);
+
+    wave_array_f32_clamp(destination, values, min, max, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 2 + sizeof(f32) * 2);
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_lerp, sizeof(addr) * 3 + sizeof(f32),
+    f32* destination = NULL; u32 destination_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(destination, destination_length, sizeof(f32) + sizeof(addr) * 2);
+    f32* start = NULL; u32 start_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(start, start_length, sizeof(f32) + sizeof(addr));
+    f32* end = NULL; u32 end_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(end, end_length, sizeof(f32));
+    f32 delta = 0.0F; STACK_GET_F32(delta, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, start_length);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(destination_length, end_length);
+
+    wave_array_f32_lerp(destination, start, end, delta, destination_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 3 + sizeof(f32));
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+// Array Reduction Functions
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_sum, sizeof(addr),
+    f32* values = NULL; u32 values_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values, values_length, 0);
+
+    STACK_POP_BYTES(sizeof(addr));
+    STACK_PUSH_TYPE(f32, wave_array_f32_sum(values, values_length));
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_dot, sizeof(addr) * 2,
+    f32* values1 = NULL; u32 values1_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values1, values1_length, sizeof(addr));
+    f32* values2 = NULL; u32 values2_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values2, values2_length, 0);
+    WAVE_ARRAY_MATH_CHECK_LENGTH(values1_length, values2_length);
+
+    STACK_POP_BYTES(sizeof(addr) * 2);
+    STACK_PUSH_TYPE(f32, wave_array_f32_dot(values1, values2, values1_length));
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_min, sizeof(addr),
+    f32* values = NULL; u32 values_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values, values_length, 0);
+
+    STACK_POP_BYTES(sizeof(addr));
+    STACK_PUSH_TYPE(f32, wave_array_f32_min(values, values_length));
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+WAVE_VM_NATIVE_FUNCTION(array_math, f32_arr_max, sizeof(addr),
+    f32* values = NULL; u32 values_length = 0; WAVE_ARRAY_MATH_GET_F32_ARRAY(values, values_length, 0);
+
+    STACK_POP_BYTES(sizeof(addr));
+    STACK_PUSH_TYPE(f32, wave_array_f32_max(values, values_length));
+    *out_stack = stack;
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+)
+
+#include "language/api/wave_api_include_end.h"
+
+#endif
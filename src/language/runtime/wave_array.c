@@ -0,0 +1,165 @@
+#include "wave_array.h"
+
+#include "common/constants.h"
+#include "common/defines.h"
+
+#include "common/memory/memory.h"
+
+// Functions
+
+u32 wave_array_get_capacity(u32 length) {
+    u32 capacity = WAVE_ARRAY_DYNAMIC_MIN_CAPACITY;
+    while (capacity < length) {
+        capacity <<= 1;
+    }
+
+    return capacity;
+}
+
+void wave_array_fill_scalar(byte* data, u32 length, wave_type value_type, u64 value) {
+    switch (value_type) {
+        case WAVE_TYPE_U8:  { memory_set_8((u8*) data, (u8) value, length); break; }
+        case WAVE_TYPE_U16: { memory_set_16((u16*) data, (u16) value, length); break; }
+        case WAVE_TYPE_U32: { memory_set_32((u32*) data, (u32) value, length); break; }
+        case WAVE_TYPE_U64: { memory_set_64((u64*) data, (u64) value, length); break; }
+
+        default: {
+            break;
+        }
+    }
+}
+
+void wave_array_move_scalar(byte* destination, const byte* source, umax bytes) {
+    if (destination == source || bytes == 0) {
+        return;
+    }
+
+    // copy forwards if the destination lies in front of the source, otherwise copy backwards so overlapping ranges stay intact
+
+    if (destination < source || destination >= source + bytes) {
+        const byte* source_end = source + bytes;
+
+        #if PROGRAM_FEATURE_32BIT_MODE == 0
+        while ((source_end - source) >= sizeof(u64)) {
+            *((u64*) destination) = *((u64*) source);
+            source += sizeof(u64);
+            destination += sizeof(u64);
+        }
+        #else
+        while ((source_end - source) >= sizeof(u32)) {
+            *((u32*) destination) = *((u32*) source);
+            source += sizeof(u32);
+            destination += sizeof(u32);
+        }
+        #endif
+
+        while ((source_end - source) > 0) {
+            *destination = *source;
+            source++;
+            destination++;
+        }
+    } else {
+        const byte* source_start = source;
+
+        source += bytes;
+        destination += bytes;
+
+        #if PROGRAM_FEATURE_32BIT_MODE == 0
+        while ((source - source_start) >= sizeof(u64)) {
+            source -= sizeof(u64);
+            destination -= sizeof(u64);
+            *((u64*) destination) = *((u64*) source);
+        }
+        #else
+        while ((source - source_start) >= sizeof(u32)) {
+            source -= sizeof(u32);
+            destination -= sizeof(u32);
+            *((u32*) destination) = *((u32*) source);
+        }
+        #endif
+
+        while ((source - source_start) > 0) {
+            source--;
+            destination--;
+            *destination = *source;
+        }
+    }
+}
+
+u32 wave_array_find_scalar(const byte* data, u32 length, wave_type type, u64 value) {
+    u32 index = 0;
+
+    switch (type) {
+        case WAVE_TYPE_U8:
+        case WAVE_TYPE_I8: {
+            // compare a whole word of bytes at once and only fall back to single bytes once a word contains a match
+
+            #if PROGRAM_FEATURE_32BIT_MODE == 0
+            const u64 low_bits  = 0x0101010101010101ULL;
+            const u64 high_bits = 0x8080808080808080ULL;
+            const u64 pattern = ((u64) ((u8) value)) * low_bits;
+            while ((length - index) >= sizeof(u64)) {
+                u64 word = *((u64*) (data + index)) ^ pattern; // matching bytes become zero
+                if (((word - low_bits) & ~word & high_bits) != 0) {
+                    break;
+                }
+
+                index += sizeof(u64);
+            }
+            #else
+            const u32 low_bits  = 0x01010101;
+            const u32 high_bits = 0x80808080;
+            const u32 pattern = ((u32) ((u8) value)) * low_bits;
+            while ((length - index) >= sizeof(u32)) {
+                u32 word = *((u32*) (data + index)) ^ pattern; // matching bytes become zero
+                if (((word - low_bits) & ~word & high_bits) != 0) {
+                    break;
+                }
+
+                index += sizeof(u32);
+            }
+            #endif
+
+            for (; index < length; index++) {
+                if (data[index] == (u8) value) {
+                    return index;
+                }
+            }
+
+            break;
+        }
+
+        #define FIND_LOOP(type, compare_value)                  \
+            do {                                                \
+                const type* values = (const type*) data;        \
+                const type search_value = (compare_value);      \
+                for (; index < length; index++) {               \
+                    if (values[index] == search_value) {        \
+                        return index;                           \
+                    }                                           \
+                }                                               \
+            } while (0)
+
+        case WAVE_TYPE_U16:
+        case WAVE_TYPE_I16: { FIND_LOOP(u16, (u16) value); break; }
+
+        case WAVE_TYPE_U32:
+        case WAVE_TYPE_I32: { FIND_LOOP(u32, (u32) value); break; }
+
+        case WAVE_TYPE_U64:
+        case WAVE_TYPE_I64: { FIND_LOOP(u64, value); break; }
+
+        // floats are compared by value, so that 0.0 matches -0.0 and NaN never matches
+
+        case WAVE_TYPE_F32: { u32 temp = (u32) value; f32 float_value = 0.0F; memory_copy(&temp, &float_value, sizeof(f32)); FIND_LOOP(f32, float_value); break; }
+        case WAVE_TYPE_F64: { f64 float_value = 0.0; memory_copy(&value, &float_value, sizeof(f64)); FIND_LOOP(f64, float_value); break; }
+
+        #undef FIND_LOOP
+
+        default: {
+            break;
+        }
+    }
+
+    return U32_MAX;
+}
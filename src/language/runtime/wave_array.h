@@ -0,0 +1,56 @@
+#ifndef WAVE_LANGUAGE_ARRAY
+#define WAVE_LANGUAGE_ARRAY
+
+// Includes
+
+#include "common/constants.h"
+
+#include "language/wave_common.h"
+
+// Defines
+
+/* Array Structure
+*
+* ARRAY STRUCTURE: [ 32bit field : (2bit value_size, 1bit dynamic, 1bit view, 1bit sliced, 27bit length) | array data : (value...) ]
+* ARRAY VIEW STRUCTURE: [ 32bit field : (2bit value_size, 1bit dynamic, 1bit view, 1bit sliced, 27bit length) | addr data ]
+*
+*     @value_size - the size of each element as a power of two (8bit - 64bit), equivalent to @WAVE_TYPE_U8 - @WAVE_TYPE_U64
+*     @dynamic    - whether the array was grown by @OPCODE_EXT_ARR_PUSH, its allocated capacity is then @WAVE_ARRAY_GET_CAPACITY(@length)
+*     @view       - whether the array is a view (see @OPCODE_EXT_ARR_SLICE), views store a pointer to the data of another array
+*     @sliced     - whether a view of the array was created, its data is never moved from then on
+*     @length     - the amount of elements stored in the array
+*
+* Elements are stored unboxed and without padding. A view does not own its data
+* and must not outlive the array it was created from. Views are not tracked once they are
+* freed, which is why @sliced stays set for the lifetime of the array.
+* */
+
+#define WAVE_ARRAY_FIELD_VALUE_SIZE_SHIFT (U32_BIT_COUNT - 2)
+#define WAVE_ARRAY_FIELD_DYNAMIC_BIT (((u32) 0b1) << (U32_BIT_COUNT - 3))
+#define WAVE_ARRAY_FIELD_VIEW_BIT (((u32) 0b1) << (U32_BIT_COUNT - 4))
+#define WAVE_ARRAY_FIELD_SLICED_BIT (((u32) 0b1) << (U32_BIT_COUNT - 5))
+#define WAVE_ARRAY_FIELD_LENGTH_MASK (U32_BIT_1 >> 5)
+
+#define WAVE_ARRAY_LENGTH_MAX (WAVE_ARRAY_FIELD_LENGTH_MASK)
+#define WAVE_ARRAY_DYNAMIC_MIN_CAPACITY (8)
+
+#define WAVE_ARRAY_GET_FIELD(array) (*((u32*) (array)))
+#define WAVE_ARRAY_GET_LENGTH(field) ((field) & WAVE_ARRAY_FIELD_LENGTH_MASK)
+#define WAVE_ARRAY_GET_VALUE_TYPE(field) ((wave_type) (((field) >> WAVE_ARRAY_FIELD_VALUE_SIZE_SHIFT) & 0b11))
+#define WAVE_ARRAY_GET_VALUE_SIZE(field) (((umax) 0b1) << WAVE_ARRAY_GET_VALUE_TYPE(field))
+#define WAVE_ARRAY_GET_DATA(array, field) (((field) & WAVE_ARRAY_FIELD_VIEW_BIT) != 0 ? *((byte**) ((array) + sizeof(u32))) : ((byte*) (array) + sizeof(u32)))
+
+#define WAVE_ARRAY_CREATE_FIELD(value_type, length) ((((u32) (value_type)) << WAVE_ARRAY_FIELD_VALUE_SIZE_SHIFT) | ((length) & WAVE_ARRAY_FIELD_LENGTH_MASK))
+
+// Functions
+
+u32 wave_array_get_capacity(u32 length); // the capacity of a dynamic array holding @length elements (the next power of two, at least @WAVE_ARRAY_DYNAMIC_MIN_CAPACITY)
+
+// portable implementations, used as the scalar bulk kernels and for the remaining elements of the vector kernels,
+// the opcodes call the dispatching functions in "wave_array_kernels.h" instead
+
+void wave_array_fill_scalar(byte* data, u32 length, wave_type value_type, u64 value);
+void wave_array_move_scalar(byte* destination, const byte* source, umax bytes);
+u32 wave_array_find_scalar(const byte* data, u32 length, wave_type type, u64 value);
+
+#endif
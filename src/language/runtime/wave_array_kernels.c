@@ -0,0 +1,224 @@
+#include "wave_array_kernels.h"
+
+#include "common/constants.h"
+#include "common/defines.h"
+
+#include "language/runtime/wave_array.h"
+
+#if WAVE_ARRAY_KERNELS_X86 != 0
+#include <cpuid.h>
+#endif
+
+// Kernels
+
+#define WAVE_ARRAY_KERNELS_NAME scalar
+#define WAVE_ARRAY_KERNELS_ISA WAVE_ARRAY_KERNELS_ISA_SCALAR
+#include "wave_array_kernels_inline.h"
+
+#if WAVE_ARRAY_KERNELS_X86 != 0
+
+#define WAVE_ARRAY_KERNELS_NAME sse2
+#define WAVE_ARRAY_KERNELS_ISA WAVE_ARRAY_KERNELS_ISA_SSE2
+#include "wave_array_kernels_inline.h"
+
+#define WAVE_ARRAY_KERNELS_NAME avx2
+#define WAVE_ARRAY_KERNELS_ISA WAVE_ARRAY_KERNELS_ISA_AVX2
+#include "wave_array_kernels_inline.h"
+
+#define WAVE_ARRAY_KERNELS_NAME avx512
+#define WAVE_ARRAY_KERNELS_ISA WAVE_ARRAY_KERNELS_ISA_AVX512
+#include "wave_array_kernels_inline.h"
+
+#endif
+
+// Defines
+
+#define WAVE_ARRAY_KERNELS_XCR0_AVX (0x6) /* xmm and ymm state are saved by the operating system */
+#define WAVE_ARRAY_KERNELS_XCR0_AVX512 (0xE6) /* xmm, ymm, opmask and zmm state are saved by the operating system */
+
+#define WAVE_ARRAY_KERNELS_FEATURE_FMA (0b001)
+#define WAVE_ARRAY_KERNELS_FEATURE_AVX2 (0b010) /* also requires the operating system to save the ymm state */
+#define WAVE_ARRAY_KERNELS_FEATURE_AVX512 (0b100) /* AVX512F, also requires the operating system to save the zmm state */
+
+// partially overlapping arrays are left to the scalar kernels, which finish every element before reading the next one
+#define WAVE_ARRAY_KERNELS_OVERLAP(destination, source, length) ((destination) != (source) && (destination) < (source) + (length) && (source) < (destination) + (length))
+
+// Variables
+
+static const wave_array_f32_kernels* wave_array_f32_active_kernels = &wave_array_f32_kernels_scalar;
+static const wave_array_bulk_kernels* wave_array_bulk_active_kernels = &wave_array_bulk_kernels_scalar;
+
+// Functions
+
+#if WAVE_ARRAY_KERNELS_X86 != 0
+static u32 wave_array_get_kernel_features(void) {
+    u32 eax = 0;
+    u32 ebx = 0;
+    u32 ecx = 0;
+    u32 edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return 0; // sse2 is part of x86-64
+    }
+
+    u32 features = (ecx & bit_FMA) != 0 ? WAVE_ARRAY_KERNELS_FEATURE_FMA : 0;
+    bool os_saves_state = (ecx & bit_OSXSAVE) != 0;
+
+    u64 xcr0 = 0;
+    if (os_saves_state) {
+        u32 xcr0_low = 0;
+        u32 xcr0_high = 0;
+        __asm__ volatile ("xgetbv" : "=a" (xcr0_low), "=d" (xcr0_high) : "c" (0));
+        xcr0 = ((u64) xcr0_high << 32) | xcr0_low;
+    }
+
+    if (__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) == 0) {
+        return 0;
+    }
+
+    if ((ebx & bit_AVX2) != 0 && (xcr0 & WAVE_ARRAY_KERNELS_XCR0_AVX) == WAVE_ARRAY_KERNELS_XCR0_AVX) {
+        features |= WAVE_ARRAY_KERNELS_FEATURE_AVX2;
+    }
+
+    if ((ebx & bit_AVX512F) != 0 && (xcr0 & WAVE_ARRAY_KERNELS_XCR0_AVX512) == WAVE_ARRAY_KERNELS_XCR0_AVX512) {
+        features |= WAVE_ARRAY_KERNELS_FEATURE_AVX512;
+    }
+
+    return features;
+}
+#endif
+
+const wave_array_f32_kernels* wave_array_select_f32_kernels(void) {
+    #if WAVE_ARRAY_KERNELS_X86 != 0
+    u32 features = wave_array_get_kernel_features();
+    if ((features & WAVE_ARRAY_KERNELS_FEATURE_AVX512) != 0) {
+        return &wave_array_f32_kernels_avx512;
+    }
+
+    if ((features & WAVE_ARRAY_KERNELS_FEATURE_AVX2) != 0 && (features & WAVE_ARRAY_KERNELS_FEATURE_FMA) != 0) {
+        return &wave_array_f32_kernels_avx2;
+    }
+
+    return &wave_array_f32_kernels_sse2;
+    #else
+    return &wave_array_f32_kernels_scalar;
+    #endif
+}
+
+void wave_array_set_f32_kernels(const wave_array_f32_kernels* kernels) {
+    wave_array_f32_active_kernels = kernels;
+}
+
+const wave_array_bulk_kernels* wave_array_select_bulk_kernels(void) {
+    #if WAVE_ARRAY_KERNELS_X86 != 0
+    if ((wave_array_get_kernel_features() & WAVE_ARRAY_KERNELS_FEATURE_AVX2) != 0) {
+        return &wave_array_bulk_kernels_avx2;
+    }
+
+    return &wave_array_bulk_kernels_sse2;
+    #else
+    return &wave_array_bulk_kernels_scalar;
+    #endif
+}
+
+void wave_array_set_bulk_kernels(const wave_array_bulk_kernels* kernels) {
+    wave_array_bulk_active_kernels = kernels;
+}
+
+void wave_array_fill(byte* data, u32 length, wave_type value_type, u64 value) {
+    wave_array_bulk_active_kernels->fill(data, length, value_type, value);
+}
+
+void wave_array_move(byte* destination, const byte* source, umax bytes) {
+    if (destination == source || bytes == 0) {
+        return;
+    }
+
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, source, bytes)) {
+        wave_array_move_scalar(destination, source, bytes);
+    } else {
+        wave_array_bulk_active_kernels->copy(destination, source, bytes);
+    }
+}
+
+u32 wave_array_find(const byte* data, u32 length, wave_type type, u64 value) {
+    return wave_array_bulk_active_kernels->find(data, length, type, value);
+}
+
+void wave_array_f32_add(f32* destination, const f32* values1, const f32* values2, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, values1, length) || WAVE_ARRAY_KERNELS_OVERLAP(destination, values2, length)) {
+        wave_array_f32_add_scalar(destination, values1, values2, length);
+    } else {
+        wave_array_f32_active_kernels->add(destination, values1, values2, length);
+    }
+}
+
+void wave_array_f32_mul(f32* destination, const f32* values1, const f32* values2, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, values1, length) || WAVE_ARRAY_KERNELS_OVERLAP(destination, values2, length)) {
+        wave_array_f32_mul_scalar(destination, values1, values2, length);
+    } else {
+        wave_array_f32_active_kernels->mul(destination, values1, values2, length);
+    }
+}
+
+void wave_array_f32_fma(f32* destination, const f32* values1, const f32* values2, const f32* values3, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, values1, length) || WAVE_ARRAY_KERNELS_OVERLAP(destination, values2, length) || WAVE_ARRAY_KERNELS_OVERLAP(destination, values3, length)) {
+        wave_array_f32_fma_scalar(destination, values1, values2, values3, length);
+    } else {
+        wave_array_f32_active_kernels->fma(destination, values1, values2, values3, length);
+    }
+}
+
+void wave_array_f32_sin(f32* destination, const f32* values, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, values, length)) {
+        wave_array_f32_sin_scalar(destination, values, length);
+    } else {
+        wave_array_f32_active_kernels->sin(destination, values, length);
+    }
+}
+
+void wave_array_f32_cos(f32* destination, const f32* values, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, values, length)) {
+        wave_array_f32_cos_scalar(destination, values, length);
+    } else {
+        wave_array_f32_active_kernels->cos(destination, values, length);
+    }
+}
+
+void wave_array_f32_clamp(f32* destination, const f32* values, f32 min, f32 max, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, values, length)) {
+        wave_array_f32_clamp_scalar(destination, values, min, max, length);
+    } else {
+        wave_array_f32_active_kernels->clamp(destination, values, min, max, length);
+    }
+}
+
+void wave_array_f32_lerp(f32* destination, const f32* start, const f32* end, f32 delta, u32 length) {
+    if (WAVE_ARRAY_KERNELS_OVERLAP(destination, start, length) || WAVE_ARRAY_KERNELS_OVERLAP(destination, end, length)) {
+        wave_array_f32_lerp_scalar(destination, start, end, delta, length);
+    } else {
+        wave_array_f32_active_kernels->lerp(destination, start, end, delta, length);
+    }
+}
+
+f32 wave_array_f32_sum(const f32* values, u32 length) {
+    return wave_array_f32_active_kernels->sum(values, length);
+}
+
+f32 wave_array_f32_dot(const f32* values1, const f32* values2, u32 length) {
+    return wave_array_f32_active_kernels->dot(values1, values2, length);
+}
+
+f32 wave_array_f32_min(const f32* values, u32 length) {
+    return wave_array_f32_active_kernels->min(values, length);
+}
+
+f32 wave_array_f32_max(const f32* values, u32 length) {
+    return wave_array_f32_active_kernels->max(values, length);
+}
+
+#undef WAVE_ARRAY_KERNELS_XCR0_AVX
+#undef WAVE_ARRAY_KERNELS_XCR0_AVX512
+#undef WAVE_ARRAY_KERNELS_FEATURE_FMA
+#undef WAVE_ARRAY_KERNELS_FEATURE_AVX2
+#undef WAVE_ARRAY_KERNELS_FEATURE_AVX512
+#undef WAVE_ARRAY_KERNELS_OVERLAP
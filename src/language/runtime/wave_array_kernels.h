@@ -0,0 +1,76 @@
+#ifndef WAVE_LANGUAGE_ARRAY_KERNELS
+#define WAVE_LANGUAGE_ARRAY_KERNELS
+
+// Includes
+
+#include "common/constants.h"
+#include "common/defines.h"
+
+#include "language/wave_common.h"
+
+// Defines
+
+#if PROGRAM_FEATURE_SIMD != 0 && defined(__GNUC__) && defined(__x86_64__)
+    #define WAVE_ARRAY_KERNELS_X86 (1) /* SSE2, AVX2 and AVX-512 kernels are compiled in and picked at runtime (see @wave_array_select_f32_kernels) */
+#else
+    #define WAVE_ARRAY_KERNELS_X86 (0)
+#endif
+
+// Typedefs
+
+typedef struct {
+    cstr name; // name of the instruction set the kernels were compiled for
+
+    void (*add)(f32* destination, const f32* values1, const f32* values2, u32 length);
+    void (*mul)(f32* destination, const f32* values1, const f32* values2, u32 length);
+    void (*fma)(f32* destination, const f32* values1, const f32* values2, const f32* values3, u32 length);
+    void (*sin)(f32* destination, const f32* values, u32 length);
+    void (*cos)(f32* destination, const f32* values, u32 length);
+    void (*clamp)(f32* destination, const f32* values, f32 min, f32 max, u32 length);
+    void (*lerp)(f32* destination, const f32* start, const f32* end, f32 delta, u32 length);
+
+    f32 (*sum)(const f32* values, u32 length);
+    f32 (*dot)(const f32* values1, const f32* values2, u32 length);
+    f32 (*min)(const f32* values, u32 length);
+    f32 (*max)(const f32* values, u32 length);
+} wave_array_f32_kernels;
+
+typedef struct {
+    cstr name; // name of the instruction set the kernels were compiled for
+
+    void (*fill)(byte* data, u32 length, wave_type value_type, u64 value);
+    void (*copy)(byte* destination, const byte* source, umax bytes); // @destination and @source never overlap
+    u32 (*find)(const byte* data, u32 length, wave_type type, u64 value);
+} wave_array_bulk_kernels;
+
+// Functions
+
+const wave_array_f32_kernels* wave_array_select_f32_kernels(void); // the widest kernel set the cpu and the operating system support (cpuid), the portable kernels otherwise
+void wave_array_set_f32_kernels(const wave_array_f32_kernels* kernels); // sets the kernel set used by the f32 functions below, the portable kernels are used until this is called
+
+const wave_array_bulk_kernels* wave_array_select_bulk_kernels(void); // like @wave_array_select_f32_kernels, cpus with AVX-512 use the AVX2 kernels (byte and word compares would need AVX512BW)
+void wave_array_set_bulk_kernels(const wave_array_bulk_kernels* kernels); // sets the kernel set used by the bulk functions below, the portable kernels are used until this is called
+
+// bulk array kernels (used by the ARR_FILL, ARR_COPY and ARR_FIND opcodes), see @wave_array_fill_scalar, @wave_array_move_scalar and @wave_array_find_scalar
+
+void wave_array_fill(byte* data, u32 length, wave_type value_type, u64 value); // @value_type is the value size of the array (@WAVE_TYPE_U8 - @WAVE_TYPE_U64)
+void wave_array_move(byte* destination, const byte* source, umax bytes); // overlapping ranges are copied as if an intermediate buffer was used
+u32 wave_array_find(const byte* data, u32 length, wave_type type, u64 value); // returns U32_MAX if no element matches, floats are compared by value
+
+// f32 array kernels (used by the array math builtins), destination arrays may be one of the source arrays,
+// partially overlapping arrays (views) are processed one element after another
+
+void wave_array_f32_add(f32* destination, const f32* values1, const f32* values2, u32 length);
+void wave_array_f32_mul(f32* destination, const f32* values1, const f32* values2, u32 length);
+void wave_array_f32_fma(f32* destination, const f32* values1, const f32* values2, const f32* values3, u32 length); // @destination = @values1 * @values2 + @values3
+void wave_array_f32_sin(f32* destination, const f32* values, u32 length);
+void wave_array_f32_cos(f32* destination, const f32* values, u32 length);
+void wave_array_f32_clamp(f32* destination, const f32* values, f32 min, f32 max, u32 length);
+void wave_array_f32_lerp(f32* destination, const f32* start, const f32* end, f32 delta, u32 length);
+
+f32 wave_array_f32_sum(const f32* values, u32 length);
+f32 wave_array_f32_dot(const f32* values1, const f32* values2, u32 length);
+f32 wave_array_f32_min(const f32* values, u32 length); // returns 0 if @length is 0
+f32 wave_array_f32_max(const f32* values, u32 length); // returns 0 if @length is 0
+
+#endif
@@ -0,0 +1,657 @@
+#ifndef WAVE_LANGUAGE_ARRAY_KERNELS_INLINE
+#define WAVE_LANGUAGE_ARRAY_KERNELS_INLINE
+
+// Includes
+
+#include "common/constants.h"
+#include "common/defines.h"
+#include "common/macros.h"
+
+#include "common/math/primitives/f32_math.h"
+
+#include "language/runtime/wave_array.h"
+#include "language/runtime/wave_array_kernels.h"
+
+#if WAVE_ARRAY_KERNELS_X86 != 0
+#include <immintrin.h>
+#endif
+
+// Defines
+
+#define WAVE_ARRAY_KERNELS_ISA_SCALAR (0)
+#define WAVE_ARRAY_KERNELS_ISA_SSE2 (1)
+#define WAVE_ARRAY_KERNELS_ISA_AVX2 (2)
+#define WAVE_ARRAY_KERNELS_ISA_AVX512 (3)
+
+// sin and cos use the single precision cephes approximation (reduction by pi/4, one polynomial per octant),
+// which is accurate to a few ulp for |x| <= @WAVE_ARRAY_KERNELS_SIN_COS_LIMIT, larger values, nan and inf fall back to @f32_sin and @f32_cos
+
+#define WAVE_ARRAY_KERNELS_SIN_COS_LIMIT (8192.0F)
+
+#define WAVE_ARRAY_KERNELS_FOUR_OVER_PI (1.27323954473516F)
+#define WAVE_ARRAY_KERNELS_PI_OVER_FOUR_1 (0.78515625F)
+#define WAVE_ARRAY_KERNELS_PI_OVER_FOUR_2 (2.4187564849853515625E-4F)
+#define WAVE_ARRAY_KERNELS_PI_OVER_FOUR_3 (3.77489497744594108E-8F)
+
+#define WAVE_ARRAY_KERNELS_COS_0 (2.443315711809948E-5F)
+#define WAVE_ARRAY_KERNELS_COS_1 (-1.388731625493765E-3F)
+#define WAVE_ARRAY_KERNELS_COS_2 (4.166664568298827E-2F)
+
+#define WAVE_ARRAY_KERNELS_SIN_0 (-1.9515295891E-4F)
+#define WAVE_ARRAY_KERNELS_SIN_1 (8.3321608736E-3F)
+#define WAVE_ARRAY_KERNELS_SIN_2 (-1.6666654611E-1F)
+
+#endif
+
+// compile-time dependent kernels
+
+#ifndef WAVE_ARRAY_KERNELS_NAME
+#define WAVE_ARRAY_KERNELS_NAME scalar /* the suffix of every kernel and of the kernel set */
+#endif
+
+#ifndef WAVE_ARRAY_KERNELS_ISA
+#define WAVE_ARRAY_KERNELS_ISA WAVE_ARRAY_KERNELS_ISA_SCALAR /* the instruction set the kernels are written in */
+#endif
+
+#define KERNEL(name) CAT3(wave_array_f32_, name, CAT(_, WAVE_ARRAY_KERNELS_NAME))
+#define BULK_KERNEL(name) CAT3(wave_array_, name, CAT(_, WAVE_ARRAY_KERNELS_NAME))
+#define KERNEL_STRINGIFY(name) STRINGIFY(name)
+
+/* Vector Operations
+*
+* VF is a vector of @VECTOR_WIDTH f32 values, VI a vector of as many i32 values and VM a lane mask.
+* The scalar instruction set is a vector of width 1, so that every kernel only needs to be written once.
+* VF_MIN and VF_MAX return the second operand if either operand is nan, like minps and maxps do.
+* */
+
+#if WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_SCALAR
+    #define KERNEL_ATTRIBUTES
+
+    #define VECTOR_WIDTH (1)
+    #define VF f32
+    #define VI i32
+    #define VM bool
+
+    #define VF_LOAD(pointer) (*(pointer))
+    #define VF_STORE(pointer, value) (*(pointer) = (value))
+    #define VF_SET(value) ((f32) (value))
+
+    #define VF_ADD(value1, value2) ((value1) + (value2))
+    #define VF_SUB(value1, value2) ((value1) - (value2))
+    #define VF_MUL(value1, value2) ((value1) * (value2))
+    #define VF_FMA(value1, value2, value3) ((value1) * (value2) + (value3))
+    #define VF_MIN(value1, value2) ((value1) < (value2) ? (value1) : (value2))
+    #define VF_MAX(value1, value2) ((value1) > (value2) ? (value1) : (value2))
+
+    #define VF_AS_VI(value) (((union { f32 value_f32; i32 value_i32; }) { .value_f32 = (value) }).value_i32)
+    #define VI_AS_VF(value) (((union { f32 value_f32; i32 value_i32; }) { .value_i32 = (value) }).value_f32)
+    #define VF_TO_VI(value) ((i32) (value))
+    #define VI_TO_VF(value) ((f32) (value))
+
+    #define VI_SET(value) ((i32) (value))
+    #define VI_ADD(value1, value2) ((value1) + (value2))
+    #define VI_SUB(value1, value2) ((value1) - (value2))
+    #define VI_AND(value1, value2) ((value1) & (value2))
+    #define VI_AND_NOT(value1, value2) (~(value1) & (value2))
+    #define VI_XOR(value1, value2) ((value1) ^ (value2))
+    #define VI_SHIFT_LEFT(value, amount) ((i32) ((u32) (value) << (amount)))
+
+    #define VM_VI_ZERO(value) ((value) == 0)
+    #define VM_ANY_NOT_LESS_EQUAL(value1, value2) (!((value1) <= (value2)))
+    #define VF_SELECT(mask, value1, value2) ((mask) ? (value1) : (value2))
+#elif WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_SSE2
+    #define KERNEL_ATTRIBUTES __attribute__((target("sse2")))
+
+    #define VECTOR_WIDTH (4)
+    #define VF __m128
+    #define VI __m128i
+    #define VM __m128
+
+    #define VF_LOAD(pointer) _mm_loadu_ps(pointer)
+    #define VF_STORE(pointer, value) _mm_storeu_ps(pointer, value)
+    #define VF_SET(value) _mm_set1_ps(value)
+
+    #define VF_ADD(value1, value2) _mm_add_ps(value1, value2)
+    #define VF_SUB(value1, value2) _mm_sub_ps(value1, value2)
+    #define VF_MUL(value1, value2) _mm_mul_ps(value1, value2)
+    #define VF_FMA(value1, value2, value3) _mm_add_ps(_mm_mul_ps(value1, value2), value3)
+    #define VF_MIN(value1, value2) _mm_min_ps(value1, value2)
+    #define VF_MAX(value1, value2) _mm_max_ps(value1, value2)
+
+    #define VF_AS_VI(value) _mm_castps_si128(value)
+    #define VI_AS_VF(value) _mm_castsi128_ps(value)
+    #define VF_TO_VI(value) _mm_cvttps_epi32(value)
+    #define VI_TO_VF(value) _mm_cvtepi32_ps(value)
+
+    #define VI_SET(value) _mm_set1_epi32(value)
+    #define VI_ADD(value1, value2) _mm_add_epi32(value1, value2)
+    #define VI_SUB(value1, value2) _mm_sub_epi32(value1, value2)
+    #define VI_AND(value1, value2) _mm_and_si128(value1, value2)
+    #define VI_AND_NOT(value1, value2) _mm_andnot_si128(value1, value2)
+    #define VI_XOR(value1, value2) _mm_xor_si128(value1, value2)
+    #define VI_SHIFT_LEFT(value, amount) _mm_slli_epi32(value, amount)
+
+    #define VM_VI_ZERO(value) _mm_castsi128_ps(_mm_cmpeq_epi32(value, _mm_setzero_si128()))
+    #define VM_ANY_NOT_LESS_EQUAL(value1, value2) (_mm_movemask_ps(_mm_cmpnle_ps(value1, value2)) != 0)
+    #define VF_SELECT(mask, value1, value2) _mm_or_ps(_mm_and_ps(mask, value1), _mm_andnot_ps(mask, value2))
+#elif WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_AVX2
+    #define KERNEL_ATTRIBUTES __attribute__((target("avx2,fma")))
+
+    #define VECTOR_WIDTH (8)
+    #define VF __m256
+    #define VI __m256i
+    #define VM __m256
+
+    #define VF_LOAD(pointer) _mm256_loadu_ps(pointer)
+    #define VF_STORE(pointer, value) _mm256_storeu_ps(pointer, value)
+    #define VF_SET(value) _mm256_set1_ps(value)
+
+    #define VF_ADD(value1, value2) _mm256_add_ps(value1, value2)
+    #define VF_SUB(value1, value2) _mm256_sub_ps(value1, value2)
+    #define VF_MUL(value1, value2) _mm256_mul_ps(value1, value2)
+    #define VF_FMA(value1, value2, value3) _mm256_fmadd_ps(value1, value2, value3)
+    #define VF_MIN(value1, value2) _mm256_min_ps(value1, value2)
+    #define VF_MAX(value1, value2) _mm256_max_ps(value1, value2)
+
+    #define VF_AS_VI(value) _mm256_castps_si256(value)
+    #define VI_AS_VF(value) _mm256_castsi256_ps(value)
+    #define VF_TO_VI(value) _mm256_cvttps_epi32(value)
+    #define VI_TO_VF(value) _mm256_cvtepi32_ps(value)
+
+    #define VI_SET(value) _mm256_set1_epi32(value)
+    #define VI_ADD(value1, value2) _mm256_add_epi32(value1, value2)
+    #define VI_SUB(value1, value2) _mm256_sub_epi32(value1, value2)
+    #define VI_AND(value1, value2) _mm256_and_si256(value1, value2)
+    #define VI_AND_NOT(value1, value2) _mm256_andnot_si256(value1, value2)
+    #define VI_XOR(value1, value2) _mm256_xor_si256(value1, value2)
+    #define VI_SHIFT_LEFT(value, amount) _mm256_slli_epi32(value, amount)
+
+    #define VM_VI_ZERO(value) _mm256_castsi256_ps(_mm256_cmpeq_epi32(value, _mm256_setzero_si256()))
+    #define VM_ANY_NOT_LESS_EQUAL(value1, value2) (_mm256_movemask_ps(_mm256_cmp_ps(value1, value2, _CMP_NLE_UQ)) != 0)
+    #define VF_SELECT(mask, value1, value2) _mm256_blendv_ps(value2, value1, mask)
+#elif WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_AVX512
+    #define KERNEL_ATTRIBUTES __attribute__((target("avx512f")))
+
+    #define VECTOR_WIDTH (16)
+    #define VF __m512
+    #define VI __m512i
+    #define VM __mmask16
+
+    #define VF_LOAD(pointer) _mm512_loadu_ps(pointer)
+    #define VF_STORE(pointer, value) _mm512_storeu_ps(pointer, value)
+    #define VF_SET(value) _mm512_set1_ps(value)
+
+    #define VF_ADD(value1, value2) _mm512_add_ps(value1, value2)
+    #define VF_SUB(value1, value2) _mm512_sub_ps(value1, value2)
+    #define VF_MUL(value1, value2) _mm512_mul_ps(value1, value2)
+    #define VF_FMA(value1, value2, value3) _mm512_fmadd_ps(value1, value2, value3)
+    #define VF_MIN(value1, value2) _mm512_min_ps(value1, value2)
+    #define VF_MAX(value1, value2) _mm512_max_ps(value1, value2)
+
+    #define VF_AS_VI(value) _mm512_castps_si512(value)
+    #define VI_AS_VF(value) _mm512_castsi512_ps(value)
+    #define VF_TO_VI(value) _mm512_cvttps_epi32(value)
+    #define VI_TO_VF(value) _mm512_cvtepi32_ps(value)
+
+    #define VI_SET(value) _mm512_set1_epi32(value)
+    #define VI_ADD(value1, value2) _mm512_add_epi32(value1, value2)
+    #define VI_SUB(value1, value2) _mm512_sub_epi32(value1, value2)
+    #define VI_AND(value1, value2) _mm512_and_si512(value1, value2)
+    #define VI_AND_NOT(value1, value2) _mm512_andnot_si512(value1, value2)
+    #define VI_XOR(value1, value2) _mm512_xor_si512(value1, value2)
+    #define VI_SHIFT_LEFT(value, amount) _mm512_slli_epi32(value, amount)
+
+    #define VM_VI_ZERO(value) _mm512_cmpeq_epi32_mask(value, _mm512_setzero_si512())
+    #define VM_ANY_NOT_LESS_EQUAL(value1, value2) (_mm512_cmp_ps_mask(value1, value2, _CMP_NLE_UQ) != 0)
+    #define VF_SELECT(mask, value1, value2) _mm512_mask_blend_ps(mask, value2, value1)
+#endif
+
+#define VF_ABS(value) VI_AS_VF(VI_AND(VF_AS_VI(value), VI_SET(I32_MAX)))
+
+/* Byte Vector Operations
+*
+* VB is a vector of @VB_WIDTH bytes used by the bulk kernels (fill, copy, find), which only exist for SSE2 and AVX2.
+* VB_CMPEQ_x sets all bytes of the x bit lanes that are equal and VB_MASK gathers the highest bit of every byte,
+* so the first match starts at the byte index of the lowest set bit.
+* */
+
+#if WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_SSE2
+    #define VB_WIDTH (16)
+    #define VB __m128i
+
+    #define VB_LOAD(pointer) _mm_loadu_si128((const __m128i*) (pointer))
+    #define VB_STORE(pointer, value) _mm_storeu_si128((__m128i*) (pointer), value)
+    #define VB_SET_8(value) _mm_set1_epi8((i8) (value))
+    #define VB_SET_16(value) _mm_set1_epi16((i16) (value))
+    #define VB_SET_32(value) _mm_set1_epi32((i32) (value))
+    #define VB_SET_64(value) _mm_set1_epi64x((i64) (value))
+
+    #define VB_CMPEQ_8(value1, value2) _mm_cmpeq_epi8(value1, value2)
+    #define VB_CMPEQ_16(value1, value2) _mm_cmpeq_epi16(value1, value2)
+    #define VB_CMPEQ_32(value1, value2) _mm_cmpeq_epi32(value1, value2)
+    #define VB_CMPEQ_64(value1, value2) _mm_and_si128(_mm_cmpeq_epi32(value1, value2), _mm_shuffle_epi32(_mm_cmpeq_epi32(value1, value2), _MM_SHUFFLE(2, 3, 0, 1))) /* SSE2 has no 64bit compare, both halves have to match */
+    #define VB_CMPEQ_F32(value1, value2) _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(value1), _mm_castsi128_ps(value2)))
+    #define VB_CMPEQ_F64(value1, value2) _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(value1), _mm_castsi128_pd(value2)))
+    #define VB_MASK(value) ((u32) _mm_movemask_epi8(value))
+#elif WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_AVX2
+    #define VB_WIDTH (32)
+    #define VB __m256i
+
+    #define VB_LOAD(pointer) _mm256_loadu_si256((const __m256i*) (pointer))
+    #define VB_STORE(pointer, value) _mm256_storeu_si256((__m256i*) (pointer), value)
+    #define VB_SET_8(value) _mm256_set1_epi8((i8) (value))
+    #define VB_SET_16(value) _mm256_set1_epi16((i16) (value))
+    #define VB_SET_32(value) _mm256_set1_epi32((i32) (value))
+    #define VB_SET_64(value) _mm256_set1_epi64x((i64) (value))
+
+    #define VB_CMPEQ_8(value1, value2) _mm256_cmpeq_epi8(value1, value2)
+    #define VB_CMPEQ_16(value1, value2) _mm256_cmpeq_epi16(value1, value2)
+    #define VB_CMPEQ_32(value1, value2) _mm256_cmpeq_epi32(value1, value2)
+    #define VB_CMPEQ_64(value1, value2) _mm256_cmpeq_epi64(value1, value2)
+    #define VB_CMPEQ_F32(value1, value2) _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(value1), _mm256_castsi256_ps(value2), _CMP_EQ_OQ))
+    #define VB_CMPEQ_F64(value1, value2) _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(value1), _mm256_castsi256_pd(value2), _CMP_EQ_OQ))
+    #define VB_MASK(value) ((u32) _mm256_movemask_epi8(value))
+#endif
+
+// element-wise kernels process @VECTOR_WIDTH elements per iteration, the remaining elements are passed to the scalar kernels
+
+#define KERNEL_LOOP(...)                                                \
+    u32 index = 0;                                                      \
+    for (; index + VECTOR_WIDTH <= length; index += VECTOR_WIDTH) {     \
+        __VA_ARGS__;                                                    \
+    }
+
+// reductions keep 4 independent accumulators, so consecutive iterations do not depend on each other
+
+#define KERNEL_REDUCE(initial_value, statement, combine, combine_scalar)                                \
+    VF result0 = VF_SET(initial_value);                                                                 \
+    VF result1 = result0;                                                                               \
+    VF result2 = result0;                                                                               \
+    VF result3 = result0;                                                                               \
+                                                                                                        \
+    u32 index = 0;                                                                                      \
+    for (; index + VECTOR_WIDTH * 4 <= length; index += VECTOR_WIDTH * 4) {                             \
+        { VF* result = &result0; const u32 i = index + VECTOR_WIDTH * 0; statement; }                   \
+        { VF* result = &result1; const u32 i = index + VECTOR_WIDTH * 1; statement; }                   \
+        { VF* result = &result2; const u32 i = index + VECTOR_WIDTH * 2; statement; }                   \
+        { VF* result = &result3; const u32 i = index + VECTOR_WIDTH * 3; statement; }                   \
+    }                                                                                                   \
+                                                                                                        \
+    for (; index + VECTOR_WIDTH <= length; index += VECTOR_WIDTH) {                                     \
+        VF* result = &result0; const u32 i = index; statement;                                          \
+    }                                                                                                   \
+                                                                                                        \
+    f32 lanes[VECTOR_WIDTH];                                                                            \
+    VF_STORE(lanes, combine(combine(result0, result1), combine(result2, result3)));                     \
+                                                                                                        \
+    f32 value = lanes[0];                                                                               \
+    for (u32 lane = 1; lane < VECTOR_WIDTH; lane++) {                                                   \
+        value = combine_scalar(lanes[lane], value);                                                     \
+    }
+
+#define KERNEL_SCALAR_ADD(value1, value2) ((value1) + (value2))
+#define KERNEL_SCALAR_MIN(value1, value2) ((value1) < (value2) ? (value1) : (value2))
+#define KERNEL_SCALAR_MAX(value1, value2) ((value1) > (value2) ? (value1) : (value2))
+
+// Functions
+
+static KERNEL_ATTRIBUTES inline VF KERNEL(sin_cos)(VF values, bool cosine) {
+    VI sign = cosine ? VI_SET(0) : VI_AND(VF_AS_VI(values), VI_SET(I32_MIN));
+    VF x = VF_ABS(values);
+
+    // octant (rounded up to an even number) and the reduction of x into [-pi/4, pi/4]
+    VI octant = VF_TO_VI(VF_MUL(x, VF_SET(WAVE_ARRAY_KERNELS_FOUR_OVER_PI)));
+    octant = VI_AND(VI_ADD(octant, VI_SET(1)), VI_SET(~1));
+    VF y = VI_TO_VF(octant);
+
+    if (cosine) {
+        octant = VI_SUB(octant, VI_SET(2));
+        sign = VI_SHIFT_LEFT(VI_AND_NOT(octant, VI_SET(4)), 29);
+    } else {
+        sign = VI_XOR(sign, VI_SHIFT_LEFT(VI_AND(octant, VI_SET(4)), 29));
+    }
+
+    VM sin_polynomial = VM_VI_ZERO(VI_AND(octant, VI_SET(2)));
+
+    x = VF_FMA(y, VF_SET(-WAVE_ARRAY_KERNELS_PI_OVER_FOUR_1), x);
+    x = VF_FMA(y, VF_SET(-WAVE_ARRAY_KERNELS_PI_OVER_FOUR_2), x);
+    x = VF_FMA(y, VF_SET(-WAVE_ARRAY_KERNELS_PI_OVER_FOUR_3), x);
+    VF z = VF_MUL(x, x);
+
+    VF cos_value = VF_FMA(VF_SET(WAVE_ARRAY_KERNELS_COS_0), z, VF_SET(WAVE_ARRAY_KERNELS_COS_1));
+    cos_value = VF_FMA(cos_value, z, VF_SET(WAVE_ARRAY_KERNELS_COS_2));
+    cos_value = VF_MUL(VF_MUL(cos_value, z), z);
+    cos_value = VF_FMA(z, VF_SET(-0.5F), cos_value);
+    cos_value = VF_ADD(cos_value, VF_SET(1.0F));
+
+    VF sin_value = VF_FMA(VF_SET(WAVE_ARRAY_KERNELS_SIN_0), z, VF_SET(WAVE_ARRAY_KERNELS_SIN_1));
+    sin_value = VF_FMA(sin_value, z, VF_SET(WAVE_ARRAY_KERNELS_SIN_2));
+    sin_value = VF_MUL(sin_value, z);
+    sin_value = VF_FMA(sin_value, x, x);
+
+    VF result = VF_SELECT(sin_polynomial, sin_value, cos_value);
+    return VI_AS_VF(VI_XOR(VF_AS_VI(result), sign));
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(add)(f32* destination, const f32* values1, const f32* values2, u32 length) {
+    KERNEL_LOOP(VF_STORE(destination + index, VF_ADD(VF_LOAD(values1 + index), VF_LOAD(values2 + index))));
+
+    if (index < length) {
+        wave_array_f32_add_scalar(destination + index, values1 + index, values2 + index, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(mul)(f32* destination, const f32* values1, const f32* values2, u32 length) {
+    KERNEL_LOOP(VF_STORE(destination + index, VF_MUL(VF_LOAD(values1 + index), VF_LOAD(values2 + index))));
+
+    if (index < length) {
+        wave_array_f32_mul_scalar(destination + index, values1 + index, values2 + index, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(fma)(f32* destination, const f32* values1, const f32* values2, const f32* values3, u32 length) {
+    KERNEL_LOOP(VF_STORE(destination + index, VF_FMA(VF_LOAD(values1 + index), VF_LOAD(values2 + index), VF_LOAD(values3 + index))));
+
+    if (index < length) {
+        wave_array_f32_fma_scalar(destination + index, values1 + index, values2 + index, values3 + index, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(sin)(f32* destination, const f32* values, u32 length) {
+    KERNEL_LOOP(
+        VF vector = VF_LOAD(values + index);
+        if (VM_ANY_NOT_LESS_EQUAL(VF_ABS(vector), VF_SET(WAVE_ARRAY_KERNELS_SIN_COS_LIMIT))) {
+            for (u32 lane = 0; lane < VECTOR_WIDTH; lane++) {
+                destination[index + lane] = f32_sin(values[index + lane]);
+            }
+        } else {
+            VF_STORE(destination + index, KERNEL(sin_cos)(vector, false));
+        }
+    );
+
+    if (index < length) {
+        wave_array_f32_sin_scalar(destination + index, values + index, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(cos)(f32* destination, const f32* values, u32 length) {
+    KERNEL_LOOP(
+        VF vector = VF_LOAD(values + index);
+        if (VM_ANY_NOT_LESS_EQUAL(VF_ABS(vector), VF_SET(WAVE_ARRAY_KERNELS_SIN_COS_LIMIT))) {
+            for (u32 lane = 0; lane < VECTOR_WIDTH; lane++) {
+                destination[index + lane] = f32_cos(values[index + lane]);
+            }
+        } else {
+            VF_STORE(destination + index, KERNEL(sin_cos)(vector, true));
+        }
+    );
+
+    if (index < length) {
+        wave_array_f32_cos_scalar(destination + index, values + index, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(clamp)(f32* destination, const f32* values, f32 min, f32 max, u32 length) {
+    VF min_vector = VF_SET(min);
+    VF max_vector = VF_SET(max);
+    KERNEL_LOOP(VF_STORE(destination + index, VF_MAX(min_vector, VF_MIN(max_vector, VF_LOAD(values + index)))));
+
+    if (index < length) {
+        wave_array_f32_clamp_scalar(destination + index, values + index, min, max, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES void KERNEL(lerp)(f32* destination, const f32* start, const f32* end, f32 delta, u32 length) {
+    VF delta_vector = VF_SET(delta);
+    KERNEL_LOOP(
+        VF start_vector = VF_LOAD(start + index);
+        VF_STORE(destination + index, VF_FMA(delta_vector, VF_SUB(VF_LOAD(end + index), start_vector), start_vector));
+    );
+
+    if (index < length) {
+        wave_array_f32_lerp_scalar(destination + index, start + index, end + index, delta, length - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES f32 KERNEL(sum)(const f32* values, u32 length) {
+    KERNEL_REDUCE(0.0F, *result = VF_ADD(*result, VF_LOAD(values + i)), VF_ADD, KERNEL_SCALAR_ADD);
+
+    for (; index < length; index++) {
+        value += values[index];
+    }
+
+    return value;
+}
+
+static KERNEL_ATTRIBUTES f32 KERNEL(dot)(const f32* values1, const f32* values2, u32 length) {
+    KERNEL_REDUCE(0.0F, *result = VF_FMA(VF_LOAD(values1 + i), VF_LOAD(values2 + i), *result), VF_ADD, KERNEL_SCALAR_ADD);
+
+    for (; index < length; index++) {
+        value += values1[index] * values2[index];
+    }
+
+    return value;
+}
+
+static KERNEL_ATTRIBUTES f32 KERNEL(min)(const f32* values, u32 length) {
+    if (length == 0) {
+        return 0.0F;
+    }
+
+    KERNEL_REDUCE(values[0], *result = VF_MIN(VF_LOAD(values + i), *result), VF_MIN, KERNEL_SCALAR_MIN);
+
+    for (; index < length; index++) {
+        value = KERNEL_SCALAR_MIN(values[index], value);
+    }
+
+    return value;
+}
+
+static KERNEL_ATTRIBUTES f32 KERNEL(max)(const f32* values, u32 length) {
+    if (length == 0) {
+        return 0.0F;
+    }
+
+    KERNEL_REDUCE(values[0], *result = VF_MAX(VF_LOAD(values + i), *result), VF_MAX, KERNEL_SCALAR_MAX);
+
+    for (; index < length; index++) {
+        value = KERNEL_SCALAR_MAX(values[index], value);
+    }
+
+    return value;
+}
+
+static const wave_array_f32_kernels CAT(wave_array_f32_kernels_, WAVE_ARRAY_KERNELS_NAME) = {
+    .name = KERNEL_STRINGIFY(WAVE_ARRAY_KERNELS_NAME),
+
+    .add = KERNEL(add),
+    .mul = KERNEL(mul),
+    .fma = KERNEL(fma),
+    .sin = KERNEL(sin),
+    .cos = KERNEL(cos),
+    .clamp = KERNEL(clamp),
+    .lerp = KERNEL(lerp),
+
+    .sum = KERNEL(sum),
+    .dot = KERNEL(dot),
+    .min = KERNEL(min),
+    .max = KERNEL(max)
+};
+
+#if WAVE_ARRAY_KERNELS_ISA == WAVE_ARRAY_KERNELS_ISA_SCALAR
+
+static const wave_array_bulk_kernels wave_array_bulk_kernels_scalar = {
+    .name = "scalar",
+
+    .fill = wave_array_fill_scalar,
+    .copy = wave_array_move_scalar,
+    .find = wave_array_find_scalar
+};
+
+#elif defined(VB)
+
+static KERNEL_ATTRIBUTES void BULK_KERNEL(fill)(byte* data, u32 length, wave_type value_type, u64 value) {
+    VB pattern;
+    switch (value_type) {
+        case WAVE_TYPE_U8:  { pattern = VB_SET_8(value); break; }
+        case WAVE_TYPE_U16: { pattern = VB_SET_16(value); break; }
+        case WAVE_TYPE_U32: { pattern = VB_SET_32(value); break; }
+        case WAVE_TYPE_U64: { pattern = VB_SET_64(value); break; }
+
+        default: {
+            return;
+        }
+    }
+
+    umax bytes = (umax) length << value_type;
+    umax index = 0;
+    for (; index + VB_WIDTH <= bytes; index += VB_WIDTH) {
+        VB_STORE(data + index, pattern);
+    }
+
+    if (index < bytes) {
+        wave_array_fill_scalar(data + index, (u32) ((bytes - index) >> value_type), value_type, value);
+    }
+}
+
+static KERNEL_ATTRIBUTES void BULK_KERNEL(copy)(byte* destination, const byte* source, umax bytes) {
+    umax index = 0;
+    for (; index + VB_WIDTH * 4 <= bytes; index += VB_WIDTH * 4) {
+        VB vector0 = VB_LOAD(source + index + VB_WIDTH * 0);
+        VB vector1 = VB_LOAD(source + index + VB_WIDTH * 1);
+        VB vector2 = VB_LOAD(source + index + VB_WIDTH * 2);
+        VB vector3 = VB_LOAD(source + index + VB_WIDTH * 3);
+        VB_STORE(destination + index + VB_WIDTH * 0, vector0);
+        VB_STORE(destination + index + VB_WIDTH * 1, vector1);
+        VB_STORE(destination + index + VB_WIDTH * 2, vector2);
+        VB_STORE(destination + index + VB_WIDTH * 3, vector3);
+    }
+
+    for (; index + VB_WIDTH <= bytes; index += VB_WIDTH) {
+        VB_STORE(destination + index, VB_LOAD(source + index));
+    }
+
+    if (index < bytes) {
+        wave_array_move_scalar(destination + index, source + index, bytes - index);
+    }
+}
+
+static KERNEL_ATTRIBUTES u32 BULK_KERNEL(find)(const byte* data, u32 length, wave_type type, u64 value) {
+    #define FIND_LOOP(size_shift, pattern, compare)                                                                         \
+        do {                                                                                                                \
+            const VB search_pattern = (pattern);                                                                            \
+            const umax bytes = (umax) length << (size_shift);                                                               \
+            umax index = 0;                                                                                                 \
+            for (; index + VB_WIDTH <= bytes; index += VB_WIDTH) {                                                          \
+                u32 mask = VB_MASK(compare(VB_LOAD(data + index), search_pattern));                                         \
+                if (mask != 0) {                                                                                            \
+                    return (u32) ((index + (umax) __builtin_ctz(mask)) >> (size_shift));                                    \
+                }                                                                                                           \
+            }                                                                                                               \
+                                                                                                                            \
+            u32 result = wave_array_find_scalar(data + index, (u32) ((bytes - index) >> (size_shift)), type, value);       \
+            return result == U32_MAX ? U32_MAX : (u32) (index >> (size_shift)) + result;                                    \
+        } while (0)
+
+    switch (type) {
+        case WAVE_TYPE_U8:
+        case WAVE_TYPE_I8: { FIND_LOOP(0, VB_SET_8(value), VB_CMPEQ_8); }
+
+        case WAVE_TYPE_U16:
+        case WAVE_TYPE_I16: { FIND_LOOP(1, VB_SET_16(value), VB_CMPEQ_16); }
+
+        case WAVE_TYPE_U32:
+        case WAVE_TYPE_I32: { FIND_LOOP(2, VB_SET_32(value), VB_CMPEQ_32); }
+
+        case WAVE_TYPE_U64:
+        case WAVE_TYPE_I64: { FIND_LOOP(3, VB_SET_64(value), VB_CMPEQ_64); }
+
+        // the search value is broadcast by its bits and compared by value, so that 0.0 matches -0.0 and NaN never matches
+
+        case WAVE_TYPE_F32: { FIND_LOOP(2, VB_SET_32(value), VB_CMPEQ_F32); }
+        case WAVE_TYPE_F64: { FIND_LOOP(3, VB_SET_64(value), VB_CMPEQ_F64); }
+
+        default: {
+            break;
+        }
+    }
+
+    #undef FIND_LOOP
+
+    return U32_MAX;
+}
+
+static const wave_array_bulk_kernels CAT(wave_array_bulk_kernels_, WAVE_ARRAY_KERNELS_NAME) = {
+    .name = KERNEL_STRINGIFY(WAVE_ARRAY_KERNELS_NAME),
+
+    .fill = BULK_KERNEL(fill),
+    .copy = BULK_KERNEL(copy),
+    .find = BULK_KERNEL(find)
+};
+
+#endif
+
+#undef WAVE_ARRAY_KERNELS_NAME
+#undef WAVE_ARRAY_KERNELS_ISA
+
+#undef KERNEL
+#undef BULK_KERNEL
+#undef KERNEL_STRINGIFY
+#undef KERNEL_ATTRIBUTES
+
+#undef VECTOR_WIDTH
+#undef VF
+#undef VI
+#undef VM
+
+#undef VF_LOAD
+#undef VF_STORE
+#undef VF_SET
+
+#undef VF_ADD
+#undef VF_SUB
+#undef VF_MUL
+#undef VF_FMA
+#undef VF_MIN
+#undef VF_MAX
+
+#undef VF_AS_VI
+#undef VI_AS_VF
+#undef VF_TO_VI
+#undef VI_TO_VF
+
+#undef VI_SET
+#undef VI_ADD
+#undef VI_SUB
+#undef VI_AND
+#undef VI_AND_NOT
+#undef VI_XOR
+#undef VI_SHIFT_LEFT
+
+#undef VM_VI_ZERO
+#undef VM_ANY_NOT_LESS_EQUAL
+#undef VF_SELECT
+
+#undef VF_ABS
+
+#undef VB_WIDTH
+#undef VB
+#undef VB_LOAD
+#undef VB_STORE
+#undef VB_SET_8
+#undef VB_SET_16
+#undef VB_SET_32
+#undef VB_SET_64
+#undef VB_CMPEQ_8
+#undef VB_CMPEQ_16
+#undef VB_CMPEQ_32
+#undef VB_CMPEQ_64
+#undef VB_CMPEQ_F32
+#undef VB_CMPEQ_F64
+#undef VB_MASK
+
+#undef KERNEL_LOOP
+#undef KERNEL_REDUCE
+#undef KERNEL_SCALAR_ADD
+#undef KERNEL_SCALAR_MIN
+#undef KERNEL_SCALAR_MAX
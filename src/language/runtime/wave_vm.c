@@ -5,9 +5,13 @@
 
 #include "common/data/string/hash.h"
 
+#include "common/memory/memory.h"
+
 #include "language/wave_limits.h"
 #include "language/wave_opcodes.h"
 
+#include "language/runtime/wave_array_kernels.h"
+
 // Functions
 
 error_code wave_vm_initialize(
@@ -42,6 +46,9 @@ error_code wave_vm_initialize(
         .stack_end = NULL,
         .stack_top = NULL,
         .stack_size = U32_MAX,
+        .stack_pinned = false,
+        .retired_stacks = { NULL },
+        .retired_stack_count = 0,
 
         .call_stack_start = NULL,
         .call_stack_end = NULL,
@@ -52,6 +59,9 @@ error_code wave_vm_initialize(
         .globals_length = 0,
         .globals_size = U32_MAX,
 
+        .profile_executed_counts = NULL,
+        .profile_taken_counts = NULL,
+
         .execution_finished = false,
         .result = (number) { .number_type = NUMBER_TYPE_U64, .number_value = (union_number) { .value_u64 = 0 } }
     };
@@ -63,6 +73,10 @@ error_code wave_vm_initialize(
     RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &vm.native_functions, sizeof(wave_native_function) * vm.function_stack_length);
     RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &vm.native_function_callbacks, sizeof(wave_native_function_callback) * vm.function_stack_length);
 
+    // selecting the bulk array kernels used by the array opcodes
+
+    wave_array_set_bulk_kernels(wave_array_select_bulk_kernels());
+
     // output vm
 
     *out_vm = vm;
@@ -135,23 +149,29 @@ error_code wave_vm_initialize_runtime(wave_vm* vm, u32 error_stack_size, u32 sta
     vm->error_stack_end = error_stack_start + error_stack_size;
     vm->error_stack_top = error_stack_start;
 
-    // allocating stack
+    // allocating stack, only a small part of the stack is allocated up front, it grows on demand up to @stack_size
+
+    u32 stack_capacity = stack_size < WAVE_VM_STACK_INITIAL_SIZE ? stack_size : WAVE_VM_STACK_INITIAL_SIZE;
 
     byte* stack_start = NULL;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &stack_start, sizeof(byte) * stack_size);
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &stack_start, sizeof(byte) * stack_capacity);
 
     vm->stack_start = stack_start;
-    vm->stack_end = stack_start + stack_size;
+    vm->stack_end = stack_start + stack_capacity;
     vm->stack_top = stack_start;
+    vm->stack_size = stack_size;
 
-    // allocating call stack
+    // allocating call stack, grows on demand up to @call_stack_size
+
+    u32 call_stack_capacity = call_stack_size < WAVE_VM_CALL_STACK_INITIAL_SIZE ? call_stack_size : WAVE_VM_CALL_STACK_INITIAL_SIZE;
 
     u32* call_stack_start = NULL;
-    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &call_stack_start, sizeof(u32) * call_stack_size);
+    RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &call_stack_start, sizeof(u32) * call_stack_capacity);
 
     vm->call_stack_start = call_stack_start;
-    vm->call_stack_end = call_stack_start + call_stack_size;
+    vm->call_stack_end = call_stack_start + call_stack_capacity;
     vm->call_stack_top = call_stack_start;
+    vm->call_stack_size = call_stack_size;
 
     // allocating globals
 
@@ -183,6 +203,10 @@ error_code wave_vm_begin_execution(wave_vm* vm) {
     // reset stacks
 
     vm->error_stack_top = vm->error_stack_start;
+    vm->stack_top = vm->stack_start;
+    vm->stack_pinned = false;
+    RUN_ERROR_CODE_FUNCTION(wave_vm_release_retired_stacks, vm);
+    RUN_ERROR_CODE_FUNCTION(wave_vm_grow_stack, vm, parameter_size + locals_stack_frame_size + WAVE_VM_STACK_HEADROOM);
     vm->stack_top = vm->stack_start + parameter_size + locals_stack_frame_size;
 
     // initialize call stack
@@ -236,6 +260,10 @@ error_code wave_vm_begin_function_execution(wave_vm* vm, string_hash function_na
     // reset stacks
 
     vm->error_stack_top = vm->error_stack_start;
+    vm->stack_top = vm->stack_start;
+    vm->stack_pinned = false;
+    RUN_ERROR_CODE_FUNCTION(wave_vm_release_retired_stacks, vm);
+    RUN_ERROR_CODE_FUNCTION(wave_vm_grow_stack, vm, parameter_size + locals_stack_frame_size + WAVE_VM_STACK_HEADROOM);
     vm->stack_top = vm->stack_start + parameter_size + locals_stack_frame_size;
 
     // initialize call stack
@@ -255,9 +283,100 @@ error_code wave_vm_begin_function_execution(wave_vm* vm, string_hash function_na
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
+error_code wave_vm_grow_stack(wave_vm* vm, umax required_size) {
+    umax capacity = vm->stack_end - vm->stack_start;
+    if (required_size <= capacity) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    if (required_size > vm->stack_size) {
+        return ERROR_CODE_LANGUAGE_RUNTIME_STACK_OVERFLOW;
+    }
+
+    umax new_capacity = capacity > 0 ? capacity : WAVE_VM_STACK_INITIAL_SIZE;
+    while (new_capacity < required_size) {
+        new_capacity *= 2;
+    }
+
+    new_capacity = new_capacity < vm->stack_size ? new_capacity : vm->stack_size;
+
+    // everything else in the vm references the stack by offsets, only the stack pointers need to be rebased
+
+    umax stack_top = vm->stack_top - vm->stack_start;
+    if (vm->stack_pinned) {
+        // objects placed inside the stack are referenced by their address, they are never written to after their creation,
+        // so the old stack is kept unchanged until the execution restarts and the objects stay valid at their old address
+
+        if (vm->retired_stack_count >= WAVE_VM_RETIRED_STACKS_MAX) {
+            return ERROR_CODE_LANGUAGE_RUNTIME_STACK_OVERFLOW;
+        }
+
+        const wave_memory_allocation_function allocate_memory = vm->allocate_memory;
+
+        byte* new_stack_start = NULL;
+        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &new_stack_start, sizeof(byte) * new_capacity);
+        memory_copy(vm->stack_start, new_stack_start, (u32) stack_top);
+
+        vm->retired_stacks[vm->retired_stack_count] = vm->stack_start;
+        vm->retired_stack_count++;
+        vm->stack_start = new_stack_start;
+    } else {
+        const wave_memory_reallocation_function reallocate_memory = vm->reallocate_memory;
+        RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(vm->stack_start), sizeof(byte) * new_capacity);
+    }
+
+    vm->stack_end = vm->stack_start + new_capacity;
+    vm->stack_top = vm->stack_start + stack_top;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_vm_grow_call_stack(wave_vm* vm, umax required_size) {
+    umax capacity = vm->call_stack_end - vm->call_stack_start;
+    if (required_size <= capacity) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    if (required_size > vm->call_stack_size) {
+        return ERROR_CODE_LANGUAGE_RUNTIME_CALL_STACK_OVERFLOW;
+    }
+
+    umax new_capacity = capacity > 0 ? capacity : WAVE_VM_CALL_STACK_INITIAL_SIZE;
+    while (new_capacity < required_size) {
+        new_capacity *= 2;
+    }
+
+    new_capacity = new_capacity < vm->call_stack_size ? new_capacity : vm->call_stack_size;
+
+    const wave_memory_reallocation_function reallocate_memory = vm->reallocate_memory;
+
+    umax call_stack_top = vm->call_stack_top - vm->call_stack_start;
+    RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &(vm->call_stack_start), sizeof(u32) * new_capacity);
+
+    vm->call_stack_end = vm->call_stack_start + new_capacity;
+    vm->call_stack_top = vm->call_stack_start + call_stack_top;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+error_code wave_vm_release_retired_stacks(wave_vm* vm) {
+    const wave_memory_deallocation_function deallocate_memory = vm->deallocate_memory;
+
+    for (u32 i = 0; i < vm->retired_stack_count; i++) {
+        RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) vm->retired_stacks[i]);
+        vm->retired_stacks[i] = NULL;
+    }
+
+    vm->retired_stack_count = 0;
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
 error_code wave_vm_destroy(wave_vm* vm) {
     const wave_memory_deallocation_function deallocate_memory = vm->deallocate_memory;
 
+    RUN_ERROR_CODE_FUNCTION(wave_vm_release_retired_stacks, vm);
+
     #define DEALLOCATE_SAFE(pointer) do { if (pointer != NULL) { RUN_ERROR_CODE_FUNCTION(deallocate_memory, (void*) pointer); pointer = NULL; } } while (0)
 
     DEALLOCATE_SAFE(vm->native_functions);
@@ -14,6 +14,11 @@
 
 #define WAVE_VM_INIT_DEFAULT_PARAMETERS 32, 2048, 64 * 3, 256
 
+#define WAVE_VM_STACK_INITIAL_SIZE (256) /* the amount of bytes the stack starts out with, it then grows on demand up to @stack_size */
+#define WAVE_VM_CALL_STACK_INITIAL_SIZE (16 * 3) /* the amount of call stack entries the call stack starts out with (3 per function call) */
+#define WAVE_VM_STACK_HEADROOM (128) /* the amount of free bytes on the stack that is guaranteed above a new stack frame */
+#define WAVE_VM_RETIRED_STACKS_MAX (32) /* the stack at least doubles whenever it is replaced, so a stack of at most U32_MAX bytes is replaced less than 32 times */
+
 // Typedefs
 
 typedef struct {
@@ -46,17 +51,23 @@ typedef struct {
     byte* stack_start; // pointer to the start of the stack; the stack is the main memory and stores all values in order without padding
     byte* stack_end; // pointer to the end of the stack
     byte* stack_top; // pointer to the top of the stack
-    u32 stack_size;
+    u32 stack_size; // the maximum size of the stack, the stack grows geometrically up to this size (see @wave_vm_grow_stack)
+    bool stack_pinned; // set once an object has been placed inside the stack (see @OPCODE_EXT_STR_NEW_LOCAL), the stack is then copied instead of moved when growing
+    byte* retired_stacks[WAVE_VM_RETIRED_STACKS_MAX]; // stacks that were replaced while the stack was pinned, they keep the objects at their old addresses alive until the execution restarts
+    u32 retired_stack_count; // the amount of retired stacks
 
     u32* call_stack_start; // pointer to the start of the call stack; the call stack keeps the instruction pointers from before a function was called in order to return to them later when the function is finished
     u32* call_stack_end; // pointer to the end of the call stack
     u32* call_stack_top; // pointer to the top of the call stack
-    u32 call_stack_size;
+    u32 call_stack_size; // the maximum size of the call stack, the call stack grows geometrically up to this size (see @wave_vm_grow_call_stack)
 
     byte* globals_start; // pointer to the start of the global array; the global array can be accessed at any time and stores every type without padding for global usage inside of one running vm
     u32 globals_length; // length of the global array
     u32 globals_size;
 
+    u32* profile_executed_counts; // the calls of every function at its branch offset and the executions of every conditional jump and switch at their offset, NULL if the execution is not profiled (see @wave_profile_attach)
+    u32* profile_taken_counts; // the taken conditional jumps at their offset and the used jump table entries at the offset of the entry
+
     bool execution_finished; // whether the vm has finished execution
     number result; // the result of the bytecode execution
 } wave_vm;
@@ -73,6 +84,10 @@ error_code wave_vm_initialize_runtime(wave_vm* vm, u32 error_stack_size, u32 sta
 error_code wave_vm_begin_execution(wave_vm* vm);
 error_code wave_vm_begin_function_execution(wave_vm* vm, string_hash function_name);
 
+error_code wave_vm_grow_stack(wave_vm* vm, umax required_size); // grows the stack so that it can hold at least @required_size bytes, the stack may be moved in memory
+error_code wave_vm_grow_call_stack(wave_vm* vm, umax required_size); // grows the call stack so that it can hold at least @required_size entries, the call stack may be moved in memory
+error_code wave_vm_release_retired_stacks(wave_vm* vm); // deallocates the stacks that were replaced while the stack was pinned, no object inside them may be referenced anymore
+
 error_code wave_vm_destroy(wave_vm* vm);
 
 #endif
@@ -1,5 +1,6 @@
 #include "wave_vm_container.h"
 
+#include "language/func/wave_array_math.h"
 #include "language/func/wave_debug.h"
 #include "language/func/wave_math.h"
 
@@ -56,6 +57,25 @@ error_code wave_vm_register_math_functions(wave_vm* vm) {
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
+error_code wave_vm_register_array_math_functions(wave_vm* vm) {
+    wave_array_set_f32_kernels(wave_array_select_f32_kernels());
+
+    REGISTER_BUILTIN_FUNCTION_3(array_math, f32_arr_add, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_3(array_math, f32_arr_mul, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_4(array_math, f32_arr_fma, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_2(array_math, f32_arr_sin, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_2(array_math, f32_arr_cos, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_4(array_math, f32_arr_clamp, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_F32, WAVE_TYPE_F32);
+    REGISTER_BUILTIN_FUNCTION_4(array_math, f32_arr_lerp, WAVE_TYPE_VOID, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_ARR, WAVE_TYPE_F32);
+
+    REGISTER_BUILTIN_FUNCTION_1(array_math, f32_arr_sum, WAVE_TYPE_F32, true, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_2(array_math, f32_arr_dot, WAVE_TYPE_F32, true, WAVE_TYPE_ARR, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_1(array_math, f32_arr_min, WAVE_TYPE_F32, true, WAVE_TYPE_ARR);
+    REGISTER_BUILTIN_FUNCTION_1(array_math, f32_arr_max, WAVE_TYPE_F32, true, WAVE_TYPE_ARR);
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
 error_code wave_vm_register_string_functions(wave_vm* vm) {
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
@@ -73,6 +93,7 @@ error_code wave_vm_register_debug_functions(wave_vm* vm) {
 
 error_code wave_vm_register_default_functions(wave_vm* vm) {
     RUN_ERROR_CODE_FUNCTION(wave_vm_register_math_functions, vm);
+    RUN_ERROR_CODE_FUNCTION(wave_vm_register_array_math_functions, vm);
     RUN_ERROR_CODE_FUNCTION(wave_vm_register_string_functions, vm);
     RUN_ERROR_CODE_FUNCTION(wave_vm_register_file_functions, vm);
     RUN_ERROR_CODE_FUNCTION(wave_vm_register_debug_functions, vm);
@@ -114,6 +114,7 @@ error_code wave_vm_execute_batch_safe(wave_vm* vm);
 // Native Functions
 
 error_code wave_vm_register_math_functions(wave_vm* vm);
+error_code wave_vm_register_array_math_functions(wave_vm* vm);
 error_code wave_vm_register_string_functions(wave_vm* vm);
 error_code wave_vm_register_file_functions(wave_vm* vm);
 error_code wave_vm_register_debug_functions(wave_vm* vm);
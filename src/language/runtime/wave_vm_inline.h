@@ -15,8 +15,11 @@
 #include "common/math/primitives/uint_math.h"
 
 #include "language/wave_common.h"
+#include "language/wave_limits.h"
 #include "language/wave_opcodes.h"
 
+#include "language/runtime/wave_array.h"
+#include "language/runtime/wave_array_kernels.h"
 #include "language/runtime/wave_vm.h"
 
 #endif
@@ -40,6 +43,7 @@
 
 #define WAVE_VM_STACK_INLINE_DEFINE (1) /* define the macros for accessing the stack */
 #define WAVE_VM_STACK_INLINE_THROW_ERRORS (1) /* use custom error handling (default is a return statement) */
+#define WAVE_VM_STACK_INLINE_GROW (1) /* grow the stack before pushing onto it (see @STACK_RESERVE) */
 #include "wave_vm_stack_inline.h" /* macros for accessing the stack; variables named "stack_start", "stack_end" & "stack" need to be defined in order for the macros to function properly */
 
 /* wave_vm_execute
@@ -144,12 +148,55 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
     u32* call_stack_end = vm->call_stack_end;
     u32* call_stack = vm->call_stack_top;
 
+    // growing the stacks on demand (see @wave_vm_grow_stack), the stacks are referenced by offsets only, which is why they may be moved in memory
+
+    #define STACK_RESERVE(size)                                                                                     \
+        do {                                                                                                        \
+            if (stack + (size) > stack_end) {                                                                       \
+                vm->stack_top = stack;                                                                              \
+                temp_error_code = wave_vm_grow_stack(vm, (umax) (stack - stack_start) + (size));                    \
+                if (temp_error_code != ERROR_CODE_EXECUTION_SUCCESSFUL) {                                           \
+                    THROW_ERROR(temp_error_code);                                                                   \
+                }                                                                                                   \
+                                                                                                                    \
+                stack_start = vm->stack_start;                                                                      \
+                stack_end = vm->stack_end;                                                                          \
+                stack = vm->stack_top;                                                                              \
+            }                                                                                                       \
+        } while (0)
+
+    #define CALL_STACK_RESERVE(count)                                                                               \
+        do {                                                                                                        \
+            if (call_stack + (count) > call_stack_end) {                                                            \
+                vm->call_stack_top = call_stack;                                                                    \
+                temp_error_code = wave_vm_grow_call_stack(vm, (umax) (call_stack - call_stack_start) + (count));    \
+                if (temp_error_code != ERROR_CODE_EXECUTION_SUCCESSFUL) {                                           \
+                    THROW_ERROR(temp_error_code);                                                                   \
+                }                                                                                                   \
+                                                                                                                    \
+                call_stack_start = vm->call_stack_start;                                                            \
+                call_stack_end = vm->call_stack_end;                                                                \
+                call_stack = vm->call_stack_top;                                                                    \
+            }                                                                                                       \
+        } while (0)
+
     // globals
 
     byte* globals_start = vm->globals_start;
     u32 globals_length = vm->globals_length;
     byte* globals_end = globals_start + globals_length;
 
+    // profiling, the counters of an instruction are addressed by its offset into the bytecode (see @wave_profile_attach)
+
+    #if PROGRAM_FEATURE_WAVE_PROFILER != 0
+        u32* profile_executed_counts = vm->profile_executed_counts;
+        u32* profile_taken_counts = vm->profile_taken_counts;
+
+        #define PROFILE_COUNT(counts, pointer) do { if ((counts) != NULL) { (counts)[(pointer) - bytecode_start]++; } } while (0)
+    #else
+        #define PROFILE_COUNT(counts, pointer) do {} while (0)
+    #endif
+
     // functions
 
     /* Function Calls, Returns & Error Handling
@@ -176,18 +223,18 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
     *
     *     1. the instruction pointer to the next instruction (@call_stack.@parent_instruction_pointer) is pushed to the call stack
     *     2. the child instruction pointer (@call_stack.@child_instruction_pointer), which points to the first instruction of the function that was called, is pushed to the call stack
-    *     3. the current position in the stack (@call_stack.@stack_frame) is pushed to the call stack
+    *     3. the position of the parameters in the stack (@call_stack.@stack_frame), where the stack frame of the function starts, is pushed to the call stack
     *
     *     4. the instruction pointer is moved to the beginning of the first instruction and @locals_stack_frame_size is read, then the
     *        stack pointer is incremented by the size of the local variables in the function (@locals_stack_frame_size)
     *
     *     5. the first and the following instructions are executed
     *
-    *     6. once a return instruction (@OPCODE_RETURN) is hit, the parent instruction pointer (@call_stack.@parent_instruction_pointer) is popped off the call stack
-    *        together with the function call data (@call_stack.@parent_instruction_pointer, @call_stack.@child_instruction_pointer, @call_stack.@stack_frame) and the instruction pointer is
-    *        set to @parent_instruction_pointer
+    *     6. once a return instruction (@OPCODE_RETURN) is hit, the return value is moved to the start of the stack frame (@call_stack.@stack_frame), which drops the parameters and locals,
+    *        then the parent instruction pointer (@call_stack.@parent_instruction_pointer) is popped off the call stack together with the function call data
+    *        (@call_stack.@parent_instruction_pointer, @call_stack.@child_instruction_pointer, @call_stack.@stack_frame) and the instruction pointer is set to @parent_instruction_pointer
     *
-    * SIDENOTE: see @OPCODE_CALL_x, @OPCODE_RETURN, @OPCODE_LOAD_x and @OPCODE_STORE_x for more information.
+    * SIDENOTE: see @OPCODE_CALL_x, @OPCODE_EXT_TAIL_CALL, @OPCODE_RETURN, @OPCODE_LOAD_x and @OPCODE_STORE_x for more information.
     *
     * When an exception is thrown inside a function, the following steps are performed:
     *     1. the start of the function stack frame (@call_stack.@stack_frame) is popped off the call stack
@@ -291,19 +338,24 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
             }
 
             #if WAVE_VM_SAFE_MODE == 0
-                #define OPCODE_IMPL_CJUMP_IF(compare_operation, type)   \
-                    do {                                                \
-                        i16 offset = GET_I16(); NEXT_16();              \
-                        type value = 0; STACK_GET(value, 0);            \
-                                                                        \
-                        if (value compare_operation 0) {                \
-                            STACK_POP_BYTES(sizeof(type));              \
-                            NEXT_OFFSET(offset);                        \
-                        }                                               \
+                #define OPCODE_IMPL_CJUMP_IF(compare_operation, type)                               \
+                    do {                                                                            \
+                        PROFILE_COUNT(profile_executed_counts, bytecode - 1);                       \
+                                                                                                    \
+                        i16 offset = GET_I16(); NEXT_16();                                          \
+                        type value = 0; STACK_GET(value, 0);                                        \
+                                                                                                    \
+                        if (value compare_operation 0) {                                            \
+                            PROFILE_COUNT(profile_taken_counts, bytecode - 1 - sizeof(u16));        \
+                            STACK_POP_BYTES(sizeof(type));                                          \
+                            NEXT_OFFSET(offset);                                                    \
+                        }                                                                           \
                     } while (0)
             #else
                 #define OPCODE_IMPL_CJUMP_IF(compare_operation, type)                                       \
                     do {                                                                                    \
+                        PROFILE_COUNT(profile_executed_counts, bytecode - 1);                               \
+                                                                                                            \
                         i16 offset = GET_I16(); NEXT_16();                                                  \
                         type value = 0; STACK_GET(value, 0);                                                \
                                                                                                             \
@@ -312,6 +364,7 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                         }                                                                                   \
                                                                                                             \
                         if (value compare_operation 0) {                                                    \
+                            PROFILE_COUNT(profile_taken_counts, bytecode - 1 - sizeof(u16));                \
                             STACK_POP_BYTES(sizeof(type));                                                  \
                             NEXT_OFFSET(offset);                                                            \
                         }                                                                                   \
@@ -352,35 +405,35 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 *
                 * The value of the size @value_size is popped off the stack and the instruction pointer moved to the end of this
                 * instruction and then incremented by the @branch_offset at the index of the value (from the stack) in the array @jump_table.
+                * If the value is not a valid index, the execution continues behind this instruction (the default case).
                 * */
 
+                PROFILE_COUNT(profile_executed_counts, bytecode - 1);
+
                 u16 field = GET_U16(); NEXT_16();
                 u16 length = field & 0b0011111111111111;
-                if (length == 0) {
-                    break;
-                }
 
-                wave_type value_type = (wave_type) (field >> (U16_BIT_COUNT - 2));
                 u64 table_index = 0;
-                switch (value_type) {
-                    case WAVE_TYPE_U8:  { STACK_GET_U8(table_index,  0); break; }
-                    case WAVE_TYPE_U16: { STACK_GET_U16(table_index, 0); break; }
-                    case WAVE_TYPE_U32: { STACK_GET_U32(table_index, 0); break; }
-                    case WAVE_TYPE_U64: { STACK_GET_U64(table_index, 0); break; }
+                switch ((wave_type) (field >> (U16_BIT_COUNT - 2))) {
+                    case WAVE_TYPE_U8:  { u8  value = 0; STACK_POP_TYPE(u8,  value); table_index = value; break; }
+                    case WAVE_TYPE_U16: { u16 value = 0; STACK_POP_TYPE(u16, value); table_index = value; break; }
+                    case WAVE_TYPE_U32: { u32 value = 0; STACK_POP_TYPE(u32, value); table_index = value; break; }
+                    case WAVE_TYPE_U64: { STACK_POP_TYPE(u64, table_index); break; }
 
                     default: {
                         return ERROR_CODE_LANGUAGE_RUNTIME_INVALID_SWITCH_CASE_VALUE;
                     }
                 }
 
-                #if WAVE_VM_SAFE_MODE != 0
                 if (table_index >= length) {
-                    THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_INVALID_SWITCH_CASE_VALUE);
+                    NEXT_OFFSET(sizeof(u16) * length);
+                    break;
                 }
-                #endif
 
-                NEXT_OFFSET(sizeof(u16) * table_index);
-                u16 branch_offset = GET_U16();
+                u16 branch_offset = *((u16*) (bytecode + sizeof(u16) * table_index));
+                PROFILE_COUNT(profile_taken_counts, bytecode + sizeof(u16) * table_index);
+
+                NEXT_OFFSET(sizeof(u16) * length); // jump to the end of this instruction and jump by the offset from the jump table
 
                 #if WAVE_VM_SAFE_MODE != 0
                 if ((bytecode + branch_offset) > bytecode_end) {
@@ -388,8 +441,7 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 }
                 #endif
 
-                NEXT_OFFSET(sizeof(u16) * (length - table_index) + branch_offset); // jump to the end of this instruction and jump by the offset from the jump table
-
+                NEXT_OFFSET(branch_offset);
                 break;
             }
 
@@ -400,30 +452,31 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 *          2bit : @value_size - the size of the top value in the stack, to be used to look up the @branch_offset from the table (8bit - 64bit)
                 *         14bit : @length     - the length of the jump table
                 *     @jump_table ((@value_size bits + 16bit) * @length):
-                *         x bit : @value - the value to the corresponding @branch_offset
+                *         x bit : @value - the value to the corresponding @branch_offset, in ascending order
                 *         16bit : @branch_offset - the offset to jump by relative to the end of this instruction
                 *
                 * The value of the size @value_size is popped off the stack and then searched in @jump_table using a
                 * binary search algorithm (best case complexity: O(log(n))). If the value was found the instruction pointer is
-                * moved to the end of this instruction and then incremented by the found @branch_offset.
+                * moved to the end of this instruction and then incremented by the found @branch_offset, otherwise the execution
+                * continues behind this instruction (the default case).
                 *
                 * Parameters are popped off the stack.
                 * */
 
+                PROFILE_COUNT(profile_executed_counts, bytecode - 1);
+
                 u16 field = GET_U16(); NEXT_16();
                 u16 length = field & 0b0011111111111111;
-                if (length == 0) {
-                    break;
-                }
 
                 wave_type value_type = (wave_type) (field >> (U16_BIT_COUNT - 2));
                 umax value_size = 0b1 << value_type; // should be equivalent to using sizeof
+                umax entry_size = value_size + sizeof(u16);
 
                 u64 value = 0;
                 switch (value_type) {
-                    case WAVE_TYPE_U8:  { STACK_POP_TYPE(u8,  value); break; }
-                    case WAVE_TYPE_U16: { STACK_POP_TYPE(u16, value); break; }
-                    case WAVE_TYPE_U32: { STACK_POP_TYPE(u32, value); break; }
+                    case WAVE_TYPE_U8:  { u8  top = 0; STACK_POP_TYPE(u8,  top); value = top; break; }
+                    case WAVE_TYPE_U16: { u16 top = 0; STACK_POP_TYPE(u16, top); value = top; break; }
+                    case WAVE_TYPE_U32: { u32 top = 0; STACK_POP_TYPE(u32, top); value = top; break; }
                     case WAVE_TYPE_U64: { STACK_POP_TYPE(u64, value); break; }
 
                     default: {
@@ -431,43 +484,46 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                     }
                 }
 
-                u16 branch_offset = 0;
-                bool found_offset = false;
-
                 u16 bound_left = 0;
-                u16 bound_right = length - 1;
-                while (bound_left != bound_right) { // binary search in the jump table
-                    u16 middle_index = (bound_left + bound_right) / 2;
+                u16 bound_right = length;
+                while (bound_left < bound_right) { // binary search in the jump table for the first value not below @value
+                    u16 middle_index = bound_left + (bound_right - bound_left) / 2;
+                    const byte* entry = bytecode + entry_size * middle_index;
+
                     u64 middle_value = 0;
-                    umax bytecode_offset = (value_size * middle_index) + (sizeof(u16) * (middle_index == 0 ? 0 : middle_index - 1));
                     switch (value_type) { // [ array jump_table : (value, 16bit : branch_offset) ]
-                        case WAVE_TYPE_U8:  { middle_value = (u64) (*((u8*)  bytecode + bytecode_offset)); break; }
-                        case WAVE_TYPE_U16: { middle_value = (u64) (*((u16*) bytecode + bytecode_offset)); break; }
-                        case WAVE_TYPE_U32: { middle_value = (u64) (*((u32*) bytecode + bytecode_offset)); break; }
-                        case WAVE_TYPE_U64: { middle_value = (u64) (*((u64*) bytecode + bytecode_offset)); break; }
+                        case WAVE_TYPE_U8:  { middle_value = (u64) *((u8*)  entry); break; }
+                        case WAVE_TYPE_U16: { middle_value = (u64) *((u16*) entry); break; }
+                        case WAVE_TYPE_U32: { middle_value = (u64) *((u32*) entry); break; }
+                        default:            { middle_value = (u64) *((u64*) entry); break; }
+                    }
 
-                        default: {
-                            return ERROR_CODE_LANGUAGE_RUNTIME_INVALID_SWITCH_CASE_VALUE;
-                        }
+                    if (middle_value < value) {
+                        bound_left = middle_index + 1;
+                    } else {
+                        bound_right = middle_index;
                     }
+                }
 
-                    if (middle_value > value) {
-                        bound_right = middle_index - 1;
-                    } else if (middle_value < value) {
-                        bound_left = middle_index;
+                u16 branch_offset = 0;
+                if (bound_left < length) {
+                    const byte* entry = bytecode + entry_size * bound_left;
+
+                    u64 found_value = 0;
+                    switch (value_type) {
+                        case WAVE_TYPE_U8:  { found_value = (u64) *((u8*)  entry); break; }
+                        case WAVE_TYPE_U16: { found_value = (u64) *((u16*) entry); break; }
+                        case WAVE_TYPE_U32: { found_value = (u64) *((u32*) entry); break; }
+                        default:            { found_value = (u64) *((u64*) entry); break; }
                     }
 
-                    if (middle_value == value) {
-                        branch_offset = *((u16*) (bytecode + ((value_size + sizeof(u16)) * middle_index)));
-                        goto wave_vm_execute_lookupswitch_end;
+                    if (found_value == value) {
+                        branch_offset = *((u16*) (entry + value_size));
+                        PROFILE_COUNT(profile_taken_counts, entry);
                     }
                 }
 
-                return ERROR_CODE_LANGUAGE_RUNTIME_INVALID_SWITCH_CASE_VALUE; // if we land here, an error occurred
-
-                wave_vm_execute_lookupswitch_end: {}
-
-                NEXT_OFFSET((value_size + sizeof(u16)) * length); // jump to the end of this instruction
+                NEXT_OFFSET(entry_size * length); // jump to the end of this instruction
 
                 #if WAVE_VM_SAFE_MODE != 0
                 if ((bytecode + branch_offset) > bytecode_end) {
@@ -503,6 +559,8 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 }
                 #endif
 
+                STACK_RESERVE(WAVE_VM_STACK_HEADROOM);
+
                 byte* temp_stack_top = stack;
                 vm->native_function_callbacks[function_index](stack_start, stack_end, stack, &temp_stack_top);
                 stack = temp_stack_top;
@@ -535,6 +593,8 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 }
                 #endif
 
+                STACK_RESERVE(WAVE_VM_STACK_HEADROOM);
+
                 byte* temp_stack_top = stack;
                 error_code function_result = vm->native_function_callbacks[function_index](stack_start, stack_end, stack, &temp_stack_top);
                 stack = temp_stack_top;
@@ -556,9 +616,7 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 * This instruction may not run functions that can throw error codes.
                 * */
 
-                if ((call_stack + 3) > call_stack_end) {
-                    THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_CALL_STACK_OVERFLOW);
-                }
+                CALL_STACK_RESERVE(3);
 
                 u32 branch_offset = GET_U32(); NEXT_32();
                 #if WAVE_VM_SAFE_MODE != 0
@@ -571,13 +629,15 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 u32 child_instruction_pointer = (bytecode + branch_offset) - bytecode_start;
 
                 bytecode = bytecode_start + branch_offset;
+                PROFILE_COUNT(profile_executed_counts, bytecode);
 
                 u16 parameter_size = GET_U16(); NEXT_16();
                 u16 locals_stack_frame_size = GET_U16(); NEXT_16();
+                STACK_RESERVE(locals_stack_frame_size + WAVE_VM_STACK_HEADROOM);
 
                 *call_stack = (typeof(*call_stack)) parent_instruction_pointer; call_stack++; // parent instruction pointer
                 *call_stack = (typeof(*call_stack)) child_instruction_pointer; call_stack++; // child instruction pointer (used in error handling)
-                *call_stack = (typeof(*call_stack)) STACK_GET_TOP() - parameter_size + locals_stack_frame_size; call_stack++; // stack frame
+                *call_stack = (typeof(*call_stack)) STACK_GET_TOP() - parameter_size; call_stack++; // stack frame (starts with the parameters, followed by the locals)
 
                 stack += locals_stack_frame_size;
                 break;
@@ -605,15 +665,16 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 if ((function_identifier & (0b1 << (U32_BIT_COUNT - 1))) != 0) { // native function
                     u16 function_index = function_identifier & U16_BIT_1;
 
+                    STACK_RESERVE(WAVE_VM_STACK_HEADROOM);
+
                     byte* temp_stack_top = stack;
                     vm->native_function_callbacks[function_index](stack_start, stack_end, stack, &temp_stack_top);
                     stack = temp_stack_top;
                 } else {
                     u32 branch_offset = (function_identifier & (U32_BIT_1 >> 1));
 
-                    if ((call_stack + 3) > call_stack_end) {
-                        THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_CALL_STACK_OVERFLOW);
-                    }
+                    CALL_STACK_RESERVE(3);
+                    STACK_RESERVE(WAVE_VM_STACK_HEADROOM);
 
                     #if WAVE_VM_SAFE_MODE != 0
                     if ((bytecode_start + branch_offset) > bytecode_end) {
@@ -659,6 +720,8 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 if ((function_identifier & (0b1 << (U32_BIT_COUNT - 1))) != 0) { // native function
                     u16 function_index = function_identifier & U16_BIT_1;
 
+                    STACK_RESERVE(WAVE_VM_STACK_HEADROOM);
+
                     byte* temp_stack_top = stack;
                     error_code function_result = vm->native_function_callbacks[function_index](stack_start, stack_end, stack, &temp_stack_top);
                     stack = temp_stack_top;
@@ -672,9 +735,8 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                         branch_offset = -branch_offset;
                     }
 
-                    if ((call_stack + 3) > call_stack_end) {
-                        THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_CALL_STACK_OVERFLOW);
-                    }
+                    CALL_STACK_RESERVE(3);
+                    STACK_RESERVE(WAVE_VM_STACK_HEADROOM);
 
                     #if WAVE_VM_SAFE_MODE != 0
                     if ((bytecode + branch_offset) > bytecode_end) {
@@ -693,11 +755,15 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
             }
 
             case OPCODE_RETURN: {
-                /* Instruction Description:
+                /* Instruction Bytecode: [ opcode | 8bit return_size ]
+                *
+                *     @return_size (8bit) - the size of the return value on top of the stack, 0 if the function does not return anything
                 *
                 * Returns from a function, by setting the instruction pointer to parent instruction pointer
                 * (stored in the call stack) and then popping the function call data off the call stack (parent instruction pointer,
                 * child instruction pointer, stack frame).
+                * The return value is moved to the start of the stack frame, which drops the parameters, the locals and any other value
+                * of the function, so that the caller continues with the return value in place of the parameters it pushed.
                 * */
 
                 #if WAVE_VM_SAFE_MODE != 0
@@ -706,6 +772,19 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 }
                 #endif
 
+                u8 return_size = GET_U8(); NEXT_8();
+
+                // the return value lies above the stack frame, so copying from the front never overwrites bytes that were not read yet
+
+                typeof(*call_stack) stack_frame = *(call_stack - 1);
+                byte* return_value = stack - return_size;
+                stack = stack_start + stack_frame;
+                for (u8 i = 0; i < return_size; i++) {
+                    stack[i] = return_value[i];
+                }
+
+                stack += return_size;
+
                 call_stack -= 3; // pop parent instruction pointer, child instruction pointer and stack frame
                 bytecode = bytecode_start + (umax) *call_stack; // retrieve parent instruction pointer
                 break;
@@ -1628,17 +1707,17 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 *     @field (32bit):
                 *          1bit : @has_data   - whether the array is created empty (every value is set to 0)
                 *          2bit : @value_size - the size of the top values stored in the array (8bit - 64bit)
-                *         29bit : @length     - the length of the array
+                *         29bit : @length     - the length of the array (may not exceed @WAVE_ARRAY_LENGTH_MAX)
                 *     @data ((@type bits) * @length):
                 *         x bit : @value - the value
                 *
                 * Allocates a new array with the length @length. If @has_data is set to true
                 * the array is set to @data, while respecting the size of each value (@value_size).
-                * The array is preceded by its value_size (2bit) and its length (30bit) in the assigned memory block.
+                * The array is preceded by its field (32bit) in the assigned memory block.
                 * The address of the newly created array is then pushed to the stack.
                 * @data should be as long as @length and in bytes as big as @length * @value_size
                 *
-                * ARRAY STRUCTURE: [ 32bit field : (2bit value_size, 30bit length) | array data : (value...) ]
+                * ARRAY STRUCTURE: [ 32bit field : (2bit value_size, 1bit dynamic, 1bit view, 1bit sliced, 27bit length) | array data : (value...) ]
                 *
                 * Arrays need to be popped off the stack using @POP_FREE.
                 * */
@@ -1649,6 +1728,12 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 wave_type value_type = (wave_type) ((field >> (U32_BIT_COUNT - 3)) & 0b011);
                 umax value_size = 0b1 << value_type; // should be equivalent to using sizeof
 
+                #if WAVE_VM_SAFE_MODE != 0
+                if (length > WAVE_ARRAY_LENGTH_MAX) {
+                    THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_TOO_LONG);
+                }
+                #endif
+
                 str array_start = NULL;
                 str array_end = NULL;
                 str array = NULL;
@@ -1659,13 +1744,13 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                     RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &array_start, sizeof(u32) + value_size * length);
                 }
 
-                *((u32*) array_start) = (value_type << (U32_BIT_COUNT - 2)) & (length & (~((u32) 0b0) >> 2));
+                WAVE_ARRAY_GET_FIELD(array_start) = WAVE_ARRAY_CREATE_FIELD(value_type, length);
                 if (length == 0 || !has_data) {
                     goto wave_vm_execute_arr_new_end;
                 }
 
                 array = array_start + sizeof(u32); // move to the start of the array
-                array_end = array + length;
+                array_end = array + value_size * length;
 
                 // copy the string word by word to potentially save time
 
@@ -1696,20 +1781,20 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                     THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
                 }
 
-                u32 field = *((u32*) array); array += sizeof(u32);
-                u32 length = field & (U32_BIT_1 >> 3);
+                u32 field = WAVE_ARRAY_GET_FIELD(array);
+                u32 length = WAVE_ARRAY_GET_LENGTH(field);
+                byte* data = WAVE_ARRAY_GET_DATA(array, field);
 
                 u32 index = 0; STACK_GET_U32(index, 0); // get the desired index from the stack
                 if (index >= length) {
                     THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_INDEX_OUT_OF_BOUNDS);
                 }
 
-                wave_type value_type = (wave_type) ((field >> (U32_BIT_COUNT - 2)) & 0b11);
-                switch (value_type) {
-                    case WAVE_TYPE_U8:  { STACK_PUSH_8( ((u8*)  array)[index]); break; }
-                    case WAVE_TYPE_U16: { STACK_PUSH_16(((u16*) array)[index]); break; }
-                    case WAVE_TYPE_U32: { STACK_PUSH_32(((u32*) array)[index]); break; }
-                    case WAVE_TYPE_U64: { STACK_PUSH_64(((u64*) array)[index]); break; }
+                switch (WAVE_ARRAY_GET_VALUE_TYPE(field)) {
+                    case WAVE_TYPE_U8:  { STACK_PUSH_8( ((u8*)  data)[index]); break; }
+                    case WAVE_TYPE_U16: { STACK_PUSH_16(((u16*) data)[index]); break; }
+                    case WAVE_TYPE_U32: { STACK_PUSH_32(((u32*) data)[index]); break; }
+                    case WAVE_TYPE_U64: { STACK_PUSH_64(((u64*) data)[index]); break; }
 
                     default: {
                         return ERROR_CODE_LANGUAGE_RUNTIME_INVALID_SWITCH_CASE_VALUE;
@@ -1738,15 +1823,16 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                     THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
                 }
 
-                u32 field = *((u32*) array); array += sizeof(u32);
-                u32 length = field & (U32_BIT_1 >> 3);
+                u32 field = WAVE_ARRAY_GET_FIELD(array);
+                u32 length = WAVE_ARRAY_GET_LENGTH(field);
+                array = (str) WAVE_ARRAY_GET_DATA(array, field);
 
                 u32 index = 0; STACK_GET_U32(index, 0); // get the desired index from the stack
                 if (index >= length) {
                     THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_INDEX_OUT_OF_BOUNDS);
                 }
 
-                wave_type value_type = (wave_type) ((field >> (U32_BIT_COUNT - 2)) & 0b11);
+                wave_type value_type = WAVE_ARRAY_GET_VALUE_TYPE(field);
                 switch (value_type) {
                     case WAVE_TYPE_U8:  { u8 value  = 0; STACK_GET_U8(value, sizeof(u32));  ((u8*)  array)[index] = value; break; }
                     case WAVE_TYPE_U16: { u16 value = 0; STACK_GET_U16(value, sizeof(u32)); ((u16*) array)[index] = value; break; }
@@ -1776,8 +1862,7 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                     THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
                 }
 
-                u32 field = *((u32*) array);
-                u32 length = field & (U32_BIT_1 >> 3);
+                u32 length = WAVE_ARRAY_GET_LENGTH(WAVE_ARRAY_GET_FIELD(array));
                 STACK_PUSH_32(length);
                 break;
             }
@@ -1838,7 +1923,6 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 break;
             }
 
-            #undef MEMORY_COPY_WORD_WISE
             #undef WORD_PUSH
 
             #if WAVE_VM_SAFE_MODE == 0
@@ -1990,6 +2074,7 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 byte parameter = GET_BYTE(); NEXT_BYTE();
                 wave_type convert_from = (wave_type) ((parameter >> 4) & 0b00001111);
                 wave_type convert_to = (wave_type) ((parameter >> 0) & 0b00001111);
+                STACK_RESERVE(sizeof(u64)); // the converted value may be larger than the original one
 
                 #if WAVE_VM_SAFE_MODE == 0
                 #define CONVERT(from_type, from_name, to_type, to_name)                                     \
@@ -2057,6 +2142,7 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
                 byte parameter = GET_BYTE(); NEXT_BYTE();
                 wave_type convert_from = (wave_type) ((parameter >> 4) & 0b00001111);
                 wave_type convert_to = (wave_type) ((parameter >> 0) & 0b00001111);
+                STACK_RESERVE(sizeof(u64)); // the converted value may be larger than the original one
 
                 #if WAVE_VM_SAFE_MODE == 0
                 #define CONVERT(from_type, from_name, to_type, to_name)                                         \
@@ -2107,6 +2193,487 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
 
             #undef CONVERT_SWITCH
 
+            ////////////////////////////////////////////////////////////////
+            // Extended Opcodes                                           //
+            ////////////////////////////////////////////////////////////////
+
+            case OPCODE_EXT: {
+                /* Instruction Bytecode: [ opcode | 8bit extended_opcode | ... ]
+                *
+                *     @extended_opcode (8bit) - the extended opcode to execute (see wave_opcodes_extended_inline.h)
+                *
+                * Executes the extended opcode @extended_opcode. Extended opcodes are used for less frequent
+                * instructions, as all 256 main opcodes are in use.
+                * */
+
+                wave_opcode_extended extended_opcode = (wave_opcode_extended) GET_BYTE(); NEXT_BYTE();
+
+                // reads a value of the size of @value_type at @offset in the stack into a 64bit variable
+
+                #define ARRAY_STACK_GET_VALUE(variable, value_size, offset)                 \
+                    do {                                                                    \
+                        switch (value_size) {                                               \
+                            case (sizeof(u8)):  { STACK_GET_U8(variable,  offset); break; } \
+                            case (sizeof(u16)): { STACK_GET_U16(variable, offset); break; } \
+                            case (sizeof(u32)): { STACK_GET_U32(variable, offset); break; } \
+                            case (sizeof(u64)): { STACK_GET_U64(variable, offset); break; } \
+                                                                                            \
+                            default: {                                                      \
+                                THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_TYPE_MISMATCH);\
+                            }                                                               \
+                        }                                                                   \
+                    } while (0)
+
+                #if WAVE_VM_SAFE_MODE != 0
+                    #define ARRAY_CHECK_VALUE_SIZE(field, value_size)                           \
+                        do {                                                                    \
+                            if (WAVE_ARRAY_GET_VALUE_SIZE(field) != (value_size)) {             \
+                                THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_TYPE_MISMATCH);    \
+                            }                                                                   \
+                        } while (0)
+                #else
+                    #define ARRAY_CHECK_VALUE_SIZE(field, value_size) EMPTY_CODE_BLOCK()
+                #endif
+
+                switch (extended_opcode) {
+                    ////////////////////////////////////////////////////////////////
+                    // Array Bulk Operations                                      //
+                    ////////////////////////////////////////////////////////////////
+
+                    case OPCODE_EXT_ARR_FILL: {
+                        /* Instruction Bytecode: [ opcode | 8bit extended_opcode | 8bit value_type ]
+                        *
+                        *     @value_type (8bit) - the type of @value, its size must match the value size of @array
+                        *
+                        * Stack Parameters: (bottom -> top)
+                        *
+                        *     @array (addr) - the array to be filled
+                        *     @value (x bit) - the value
+                        *
+                        * Sets every element of @array to @value. The array is filled word by word,
+                        * so filling a view (see @OPCODE_EXT_ARR_SLICE) sets a range of another array.
+                        *
+                        * Parameters are not popped off the stack.
+                        * */
+
+                        wave_type value_type = (wave_type) GET_BYTE(); NEXT_BYTE();
+                        umax value_size = wave_type_get_size(value_type);
+
+                        u64 value = 0; ARRAY_STACK_GET_VALUE(value, value_size, 0);
+                        str array = NULL; STACK_GET(array, value_size);
+                        if (array == NULL) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
+                        }
+
+                        u32 field = WAVE_ARRAY_GET_FIELD(array);
+                        ARRAY_CHECK_VALUE_SIZE(field, value_size);
+
+                        wave_array_fill(WAVE_ARRAY_GET_DATA(array, field), WAVE_ARRAY_GET_LENGTH(field), WAVE_ARRAY_GET_VALUE_TYPE(field), value);
+                        break;
+                    }
+
+                    case OPCODE_EXT_ARR_COPY: {
+                        /* Stack Parameters: (bottom -> top)
+                        *
+                        *     @destination (addr) - the array that is copied to
+                        *     @destination_index (32bit) - the index of the first element that is written in @destination
+                        *     @source (addr) - the array that is copied from
+                        *     @source_index (32bit) - the index of the first element that is read from @source
+                        *     @length (32bit) - the amount of elements to copy
+                        *
+                        * Copies @length elements from @source starting at @source_index to @destination starting at @destination_index.
+                        * Both arrays need to store values of the same size. @source and @destination may be the same array or
+                        * views of the same array, overlapping ranges are copied as if an intermediate buffer was used.
+                        *
+                        * Parameters are not popped off the stack.
+                        * */
+
+                        u32 length = 0; STACK_GET_U32(length, 0);
+                        u32 source_index = 0; STACK_GET_U32(source_index, sizeof(u32));
+                        str source = NULL; STACK_GET(source, sizeof(u32) * 2);
+                        u32 destination_index = 0; STACK_GET_U32(destination_index, sizeof(u32) * 2 + sizeof(addr));
+                        str destination = NULL; STACK_GET(destination, sizeof(u32) * 3 + sizeof(addr));
+                        if (source == NULL || destination == NULL) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
+                        }
+
+                        u32 source_field = WAVE_ARRAY_GET_FIELD(source);
+                        u32 destination_field = WAVE_ARRAY_GET_FIELD(destination);
+                        if (WAVE_ARRAY_GET_VALUE_TYPE(source_field) != WAVE_ARRAY_GET_VALUE_TYPE(destination_field)) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_TYPE_MISMATCH);
+                        }
+
+                        if ((u64) source_index + length > WAVE_ARRAY_GET_LENGTH(source_field) || (u64) destination_index + length > WAVE_ARRAY_GET_LENGTH(destination_field)) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_INDEX_OUT_OF_BOUNDS);
+                        }
+
+                        umax value_size = WAVE_ARRAY_GET_VALUE_SIZE(source_field);
+                        wave_array_move(
+                            WAVE_ARRAY_GET_DATA(destination, destination_field) + value_size * destination_index,
+                            WAVE_ARRAY_GET_DATA(source, source_field) + value_size * source_index,
+                            value_size * length
+                        );
+
+                        break;
+                    }
+
+                    case OPCODE_EXT_ARR_SLICE: {
+                        /* Stack Parameters: (bottom -> top)
+                        *
+                        *     @array (addr) - the array to create a view of
+                        *     @start (32bit) - the index of the first element of the view
+                        *     @length (32bit) - the amount of elements in the view
+                        *
+                        * Allocates a new array view that references @length elements of @array starting at @start
+                        * without copying any data and pushes its address to the stack. Views of views reference the
+                        * original data directly. Writing to a view modifies the original array.
+                        *
+                        * ARRAY VIEW STRUCTURE: [ 32bit field : (2bit value_size, 1bit dynamic, 1bit view, 1bit sliced, 27bit length) | addr data ]
+                        *
+                        * A view must not outlive the array it references and cannot be resized. @array is marked as sliced,
+                        * so that @OPCODE_EXT_ARR_PUSH never moves the data the view points to.
+                        * Views need to be popped off the stack using @POP_FREE, which only frees the view itself.
+                        *
+                        * Parameters are not popped off the stack.
+                        * */
+
+                        u32 length = 0; STACK_GET_U32(length, 0);
+                        u32 start = 0; STACK_GET_U32(start, sizeof(u32));
+                        str array = NULL; STACK_GET(array, sizeof(u32) * 2);
+                        if (array == NULL) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
+                        }
+
+                        u32 field = WAVE_ARRAY_GET_FIELD(array);
+                        if ((u64) start + length > WAVE_ARRAY_GET_LENGTH(field)) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_INDEX_OUT_OF_BOUNDS);
+                        }
+
+                        str view = NULL;
+                        RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &view, sizeof(u32) + sizeof(addr));
+
+                        WAVE_ARRAY_GET_FIELD(array) = field | WAVE_ARRAY_FIELD_SLICED_BIT; // a view of a view leaves the array it was taken from sliced already
+
+                        WAVE_ARRAY_GET_FIELD(view) = WAVE_ARRAY_CREATE_FIELD(WAVE_ARRAY_GET_VALUE_TYPE(field), length) | WAVE_ARRAY_FIELD_VIEW_BIT;
+                        *((byte**) (view + sizeof(u32))) = WAVE_ARRAY_GET_DATA(array, field) + WAVE_ARRAY_GET_VALUE_SIZE(field) * start;
+
+                        STACK_PUSH_ADDR(view);
+                        break;
+                    }
+
+                    case OPCODE_EXT_ARR_FIND: {
+                        /* Instruction Bytecode: [ opcode | 8bit extended_opcode | 8bit value_type ]
+                        *
+                        *     @value_type (8bit) - the type of @value, used to compare floats by value; its size must match the value size of @array
+                        *
+                        * Stack Parameters: (bottom -> top)
+                        *
+                        *     @array (addr) - the array to be searched
+                        *     @value (x bit) - the value to search for
+                        *     @start (32bit) - the index to start searching at
+                        *
+                        * Searches @array for the first element equal to @value, beginning at @start, and pushes its index (u32)
+                        * to the stack. If no element matches, U32_MAX is pushed instead.
+                        *
+                        * Parameters are not popped off the stack.
+                        * */
+
+                        wave_type value_type = (wave_type) GET_BYTE(); NEXT_BYTE();
+                        umax value_size = wave_type_get_size(value_type);
+
+                        u32 start = 0; STACK_GET_U32(start, 0);
+                        u64 value = 0; ARRAY_STACK_GET_VALUE(value, value_size, sizeof(u32));
+                        str array = NULL; STACK_GET(array, sizeof(u32) + value_size);
+                        if (array == NULL) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
+                        }
+
+                        u32 field = WAVE_ARRAY_GET_FIELD(array);
+                        ARRAY_CHECK_VALUE_SIZE(field, value_size);
+
+                        u32 length = WAVE_ARRAY_GET_LENGTH(field);
+                        u32 index = U32_MAX;
+                        if (start < length) {
+                            index = wave_array_find(WAVE_ARRAY_GET_DATA(array, field) + value_size * start, length - start, value_type, value);
+                            index = index == U32_MAX ? U32_MAX : index + start;
+                        }
+
+                        STACK_PUSH_32(index);
+                        break;
+                    }
+
+                    case OPCODE_EXT_ARR_PUSH: {
+                        /* Instruction Bytecode: [ opcode | 8bit extended_opcode | 8bit value_type ]
+                        *
+                        *     @value_type (8bit) - the type of @value, its size must match the value size of @array
+                        *
+                        * Stack Parameters: (bottom -> top)
+                        *
+                        *     @array (addr) - the array that is appended to
+                        *     @value (x bit) - the value to append
+                        *
+                        * Appends @value to the end of @array. The first push turns the array into a dynamic array, whose capacity
+                        * is the next power of two of its length (see @wave_array_get_capacity). Further pushes only reallocate
+                        * once the capacity is exhausted, which keeps appending amortized constant time.
+                        *
+                        * Reallocating moves the data of the array, which is why arrays that views were created of (see @OPCODE_EXT_ARR_SLICE)
+                        * only grow within their capacity. Other copies of the address of @array are outdated after a reallocation, as with @OPCODE_STR_CONCAT.
+                        *
+                        * Both parameters are popped off the stack and the (possibly reallocated) address of @array is pushed.
+                        * */
+
+                        wave_type value_type = (wave_type) GET_BYTE(); NEXT_BYTE();
+                        umax value_size = wave_type_get_size(value_type);
+
+                        u64 value = 0; ARRAY_STACK_GET_VALUE(value, value_size, 0);
+                        str array = NULL; STACK_GET(array, value_size);
+                        if (array == NULL) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_NULL_POINTER_EXCEPTION);
+                        }
+
+                        u32 field = WAVE_ARRAY_GET_FIELD(array);
+                        ARRAY_CHECK_VALUE_SIZE(field, value_size);
+
+                        if ((field & WAVE_ARRAY_FIELD_VIEW_BIT) != 0) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_VIEW_NOT_RESIZABLE);
+                        }
+
+                        u32 length = WAVE_ARRAY_GET_LENGTH(field);
+                        if (length >= WAVE_ARRAY_LENGTH_MAX) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_TOO_LONG);
+                        }
+
+                        // a dynamic array is only full, once its length reached its capacity
+
+                        if ((field & WAVE_ARRAY_FIELD_DYNAMIC_BIT) == 0 || length == wave_array_get_capacity(length)) {
+                            if ((field & WAVE_ARRAY_FIELD_SLICED_BIT) != 0) {
+                                THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_ARRAY_SLICED_NOT_RESIZABLE);
+                            }
+
+                            RUN_ERROR_CODE_FUNCTION(reallocate_memory, (void**) &array, sizeof(u32) + value_size * wave_array_get_capacity(length + 1));
+                        }
+
+                        WAVE_ARRAY_GET_FIELD(array) = WAVE_ARRAY_CREATE_FIELD(WAVE_ARRAY_GET_VALUE_TYPE(field), length + 1) | (field & WAVE_ARRAY_FIELD_SLICED_BIT) | WAVE_ARRAY_FIELD_DYNAMIC_BIT;
+
+                        byte* data = (byte*) array + sizeof(u32) + value_size * length;
+                        switch (value_size) {
+                            case (sizeof(u8)):  { *((u8*)  data) = (u8)  value; break; }
+                            case (sizeof(u16)): { *((u16*) data) = (u16) value; break; }
+                            case (sizeof(u32)): { *((u32*) data) = (u32) value; break; }
+                            case (sizeof(u64)): { *((u64*) data) = (u64) value; break; }
+
+                            default: {
+                                break;
+                            }
+                        }
+
+                        STACK_POP_BYTES(value_size + sizeof(addr));
+                        STACK_PUSH_ADDR(array);
+                        break;
+                    }
+
+                    ////////////////////////////////////////////////////////////////
+                    // Local Stack                                                //
+                    ////////////////////////////////////////////////////////////////
+
+                    /* Instruction Bytecode: [ opcode | 8bit extended_opcode | 16bit offset ]
+                    *
+                    *     @offset (16bit) - the offset of the variable from the start of the local stack (function stack frame)
+                    *
+                    * Stack Parameters: (bottom -> top)
+                    *
+                    *     @value (x bit) - the value to be stored
+                    *
+                    * Sets the variable at @offset in the local stack (function stack frame) to @value.
+                    * The compiler emits this in place of a store followed by a load of the same variable.
+                    *
+                    * Parameters are not popped off the stack.
+                    * */
+                    #define OPCODE_IMPL_STORE_KEEP(type)                                            \
+                        do {                                                                        \
+                            u16 offset = GET_U16(); NEXT_16();                                      \
+                            typeof(*call_stack) stack_frame = *(call_stack - 1);                    \
+                            type value = 0; STACK_GET(value, 0);                                    \
+                            *((type*) (stack_start + stack_frame + offset)) = value;                \
+                        } while (0)
+
+                    case OPCODE_EXT_STORE_KEEP_8:  { OPCODE_IMPL_STORE_KEEP(u8);  break; }
+                    case OPCODE_EXT_STORE_KEEP_16: { OPCODE_IMPL_STORE_KEEP(u16); break; }
+                    case OPCODE_EXT_STORE_KEEP_32: { OPCODE_IMPL_STORE_KEEP(u32); break; }
+                    case OPCODE_EXT_STORE_KEEP_64: { OPCODE_IMPL_STORE_KEEP(u64); break; }
+
+                    #undef OPCODE_IMPL_STORE_KEEP
+
+                    ////////////////////////////////////////////////////////////////
+                    // Frame Allocation                                           //
+                    ////////////////////////////////////////////////////////////////
+
+                    case OPCODE_EXT_STR_NEW_LOCAL: {
+                        /* Instruction Bytecode: [ opcode | 8bit extended_opcode | 16bit offset | 32bit length | str string_data ]
+                        *
+                        *     @offset (16bit) - the offset of the string from the start of the local stack (function stack frame)
+                        *     @length (32bit) - the length of @string_data in bytes
+                        *     @string_data (n bits) - the uncompressed string data (not null-terminated)
+                        *
+                        * Same as @OPCODE_STR_NEW, but the string is written to the local stack frame at @offset instead of
+                        * being allocated. The compiler only emits this for strings that do not escape the function,
+                        * which is why the string must not be freed and is popped off the stack like any other address.
+                        * If @offset is @WAVE_LIMIT_OPCODE_STR_NEW_LOCAL_HEAP, the string is allocated like with @OPCODE_STR_NEW.
+                        *
+                        * The local stack frame needs to reserve sizeof(u32) + @length bytes at @offset.
+                        * */
+
+                        u16 offset = GET_U16(); NEXT_16();
+                        u32 length = GET_U32(); NEXT_32();
+
+                        str string_start = NULL;
+                        if (offset == WAVE_LIMIT_OPCODE_STR_NEW_LOCAL_HEAP) {
+                            RUN_ERROR_CODE_FUNCTION(allocate_memory, (void**) &string_start, sizeof(u32) + sizeof(char) * length);
+                        } else {
+                            typeof(*call_stack) stack_frame = *(call_stack - 1);
+                            string_start = (str) (stack_start + stack_frame + offset);
+                            vm->stack_pinned = true; // the address of the string must stay valid
+                        }
+
+                        *((u32*) string_start) = length;
+
+                        str string = string_start + sizeof(u32); // move to the start of the string
+                        str string_end = string + length;
+
+                        #define WORD_PUSH(type, type_name) *((type*) string) = GET_##type_name(); string += sizeof(type); NEXT_TYPE(type)
+                        MEMORY_COPY_WORD_WISE(string_end, string);
+                        #undef WORD_PUSH
+
+                        STACK_PUSH_ADDR(string_start);
+                        break;
+                    }
+
+                    ////////////////////////////////////////////////////////////////
+                    // Functions                                                  //
+                    ////////////////////////////////////////////////////////////////
+
+                    case OPCODE_EXT_TAIL_CALL: {
+                        /* Instruction Bytecode: [ opcode | 8bit extended_opcode | 32bit branch_offset ]
+                        *
+                        *     @branch_offset (32bit) - the offset of the called function relative to the start of the bytecode
+                        *
+                        * Same as @OPCODE_CALL followed by @OPCODE_RETURN, but without growing the call stack. The parameters of the called
+                        * function are moved to the start of the current stack frame, which drops the locals and the values of the current
+                        * function, and its call stack entry is kept, so the called function returns to the parent of the current one.
+                        * Only the child instruction pointer is replaced, as the root sets of the called function apply from now on.
+                        *
+                        * The compiler only emits this instruction for calls in tail position, in functions that do not have to free any
+                        * objects and do not place objects in their stack frame (see @OPCODE_EXT_STR_NEW_LOCAL).
+                        * */
+
+                        u32 branch_offset = GET_U32(); NEXT_32();
+                        #if WAVE_VM_SAFE_MODE != 0
+                        if ((bytecode_start + branch_offset) > bytecode_end) {
+                            THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_JUMPED_OUT_OF_BYTECODE);
+                        }
+                        #endif
+
+                        bytecode = bytecode_start + branch_offset;
+                        PROFILE_COUNT(profile_executed_counts, bytecode);
+
+                        u16 parameter_size = GET_U16(); NEXT_16();
+                        u16 locals_stack_frame_size = GET_U16(); NEXT_16();
+
+                        // the stack frame starts below the parameters, so copying from the front never overwrites bytes that were not read yet
+
+                        typeof(*call_stack) stack_frame = *(call_stack - 1);
+                        byte* parameters = stack - parameter_size;
+                        stack = stack_start + stack_frame;
+                        for (u16 i = 0; i < parameter_size; i++) {
+                            stack[i] = parameters[i];
+                        }
+
+                        stack += parameter_size;
+                        STACK_RESERVE(locals_stack_frame_size + WAVE_VM_STACK_HEADROOM);
+
+                        *(call_stack - 2) = (typeof(*call_stack)) branch_offset; // child instruction pointer (used in error handling)
+
+                        stack += locals_stack_frame_size;
+                        break;
+                    }
+
+                    ////////////////////////////////////////////////////////////////
+                    // Type Conversion                                            //
+                    ////////////////////////////////////////////////////////////////
+
+                    /* Stack Parameters: (bottom -> top)
+                    *
+                    *     @value (8 - 64bit) - the value that is being converted
+                    *
+                    * Same as @OPCODE_TYPE_CONV_STATIC with a fixed pair of types, which the compiler emits in its place.
+                    * Truncations and zero extensions do not depend on the signedness, sign extensions do.
+                    * */
+                    #if WAVE_VM_SAFE_MODE == 0
+                    #define OPCODE_IMPL_CONVERT(from_type, to_type)                                             \
+                        do {                                                                                    \
+                            STACK_ACCESS_TYPE(from_type, to_type, 0) = (to_type) STACK_ACCESS(from_type, 0);    \
+                            stack += sizeof(to_type);                                                           \
+                            stack -= sizeof(from_type);                                                         \
+                        } while (0)
+                    #else
+                    #define OPCODE_IMPL_CONVERT(from_type, to_type)                                                                     \
+                        do {                                                                                                            \
+                            if (STACK_GET_TOP() >= sizeof(from_type) && (stack_end - stack) >= (sizeof(from_type) + sizeof(to_type))) { \
+                                STACK_ACCESS_TYPE(from_type, to_type, 0) = (to_type) STACK_ACCESS(from_type, 0);                        \
+                                stack += sizeof(to_type);                                                                               \
+                                stack -= sizeof(from_type);                                                                             \
+                            } else {                                                                                                    \
+                                THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_STACK_OVERFLOW);                                                \
+                            }                                                                                                           \
+                        } while (0)
+                    #endif
+
+                    case OPCODE_EXT_U16_TO_U8:  { OPCODE_IMPL_CONVERT(u16, u8);  break; }
+                    case OPCODE_EXT_U32_TO_U8:  { OPCODE_IMPL_CONVERT(u32, u8);  break; }
+                    case OPCODE_EXT_U32_TO_U16: { OPCODE_IMPL_CONVERT(u32, u16); break; }
+                    case OPCODE_EXT_U64_TO_U8:  { OPCODE_IMPL_CONVERT(u64, u8);  break; }
+                    case OPCODE_EXT_U64_TO_U16: { OPCODE_IMPL_CONVERT(u64, u16); break; }
+                    case OPCODE_EXT_U64_TO_U32: { OPCODE_IMPL_CONVERT(u64, u32); break; }
+
+                    case OPCODE_EXT_U8_TO_U16:  { OPCODE_IMPL_CONVERT(u8,  u16); break; }
+                    case OPCODE_EXT_U8_TO_U32:  { OPCODE_IMPL_CONVERT(u8,  u32); break; }
+                    case OPCODE_EXT_U8_TO_U64:  { OPCODE_IMPL_CONVERT(u8,  u64); break; }
+                    case OPCODE_EXT_U16_TO_U32: { OPCODE_IMPL_CONVERT(u16, u32); break; }
+                    case OPCODE_EXT_U16_TO_U64: { OPCODE_IMPL_CONVERT(u16, u64); break; }
+                    case OPCODE_EXT_U32_TO_U64: { OPCODE_IMPL_CONVERT(u32, u64); break; }
+
+                    case OPCODE_EXT_I8_TO_I16:  { OPCODE_IMPL_CONVERT(i8,  i16); break; }
+                    case OPCODE_EXT_I8_TO_I32:  { OPCODE_IMPL_CONVERT(i8,  i32); break; }
+                    case OPCODE_EXT_I8_TO_I64:  { OPCODE_IMPL_CONVERT(i8,  i64); break; }
+                    case OPCODE_EXT_I16_TO_I32: { OPCODE_IMPL_CONVERT(i16, i32); break; }
+                    case OPCODE_EXT_I16_TO_I64: { OPCODE_IMPL_CONVERT(i16, i64); break; }
+                    case OPCODE_EXT_I32_TO_I64: { OPCODE_IMPL_CONVERT(i32, i64); break; }
+
+                    case OPCODE_EXT_I32_TO_F32: { OPCODE_IMPL_CONVERT(i32, f32); break; }
+                    case OPCODE_EXT_I32_TO_F64: { OPCODE_IMPL_CONVERT(i32, f64); break; }
+                    case OPCODE_EXT_U32_TO_F64: { OPCODE_IMPL_CONVERT(u32, f64); break; }
+                    case OPCODE_EXT_I64_TO_F64: { OPCODE_IMPL_CONVERT(i64, f64); break; }
+                    case OPCODE_EXT_F32_TO_I32: { OPCODE_IMPL_CONVERT(f32, i32); break; }
+                    case OPCODE_EXT_F64_TO_I32: { OPCODE_IMPL_CONVERT(f64, i32); break; }
+                    case OPCODE_EXT_F64_TO_I64: { OPCODE_IMPL_CONVERT(f64, i64); break; }
+                    case OPCODE_EXT_F32_TO_F64: { OPCODE_IMPL_CONVERT(f32, f64); break; }
+                    case OPCODE_EXT_F64_TO_F32: { OPCODE_IMPL_CONVERT(f64, f32); break; }
+
+                    #undef OPCODE_IMPL_CONVERT
+
+                    default: {
+                        return ERROR_CODE_LANGUAGE_RUNTIME_INVALID_OPCODE;
+                    }
+                }
+
+                #undef ARRAY_STACK_GET_VALUE
+                #undef ARRAY_CHECK_VALUE_SIZE
+
+                break;
+            }
+
+            #undef MEMORY_COPY_WORD_WISE // also used by @OPCODE_EXT_STR_NEW_LOCAL
+
             default: { // this case should never hit, especially if 256 opcodes are defined, and indicates that an instruction was not executed properly or the compiler version differs from this version
                 return ERROR_CODE_LANGUAGE_RUNTIME_INVALID_OPCODE;
             }
@@ -2173,6 +2740,11 @@ error_code WAVE_VM_EXECUTE_FUNCTION_NAME(wave_vm* vm) {
     #undef ERROR_STACK_PUSH
     #undef THROW_ERROR
 
+    #undef STACK_RESERVE
+    #undef CALL_STACK_RESERVE
+
+    #undef PROFILE_COUNT
+
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
@@ -6,6 +6,15 @@
 #define THROW_ERROR(error) do { return error; } while (0)
 #endif
 
+// growing the stack (the vm grows its stack before every push, see @STACK_RESERVE in wave_vm_inline.h,
+// native functions push into the headroom that is reserved before they are called)
+
+#if WAVE_VM_STACK_INLINE_GROW != 0
+#define STACK_GROW(size) STACK_RESERVE(size)
+#else
+#define STACK_GROW(size) do { } while (0)
+#endif
+
 // accessing the stack
 
 #define STACK_TOP (stack)
@@ -23,12 +32,14 @@
 #if WAVE_VM_SAFE_MODE == 0
     #define STACK_PUSH_TYPE(type, value)        \
         do {                                    \
+            STACK_GROW(sizeof(type));           \
             STACK_ACCESS_TOP(type) = (value);   \
             STACK_TOP += sizeof(type);          \
         } while (0)
 #else
     #define STACK_PUSH_TYPE(type, value)                                    \
         do {                                                                \
+            STACK_GROW(sizeof(type));                                       \
             if (STACK_TOP + sizeof(type) <= STACK_END) {                    \
                 STACK_ACCESS_TOP(type) = (value);                           \
                 STACK_TOP += sizeof(type);                                  \
@@ -203,12 +214,14 @@
 #if WAVE_VM_SAFE_MODE == 0
     #define STACK_DUP_TYPE(type)                            \
         do {                                                \
+            STACK_GROW(sizeof(type));                       \
             STACK_ACCESS_TOP(type) = STACK_ACCESS(type, 0); \
             STACK_TOP += sizeof(type);                      \
         } while (0)
 #else
     #define STACK_DUP_TYPE(type)                                                                \
         do {                                                                                    \
+            STACK_GROW(sizeof(type));                                                           \
             if (STACK_GET_TOP() >= sizeof(type) && (STACK_TOP + sizeof(type)) <= STACK_END) {   \
                 STACK_ACCESS_TOP(type) = STACK_ACCESS(type, 0);                                 \
                 STACK_TOP += sizeof(type);                                                      \
@@ -223,12 +236,14 @@
 #if WAVE_VM_SAFE_MODE == 0
     #define STACK_PULL_TYPE(type, offset)                           \
         do {                                                        \
+            STACK_GROW(sizeof(type));                               \
             STACK_ACCESS_TOP(type) = STACK_ACCESS(type, offset);    \
             STACK_TOP += sizeof(type);                              \
         } while (0)
 #else
     #define STACK_PULL_TYPE(type, offset)                                                                   \
         do {                                                                                                \
+            STACK_GROW(sizeof(type));                                                                       \
             if (STACK_GET_TOP() >= (sizeof(type) + (offset)) && (STACK_TOP + sizeof(type)) <= STACK_END) {  \
                 STACK_ACCESS_TOP(type) = STACK_ACCESS(type, offset);                                        \
                 STACK_TOP += sizeof(type);                                                                  \
@@ -263,13 +278,13 @@
     #define STACK_OPERATION_BINARY(type, operation)                                                                 \
         do {                                                                                                        \
             STACK_ACCESS(type, sizeof(type)) = STACK_ACCESS(type, sizeof(type)) operation STACK_ACCESS(type, 0);    \
-            STACK_TOP -= sizeof(u32);                                                                               \
+            STACK_TOP -= sizeof(type);                                                                              \
         } while (0)
 
     #define STACK_OPERATION_BINARY_FUNC(type, function_name)                                                            \
         do {                                                                                                            \
             STACK_ACCESS(type, sizeof(type)) = function_name(STACK_ACCESS(type, sizeof(type)), STACK_ACCESS(type, 0));  \
-            STACK_TOP -= sizeof(u32);                                                                                   \
+            STACK_TOP -= sizeof(type);                                                                                  \
         } while (0)
 
     #define STACK_OPERATION_BINARY_FUNC_ZERO_CHECK(type, function_name)                                                     \
@@ -326,7 +341,7 @@
         do {                                                                                                            \
             if (STACK_GET_TOP() >= (umax) (sizeof(type) * 2)) {                                                         \
                 STACK_ACCESS(type, sizeof(type)) = STACK_ACCESS(type, sizeof(type)) operation STACK_ACCESS(type, 0);    \
-                STACK_TOP -= sizeof(u32);                                                                               \
+                STACK_TOP -= sizeof(type);                                                                              \
             } else {                                                                                                    \
                 THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_OPERATION_LEFT_STACK);                                          \
             }                                                                                                           \
@@ -336,7 +351,7 @@
         do {                                                                                                                \
             if (STACK_GET_TOP() >= (umax) (sizeof(type) * 2)) {                                                             \
                 STACK_ACCESS(type, sizeof(type)) = function_name(STACK_ACCESS(type, sizeof(type)), STACK_ACCESS(type, 0));  \
-                STACK_TOP -= sizeof(u32);                                                                                   \
+                STACK_TOP -= sizeof(type);                                                                                  \
             } else {                                                                                                        \
                 THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_OPERATION_LEFT_STACK);                                              \
             }                                                                                                               \
@@ -344,7 +359,7 @@
 
     #define STACK_OPERATION_BINARY_FUNC_ZERO_CHECK(type, function_name)                                                     \
         do {                                                                                                                \
-            if (STACK_GET_TOP() >= (umax) (sizeof(type) * 2)) {                                                             \
+            if (STACK_GET_TOP() < (umax) (sizeof(type) * 2)) {                                                              \
                 THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_OPERATION_LEFT_STACK);                                              \
             }                                                                                                               \
                                                                                                                             \
@@ -359,7 +374,7 @@
 
     #define STACK_OPERATION_BINARY_ASSIGN_ZERO_CHECK(type, operation)               \
         do {                                                                        \
-            if (STACK_GET_TOP() >= (umax) (sizeof(type) * 2)) {                     \
+            if (STACK_GET_TOP() < (umax) (sizeof(type) * 2)) {                      \
                 THROW_ERROR(ERROR_CODE_LANGUAGE_RUNTIME_OPERATION_LEFT_STACK);      \
             }                                                                       \
                                                                                     \
@@ -379,6 +394,10 @@
 
 #undef THROW_ERROR
 
+// growing the stack
+
+#undef STACK_GROW
+
 // accessing stack
 
 #undef STACK_TOP
@@ -458,4 +477,5 @@
 
 #undef WAVE_VM_STACK_INLINE_DEFINE
 #undef WAVE_VM_STACK_INLINE_THROW_ERRORS
+#undef WAVE_VM_STACK_INLINE_GROW
 #undef WAVE_VM_SAFE_MODE
@@ -15,9 +15,13 @@
 
 #define WAVE_LIMIT_OPCODE_POP_N_MAX (U16_MAX)
 
+#define WAVE_LIMIT_OPCODE_STR_NEW_LOCAL_HEAP (U16_MAX) /* the offset used by @OPCODE_EXT_STR_NEW_LOCAL to allocate the string on the heap instead */
+
 // Other
 
 #define WAVE_LIMIT_MAX_LOCALS_OFFSET (U16_MAX)
 #define WAVE_LIMIT_MAX_GLOBALS_OFFSET (U16_MAX)
 
+#define WAVE_LIMIT_MAX_FRAME_OBJECT_SIZE (256) /* objects larger than this are never placed in the local stack frame */
+
 #endif
@@ -12,8 +12,16 @@ str WAVE_OPCODE_NAMES[] = {
 
     #undef OPCODE_ENTRY
 };
+
+str WAVE_OPCODE_EXTENDED_NAMES[] = {
+    #define OPCODE_EXTENDED_ENTRY(name) WAVE_OPCODE_EXTENDED_PREFIX_STRING #name,
+    #include "wave_opcodes_extended_inline.h"
+
+    #undef OPCODE_EXTENDED_ENTRY
+};
 #else
 str WAVE_OPCODE_NAMES[] = { "OPCODE_UNDEFINED" };
+str WAVE_OPCODE_EXTENDED_NAMES[] = { "OPCODE_EXT_UNDEFINED" };
 #endif
 
 // Opcode Functions
@@ -33,3 +41,19 @@ str wave_opcode_get_complete_name(wave_opcode opcode) {
     return WAVE_OPCODE_NAMES[0];
     #endif
 }
+
+str wave_opcode_extended_get_name(wave_opcode_extended opcode) {
+    #if PROGRAM_FEATURE_NO_OPCODE_NAMES == 0
+    return WAVE_OPCODE_EXTENDED_NAMES[opcode] + (STRING_LENGTH(WAVE_OPCODE_EXTENDED_PREFIX_STRING) - 1);
+    #else
+    return WAVE_OPCODE_EXTENDED_NAMES[0];
+    #endif
+}
+
+str wave_opcode_extended_get_complete_name(wave_opcode_extended opcode) {
+    #if PROGRAM_FEATURE_NO_OPCODE_NAMES == 0
+    return WAVE_OPCODE_EXTENDED_NAMES[opcode];
+    #else
+    return WAVE_OPCODE_EXTENDED_NAMES[0];
+    #endif
+}
@@ -9,6 +9,7 @@
 // Enum Generation
 
 #define WAVE_OPCODE_PREFIX_STRING "OPCODE_"
+#define WAVE_OPCODE_EXTENDED_PREFIX_STRING "OPCODE_EXT_"
 
 typedef enum {
     #define OPCODE_ENTRY(name) CONCAT(OPCODE_, name),
@@ -22,6 +23,18 @@ COMPILE_ASSERT(OPCODE_MAX <= 256, too_many_opcodes_defined);
 
 typedef byte wave_opcode; // WAVE_OPCODES
 
+typedef enum {
+    #define OPCODE_EXTENDED_ENTRY(name) CONCAT(OPCODE_EXT_, name),
+    #include "wave_opcodes_extended_inline.h"
+
+    #undef OPCODE_EXTENDED_ENTRY
+
+    OPCODE_EXT_MAX
+} WAVE_OPCODES_EXTENDED;
+COMPILE_ASSERT(OPCODE_EXT_MAX <= 256, too_many_extended_opcodes_defined);
+
+typedef byte wave_opcode_extended; // WAVE_OPCODES_EXTENDED
+
 typedef enum {
     DEBUG_INSTRUCTION_TYPE_FUNCTION_START,
     DEBUG_INSTRUCTION_TYPE_FUNCTION_END,
@@ -39,4 +52,7 @@ typedef byte debug_instruction_type;
 str wave_opcode_get_name(wave_opcode opcode);
 str wave_opcode_get_complete_name(wave_opcode opcode);
 
+str wave_opcode_extended_get_name(wave_opcode_extended opcode);
+str wave_opcode_extended_get_complete_name(wave_opcode_extended opcode);
+
 #endif
@@ -0,0 +1,75 @@
+#ifndef OPCODE_EXTENDED_ENTRY
+#define OPCODE_EXTENDED_ENTRY(...)
+#endif
+
+// Extended Opcodes (maximum of 256 extended opcodes can be defined):
+// every extended opcode is prefixed by @OPCODE_EXT in the bytecode: [ OPCODE_EXT | 8bit extended_opcode | ... ]
+
+////////////////////////////////////////////////////////////////
+// Array Bulk Operations                                      //
+////////////////////////////////////////////////////////////////
+
+OPCODE_EXTENDED_ENTRY(ARR_FILL)         /* [ opcode | 8bit type ] - sets every element of the array (addr; @stack_top - sizeof(array.@type)) to the value at the top of the stack (array.@type; @stack_top) */
+OPCODE_EXTENDED_ENTRY(ARR_COPY)         /* copies @length elements from the source array at @source_index into the destination array at @destination_index, the ranges may overlap (see @OPCODE_EXT_ARR_COPY) */
+OPCODE_EXTENDED_ENTRY(ARR_SLICE)        /* pushes the address of a new array view referencing @length elements of the array (addr) starting at @start, without copying the data */
+OPCODE_EXTENDED_ENTRY(ARR_FIND)         /* [ opcode | 8bit type ] - pushes the index (u32) of the first element equal to @value starting at @start in the array or U32_MAX if no element matches */
+OPCODE_EXTENDED_ENTRY(ARR_PUSH)         /* [ opcode | 8bit type ] - appends the value at the top of the stack (array.@type; @stack_top) to the array (addr), growing it geometrically and replacing its address on the stack */
+
+////////////////////////////////////////////////////////////////
+// Local Stack                                                //
+////////////////////////////////////////////////////////////////
+
+OPCODE_EXTENDED_ENTRY(STORE_KEEP_8)     /* [ opcode | 16bit offset ] - like @OPCODE_STORE_8,  but leaves the value on the stack, replaces a store followed by a load of the same variable */
+OPCODE_EXTENDED_ENTRY(STORE_KEEP_16)    /* [ opcode | 16bit offset ] - like @OPCODE_STORE_16, but leaves the value on the stack, replaces a store followed by a load of the same variable */
+OPCODE_EXTENDED_ENTRY(STORE_KEEP_32)    /* [ opcode | 16bit offset ] - like @OPCODE_STORE_32, but leaves the value on the stack, replaces a store followed by a load of the same variable */
+OPCODE_EXTENDED_ENTRY(STORE_KEEP_64)    /* [ opcode | 16bit offset ] - like @OPCODE_STORE_64, but leaves the value on the stack, replaces a store followed by a load of the same variable */
+
+////////////////////////////////////////////////////////////////
+// Frame Allocation                                           //
+////////////////////////////////////////////////////////////////
+
+OPCODE_EXTENDED_ENTRY(STR_NEW_LOCAL)    /* [ opcode | 16bit offset | 32bit length | str string_data ] - like @OPCODE_STR_NEW, but places the string in the local stack frame at @offset, if it does not escape the function */
+
+////////////////////////////////////////////////////////////////
+// Functions                                                  //
+////////////////////////////////////////////////////////////////
+
+OPCODE_EXTENDED_ENTRY(TAIL_CALL)        /* [ opcode | 32bit branch_offset ] - like @OPCODE_CALL, but the called function reuses the stack frame and call stack entry of the current one, replaces a call followed by a return */
+
+////////////////////////////////////////////////////////////////
+// Type Conversion                                            //
+////////////////////////////////////////////////////////////////
+
+// specialized forms of @OPCODE_TYPE_CONV_STATIC, which convert the value at the top of the stack without decoding a type parameter
+// integers only depend on the width and the signedness of the converted type: the truncations and zero extensions serve the signed types of the same widths as well
+
+OPCODE_EXTENDED_ENTRY(U16_TO_U8)        /* truncates the 16bit integer at the top of the stack to 8 bits */
+OPCODE_EXTENDED_ENTRY(U32_TO_U8)        /* truncates the 32bit integer at the top of the stack to 8 bits */
+OPCODE_EXTENDED_ENTRY(U32_TO_U16)       /* truncates the 32bit integer at the top of the stack to 16 bits */
+OPCODE_EXTENDED_ENTRY(U64_TO_U8)        /* truncates the 64bit integer at the top of the stack to 8 bits */
+OPCODE_EXTENDED_ENTRY(U64_TO_U16)       /* truncates the 64bit integer at the top of the stack to 16 bits */
+OPCODE_EXTENDED_ENTRY(U64_TO_U32)       /* truncates the 64bit integer at the top of the stack to 32 bits */
+
+OPCODE_EXTENDED_ENTRY(U8_TO_U16)        /* zero extends the 8bit integer at the top of the stack to 16 bits */
+OPCODE_EXTENDED_ENTRY(U8_TO_U32)        /* zero extends the 8bit integer at the top of the stack to 32 bits */
+OPCODE_EXTENDED_ENTRY(U8_TO_U64)        /* zero extends the 8bit integer at the top of the stack to 64 bits */
+OPCODE_EXTENDED_ENTRY(U16_TO_U32)       /* zero extends the 16bit integer at the top of the stack to 32 bits */
+OPCODE_EXTENDED_ENTRY(U16_TO_U64)       /* zero extends the 16bit integer at the top of the stack to 64 bits */
+OPCODE_EXTENDED_ENTRY(U32_TO_U64)       /* zero extends the 32bit integer at the top of the stack to 64 bits */
+
+OPCODE_EXTENDED_ENTRY(I8_TO_I16)        /* sign extends the 8bit integer at the top of the stack to 16 bits */
+OPCODE_EXTENDED_ENTRY(I8_TO_I32)        /* sign extends the 8bit integer at the top of the stack to 32 bits */
+OPCODE_EXTENDED_ENTRY(I8_TO_I64)        /* sign extends the 8bit integer at the top of the stack to 64 bits */
+OPCODE_EXTENDED_ENTRY(I16_TO_I32)       /* sign extends the 16bit integer at the top of the stack to 32 bits */
+OPCODE_EXTENDED_ENTRY(I16_TO_I64)       /* sign extends the 16bit integer at the top of the stack to 64 bits */
+OPCODE_EXTENDED_ENTRY(I32_TO_I64)       /* sign extends the 32bit integer at the top of the stack to 64 bits */
+
+OPCODE_EXTENDED_ENTRY(I32_TO_F32)       /* converts the i32 at the top of the stack to f32 */
+OPCODE_EXTENDED_ENTRY(I32_TO_F64)       /* converts the i32 at the top of the stack to f64 */
+OPCODE_EXTENDED_ENTRY(U32_TO_F64)       /* converts the u32 at the top of the stack to f64 */
+OPCODE_EXTENDED_ENTRY(I64_TO_F64)       /* converts the i64 at the top of the stack to f64 */
+OPCODE_EXTENDED_ENTRY(F32_TO_I32)       /* converts the f32 at the top of the stack to i32, rounding towards zero */
+OPCODE_EXTENDED_ENTRY(F64_TO_I32)       /* converts the f64 at the top of the stack to i32, rounding towards zero */
+OPCODE_EXTENDED_ENTRY(F64_TO_I64)       /* converts the f64 at the top of the stack to i64, rounding towards zero */
+OPCODE_EXTENDED_ENTRY(F32_TO_F64)       /* converts the f32 at the top of the stack to f64 */
+OPCODE_EXTENDED_ENTRY(F64_TO_F32)       /* converts the f64 at the top of the stack to f32 */
@@ -44,7 +44,7 @@ OPCODE_ENTRY(CALL)                      /* [ opcode | 32bit branch_offset (i32)
 OPCODE_ENTRY(CALL_DYN)                  /* calls a function (native functions, or normal functions) that is stored in the stack */
 OPCODE_ENTRY(CALL_DYN_ERR)              /* calls a function (native functions, or normal functions) that is stored in the stack and throws all occurring error codes */
 
-OPCODE_ENTRY(RETURN)                    /* returns from a function, by jumping to the instruction pointer at the top of the callstack, which is then popped from the callstack */
+OPCODE_ENTRY(RETURN)                    /* returns from a function, by moving the return value to the start of the stack frame and jumping to the instruction pointer at the top of the callstack, which is then popped from the callstack */
 
 //OPCODE_ENTRY(RETURN_0)                /* returns a nothing from a function, by jumping to the instruction pointer stored at the top of the stack, which is then popped from the stack */
 //OPCODE_ENTRY(RETURN_8)                /* returns a 8bit  value from a function, by jumping to the instruction pointer stored in front of the 8bit  value in the stack, which is then popped from the stack */
@@ -284,3 +284,11 @@ OPCODE_ENTRY(STRUCT_SET_64)             /* [ opcode | 16bit offset ] - sets the
 
 OPCODE_ENTRY(TYPE_CONV_STATIC)          /* [ opcode | 8bit type : (4bit type_from, 4bit type_to) ] - pops @type_from off the stack, converts it to @type_to and pushes the converted value to the stack */
 OPCODE_ENTRY(TYPE_CONV_REINTERPRET)     /* [ opcode | 8bit type : (4bit type_from, 4bit type_to) ] - pops @type_from off the stack resizes it to the size of @type_to and pushes the converted value to the stack */
+
+////////////////////////////////////////////////////////////////
+// Extended Opcodes                                           //
+////////////////////////////////////////////////////////////////
+
+// the last opcode, so that adding it did not change the values of the opcodes in front of it
+
+OPCODE_ENTRY(EXT)                       /* [ opcode | 8bit extended_opcode | ... ] - executes the extended opcode @extended_opcode (see wave_opcodes_extended_inline.h), used once the 256 main opcodes are exhausted */
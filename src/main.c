@@ -4,6 +4,7 @@
 
 #include "language/compiler/compiler.h"
 #include "language/compiler/disassembler.h"
+#include "language/compiler/tokenizer.h"
 
 #include "language/runtime/wave_vm.h"
 #include "language/runtime/wave_vm_container.h"
@@ -79,6 +80,40 @@ static error_code builtin_disassembler_print(str string, u32 length) {
     return ERROR_CODE_EXECUTION_SUCCESSFUL;
 }
 
+#if PROGRAM_FEATURE_WAVE_TOKENIZER_BENCHMARK != 0
+
+#define TOKENIZER_BENCHMARK_MIN_BYTES (64 * 1024 * 1024) /* the amount of source bytes tokenized in total */
+
+static error_code benchmark_tokenizer(wave_vm* vm, str source, u32 source_length) {
+    if (source_length == 0) {
+        return ERROR_CODE_EXECUTION_SUCCESSFUL;
+    }
+
+    u32 iterations = TOKENIZER_BENCHMARK_MIN_BYTES / source_length + 1;
+
+    u64 start_time = 0;
+    RUN_ERROR_CODE_FUNCTION(platform_get_time_ms, &start_time);
+
+    for (u32 i = 0; i < iterations; i++) {
+        wave_token_stream tokens;
+        RUN_ERROR_CODE_FUNCTION(wave_compiler_tokenize, vm, source, &tokens);
+        RUN_ERROR_CODE_FUNCTION(wave_compiler_tokenizer_destroy);
+    }
+
+    u64 end_time = 0;
+    RUN_ERROR_CODE_FUNCTION(platform_get_time_ms, &end_time);
+
+    u64 elapsed_time = end_time > start_time ? end_time - start_time : 1;
+    u64 total_bytes = (u64) source_length * iterations;
+    DEBUG_INFO("tokenizer benchmark: %u64 bytes in %u64ms (%u64 MB/s)", total_bytes, elapsed_time, (total_bytes * 1000) / (elapsed_time * 1024 * 1024));
+
+    return ERROR_CODE_EXECUTION_SUCCESSFUL;
+}
+
+#undef TOKENIZER_BENCHMARK_MIN_BYTES
+
+#endif
+
 error_code program_main(void) {
     DEBUG_NEW_LINE();
 
@@ -108,6 +143,11 @@ error_code program_main(void) {
     RUN_ERROR_CODE_FUNCTION(wave_vm_register_default_functions, &vm);
     RUN_ERROR_CODE_FUNCTION(wave_vm_function_registration_done, &vm);
 
+    #if PROGRAM_FEATURE_WAVE_TOKENIZER_BENCHMARK != 0
+    DEBUG_INFO("benchmarking tokenizer...");
+    RUN_ERROR_CODE_FUNCTION(benchmark_tokenizer, &vm, file_content, file_length);
+    #endif
+
     // compile bytecode
 
     DEBUG_INFO("compiling bytecode...");